@@ -4,15 +4,185 @@
 #include "exti_hal.h"
 #include "assert.h"
 
+#if CONFIG_GPIO_STORM_GUARD
+#include "timer.h"
+#include "stm32f446xx.h"
+#endif /* CONFIG_GPIO_STORM_GUARD */
+
 #include <stdint.h>
 #include <stddef.h>
 
+#if CONFIG_GPIO_STORM_GUARD
+
+#define GPIO_STORM_WINDOW_CYCLES    ((uint32_t) CONFIG_GPIO_STORM_WINDOW_MS * TIMER_CYCLES_PER_MS)
+
+/* Back-off doubles on each trip following a release closely, up to 64 times the first */
+#define GPIO_STORM_MAX_SHIFT        6
+
+/*
+* Interrupt lines configured by gpio_init go through gpio_storm_isr, which counts
+* the edges of a line in fixed windows. A line over the limit is masked in EXTI,
+* the periodic release timer unmasks it once its back-off has expired.
+*/
+struct gpio_storm_line_t
+{
+    gpio_callback_t callback;
+    void* arg;
+    uint32_t window_start;      /* Cycles, low 32 bits */
+    uint32_t window_edges;
+    uint32_t release_ms;        /* End of the back-off of a masked line */
+    uint32_t released_ms;       /* Last time the line was unmasked */
+    uint32_t edges;
+    uint32_t trips;
+    uint8_t shift;              /* Back-off is CONFIG_GPIO_STORM_BACKOFF_MS << shift */
+    volatile uint8_t masked;
+};
+
+static struct gpio_storm_line_t gpio_storm_lines[GPIO_PIN_ALL];
+static soft_timer_t gpio_storm_timer;
+static uint8_t gpio_storm_started;
+
+
+static void gpio_storm_isr(uint32_t pin, void* arg)
+{
+    struct gpio_storm_line_t* line;
+    exti_hal_context_t exti_hal;
+    uint32_t primask;
+    uint32_t now;
+    uint32_t now_ms;
+
+    (void) arg;
+
+    line = &gpio_storm_lines[pin];
+
+    /* Not counted nor passed on until the release timer unmasks it */
+    if(line->masked)
+    {
+        return;
+    }
+
+    now = (uint32_t) timer_get_cycles();
+
+    if(now - line->window_start >= GPIO_STORM_WINDOW_CYCLES)
+    {
+        line->window_start = now;
+        line->window_edges = 0;
+    }
+
+    if(++line->window_edges > CONFIG_GPIO_STORM_MAX_EDGES)
+    {
+        EXTI_HAL_GET_HW(&exti_hal, EXTI);
+
+        /* EXTI_IMR is also written by interrupts of other lines and the release timer */
+        primask = __get_PRIMASK();
+        __disable_irq();
+        exti_hal_disable_interrupt(&exti_hal, pin);
+        __set_PRIMASK(primask);
+
+        now_ms = (uint32_t) timer_get_milliseconds();
+
+        /* Still chattering right after its release, wait longer this time */
+        if(line->trips != 0 &&
+            now_ms - line->released_ms < ((uint32_t) CONFIG_GPIO_STORM_BACKOFF_MS << line->shift))
+        {
+            if(line->shift < GPIO_STORM_MAX_SHIFT)
+            {
+                ++line->shift;
+            }
+        }
+        else
+        {
+            line->shift = 0;
+        }
+
+        line->release_ms = now_ms + ((uint32_t) CONFIG_GPIO_STORM_BACKOFF_MS << line->shift);
+        ++line->trips;
+        line->masked = 1;
+
+        return;
+    }
+
+    ++line->edges;
+
+    if(line->callback)
+    {
+        line->callback(pin, line->arg);
+    }
+}
+
+static void gpio_storm_release(soft_timer_t* p_timer, void* arg)
+{
+    struct gpio_storm_line_t* line;
+    exti_hal_context_t exti_hal;
+    uint32_t primask;
+    uint32_t now_ms;
+    uint32_t pin;
+
+    (void) p_timer;
+    (void) arg;
+
+    EXTI_HAL_GET_HW(&exti_hal, EXTI);
+    now_ms = (uint32_t) timer_get_milliseconds();
+
+    for(pin = 0; pin < GPIO_PIN_ALL; pin++)
+    {
+        line = &gpio_storm_lines[pin];
+
+        if(line->masked && (int32_t) (now_ms - line->release_ms) >= 0)
+        {
+            line->window_edges = 0;
+            line->released_ms = now_ms;
+            line->masked = 0;
+
+            /* Edges seen while masked are stale */
+            primask = __get_PRIMASK();
+            __disable_irq();
+            exti_hal_clear_pending(&exti_hal, pin);
+            exti_hal_enable_interrupt(&exti_hal, pin);
+            __set_PRIMASK(primask);
+        }
+    }
+}
+
+static void gpio_storm_register(exti_hal_context_t* exti_hal, uint32_t pin_mask,
+                                                        const gpio_config_t* config)
+{
+    uint32_t pin;
+
+    if(!gpio_storm_started)
+    {
+        soft_timer_init(&gpio_storm_timer, &gpio_storm_release, NULL);
+        soft_timer_start(&gpio_storm_timer, CONFIG_GPIO_STORM_WINDOW_MS,
+                                                    CONFIG_GPIO_STORM_WINDOW_MS);
+        gpio_storm_started = 1;
+    }
+
+    for(pin = 0; pin < GPIO_PIN_ALL; pin++)
+    {
+        if((pin_mask >> pin) & 0x01)
+        {
+            gpio_storm_lines[pin].callback = config->irq_callback;
+            gpio_storm_lines[pin].arg = config->irq_arg;
+            gpio_storm_lines[pin].window_edges = 0;
+            gpio_storm_lines[pin].masked = 0;
+
+            /* Lines with no callback are guarded too, a storm costs the same */
+            exti_hal_register_callback(exti_hal, pin, &gpio_storm_isr, NULL);
+        }
+    }
+}
+
+#endif  /* CONFIG_GPIO_STORM_GUARD */
+
 
 error_t gpio_init(gpio_port_t port, const gpio_config_t* config)
 {
     gpio_hal_context_t gpio_hal;
     exti_hal_context_t exti_hal;
+    uint32_t pin_mask;
+#if !CONFIG_GPIO_STORM_GUARD
     uint32_t pin_indx;
+#endif
 
     ASSERT(port < GPIO_PORT_ALL);
     ASSERT(config && config->pin_mask);
@@ -21,86 +191,75 @@ error_t gpio_init(gpio_port_t port, const gpio_config_t* config)
 
     gpio_hal_init(port);
 
-    pin_indx = 0;
-    do
+    /* All pins share the configuration, each register is written once for the port */
+    pin_mask = config->pin_mask & (BIT(GPIO_PIN_ALL) - 1UL);
+
+    if((config->mode & MODE_INPUT) != 0x00)
+    {
+        gpio_hal_set_mode_input_mask(&gpio_hal, pin_mask);
+    }
+
+    else if((config->mode & MODE_OUTPUT) != 0x00)
     {
-        if((config->pin_mask >> pin_indx) & 0x01)
+        if((config->mode & OUTPUT_PP) != 0x00)
         {
-            if((config->mode & MODE_INPUT) != 0x00)
-            {
-                gpio_hal_set_mode_input(&gpio_hal, pin_indx);
-            }
+            gpio_hal_set_mode_output_pp_mask(&gpio_hal, pin_mask);
+        }
+        else
+        {
+            gpio_hal_set_mode_output_od_mask(&gpio_hal, pin_mask);
+        }
+    }
 
-            else if((config->mode & MODE_OUTPUT) != 0x00)
-            {
-                if((config->mode & OUTPUT_PP) != 0x00)
-                {
-                    gpio_hal_set_mode_output_pp(&gpio_hal, pin_indx);
-                }
-                else
-                {
-                    gpio_hal_set_mode_output_od(&gpio_hal, pin_indx);
-                }
-            }
+    if((config->mode & MODE_MASK) != MODE_ANALOG)
+    {
+        if(config->pull == GPIO_PULLUP)
+        {
+            gpio_hal_set_pull_up_mask(&gpio_hal, pin_mask);
+        }
+        else if(config->pull == GPIO_PULLDOWN)
+        {
+            gpio_hal_set_pull_down_mask(&gpio_hal, pin_mask);
+        }
+        else
+        {
+            gpio_hal_set_pull_disable_mask(&gpio_hal, pin_mask);
+        }
+    }
+    else
+    {
+        gpio_hal_set_mode_analog_mask(&gpio_hal, pin_mask);
+    }
 
-            if((config->mode & MODE_MASK) != MODE_ANALOG)
-            {
-                
-                if(config->pull == GPIO_PULLUP)
-                {
-                    gpio_hal_set_pull_up(&gpio_hal, pin_indx);
-                }
-                else if(config->pull == GPIO_PULLDOWN)
-                {
-                    gpio_hal_set_pull_down(&gpio_hal, pin_indx);
-                }
-                else
-                {
-                    gpio_hal_set_pull_disable(&gpio_hal, pin_indx);
-                }
-            }
-            else
-            {
-                gpio_hal_set_mode_analog(&gpio_hal, pin_indx);
-            }
+    /* EXTI mode, lines sharing an NVIC interrupt line are enabled together */
+    if((config->mode & MODE_INTERRUPT) != 0x00)
+    {
+        EXTI_HAL_GET_HW(&exti_hal, EXTI);
+        
+        exti_hal_init(&exti_hal);
+        exti_hal_set_port_mask(&exti_hal, pin_mask, EXTI_GET_PORT(port));
+        exti_hal_set_edges_mask(&exti_hal, pin_mask,
+                        (config->mode & TRIGGER_RISING) != 0x00 ? pin_mask : 0,
+                        (config->mode & TRIGGER_FALLING) != 0x00 ? pin_mask : 0);
 
-            /* EXTI mode */
-            if((config->mode & MODE_INTERRUPT) != 0x00)
+#if CONFIG_GPIO_STORM_GUARD
+        gpio_storm_register(&exti_hal, pin_mask, config);
+#else
+        if(config->irq_callback)
+        {
+            for(pin_indx = 0; pin_indx < GPIO_PIN_ALL; pin_indx++)
             {
-                EXTI_HAL_GET_HW(&exti_hal, EXTI);
-                
-                exti_hal_init(&exti_hal);
-                exti_hal_set_port(&exti_hal, EXTI_GET_LINE(pin_indx), EXTI_GET_PORT(port));
-                
-                if((config->mode & TRIGGER_RISING) != 0x00)
-                {
-                    exti_hal_enable_rising_edge(&exti_hal, EXTI_GET_LINE(pin_indx));
-                }
-                else
-                {
-                    exti_hal_disable_rising_edge(&exti_hal, EXTI_GET_LINE(pin_indx));
-                }
-
-                if((config->mode & TRIGGER_FALLING) != 0x00)
-                {
-                    exti_hal_enable_falling_edge(&exti_hal, EXTI_GET_LINE(pin_indx));
-                }
-                else
-                {
-                    exti_hal_disable_falling_edge(&exti_hal, EXTI_GET_LINE(pin_indx));
-                }
-
-                if(config->irq_callback)
+                if((pin_mask >> pin_indx) & 0x01)
                 {
-                    exti_hal_register_callback(&exti_hal, pin_indx, config->irq_callback);
+                    exti_hal_register_callback(&exti_hal, pin_indx, config->irq_callback,
+                                                                    config->irq_arg);
                 }
-
-                exti_hal_enable_interrupt(&exti_hal, EXTI_GET_LINE(pin_indx));
             }
         }
+#endif /* CONFIG_GPIO_STORM_GUARD */
 
-        pin_indx++;
-    } while (pin_indx < GPIO_PIN_ALL);
+        exti_hal_enable_interrupt_mask(&exti_hal, pin_mask);
+    }
     
     return OK;
 }
@@ -137,4 +296,27 @@ void gpio_toggle_pin(gpio_port_t port, gpio_pin_t pin)
     GPIO_HAL_GET_HW(&gpio_hal, port);
 
     gpio_hal_out_toggle_pin(&gpio_hal, pin);
-}
\ No newline at end of file
+}
+
+#if CONFIG_GPIO_STORM_GUARD
+
+error_t gpio_get_storm_stats(gpio_pin_t pin, gpio_storm_stats_t* stats)
+{
+    struct gpio_storm_line_t* line;
+
+    if(pin >= GPIO_PIN_ALL || !stats)
+    {
+        return FAILED;
+    }
+
+    line = &gpio_storm_lines[pin];
+
+    stats->edges = line->edges;
+    stats->trips = line->trips;
+    stats->backoff_ms = (uint32_t) CONFIG_GPIO_STORM_BACKOFF_MS << line->shift;
+    stats->masked = line->masked;
+
+    return OK;
+}
+
+#endif  /* CONFIG_GPIO_STORM_GUARD */
\ No newline at end of file
@@ -37,7 +37,8 @@
 #define GPIO_PULLUP         0x00000001U
 #define GPIO_PULLDOWN       0x00000002U
 
-typedef void (*gpio_callback_t) (void);
+/* Called from interrupt context with the pin that triggered and irq_arg */
+typedef void (*gpio_callback_t) (uint32_t pin, void* arg);
 
 typedef enum
 {
@@ -45,12 +46,22 @@ typedef enum
     GPIO_PIN_SET = 1
 } gpio_pin_state_t;
 
+/* Interrupt storm guard counters of an EXTI line, with CONFIG_GPIO_STORM_GUARD */
+typedef struct
+{
+    uint32_t edges;             /* Edges passed to the callback */
+    uint32_t trips;             /* Times the line was masked for exceeding the rate */
+    uint32_t backoff_ms;        /* Back-off of the last trip */
+    uint8_t masked;             /* 1 while the line is masked */
+} gpio_storm_stats_t;
+
 typedef struct 
 {
     uint32_t pin_mask;
     uint32_t mode;
     uint32_t pull;
     gpio_callback_t irq_callback;
+    void* irq_arg;
 } gpio_config_t;
 
 /**
@@ -101,4 +112,20 @@ void gpio_write_pin(gpio_port_t port, gpio_pin_t pin, gpio_pin_state_t state);
  */
 void gpio_toggle_pin(gpio_port_t port, gpio_pin_t pin);
 
+/**
+ * @brief Interrupt storm counters of a pin configured by gpio_init with
+ *        CONFIG_GPIO_STORM_GUARD. A line getting more than CONFIG_GPIO_STORM_MAX_EDGES
+ *        edges in CONFIG_GPIO_STORM_WINDOW_MS is masked for a back-off, doubled when
+ *        the line trips again right after its release. Lines are shared by ports,
+ *        the counters are those of the EXTI line of the pin.
+ * 
+ * @param pin pin number as in gpio_pin_t
+ * @param stats
+ * @return error_t OK/FAILED
+ * 
+ * @example gpio_storm_stats_t stats;
+ *          gpio_get_storm_stats(GPIO_PIN_3, &stats);
+ */
+error_t gpio_get_storm_stats(gpio_pin_t pin, gpio_storm_stats_t* stats);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,484 @@
+#include "gpio_capture.h"
+
+#include "gpio_hal.h"
+#include "TIM_GP_hal.h"
+#include "timer.h"
+#include "assert.h"
+
+#if CONFIG_SERIAL_PORTS_USE
+#include "serial.h"
+#endif /* CONFIG_SERIAL_PORTS_USE */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if CONFIG_GPIO_CAPTURE_USE
+
+#if CONFIG_GPIO_WAVE_USE && (CONFIG_GPIO_CAPTURE_TIMER == CONFIG_GPIO_WAVE_TIMER)
+#error "GPIO capture and GPIO waveforms need different timers"
+#endif
+
+/* TIM1 and TIM8 clock, APB2 is not divided */
+#define GPIO_CAPTURE_TIMER_CLOCK_HZ     TIMER_CORE_CLOCK_HZ
+
+#define GPIO_CAPTURE_MAX_RELOAD         0x10000UL
+
+/* Encoded bytes are handed out by chunks */
+#define GPIO_CAPTURE_RLE_CHUNK_SIZE     64
+
+/* Time the serial Tx queue may stay full before a transfer is abandoned */
+#define GPIO_CAPTURE_SERIAL_TIMEOUT_MS  1000U
+
+struct gpio_capture_ctrl_t
+{
+    gpio_capture_config_t config;
+    tim_gp_hal_context_t* timer;
+    volatile uint8_t state;
+    uint16_t block;             /* Index of the next half to be searched */
+    uint16_t history;           /* Samples before the current half, up to pre_samples */
+    uint16_t previous;          /* Last sample of the previous half */
+    uint8_t has_previous;       /* Cleared until the first half is searched */
+    uint16_t first;             /* Index of the first sample of the capture */
+    int32_t remaining;          /* Samples after the current half still to come */
+};
+
+struct gpio_capture_rle_t
+{
+    gpio_capture_out_t out;
+    void* arg;
+    uint16_t len;
+    error_t status;             /* Nothing more is encoded once out failed */
+    uint8_t chunk[GPIO_CAPTURE_RLE_CHUNK_SIZE];
+};
+
+static struct gpio_capture_ctrl_t gpio_capture;
+
+
+/**
+ * @brief Search a half of the ring for the trigger
+ *
+ * @return uint16_t offset of the trigger sample, count if not found
+ */
+static uint16_t gpio_capture_find_trigger(const uint16_t* samples, uint16_t indx,
+                                                                    uint16_t count)
+{
+    uint16_t previous;
+    uint16_t mask;
+    uint16_t value;
+
+    mask = gpio_capture.config.trigger_mask;
+    value = gpio_capture.config.trigger_value & mask;
+    if(indx > 0)
+    {
+        previous = samples[indx - 1];
+    }
+    else if(gpio_capture.has_previous)
+    {
+        previous = gpio_capture.previous;
+    }
+    else
+    {
+        /* Nothing was sampled before the first sample, no edge can be seen on it */
+        previous = samples[0];
+    }
+
+    switch(gpio_capture.config.trigger)
+    {
+        case GPIO_CAPTURE_TRIGGER_PATTERN:
+            for(; indx < count; indx++)
+            {
+                if((samples[indx] & mask) == value)
+                {
+                    return indx;
+                }
+            }
+            break;
+        case GPIO_CAPTURE_TRIGGER_ENTER:
+            for(; indx < count; indx++)
+            {
+                if((samples[indx] & mask) == value && (previous & mask) != value)
+                {
+                    return indx;
+                }
+
+                previous = samples[indx];
+            }
+            break;
+        case GPIO_CAPTURE_TRIGGER_CHANGE:
+            for(; indx < count; indx++)
+            {
+                if((samples[indx] ^ previous) & mask)
+                {
+                    return indx;
+                }
+
+                previous = samples[indx];
+            }
+            break;
+        default:
+            return indx;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Stop sampling and check the capture was not reached by the DMA meanwhile
+ *
+ * @param end index following the last sample searched
+ */
+static void gpio_capture_finish(uint16_t end)
+{
+    uint16_t size;
+    uint16_t written;
+    uint16_t room;
+
+    tim_gp_hal_stop(gpio_capture.timer);
+
+    size = gpio_capture.config.size;
+
+    /* Samples written after the searched ones and room left before the capture */
+    written = (tim_gp_hal_get_update_dma_index(gpio_capture.timer) + size - end) % size;
+    room = (gpio_capture.first + size - end) % size;
+
+    gpio_capture.state = (written > room) ? GPIO_CAPTURE_OVERRUN : GPIO_CAPTURE_DONE;
+
+    if(gpio_capture.config.callback)
+    {
+        gpio_capture.config.callback();
+    }
+}
+
+/**
+ * @brief A half of the ring was filled, called from the DMA interrupt
+ */
+static void gpio_capture_block_done(tim_gp_hal_context_t* p_timer)
+{
+    const gpio_capture_config_t* config;
+    const uint16_t* samples;
+    uint16_t half;
+    uint16_t start;
+    uint16_t found;
+
+    (void) p_timer;
+
+    config = &gpio_capture.config;
+    half = config->size / 2U;
+    samples = &config->buffer[gpio_capture.block];
+
+    if(gpio_capture.state == GPIO_CAPTURE_ARMED)
+    {
+        /* The history must be sampled before the trigger may be found */
+        start = 0;
+
+        if(gpio_capture.history < config->pre_samples)
+        {
+            start = config->pre_samples - gpio_capture.history;
+            gpio_capture.history = (start < half) ? config->pre_samples :
+                                                    gpio_capture.history + half;
+        }
+
+        found = half;
+
+        if(start < half)
+        {
+            found = gpio_capture_find_trigger(samples, start, half);
+        }
+
+        if(found < half)
+        {
+            gpio_capture.first = (gpio_capture.block + found + config->size -
+                                            config->pre_samples) % config->size;
+            gpio_capture.remaining = (int32_t) config->post_samples - (half - found);
+            gpio_capture.state = GPIO_CAPTURE_TRIGGERED;
+        }
+
+        gpio_capture.previous = samples[half - 1U];
+        gpio_capture.has_previous = 1;
+    }
+    else if(gpio_capture.state == GPIO_CAPTURE_TRIGGERED)
+    {
+        gpio_capture.remaining -= half;
+    }
+
+    gpio_capture.block = (gpio_capture.block + half) % config->size;
+
+    if(gpio_capture.state == GPIO_CAPTURE_TRIGGERED && gpio_capture.remaining <= 0)
+    {
+        gpio_capture_finish(gpio_capture.block);
+    }
+}
+
+static void gpio_capture_rle_put(struct gpio_capture_rle_t* rle, const uint8_t* data,
+                                                                        uint16_t len)
+{
+    while(len-- && rle->status == OK)
+    {
+        rle->chunk[rle->len++] = *data++;
+
+        if(rle->len == sizeof(rle->chunk))
+        {
+            rle->status = rle->out(rle->chunk, rle->len, rle->arg);
+            rle->len = 0;
+        }
+    }
+}
+
+static void gpio_capture_rle_put_le(struct gpio_capture_rle_t* rle, uint32_t value,
+                                                                        uint8_t size)
+{
+    uint8_t bytes[4];
+    uint8_t indx;
+
+    for(indx = 0; indx < size; indx++)
+    {
+        bytes[indx] = (uint8_t) (value >> (8U * indx));
+    }
+
+    gpio_capture_rle_put(rle, bytes, size);
+}
+
+static void gpio_capture_rle_put_run(struct gpio_capture_rle_t* rle, uint16_t value,
+                                                                    uint32_t count)
+{
+    uint8_t bytes[7];
+    uint8_t len;
+
+    bytes[0] = (uint8_t) value;
+    bytes[1] = (uint8_t) (value >> 8);
+    len = 2;
+
+    while(count >= 0x80)
+    {
+        bytes[len++] = (uint8_t) (count | 0x80);
+        count >>= 7;
+    }
+
+    bytes[len++] = (uint8_t) count;
+
+    gpio_capture_rle_put(rle, bytes, len);
+}
+
+error_t gpio_capture_start(gpio_port_t port, const gpio_capture_config_t* config)
+{
+    gpio_hal_context_t gpio_hal;
+    tim_gp_config_t tim_config;
+    uint32_t ticks;
+    uint32_t prescaler;
+
+    if(port >= GPIO_PORT_ALL || !config || !config->buffer || config->size < 4 ||
+            (config->size & 0x01) || config->sample_hz == 0 || config->post_samples == 0 ||
+            config->trigger >= GPIO_CAPTURE_TRIGGER_MAX)
+    {
+        return FAILED;
+    }
+
+    if((uint32_t) config->pre_samples + config->post_samples > config->size / 2U)
+    {
+        return FAILED;
+    }
+
+    if(gpio_capture.state == GPIO_CAPTURE_ARMED || gpio_capture.state == GPIO_CAPTURE_TRIGGERED)
+    {
+        return FAILED;
+    }
+
+    /* Sample period in timer clock cycles, rounded to the nearest */
+    ticks = (GPIO_CAPTURE_TIMER_CLOCK_HZ + config->sample_hz / 2U) / config->sample_hz;
+
+    if(ticks < GPIO_CAPTURE_MIN_TICKS)
+    {
+        return FAILED;
+    }
+
+    prescaler = (ticks - 1U) / GPIO_CAPTURE_MAX_RELOAD;
+
+    tim_config.prescaler = (uint16_t) prescaler;
+    tim_config.reload = ticks / (prescaler + 1U) - 1U;
+    tim_config.count_mode = TIM_GP_COUNT_UP;
+    tim_config.callback = NULL;
+    tim_config.channel_callback = NULL;
+
+    gpio_capture.timer = tim_gp_hal_init(CONFIG_GPIO_CAPTURE_TIMER, &tim_config);
+
+    if(!gpio_capture.timer)
+    {
+        return FAILED;
+    }
+
+    memcpy(&gpio_capture.config, config, sizeof(gpio_capture_config_t));
+    gpio_capture.block = 0;
+    gpio_capture.history = 0;
+    gpio_capture.previous = 0;
+    gpio_capture.has_previous = 0;
+    gpio_capture.first = 0;
+    gpio_capture.remaining = 0;
+    gpio_capture.state = GPIO_CAPTURE_ARMED;
+
+    GPIO_HAL_GET_HW(&gpio_hal, port);
+
+    if(tim_gp_hal_start_update_dma_read(gpio_capture.timer, gpio_hal_get_idr_addr(&gpio_hal),
+                    config->buffer, config->size, &gpio_capture_block_done,
+                                                    &gpio_capture_block_done) != OK)
+    {
+        gpio_capture.state = GPIO_CAPTURE_IDLE;
+
+        return FAILED;
+    }
+
+    return OK;
+}
+
+error_t gpio_capture_stop(void)
+{
+    if(!gpio_capture.timer)
+    {
+        return FAILED;
+    }
+
+    if(gpio_capture.state == GPIO_CAPTURE_ARMED || gpio_capture.state == GPIO_CAPTURE_TRIGGERED)
+    {
+        gpio_capture.state = GPIO_CAPTURE_IDLE;
+    }
+
+    return tim_gp_hal_stop_update_dma(gpio_capture.timer);
+}
+
+uint8_t gpio_capture_get_state(void)
+{
+    return gpio_capture.state;
+}
+
+uint32_t gpio_capture_get_length(void)
+{
+    if(gpio_capture.state != GPIO_CAPTURE_DONE && gpio_capture.state != GPIO_CAPTURE_OVERRUN)
+    {
+        return 0;
+    }
+
+    return (uint32_t) gpio_capture.config.pre_samples + gpio_capture.config.post_samples;
+}
+
+uint16_t gpio_capture_get_sample(uint32_t index)
+{
+    const gpio_capture_config_t* config;
+
+    config = &gpio_capture.config;
+
+    ASSERT(index < gpio_capture_get_length());
+
+    return config->buffer[(gpio_capture.first + index) % config->size] & config->pin_mask;
+}
+
+error_t gpio_capture_write_rle(gpio_capture_out_t out, void* arg)
+{
+    struct gpio_capture_rle_t rle;
+    uint32_t length;
+    uint32_t index;
+    uint32_t count;
+    uint16_t value;
+    uint16_t sample;
+
+    length = gpio_capture_get_length();
+
+    if(!out || length == 0)
+    {
+        return FAILED;
+    }
+
+    rle.out = out;
+    rle.arg = arg;
+    rle.len = 0;
+    rle.status = OK;
+
+    gpio_capture_rle_put(&rle, (const uint8_t*) GPIO_CAPTURE_RLE_MAGIC, 4);
+    gpio_capture_rle_put_le(&rle, GPIO_CAPTURE_RLE_VERSION, 1);
+    gpio_capture_rle_put_le(&rle, (gpio_capture.state == GPIO_CAPTURE_OVERRUN) ?
+                                                        GPIO_CAPTURE_RLE_OVERRUN : 0, 1);
+    gpio_capture_rle_put_le(&rle, gpio_capture.config.pin_mask, 2);
+    gpio_capture_rle_put_le(&rle, gpio_capture.config.sample_hz, 4);
+    gpio_capture_rle_put_le(&rle, length, 4);
+    gpio_capture_rle_put_le(&rle, gpio_capture.config.pre_samples, 4);
+
+    value = gpio_capture_get_sample(0);
+    count = 1;
+
+    for(index = 1; index < length; index++)
+    {
+        sample = gpio_capture_get_sample(index);
+
+        if(sample != value)
+        {
+            gpio_capture_rle_put_run(&rle, value, count);
+            value = sample;
+            count = 0;
+        }
+
+        ++count;
+    }
+
+    gpio_capture_rle_put_run(&rle, value, count);
+
+    if(rle.len && rle.status == OK)
+    {
+        rle.status = out(rle.chunk, rle.len, arg);
+    }
+
+    return rle.status;
+}
+
+#if CONFIG_SERIAL_PORTS_USE
+
+static error_t gpio_capture_serial_out(const uint8_t* data, uint16_t len, void* arg)
+{
+    uint64_t last_progress;
+    uint16_t sent;
+    uint8_t port;
+
+    port = *(const uint8_t*) arg;
+    last_progress = timer_get_milliseconds();
+
+    /* Repeated while the Tx queue is full, given up once it stops draining */
+    while(len)
+    {
+        sent = 0;
+
+        if(serial_tx(port, data, len, &sent) != OK)
+        {
+            return FAILED;
+        }
+
+        if(sent)
+        {
+            last_progress = timer_get_milliseconds();
+        }
+        else if(timer_get_milliseconds() - last_progress >= GPIO_CAPTURE_SERIAL_TIMEOUT_MS)
+        {
+            return FAILED;
+        }
+
+        data += sent;
+        len -= sent;
+    }
+
+    return OK;
+}
+
+error_t gpio_capture_send_rle(uint8_t port)
+{
+    return gpio_capture_write_rle(&gpio_capture_serial_out, &port);
+}
+
+#else
+
+error_t gpio_capture_send_rle(uint8_t port)
+{
+    (void) port;
+
+    return FAILED;
+}
+
+#endif /* CONFIG_SERIAL_PORTS_USE */
+
+#endif  /* CONFIG_GPIO_CAPTURE_USE */
@@ -0,0 +1,131 @@
+#ifndef __GPIO_CAPTURE_H__
+
+#define __GPIO_CAPTURE_H__
+
+#include "gpio_hal.h"
+#include "types.h"
+
+#include <stdint.h>
+
+/* Fastest sample rate, a half word moved by DMA2 from a GPIO port to SRAM every 4 cycles */
+#define GPIO_CAPTURE_MIN_TICKS      4
+
+/*
+* Run-length encoded capture, little endian:
+* header "GCAP", version, flags, pin mask (16), sample rate (32), samples (32),
+* trigger index (32), then runs of a sample value (16) followed by its count as a
+* base 128 varint, 7 bits per byte from the least significant, bit 7 set on all
+* bytes but the last.
+*/
+#define GPIO_CAPTURE_RLE_MAGIC      "GCAP"
+#define GPIO_CAPTURE_RLE_VERSION    1
+#define GPIO_CAPTURE_RLE_OVERRUN    0x01
+
+typedef void (*gpio_capture_callback_t) (void);
+
+/* FAILED stops the encoding */
+typedef error_t (*gpio_capture_out_t) (const uint8_t* data, uint16_t len, void* arg);
+
+typedef enum
+{
+    GPIO_CAPTURE_TRIGGER_NOW,       /* First sample once the history is filled */
+    GPIO_CAPTURE_TRIGGER_PATTERN,   /* Pins of trigger_mask read trigger_value */
+    GPIO_CAPTURE_TRIGGER_ENTER,     /* Pins of trigger_mask change to trigger_value */
+    GPIO_CAPTURE_TRIGGER_CHANGE,    /* Any pin of trigger_mask changes */
+    GPIO_CAPTURE_TRIGGER_MAX
+} gpio_capture_trigger_t;
+
+typedef enum
+{
+    GPIO_CAPTURE_IDLE,
+    GPIO_CAPTURE_ARMED,             /* Sampling, waiting for the trigger */
+    GPIO_CAPTURE_TRIGGERED,         /* Sampling what follows the trigger */
+    GPIO_CAPTURE_DONE,
+    GPIO_CAPTURE_OVERRUN,           /* Done, the oldest samples were overwritten */
+} gpio_capture_state_t;
+
+typedef struct
+{
+    uint16_t*   buffer;
+    uint16_t    size;               /* Samples, even */
+    uint16_t    pin_mask;           /* Pins recorded, the others read as 0 */
+    uint32_t    sample_hz;
+    uint16_t    pre_samples;        /* History kept before the trigger */
+    uint16_t    post_samples;       /* From the trigger sample on, at least 1 */
+    uint8_t     trigger;            /* gpio_capture_trigger_t */
+    uint16_t    trigger_mask;
+    uint16_t    trigger_value;
+    gpio_capture_callback_t callback;   /* Capture done, interrupt context, may be NULL */
+} gpio_capture_config_t;
+
+
+/**
+ * @brief Sample all pins of a port at a fixed rate, a timer update event triggers a
+ * DMA read of the input register into the buffer, used as a ring whose halves are
+ * searched for the trigger in turn. Sampling stops once post_samples follow the
+ * trigger, the capture is then pre_samples + post_samples long.
+ * pre_samples + post_samples must not exceed half the buffer, the rest absorbs the
+ * latency of the interrupt stopping the sampling.
+ * 
+ * @param port
+ * @param config copied, the buffer must stay valid until the capture is read
+ * @return error_t FAILED if a capture is running, the configuration is invalid or
+ *         the DMA stream of the timer is used by a serial port set up before
+ * 
+ * @example gpio_capture_config_t config = {
+ *              .buffer = samples, .size = 2048, .pin_mask = 0x00FF,
+ *              .sample_hz = 1000000, .pre_samples = 256, .post_samples = 768,
+ *              .trigger = GPIO_CAPTURE_TRIGGER_ENTER,
+ *              .trigger_mask = GPIO_PIN_MASK(GPIO_PIN_0), .trigger_value = 0};
+ *          gpio_capture_start(GPIOB, &config); //Falling edge of PB0
+ */
+error_t gpio_capture_start(gpio_port_t port, const gpio_capture_config_t* config);
+
+/**
+ * @brief Abort a running capture, a finished capture is kept
+ * 
+ * @return error_t
+ */
+error_t gpio_capture_stop(void);
+
+/**
+ * @brief
+ * 
+ * @return uint8_t gpio_capture_state_t
+ */
+uint8_t gpio_capture_get_state(void);
+
+/**
+ * @brief
+ * 
+ * @return uint32_t number of samples of a finished capture, 0 otherwise
+ */
+uint32_t gpio_capture_get_length(void);
+
+/**
+ * @brief Sample of a finished capture, the trigger sample is at index pre_samples
+ * 
+ * @param index 0 to gpio_capture_get_length() - 1
+ * @return uint16_t pin levels masked by pin_mask
+ */
+uint16_t gpio_capture_get_sample(uint32_t index);
+
+/**
+ * @brief Run-length encode a finished capture, see GPIO_CAPTURE_RLE_MAGIC
+ * 
+ * @param out called with consecutive chunks of the encoding
+ * @param arg passed to out
+ * @return error_t FAILED if no capture is finished or out failed
+ */
+error_t gpio_capture_write_rle(gpio_capture_out_t out, void* arg);
+
+/**
+ * @brief Stream a finished capture over a serial port, run-length encoded
+ * 
+ * @param port serial port
+ * @return error_t FAILED if no capture is finished, the transmission could not be
+ *         started or the Tx queue did not drain for a second
+ */
+error_t gpio_capture_send_rle(uint8_t port);
+
+#endif
@@ -0,0 +1,214 @@
+#include "gpio_event.h"
+#include "gpio.h"
+
+#include "gpio_hal.h"
+#include "timer.h"
+#include "stm32f446xx.h"
+#include "assert.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if CONFIG_GPIO_EVENT_USE
+
+#if (CONFIG_GPIO_EVENT_QUEUE_SIZE & (CONFIG_GPIO_EVENT_QUEUE_SIZE - 1)) != 0
+#error "CONFIG_GPIO_EVENT_QUEUE_SIZE must be a power of 2"
+#endif
+
+#define GPIO_EVENT_QUEUE_MASK   (CONFIG_GPIO_EVENT_QUEUE_SIZE - 1UL)
+
+#define GPIO_EVENT_EDGE_RISING  BIT(GPIO_EVENT_RISING)
+#define GPIO_EVENT_EDGE_FALLING BIT(GPIO_EVENT_FALLING)
+
+/*
+* Ring with one reader and interrupts of any priority as writers, no interrupt is
+* ever masked. A writer takes the timestamp, then reserves the head slot in an
+* exclusive access. An interrupt preempting it in between moves the head or makes
+* the store fail, and the reservation is retried with a new timestamp, so slots are
+* in timestamp order. The timestamp is read outside of the exclusive access, whose
+* window holds no call nor memory access other than the head and its slot sequence.
+* A slot is published once written by setting its sequence to its position + 1,
+* the reader frees it by setting the position it takes on the next lap.
+*/
+struct gpio_event_queue_t
+{
+    gpio_event_t events[CONFIG_GPIO_EVENT_QUEUE_SIZE];
+    volatile uint32_t seq[CONFIG_GPIO_EVENT_QUEUE_SIZE];
+    volatile uint32_t head;
+    uint32_t tail;
+    volatile uint32_t dropped;
+    uint8_t ready;
+};
+
+struct gpio_event_line_t
+{
+    gpio_hal_context_t gpio;
+    uint8_t port;
+    uint8_t edges;              /* GPIO_EVENT_EDGE_RISING | GPIO_EVENT_EDGE_FALLING */
+};
+
+static struct gpio_event_queue_t gpio_event_queue;
+static struct gpio_event_line_t gpio_event_lines[GPIO_PIN_ALL];
+
+
+static void gpio_event_drop(void)
+{
+    uint32_t dropped;
+
+    do
+    {
+        dropped = __LDREXW(&gpio_event_queue.dropped);
+    } while(__STREXW(dropped + 1U, &gpio_event_queue.dropped) != 0);
+}
+
+static void gpio_event_isr(uint32_t pin, void* arg)
+{
+    struct gpio_event_line_t* line;
+    gpio_event_t* event;
+    uint64_t timestamp;
+    uint32_t seen;
+    uint32_t head;
+    uint8_t level;
+
+    (void) arg;
+
+    line = &gpio_event_lines[pin];
+    level = (uint8_t) gpio_hal_in_read_pin(&line->gpio, pin);
+
+    for(;;)
+    {
+        seen = gpio_event_queue.head;
+        timestamp = timer_get_cycles();
+        head = __LDREXW(&gpio_event_queue.head);
+
+        /* A writer preempting after the head was seen took an earlier slot */
+        if(head != seen)
+        {
+            __CLREX();
+
+            continue;
+        }
+
+        /* Full, the slot still holds the event of the previous lap */
+        if(gpio_event_queue.seq[head & GPIO_EVENT_QUEUE_MASK] != head)
+        {
+            __CLREX();
+            gpio_event_drop();
+
+            return;
+        }
+
+        if(__STREXW(head + 1U, &gpio_event_queue.head) == 0)
+        {
+            break;
+        }
+    }
+
+    event = &gpio_event_queue.events[head & GPIO_EVENT_QUEUE_MASK];
+    event->timestamp = timestamp;
+    event->pin = (uint8_t) pin;
+    event->port = line->port;
+    event->level = level;
+
+    if(line->edges == GPIO_EVENT_EDGE_RISING)
+    {
+        event->edge = GPIO_EVENT_RISING;
+    }
+    else if(line->edges == GPIO_EVENT_EDGE_FALLING)
+    {
+        event->edge = GPIO_EVENT_FALLING;
+    }
+    else
+    {
+        event->edge = level ? GPIO_EVENT_RISING : GPIO_EVENT_FALLING;
+    }
+
+    __DMB();
+    gpio_event_queue.seq[head & GPIO_EVENT_QUEUE_MASK] = head + 1U;
+}
+
+error_t gpio_event_init(gpio_port_t port, uint32_t pin_mask, uint32_t mode, uint32_t pull)
+{
+    gpio_config_t config;
+    uint32_t indx;
+
+    if(port >= GPIO_PORT_ALL || pin_mask == 0 || (pin_mask >> GPIO_PIN_ALL) != 0x00)
+    {
+        return FAILED;
+    }
+
+    if((mode & MODE_INTERRUPT) == 0x00 || (mode & TRIGGER_EDGE_MASK) == 0x00)
+    {
+        return FAILED;
+    }
+
+    if(!gpio_event_queue.ready)
+    {
+        for(indx = 0; indx < CONFIG_GPIO_EVENT_QUEUE_SIZE; indx++)
+        {
+            gpio_event_queue.seq[indx] = indx;
+        }
+
+        gpio_event_queue.ready = 1;
+    }
+
+    /* Lines are set up before gpio_init enables their interrupts */
+    for(indx = 0; indx < GPIO_PIN_ALL; indx++)
+    {
+        if((pin_mask >> indx) & 0x01)
+        {
+            GPIO_HAL_GET_HW(&gpio_event_lines[indx].gpio, port);
+            gpio_event_lines[indx].port = port;
+            gpio_event_lines[indx].edges =
+                    ((mode & TRIGGER_RISING) != 0x00 ? GPIO_EVENT_EDGE_RISING : 0) |
+                    ((mode & TRIGGER_FALLING) != 0x00 ? GPIO_EVENT_EDGE_FALLING : 0);
+        }
+    }
+
+    config.pin_mask = pin_mask;
+    config.mode = mode;
+    config.pull = pull;
+    config.irq_callback = &gpio_event_isr;
+    config.irq_arg = NULL;
+
+    return gpio_init(port, &config);
+}
+
+uint16_t gpio_event_read(gpio_event_t* events, uint16_t max)
+{
+    uint32_t tail;
+    uint16_t count;
+
+    ASSERT(events || max == 0);
+
+    tail = gpio_event_queue.tail;
+    count = 0;
+
+    /* Stops at a slot reserved by an interrupt still writing it, keeping the order */
+    while(count < max && gpio_event_queue.seq[tail & GPIO_EVENT_QUEUE_MASK] == tail + 1U)
+    {
+        __DMB();
+        events[count++] = gpio_event_queue.events[tail & GPIO_EVENT_QUEUE_MASK];
+        __DMB();
+
+        gpio_event_queue.seq[tail & GPIO_EVENT_QUEUE_MASK] =
+                                            tail + CONFIG_GPIO_EVENT_QUEUE_SIZE;
+        ++tail;
+    }
+
+    gpio_event_queue.tail = tail;
+
+    return count;
+}
+
+uint16_t gpio_event_get_count(void)
+{
+    return (uint16_t) (gpio_event_queue.head - gpio_event_queue.tail);
+}
+
+uint32_t gpio_event_get_dropped(void)
+{
+    return gpio_event_queue.dropped;
+}
+
+#endif  /* CONFIG_GPIO_EVENT_USE */
@@ -0,0 +1,72 @@
+#ifndef __GPIO_EVENT_H__
+
+#define __GPIO_EVENT_H__
+
+#include "gpio.h"
+#include "types.h"
+
+#include <stdint.h>
+
+#define GPIO_EVENT_FALLING      0
+#define GPIO_EVENT_RISING       1
+
+/* Edge of an input pin, recorded by its interrupt */
+typedef struct
+{
+    uint64_t    timestamp;      /* timer_get_cycles() when the interrupt ran */
+    uint8_t     pin;            /* gpio_pin_t, also the EXTI line */
+    uint8_t     port;           /* gpio_port_t */
+    uint8_t     edge;           /* GPIO_EVENT_RISING/GPIO_EVENT_FALLING */
+    uint8_t     level;          /* Pin level read by the interrupt, 1: High */
+} gpio_event_t;
+
+
+/**
+ * @brief Configure pins as interrupt inputs whose edges are queued instead of
+ * handled in interrupt context. The interrupt only timestamps the edge, reads the
+ * pin and pushes the event, taking the same time whatever the application does
+ * with it. Events of all pins share one queue of CONFIG_GPIO_EVENT_QUEUE_SIZE, in
+ * timestamp order. Timestamps need timer_time_base_init.
+ *
+ * @param port
+ * @param pin_mask pins queued, their EXTI lines must not be used by another port
+ * @param mode GPIO_MODE_IT_RISING, GPIO_MODE_IT_FALLING or GPIO_MODE_IT_RISING_FALLING.
+ * With both edges the edge is taken from the level read, a pulse shorter than the
+ * interrupt latency may be recorded as two events of the same edge.
+ * @param pull GPIO_NOPULL/GPIO_PULLUP/GPIO_PULLDOWN
+ * @return error_t
+ *
+ * @example gpio_event_init(GPIOB, GPIO_PIN_MASK(GPIO_PIN_3), GPIO_MODE_IT_RISING_FALLING,
+ *                                                                    GPIO_PULLUP);
+ */
+error_t gpio_event_init(gpio_port_t port, uint32_t pin_mask, uint32_t mode, uint32_t pull);
+
+/**
+ * @brief Take the oldest events out of the queue, to be called from a single
+ * task or the main loop
+ *
+ * @param events
+ * @param max size of events
+ * @return uint16_t number of events copied, oldest first
+ *
+ * @example gpio_event_t events[8];
+ *          while((count = gpio_event_read(events, 8)) != 0) { ... }
+ */
+uint16_t gpio_event_read(gpio_event_t* events, uint16_t max);
+
+/**
+ * @brief
+ *
+ * @return uint16_t number of events waiting in the queue
+ */
+uint16_t gpio_event_get_count(void);
+
+/**
+ * @brief Edges lost because the queue was full, the newest are dropped so the
+ * queued events stay contiguous
+ *
+ * @return uint32_t total since the first gpio_event_init
+ */
+uint32_t gpio_event_get_dropped(void);
+
+#endif
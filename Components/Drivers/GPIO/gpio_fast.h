@@ -0,0 +1,142 @@
+#ifndef __GPIO_FAST_H__
+
+#define __GPIO_FAST_H__
+
+/**
+ * @brief Pin I/O resolved at compile time. A pin or bus descriptor made of a
+ * constant port and pin holds the register address and pin mask as constants,
+ * once inlined set, clear and read are a single BSRR or IDR access with no
+ * context, ASSERT or call. Pins are configured beforehand with gpio_init.
+ */
+
+#include "gpio.h"
+#include "gpio_ll.h"
+
+#include <stdint.h>
+
+typedef struct
+{
+    gpio_dev_t  dev;
+    uint32_t    mask;
+} gpio_fast_pin_t;
+
+/* Pins of a port driven and read together as one value, e.g. a parallel bus */
+typedef struct
+{
+    gpio_dev_t  dev;
+    uint32_t    mask;
+    uint8_t     shift;          /* Lowest pin, bit 0 of the value */
+} gpio_fast_bus_t;
+
+/**
+ * @brief Pin descriptor
+ *
+ * @param port gpio_port_t
+ * @param pin gpio_pin_t
+ *
+ * @example #define LED     GPIO_FAST_PIN(GPIOA, GPIO_PIN_5)
+ *          gpio_fast_set(LED);
+ */
+#define GPIO_FAST_PIN(port, pin)    ((gpio_fast_pin_t) {GPIO_LL_HW(port), BIT(pin)})
+
+/**
+ * @brief Bus descriptor of consecutive pins
+ *
+ * @param port gpio_port_t
+ * @param first_pin gpio_pin_t of bit 0 of the value
+ * @param width number of pins, first_pin + width up to GPIO_PIN_ALL
+ *
+ * @example #define LCD_DATA    GPIO_FAST_BUS(GPIOC, GPIO_PIN_0, 8)
+ *          gpio_fast_bus_write(LCD_DATA, 0x3A);
+ */
+#define GPIO_FAST_BUS(port, first_pin, width)   \
+            ((gpio_fast_bus_t) {GPIO_LL_HW(port), (BIT(width) - 1UL) << (first_pin), (first_pin)})
+
+/**
+ * @brief Set pin high, one BSRR write
+ *
+ * @param pin
+ */
+static inline void gpio_fast_set(gpio_fast_pin_t pin)
+{
+    gpio_ll_out_set_mask(pin.dev, pin.mask);
+}
+
+/**
+ * @brief Set pin low, one BSRR write
+ *
+ * @param pin
+ */
+static inline void gpio_fast_clear(gpio_fast_pin_t pin)
+{
+    gpio_ll_out_reset_mask(pin.dev, pin.mask);
+}
+
+/**
+ * @brief Drive pin to state, one BSRR write with no branch
+ *
+ * @param pin
+ * @param state GPIO_PIN_RESET/GPIO_PIN_SET
+ */
+static inline void gpio_fast_write(gpio_fast_pin_t pin, gpio_pin_state_t state)
+{
+    gpio_ll_out_write_mask(pin.dev, pin.mask, state == GPIO_PIN_SET ? pin.mask : 0);
+}
+
+/**
+ * @brief Toggle pin, one ODR read and one BSRR write so other pins of the port
+ * changed by an interrupt meanwhile are not overwritten
+ *
+ * @param pin
+ */
+static inline void gpio_fast_toggle(gpio_fast_pin_t pin)
+{
+    gpio_ll_out_toggle_mask(pin.dev, pin.mask);
+}
+
+/**
+ * @brief Read pin, one IDR read
+ *
+ * @param pin
+ * @return uint32_t 1: High, 0: Low
+ */
+static inline uint32_t gpio_fast_read(gpio_fast_pin_t pin)
+{
+    return (gpio_ll_in_read_port(pin.dev) & pin.mask) != 0x00;
+}
+
+/**
+ * @brief Drive all pins of a bus at once, one BSRR write
+ *
+ * @param bus
+ * @param value bits beyond the bus width are ignored
+ */
+static inline void gpio_fast_bus_write(gpio_fast_bus_t bus, uint32_t value)
+{
+    gpio_ll_out_write_mask(bus.dev, bus.mask, value << bus.shift);
+}
+
+/**
+ * @brief Read all pins of a bus at once, one IDR read
+ *
+ * @param bus
+ * @return uint32_t pin levels, first pin in bit 0
+ */
+static inline uint32_t gpio_fast_bus_read(gpio_fast_bus_t bus)
+{
+    return (gpio_ll_in_read_port(bus.dev) & bus.mask) >> bus.shift;
+}
+
+/**
+ * @brief Drive pins of a port selected by a mask, one BSRR write
+ *
+ * @param port gpio_port_t, constant for the address to be resolved at compile time
+ * @param pin_mask pins driven, the others keep their level
+ * @param value levels of the pins, bit n for pin n
+ */
+static inline void gpio_fast_port_write(gpio_port_t port, uint32_t pin_mask, uint32_t value)
+{
+    gpio_ll_out_write_mask(GPIO_LL_HW(port), pin_mask, value);
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include "gpio_wave.h"
+#include "gpio.h"
+
+#include "gpio_hal.h"
+#include "TIM_GP_hal.h"
+#include "timer.h"
+#include "assert.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if CONFIG_GPIO_WAVE_USE
+
+/* Set pins in the low half of BSRR, reset pins in the high half */
+#define GPIO_WAVE_WORD(set, reset)  ((uint32_t) (set) | ((uint32_t) (reset) << GPIO_PIN_ALL))
+
+/* TIM1 and TIM8 clock, APB2 is not divided */
+#define GPIO_WAVE_TIMER_CLOCK_HZ    TIMER_CORE_CLOCK_HZ
+
+#define GPIO_WAVE_MAX_RELOAD        0x10000UL
+
+static tim_gp_hal_context_t* gpio_wave_timer;
+static gpio_wave_callback_t gpio_wave_callback;
+
+
+static void gpio_wave_done(tim_gp_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    if(gpio_wave_callback)
+    {
+        gpio_wave_callback();
+    }
+}
+
+error_t gpio_wave_init(gpio_wave_t* wave, uint32_t* words, uint16_t size)
+{
+    if(!wave || !words || size == 0)
+    {
+        return FAILED;
+    }
+
+    wave->words = words;
+    wave->size = size;
+    wave->len = 0;
+
+    return OK;
+}
+
+void gpio_wave_clear(gpio_wave_t* wave)
+{
+    ASSERT(wave);
+
+    wave->len = 0;
+}
+
+error_t gpio_wave_add_level(gpio_wave_t* wave, uint16_t pin_mask, uint16_t high_mask,
+                                                                    uint16_t steps)
+{
+    uint32_t* pword;
+    uint32_t word;
+
+    if(!wave || steps > wave->size - wave->len)
+    {
+        return FAILED;
+    }
+
+    high_mask &= pin_mask;
+    word = GPIO_WAVE_WORD(high_mask, pin_mask & ~high_mask);
+    pword = &wave->words[wave->len];
+    wave->len += steps;
+
+    while(steps--)
+    {
+        *pword++ = word;
+    }
+
+    return OK;
+}
+
+error_t gpio_wave_add_bits(gpio_wave_t* wave, const gpio_wave_lane_t* lanes,
+                uint8_t lane_count, uint32_t nbits, const gpio_wave_coding_t* coding)
+{
+    uint32_t* pword;
+    uint32_t bit;
+    uint16_t lane_mask;
+    uint16_t ones;
+    uint16_t zeros;
+    uint16_t set;
+    uint8_t lane;
+    uint8_t step;
+
+    if(!wave || !lanes || lane_count == 0 || !coding || coding->steps == 0 ||
+                                            coding->steps > GPIO_WAVE_MAX_STEPS)
+    {
+        return FAILED;
+    }
+
+    if(nbits > (uint32_t) (wave->size - wave->len) / coding->steps)
+    {
+        return FAILED;
+    }
+
+    lane_mask = 0;
+
+    for(lane = 0; lane < lane_count; lane++)
+    {
+        if(!lanes[lane].data || lanes[lane].pin >= GPIO_PIN_ALL)
+        {
+            return FAILED;
+        }
+
+        lane_mask |= GPIO_PIN_MASK(lanes[lane].pin);
+    }
+
+    pword = &wave->words[wave->len];
+    wave->len += nbits * coding->steps;
+
+    for(bit = 0; bit < nbits; bit++)
+    {
+        /* Lanes sending a 1 and a 0, then each sample drives both groups at once */
+        ones = 0;
+
+        for(lane = 0; lane < lane_count; lane++)
+        {
+            if((lanes[lane].data[bit >> 3] >> (7U - (bit & 7U))) & 0x01)
+            {
+                ones |= GPIO_PIN_MASK(lanes[lane].pin);
+            }
+        }
+
+        zeros = lane_mask & ~ones;
+
+        for(step = coding->steps; step-- > 0; )
+        {
+            set = 0;
+
+            if((coding->symbol[1] >> step) & 0x01)
+            {
+                set |= ones;
+            }
+
+            if((coding->symbol[0] >> step) & 0x01)
+            {
+                set |= zeros;
+            }
+
+            *pword++ = GPIO_WAVE_WORD(set, lane_mask & ~set);
+        }
+    }
+
+    return OK;
+}
+
+error_t gpio_wave_start(gpio_port_t port, const gpio_wave_t* wave, uint32_t sample_hz,
+                                    uint8_t circular, gpio_wave_callback_t callback)
+{
+    gpio_hal_context_t gpio_hal;
+    tim_gp_config_t tim_config;
+    uint32_t ticks;
+    uint32_t prescaler;
+
+    if(port >= GPIO_PORT_ALL || !wave || wave->len == 0 || sample_hz == 0)
+    {
+        return FAILED;
+    }
+
+    if(gpio_wave_is_busy())
+    {
+        return FAILED;
+    }
+
+    /* Sample period in timer clock cycles, rounded to the nearest */
+    ticks = (GPIO_WAVE_TIMER_CLOCK_HZ + sample_hz / 2U) / sample_hz;
+
+    if(ticks < GPIO_WAVE_MIN_TICKS)
+    {
+        return FAILED;
+    }
+
+    /* Long periods are prescaled, the smallest prescaler keeps the best resolution */
+    prescaler = (ticks - 1U) / GPIO_WAVE_MAX_RELOAD;
+
+    tim_config.prescaler = (uint16_t) prescaler;
+    tim_config.reload = ticks / (prescaler + 1U) - 1U;
+    tim_config.count_mode = TIM_GP_COUNT_UP;
+    tim_config.callback = NULL;
+    tim_config.channel_callback = NULL;
+
+    gpio_wave_timer = tim_gp_hal_init(CONFIG_GPIO_WAVE_TIMER, &tim_config);
+
+    if(!gpio_wave_timer)
+    {
+        return FAILED;
+    }
+
+    GPIO_HAL_GET_HW(&gpio_hal, port);
+    gpio_wave_callback = callback;
+
+    return tim_gp_hal_start_update_dma(gpio_wave_timer, gpio_hal_get_bsrr_addr(&gpio_hal),
+                            wave->words, wave->len, circular, &gpio_wave_done);
+}
+
+uint8_t gpio_wave_is_busy(void)
+{
+    if(!gpio_wave_timer)
+    {
+        return 0;
+    }
+
+    return tim_gp_hal_is_update_dma_busy(gpio_wave_timer);
+}
+
+error_t gpio_wave_stop(void)
+{
+    if(!gpio_wave_timer)
+    {
+        return FAILED;
+    }
+
+    return tim_gp_hal_stop_update_dma(gpio_wave_timer);
+}
+
+#endif  /* CONFIG_GPIO_WAVE_USE */
@@ -0,0 +1,127 @@
+#ifndef __GPIO_WAVE_H__
+
+#define __GPIO_WAVE_H__
+
+#include "gpio_hal.h"
+#include "types.h"
+
+#include <stdint.h>
+
+/* A bit is sent as a symbol of up to 32 samples */
+#define GPIO_WAVE_MAX_STEPS     32
+
+/* Fastest sample rate, a word moved by DMA2 from SRAM to a GPIO port every 4 cycles */
+#define GPIO_WAVE_MIN_TICKS     4
+
+typedef void (*gpio_wave_callback_t) (void);
+
+/*
+* Waveform of the pins of one port, one BSRR word per sample. A word sets the pins
+* of its low half and resets the pins of its high half, pins in neither half keep
+* their level so several waveforms may share a port.
+*/
+typedef struct
+{
+    uint32_t*   words;
+    uint16_t    size;           /* Capacity in words */
+    uint16_t    len;            /* Words encoded */
+} gpio_wave_t;
+
+/*
+* Line coding of a bit, symbol[b] holds the levels sent for a bit of value b,
+* first sample in bit (steps - 1). E.g. with 3 samples of 400ns a WS2812 0 is 0x4
+* and a 1 is 0x6, a Manchester coding on 2 samples is 0x2 and 0x1
+*/
+typedef struct
+{
+    uint32_t    symbol[2];
+    uint8_t     steps;          /* Samples per bit, 1 to GPIO_WAVE_MAX_STEPS */
+} gpio_wave_coding_t;
+
+/* Bits sent on a pin, most significant bit of the first byte first */
+typedef struct
+{
+    const uint8_t*  data;
+    gpio_pin_t  pin;
+} gpio_wave_lane_t;
+
+
+/**
+ * @brief Attach a buffer to a waveform, the waveform is left empty
+ * 
+ * @param wave
+ * @param words buffer of BSRR words, one per sample
+ * @param size number of words of the buffer
+ * @return error_t
+ */
+error_t gpio_wave_init(gpio_wave_t* wave, uint32_t* words, uint16_t size);
+
+/**
+ * @brief Empty a waveform to encode a new one in its buffer
+ * 
+ * @param wave
+ */
+void gpio_wave_clear(gpio_wave_t* wave);
+
+/**
+ * @brief Append samples holding pins at fixed levels
+ * 
+ * @param wave
+ * @param pin_mask pins driven, the others keep their level
+ * @param high_mask pins of pin_mask set high, the rest of pin_mask is set low
+ * @param steps number of samples
+ * @return error_t FAILED if the buffer has no room for all the samples
+ * 
+ * @example gpio_wave_add_level(&wave, GPIO_PIN_MASK(GPIO_PIN_5), 0, 40); //Reset pulse
+ */
+error_t gpio_wave_add_level(gpio_wave_t* wave, uint16_t pin_mask, uint16_t high_mask,
+                                                                    uint16_t steps);
+
+/**
+ * @brief Append bits sent in parallel on several pins, each pin with its own data.
+ * Only the pins of the lanes are driven.
+ * 
+ * @param wave
+ * @param lanes
+ * @param lane_count
+ * @param nbits bits sent on each lane
+ * @param coding
+ * @return error_t FAILED if the buffer has no room for all the samples
+ */
+error_t gpio_wave_add_bits(gpio_wave_t* wave, const gpio_wave_lane_t* lanes,
+                uint8_t lane_count, uint32_t nbits, const gpio_wave_coding_t* coding);
+
+/**
+ * @brief Play a waveform on a port, the words are written to BSRR by DMA on each
+ * update event of a timer so the pins change at an exact rate with no CPU involved
+ * and no jitter from interrupts. Pins are configured as outputs by the caller.
+ * The buffer must stay valid and unchanged until the waveform ends or is stopped.
+ * 
+ * @param port
+ * @param wave
+ * @param sample_hz sample rate, the period is rounded to a whole number of timer
+ * clock cycles
+ * @param circular 1 to repeat the waveform until gpio_wave_stop
+ * @param callback called from interrupt context at the end of a one-shot waveform,
+ * may be NULL
+ * @return error_t FAILED if a waveform is playing, the rate is out of range or the
+ *         DMA stream of the timer is used by a serial port set up before
+ */
+error_t gpio_wave_start(gpio_port_t port, const gpio_wave_t* wave, uint32_t sample_hz,
+                                    uint8_t circular, gpio_wave_callback_t callback);
+
+/**
+ * @brief
+ * 
+ * @return uint8_t 1 while a waveform is playing
+ */
+uint8_t gpio_wave_is_busy(void);
+
+/**
+ * @brief Stop the waveform, pins keep the levels of the last sample written
+ * 
+ * @return error_t
+ */
+error_t gpio_wave_stop(void);
+
+#endif
@@ -1,4 +1,5 @@
 #include "log.h"
+#include "log_private.h"
 
 #include "stdio_public.h"
 #include "timer.h"
@@ -12,8 +13,6 @@
 
 #if CONFIG_LOG_COLORS
 
-#define LOG_COLOR_END       "\033[0m"
-
 const char* colors[LOG_LEVEL_MAX] = 
 {
     "\033[0;0m",    // None
@@ -25,9 +24,44 @@ const char* colors[LOG_LEVEL_MAX] =
 
 #endif  /* CONFIG_LOG_COLORS */
 
+/* Lines are formatted once into RAM when they are queued or shared by several sinks */
+#define LOG_LINE_BUFFERED   (CONFIG_LOG_ASYNC || CONFIG_LOG_ROUTER)
+
+#if LOG_LINE_BUFFERED
+
+/* A line is handed on whole, longer messages are truncated and the line end kept */
+#define LOG_LINE_SIZE       160
+
+#endif  /* LOG_LINE_BUFFERED */
+
+struct log_sink_t
+{
+    error_t status;
+    #if LOG_LINE_BUFFERED
+    uint16_t len;
+    uint16_t body;
+    char line[LOG_LINE_SIZE];
+    #endif /* LOG_LINE_BUFFERED */
+};
+
 putchar_like_t putchar_like_func = &putch_;
 
 
+/*
+* Hexdump row, 16 bytes:
+* "aaaaaaaa  xx xx xx xx xx xx xx xx  xx xx xx xx xx xx xx xx  |................|"
+*/
+#define LOG_HEXDUMP_ROW_BYTES       16
+#define LOG_HEXDUMP_HEX_COLUMN      10
+#define LOG_HEXDUMP_ASCII_COLUMN    (LOG_HEXDUMP_HEX_COLUMN + LOG_HEXDUMP_ROW_BYTES * 3 + 3)
+#define LOG_HEXDUMP_ROW_SIZE        (LOG_HEXDUMP_ASCII_COLUMN + LOG_HEXDUMP_ROW_BYTES + 1)
+
+static const char log_hex_digits[16] = 
+{
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f',
+};
+
 const char log_prefixes[LOG_LEVEL_MAX] = 
 {
     'N',
@@ -37,27 +71,147 @@ const char log_prefixes[LOG_LEVEL_MAX] =
     'D',
 };
 
-static error_t log_write_str(const char* str)
+uint64_t log_get_timestamp(void)
 {
-    if(!str || !putchar_like_func)
+    #if (CONFIG_LOG_TIMESTAMP_SOURCE == LOG_TIMESTAMP_US)
+    return timer_cycles_to_us(timer_get_cycles());
+    #elif (CONFIG_LOG_TIMESTAMP_SOURCE == LOG_TIMESTAMP_CYCLES)
+    return timer_get_cycles();
+    #else
+    return timer_get_milliseconds();
+    #endif
+}
+
+/**
+ * @brief Output function of the formatter, characters are streamed straight to the
+ * log output as they are produced so messages of any length are written whole.
+ */
+static void log_sink_out(char c, void* arg)
+{
+    struct log_sink_t* sink = (struct log_sink_t*) arg;
+
+    #if LOG_LINE_BUFFERED
+    /* Room for the line end is kept, the rest of a longer message is cut */
+    if(sink->len < sizeof(sink->line) - (sizeof(LOG_LINE_END) - 1))
+    {
+        sink->line[sink->len++] = c;
+    }
+    #else
+    if(sink->status == OK && putchar_like_func(c) == EOF)
     {
-        return FAILED;
+        sink->status = FAILED;
     }
+    #endif /* LOG_LINE_BUFFERED */
+}
+
+/**
+ * @brief Copy bytes already formatted, without going through the formatter
+ */
+static void log_sink_write(struct log_sink_t* sink, const char* data, uint16_t len)
+{
+    #if LOG_LINE_BUFFERED
+    uint16_t room;
+
+    room = sizeof(sink->line) - (sizeof(LOG_LINE_END) - 1) - sink->len;
+    len = (len < room) ? len : room;
 
-    while(*str)
+    memcpy(&sink->line[sink->len], data, len);
+    sink->len += len;
+    #else
+    while(len-- && sink->status == OK)
     {
-        if(putchar_like_func(*str++) == EOF)
+        if(putchar_like_func(*data++) == EOF)
         {
-            return FAILED;
+            sink->status = FAILED;
         }
     }
+    #endif /* LOG_LINE_BUFFERED */
+}
+
+/**
+ * @brief Start a line with its color, level prefix, timestamp and tag
+ */
+static void log_line_begin(struct log_sink_t* sink, uint64_t timestamp, log_level_t level, 
+                                                                        const char* tag)
+{
+    const char* color;
+    char prefix;
+
+    #if CONFIG_LOG_COLORS
+    color = (level < LOG_LEVEL_MAX) ? colors[level] : colors[LOG_LEVEL_NONE];
+    #else
+    color = "";
+    #endif /* CONFIG_LOG_COLORS */
+
+    prefix = (level < LOG_LEVEL_MAX) ? 
+                        log_prefixes[level] : log_prefixes[LOG_LEVEL_NONE];
+
+    sink->status = OK;
+
+    #if LOG_LINE_BUFFERED
+    sink->len = 0;
+    #else
+    log_sink_lock();
+    #endif /* LOG_LINE_BUFFERED */
+
+    fctprintf(log_sink_out, sink, "%s%c (%llu) ", color, prefix, 
+                                                    (unsigned long long) timestamp);
+
+    #if LOG_LINE_BUFFERED
+    /* Repeated messages are detected on what follows the timestamp */
+    sink->body = sink->len;
+    #endif /* LOG_LINE_BUFFERED */
+
+    fctprintf(log_sink_out, sink, "%s: ", tag);
+}
+
+/**
+ * @brief Terminate a line and hand it to the log output
+ */
+static void log_line_end(struct log_sink_t* sink, log_level_t level)
+{
+    #if LOG_LINE_BUFFERED
+    memcpy(&sink->line[sink->len], LOG_LINE_END, sizeof(LOG_LINE_END) - 1);
+    sink->len += sizeof(LOG_LINE_END) - 1;
+
+    #if CONFIG_LOG_ROUTER
+    log_router_write(level, sink->line, sink->len, sink->body);
+    #else
+    (void) level;
+    log_async_write(sink->line, sink->len);
+    #endif /* CONFIG_LOG_ROUTER */
+    #else
+    (void) level;
+    log_sink_write(sink, LOG_LINE_END, sizeof(LOG_LINE_END) - 1);
+
+    log_sink_unlock();
+    #endif /* LOG_LINE_BUFFERED */
+}
+
+static void log_vwrite(uint64_t timestamp, log_level_t level, const char* tag, 
+                                                const char* format, va_list args)
+{
+    struct log_sink_t sink;
+
+    if(!tag || !format)
+    {
+        return;
+    }
 
-    return OK;
+    /* Prefix, message and line end in a single pass through the formatter */
+    log_line_begin(&sink, timestamp, level, tag);
+    vfctprintf(log_sink_out, &sink, format, args);
+    log_line_end(&sink, level);
 }
 
-static uint64_t log_get_timestamp(void)
+WEAK void log_sink_lock(void)
 {
-    return timer_get_milliseconds();
+
+}
+
+WEAK void log_sink_unlock(void)
+{
+
 }
 
 putchar_like_t log_set_putchar(putchar_like_t new_func)
@@ -78,120 +232,86 @@ putchar_like_t log_set_putchar(putchar_like_t new_func)
 void log_write(log_level_t level, const char* tag, const char* format, ...)
 {
     va_list args;
-    uint64_t timestamp;
-    char log_buf[104];
-    int ret;
-    char prefix;
-
-    if(!tag || !format)
-    {
-        return;
-    }
-
-    #if CONFIG_LOG_COLORS
-    const char* color = (level < LOG_LEVEL_MAX) ? 
-                                    colors[level] : colors[LOG_LEVEL_NONE];
-    log_write_str(color);
-    #endif /* CONFIG_LOG_COLORS */
-
-    prefix = (level < LOG_LEVEL_MAX) ? 
-                        log_prefixes[level] : log_prefixes[LOG_LEVEL_NONE];
-
-    timestamp = log_get_timestamp();
-    
-    snprintf_(log_buf, sizeof(log_buf), "%c (%llu) %s: ", prefix, timestamp, tag);
-
-    if(log_write_str(log_buf) != OK)
-    {
-        return;
-    }
 
     va_start(args, format);
-    ret = vsnprintf_(log_buf, sizeof(log_buf), format, args);
+    log_vwrite(log_get_timestamp(), level, tag, format, args);
     va_end(args);
+}
 
-    if(ret >= sizeof(log_buf))
-    {
-        return;
-    }
-
-    log_write_str(log_buf);
-    log_write_str("\r\n");
+void log_write_timestamped(uint64_t timestamp, log_level_t level, const char* tag, 
+                                                            const char* format, ...)
+{
+    va_list args;
 
-    #if CONFIG_LOG_COLORS
-    log_write_str(LOG_COLOR_END);
-    #endif /* CONFIG_LOG_COLORS */
+    va_start(args, format);
+    log_vwrite(timestamp, level, tag, format, args);
+    va_end(args);
 }
 
-#if 0
-/*
-* TODO: Complete this function
-*/
 void log_hexdump(log_level_t level, const char* tag, const void* buffer, uint16_t size)
 {
-    const uint8_t*psrc;
-    char* pdest;
-    uint16_t remaining;
+    struct log_sink_t sink;
+    const uint8_t* psrc;
+    char* phex;
+    char* pascii;
+    uint64_t timestamp;
+    uint32_t addr;
     uint8_t to_copy;
     uint8_t indx;
-    uint8_t is_msn;
-    uint32_t addr;
-    char str_hexaddr[11];
-    char str_mhexdump[25];
-    char str_shexdump[25];
-    char str_log[104];
+    char row[LOG_HEXDUMP_ROW_SIZE];
 
     if(!tag || !buffer || (size == 0))
     {
         return;
     }
 
-    addr = (uint32_t) buffer;
-    psrc = (const uint8_t*) buffer;
-    pdest = &str_shexdump[0];
+    #if CONFIG_LOG_RUNTIME_LEVELS
+    if(level > log_level_get(tag))
+    #else
+    if(level > CONFIG_LOG_DEFAULT_LEVEL)
+    #endif /* CONFIG_LOG_RUNTIME_LEVELS */
+    {
+        return;
+    }
 
-    remaining = size;
-    is_msn = 0;
+    psrc = (const uint8_t*) buffer;
+    addr = (uint32_t) (uintptr_t) buffer;
+    timestamp = log_get_timestamp();
 
-    while(remaining)
+    while(size)
     {
-        to_copy = (remaining > 8) ? 8 : remaining;
+        to_copy = (size > LOG_HEXDUMP_ROW_BYTES) ? LOG_HEXDUMP_ROW_BYTES : size;
 
-        for(indx = 0; indx < to_copy; indx++)
-        {
-            snprintf_(pdest, 4, "%02x ", *psrc);
-            
-            ++psrc;
-            pdest += 3;
-        }
+        /* Address, hex and ASCII columns are filled in one pass over the row */
+        memset(row, ' ', sizeof(row));
 
-        if(to_copy < 8)
+        for(indx = 0; indx < 8; indx++)
         {
-            memset(pdest, ' ', (8 - to_copy) * 3);
-            pdest += (8 - to_copy) * 3;
+            row[indx] = log_hex_digits[(addr >> (28 - 4 * indx)) & 0x0F];
         }
 
-        if(!is_msn)
-        {
-            is_msn = 1;
-            *pdest = '\0';
-            pdest = &str_mhexdump[0];
-        }
-        else
+        phex = &row[LOG_HEXDUMP_HEX_COLUMN];
+        pascii = &row[LOG_HEXDUMP_ASCII_COLUMN];
+
+        for(indx = 0; indx < to_copy; indx++)
         {
-            is_msn = 0;
-            *pdest = '\0';
-            pdest = &str_shexdump[0];
-            snprintf_(str_hexaddr, sizeof(str_hexaddr), "0x%08lx", addr);
-            snprintf_(str_log, sizeof(str_log), "%s\t%s\t%s", 
-                                str_hexaddr, str_shexdump, str_mhexdump);
-            log_write_str(str_log);
-            log_write_str("\r\n");
+            phex[0] = log_hex_digits[*psrc >> 4];
+            phex[1] = log_hex_digits[*psrc & 0x0F];
+            phex += (indx == 7) ? 4 : 3;
+
+            *pascii++ = (*psrc >= ' ' && *psrc <= '~') ? (char) *psrc : '.';
+            ++psrc;
         }
 
-        remaining -= to_copy;
+        row[LOG_HEXDUMP_ASCII_COLUMN - 1] = '|';
+        *pascii++ = '|';
+
+        /* The row is complete, it is copied to the line as is */
+        log_line_begin(&sink, timestamp, level, tag);
+        log_sink_write(&sink, row, (uint16_t) (pascii - row));
+        log_line_end(&sink, level);
+
+        size -= to_copy;
         addr += to_copy;
     }
 }
-
-#endif
\ No newline at end of file
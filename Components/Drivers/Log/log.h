@@ -2,6 +2,8 @@
 
 #define __LOG_H__
 
+#include "types.h"
+
 #include <stdint.h>
 
 #define LOG_LEVEL_NONE      0
@@ -13,6 +15,7 @@
 
 typedef uint8_t log_level_t;
 typedef int (*putchar_like_t) (char);
+typedef error_t (*log_line_func_t) (const char* line, uint16_t len);
 
 
 
@@ -27,6 +30,17 @@ typedef int (*putchar_like_t) (char);
 putchar_like_t log_set_putchar(putchar_like_t new_func);
 
 
+/**
+ * @brief Called around each log line written to the output. Default is empty,
+ * override to serialize lines from several tasks, e.g. with a mutex.
+ */
+void log_sink_lock(void);
+
+/**
+ * @brief 
+ */
+void log_sink_unlock(void);
+
 /**
  * @brief Write a log message with specific log level and tag
  * 
@@ -43,7 +57,8 @@ void log_write(log_level_t level, const char* tag, const char* format, ...)
                                                         __attribute__((format(printf, 3, 4)));
 
 /**
- * @brief 
+ * @brief Write a buffer as rows of 16 bytes with address, hex and ASCII columns,
+ * one log line per row. Nothing is formatted if the level is filtered out for tag.
  * 
  * @param level 
  * @param tag 
@@ -52,12 +67,277 @@ void log_write(log_level_t level, const char* tag, const char* format, ...)
  */
 void log_hexdump(log_level_t level, const char* tag, const void* buffer, uint16_t size);
 
+/**
+ * @brief Start draining the asynchronous log ring to a serial port. Lines logged 
+ * before this call are kept in the ring. Must be called after serial_setup.
+ * @note  Each line is copied twice, into this ring by log_async_write and again 
+ * into the serial Tx queue by the drain, which DMAs from there. The port stays 
+ * shared with other serial users, at the cost of CONFIG_SERIAL_TX_BUFFERSIZE 
+ * bytes of staging and a second memcpy per line.
+ * 
+ * @param serial_port 
+ * @return error_t 
+ */
+error_t log_async_init(uint8_t serial_port);
+
+/**
+ * @brief Queue a fully formatted line for the asynchronous backend. Usable as a 
+ * log router sink.
+ * 
+ * @param line 
+ * @param len 
+ * @return error_t FAILED if the line was dropped because the ring is full
+ */
+error_t log_async_write(const char* line, uint16_t len);
+
+/**
+ * @brief Hand queued log lines to the serial port. Called on every log write and 
+ * Tx completion, returns without waiting for the UART.
+ */
+void log_async_flush(void);
+
+/**
+ * @brief 
+ * 
+ * @return uint32_t number of log lines dropped because the ring was full 
+ */
+uint32_t log_async_get_dropped(void);
+
+/**
+ * @brief Find the active sector of the flash log and the end of its last record.
+ * Sector headers give the newest sector, whose records are then walked and their
+ * CRC checked, so the time taken grows with the sector size. Must be called before
+ * any other log_flash function.
+ * 
+ * @return error_t FAILED if the first sector could not be erased or programmed
+ */
+error_t log_flash_init(void);
+
+/**
+ * @brief Append bytes to the flash log batch. A full batch is programmed as one
+ * record, so this may stall for a sector erase. Task context only.
+ * 
+ * @param data 
+ * @param len 
+ * @return error_t FAILED if programming the batch or erasing the next sector failed
+ */
+error_t log_flash_write(const char* data, uint16_t len);
+
+/**
+ * @brief Program the pending batch as a record, e.g. before a reset. Task context only.
+ * 
+ * @return error_t FAILED if programming the batch or erasing the next sector failed,
+ *         flash_hal_get_error() tells which
+ */
+error_t log_flash_sync(void);
+
+/**
+ * @brief Character output for log_set_putchar, logs go to flash
+ * 
+ * @param c 
+ * @return int 
+ */
+int log_flash_putchar(char c);
+
+/**
+ * @brief Send every intact record of the flash log, oldest first
+ * 
+ * @param out 
+ * @return error_t 
+ */
+error_t log_flash_dump(putchar_like_t out);
+
+/**
+ * @brief Register a sink of the log router or update an already registered one.
+ * Every line is formatted once and handed to each sink whose level accepts it.
+ * log_console_write, log_async_write, log_flash_write and log_ram_write can be
+ * used as sinks. Until a sink is registered lines go to log_console_write.
+ * Lines logged from an interrupt skip sinks not marked isr_safe and are counted
+ * as suppressed for them, log_flash_write may block for seconds while erasing and
+ * must be registered with isr_safe 0.
+ * 
+ * @param func called with each accepted line, from the context that logged it
+ * @param level most verbose level passed to this sink
+ * @param rate lines per second allowed in the long run, 0 for no limit
+ * @param burst lines allowed at once after a quiet period
+ * @param isr_safe 1 if func can be called from an interrupt handler
+ * @return error_t FAILED if the sink table is full
+ */
+error_t log_router_add_sink(log_line_func_t func, log_level_t level, 
+                                    uint16_t rate, uint16_t burst, uint8_t isr_safe);
+
+/**
+ * @brief 
+ * 
+ * @param func 
+ * @param level 
+ * @return error_t FAILED if func is not a registered sink
+ */
+error_t log_router_set_level(log_line_func_t func, log_level_t level);
+
+/**
+ * @brief 
+ * 
+ * @param func 
+ * @return uint32_t number of lines not passed to a sink by its rate limit
+ */
+uint32_t log_router_get_suppressed(log_line_func_t func);
+
+/**
+ * @brief Identical consecutive messages are counted instead of written, the count
+ * is reported by the next different message or by this function.
+ */
+void log_router_flush(void);
+
+/**
+ * @brief Write a line to the function set by log_set_putchar, inside log_sink_lock
+ * 
+ * @param line 
+ * @param len 
+ * @return error_t 
+ */
+error_t log_console_write(const char* line, uint16_t len);
+
+/**
+ * @brief Keep a line in the RAM history ring, the oldest lines are overwritten
+ * 
+ * @param line 
+ * @param len 
+ * @return error_t 
+ */
+error_t log_ram_write(const char* line, uint16_t len);
+
+/**
+ * @brief Send the RAM history ring, oldest line first
+ * 
+ * @param out 
+ * @return uint16_t number of characters sent
+ */
+uint16_t log_ram_dump(putchar_like_t out);
+
+#define LOG_BINARY_MAX_ARGS     8
+
+/**
+ * @brief Record a log message without formatting it. Level, tag and format string
+ * addresses, a timestamp and the raw arguments are copied into a RAM ring. 
+ * Every argument is stored as a 32-bit word, so 64-bit and floating point 
+ * arguments are not supported and %s arguments must outlive the record.
+ * 
+ * @param level log level of the log message
+ * @param tag   tag of the log message
+ * @param format format string, must live in flash
+ * @param nargs number of 32-bit arguments following, at most LOG_BINARY_MAX_ARGS
+ */
+void log_binary_write(log_level_t level, const char* tag, const char* format, 
+                                                        uint8_t nargs, ...)
+                                                        __attribute__((format(printf, 3, 5)));
+
+/**
+ * @brief Format pending binary records through the text log output. Meant to be
+ * called from an idle task.
+ * 
+ * @param max_records maximum number of records to format in this call
+ * @return uint16_t number of records formatted
+ */
+uint16_t log_binary_flush(uint16_t max_records);
+
+/**
+ * @brief Send pending binary records unformatted to the log output, to be decoded 
+ * on the host by log_decode.py against the firmware ELF.
+ * 
+ * @param max_records maximum number of records to send in this call
+ * @return uint16_t number of records sent
+ */
+uint16_t log_binary_dump(uint16_t max_records);
+
+/**
+ * @brief 
+ * 
+ * @return uint32_t number of records dropped because the ring was full 
+ */
+uint32_t log_binary_get_dropped(void);
+
+
+/* Longest tag log_level_set accepts, terminator included */
+#define LOG_TAG_NAME_SIZE       16
+
+/**
+ * @brief Set the runtime log level of a tag. Tags are matched by string, so the
+ * pointer passed does not need to be the one used by the logging module and may
+ * be a temporary buffer, the string is copied when needed.
+ * Use "*" to set the level of all tags that were not set explicitly.
+ * Messages above the compile-time LOG_LOCAL_LEVEL of a file are never output.
+ * 
+ * @param tag shorter than LOG_TAG_NAME_SIZE
+ * @param level 
+ * @return error_t FAILED if the tag is too long or the tag table is full
+ */
+error_t log_level_set(const char* tag, log_level_t level);
+
+/**
+ * @brief 
+ * 
+ * @param tag any string, nothing is registered
+ * @return log_level_t runtime log level of the tag
+ */
+log_level_t log_level_get(const char* tag);
+
+/**
+ * @brief Register a tag and return the location of its runtime level. Used by the 
+ * log macros to cache the lookup per call site, the location stays valid forever.
+ * 
+ * @param tag kept by pointer, must live forever like the TAG of a logging module
+ * @return const log_level_t* 
+ */
+const log_level_t* log_level_ref(const char* tag);
+
+extern const log_level_t log_level_unresolved;
 
 #ifndef LOG_LOCAL_LEVEL
+#if CONFIG_LOG_RUNTIME_LEVELS
+#define LOG_LOCAL_LEVEL     CONFIG_LOG_MAXIMUM_LEVEL
+#else
 #define LOG_LOCAL_LEVEL     CONFIG_LOG_DEFAULT_LEVEL
 #endif
+#endif
+
+/* Counts up to 16 so that calls above LOG_BINARY_MAX_ARGS are caught, not miscounted */
+#define LOG_NARGS(...)                      LOG_NARGS_(0, ##__VA_ARGS__, 16, 15, 14, 13, 12, \
+                                                    11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, _14, \
+                                                    _15, _16, N, ...)    N
 
-#define LOG_LOCAL(level, tag, fmt, ...)     log_write(level, tag, fmt, ##__VA_ARGS__)
+#if CONFIG_LOG_BINARY
+#define LOG_OUTPUT(level, tag, fmt, ...)                                                \
+    do                                                                                  \
+    {                                                                                   \
+        _Static_assert(LOG_NARGS(__VA_ARGS__) <= LOG_BINARY_MAX_ARGS,                   \
+                    "binary log records take at most LOG_BINARY_MAX_ARGS arguments");   \
+        log_binary_write(level, tag, fmt, LOG_NARGS(__VA_ARGS__), ##__VA_ARGS__);       \
+    } while(0)
+#else
+#define LOG_OUTPUT(level, tag, fmt, ...)    log_write(level, tag, fmt, ##__VA_ARGS__)
+#endif
+
+#if CONFIG_LOG_RUNTIME_LEVELS
+/*
+* Each call site caches the location of its tag level. Until resolved it points to
+* log_level_unresolved which lets every level through to the lookup, afterwards a
+* filtered out message costs a single load and compare.
+*/
+#define LOG_LOCAL(level, tag, fmt, ...)                                                 \
+    do                                                                                  \
+    {                                                                                   \
+        static const log_level_t* _log_level = &log_level_unresolved;                   \
+        if(((level) <= *_log_level) && ((_log_level != &log_level_unresolved) ||        \
+                                    ((level) <= *(_log_level = log_level_ref(tag)))))   \
+        {                                                                               \
+            LOG_OUTPUT(level, tag, fmt, ##__VA_ARGS__);                                 \
+        }                                                                               \
+    } while(0)
+#else
+#define LOG_LOCAL(level, tag, fmt, ...)     LOG_OUTPUT(level, tag, fmt, ##__VA_ARGS__)
+#endif
 
 #if (LOG_LOCAL_LEVEL >= LOG_LEVEL_ERROR)
 #define LOGE(tag, fmt, ...)                 LOG_LOCAL(LOG_LEVEL_ERROR, tag, fmt, ##__VA_ARGS__)
@@ -0,0 +1,194 @@
+#include "log.h"
+#include "log_private.h"
+
+#include "stm32f446xx.h"
+#include "serial.h"
+#include "types.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if CONFIG_LOG_ASYNC
+
+#define LOG_ASYNC_PORT_NONE     0xFF
+
+/*
+* Producers reserve space with interrupts masked for a few instructions only
+* and copy their line with interrupts enabled. Reserved bytes are published to
+* the drain once the last concurrent writer (a task preempted by ISRs) is done.
+*/
+struct log_async_ring_t
+{
+    char buffer[CONFIG_LOG_ASYNC_BUFFERSIZE];
+    uint16_t reserve_head;
+    uint16_t tail;
+    uint16_t used;
+    uint16_t committed;
+    uint8_t writers;
+    uint8_t draining;
+    uint8_t rescan;
+    uint8_t port;
+    uint32_t dropped_lines;
+};
+
+static struct log_async_ring_t log_async = {.port = LOG_ASYNC_PORT_NONE};
+
+static void log_async_tx_done(uint8_t port)
+{
+    (void) port;
+
+    log_async_flush();
+}
+
+error_t log_async_init(uint8_t serial_port)
+{
+    if(serial_register_tx_callback(serial_port, log_async_tx_done) != OK)
+    {
+        return FAILED;
+    }
+
+    log_async.port = serial_port;
+    log_async_flush();
+
+    return OK;
+}
+
+error_t log_async_write(const char* line, uint16_t len)
+{
+    uint32_t primask;
+    uint16_t start;
+    uint16_t contiguous;
+
+    if(len == 0)
+    {
+        return OK;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* Drop newest, a line is either queued whole or not at all */
+    if(len > CONFIG_LOG_ASYNC_BUFFERSIZE - log_async.used)
+    {
+        ++log_async.dropped_lines;
+        __set_PRIMASK(primask);
+
+        return FAILED;
+    }
+
+    start = log_async.reserve_head;
+    log_async.reserve_head += len;
+    if(log_async.reserve_head >= CONFIG_LOG_ASYNC_BUFFERSIZE)
+    {
+        log_async.reserve_head -= CONFIG_LOG_ASYNC_BUFFERSIZE;
+    }
+
+    log_async.used += len;
+    ++log_async.writers;
+
+    __set_PRIMASK(primask);
+
+    contiguous = CONFIG_LOG_ASYNC_BUFFERSIZE - start;
+
+    if(len > contiguous)
+    {
+        memcpy(&log_async.buffer[start], line, contiguous);
+        memcpy(&log_async.buffer[0], line + contiguous, len - contiguous);
+    }
+    else
+    {
+        memcpy(&log_async.buffer[start], line, len);
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(--log_async.writers == 0)
+    {
+        log_async.committed = log_async.used;
+    }
+
+    __set_PRIMASK(primask);
+
+    log_async_flush();
+
+    return OK;
+}
+
+void log_async_flush(void)
+{
+    uint32_t primask;
+    uint16_t span;
+    uint16_t sent;
+    uint8_t more;
+
+    if(log_async.port == LOG_ASYNC_PORT_NONE)
+    {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* A single drainer at a time, the active one picks up what was added */
+    if(log_async.draining)
+    {
+        log_async.rescan = 1;
+        __set_PRIMASK(primask);
+
+        return;
+    }
+
+    log_async.draining = 1;
+
+    __set_PRIMASK(primask);
+
+    do
+    {
+        span = CONFIG_LOG_ASYNC_BUFFERSIZE - log_async.tail;
+        if(span > log_async.committed)
+        {
+            span = log_async.committed;
+        }
+
+        sent = 0;
+
+        if(span > 0)
+        {
+            serial_tx(log_async.port, (const uint8_t*) &log_async.buffer[log_async.tail],
+                                                                                span, &sent);
+        }
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        log_async.tail += sent;
+        if(log_async.tail >= CONFIG_LOG_ASYNC_BUFFERSIZE)
+        {
+            log_async.tail -= CONFIG_LOG_ASYNC_BUFFERSIZE;
+        }
+
+        log_async.used -= sent;
+        log_async.committed -= sent;
+
+        /* Flush requests that hit this drainer (new lines, Tx done) are served here */
+        more = (sent != 0) || log_async.rescan;
+        log_async.rescan = 0;
+
+        if(!more)
+        {
+            log_async.draining = 0;
+        }
+
+        __set_PRIMASK(primask);
+
+    } while(more);
+}
+
+uint32_t log_async_get_dropped(void)
+{
+    return log_async.dropped_lines;
+}
+
+#endif  /* CONFIG_LOG_ASYNC */
@@ -0,0 +1,209 @@
+#include "log.h"
+#include "log_private.h"
+
+#include "stm32f446xx.h"
+#include "assert.h"
+#include "types.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+
+#if CONFIG_LOG_BINARY
+
+/*
+* Record layout, one 32-bit word each:
+*   [0] header: sync(8) | level(4) | nargs(4) | sequence(16)
+*   [1] log timestamp, low 32 bits
+*   [2] log timestamp, high 32 bits
+*   [3] tag address
+*   [4] format address
+*   [5..] raw arguments
+* Must be kept in sync with log_decode.py
+*/
+#define LOG_BINARY_SYNC             0xA5U
+#define LOG_BINARY_HEADER_WORDS     5U
+
+#define LOG_BINARY_HEADER(level, nargs, seq)    (((uint32_t) LOG_BINARY_SYNC << 24) | \
+                                                (((uint32_t) (level) & 0x0F) << 20) | \
+                                                (((uint32_t) (nargs) & 0x0F) << 16) | \
+                                                ((uint32_t) (seq) & 0xFFFF))
+
+#define LOG_BINARY_GET_LEVEL(hdr)   (((hdr) >> 20) & 0x0F)
+#define LOG_BINARY_GET_NARGS(hdr)   (((hdr) >> 16) & 0x0F)
+
+struct log_binary_ring_t
+{
+    uint32_t words[CONFIG_LOG_BINARY_BUFFERSIZE];
+    uint16_t head;
+    uint16_t tail;
+    uint16_t count;
+    uint16_t sequence;
+    uint32_t dropped;
+};
+
+static struct log_binary_ring_t log_ring;
+
+static uint16_t log_binary_pop(uint32_t* record)
+{
+    uint32_t primask;
+    uint16_t nwords;
+    uint16_t indx;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(log_ring.count == 0)
+    {
+        __set_PRIMASK(primask);
+
+        return 0;
+    }
+
+    record[0] = log_ring.words[log_ring.tail];
+    nwords = LOG_BINARY_HEADER_WORDS + LOG_BINARY_GET_NARGS(record[0]);
+
+    for(indx = 0; indx < nwords; indx++)
+    {
+        record[indx] = log_ring.words[log_ring.tail];
+
+        if(++log_ring.tail == CONFIG_LOG_BINARY_BUFFERSIZE)
+        {
+            log_ring.tail = 0;
+        }
+    }
+
+    log_ring.count -= nwords;
+
+    __set_PRIMASK(primask);
+
+    return nwords;
+}
+
+void log_binary_write(log_level_t level, const char* tag, const char* format,
+                                                        uint8_t nargs, ...)
+{
+    va_list args;
+    uint32_t record[LOG_BINARY_HEADER_WORDS + LOG_BINARY_MAX_ARGS];
+    uint32_t primask;
+    uint64_t timestamp;
+    uint16_t nwords;
+    uint16_t indx;
+
+    ASSERT(nargs <= LOG_BINARY_MAX_ARGS);
+
+    if(!tag || !format)
+    {
+        return;
+    }
+
+    /* Whole timestamp, the cycle count wraps 32 bits in minutes */
+    timestamp = log_get_timestamp();
+    record[1] = (uint32_t) timestamp;
+    record[2] = (uint32_t) (timestamp >> 32);
+    record[3] = (uint32_t) tag;
+    record[4] = (uint32_t) format;
+
+    va_start(args, nargs);
+    for(indx = 0; indx < nargs; indx++)
+    {
+        record[LOG_BINARY_HEADER_WORDS + indx] = va_arg(args, uint32_t);
+    }
+    va_end(args);
+
+    nwords = LOG_BINARY_HEADER_WORDS + nargs;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* Drop newest, records already queued are never overwritten */
+    if(nwords > CONFIG_LOG_BINARY_BUFFERSIZE - log_ring.count)
+    {
+        ++log_ring.dropped;
+        ++log_ring.sequence;
+        __set_PRIMASK(primask);
+
+        return;
+    }
+
+    record[0] = LOG_BINARY_HEADER(level, nargs, log_ring.sequence++);
+
+    for(indx = 0; indx < nwords; indx++)
+    {
+        log_ring.words[log_ring.head] = record[indx];
+
+        if(++log_ring.head == CONFIG_LOG_BINARY_BUFFERSIZE)
+        {
+            log_ring.head = 0;
+        }
+    }
+
+    log_ring.count += nwords;
+
+    __set_PRIMASK(primask);
+}
+
+uint16_t log_binary_flush(uint16_t max_records)
+{
+    uint32_t record[LOG_BINARY_HEADER_WORDS + LOG_BINARY_MAX_ARGS];
+    const uint32_t* args;
+    uint16_t flushed;
+
+    args = &record[LOG_BINARY_HEADER_WORDS];
+    flushed = 0;
+
+    while(flushed < max_records && log_binary_pop(record))
+    {
+        /*
+        * Unused trailing words are ignored by the formatter, every argument
+        * was stored as a 32-bit word so they are passed back the same way
+        */
+        log_write_timestamped(((uint64_t) record[2] << 32) | record[1],
+                    (log_level_t) LOG_BINARY_GET_LEVEL(record[0]),
+                    (const char*) record[3], (const char*) record[4],
+                    args[0], args[1], args[2], args[3],
+                    args[4], args[5], args[6], args[7]);
+
+        ++flushed;
+    }
+
+    return flushed;
+}
+
+uint16_t log_binary_dump(uint16_t max_records)
+{
+    uint32_t record[LOG_BINARY_HEADER_WORDS + LOG_BINARY_MAX_ARGS];
+    uint16_t dumped;
+    uint16_t nwords;
+    uint16_t indx;
+
+    dumped = 0;
+
+    if(!putchar_like_func)
+    {
+        return 0;
+    }
+
+    while(dumped < max_records && (nwords = log_binary_pop(record)) != 0)
+    {
+        /* Little endian, the sync byte is the last byte of the header word */
+        for(indx = 0; indx < nwords; indx++)
+        {
+            putchar_like_func((char) (record[indx] & 0xFF));
+            putchar_like_func((char) ((record[indx] >> 8) & 0xFF));
+            putchar_like_func((char) ((record[indx] >> 16) & 0xFF));
+            putchar_like_func((char) ((record[indx] >> 24) & 0xFF));
+        }
+
+        ++dumped;
+    }
+
+    return dumped;
+}
+
+uint32_t log_binary_get_dropped(void)
+{
+    return log_ring.dropped;
+}
+
+#endif  /* CONFIG_LOG_BINARY */
@@ -0,0 +1,455 @@
+#include "log.h"
+
+#include "flash_hal.h"
+#include "types.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if CONFIG_LOG_FLASH
+
+#define LOG_FLASH_LAST_SECTOR       (CONFIG_LOG_FLASH_FIRST_SECTOR + CONFIG_LOG_FLASH_SECTORS - 1)
+
+/* Sector 7 is the last one, flash_sector_t can not be used by the preprocessor */
+#if (CONFIG_LOG_FLASH_SECTORS < 2) || (LOG_FLASH_LAST_SECTOR > 7)
+#error "Flash log needs at least two sectors inside the flash"
+#endif
+
+#if (CONFIG_LOG_FLASH_BATCH_SIZE % 4) != 0
+#error "CONFIG_LOG_FLASH_BATCH_SIZE must be a multiple of 4"
+#endif
+
+/* Programming parallelism of word writes needs a 2.7-3.6V supply */
+#define LOG_FLASH_VOLTAGE_RANGE     FLASH_VOLTAGE_RANGE_3
+
+#define LOG_FLASH_SECTOR_MAGIC      0x31474F4CU     /* "LOG1" */
+#define LOG_FLASH_ERASED            0xFFFFFFFFU
+
+/*
+* Each sector starts with a header holding a sequence number incremented every
+* time a sector is opened, the newest sector is the one with the highest number,
+* and the sequence number its first record takes.
+* Records follow, word aligned:
+*   [0] length(16) | crc16(16)   written first, erased word marks the head
+*   [1] record sequence number
+*   [2..] payload, padded with 0xFF to a whole word
+* The CRC covers the sequence number and the payload, a record torn by a reset
+* keeps its length so the scan can step over it.
+*/
+#define LOG_FLASH_RECORD_HEADER(len, crc)   (((uint32_t) (crc) << 16) | (len))
+#define LOG_FLASH_RECORD_LEN(hdr)           ((hdr) & 0xFFFF)
+#define LOG_FLASH_RECORD_CRC(hdr)           ((hdr) >> 16)
+#define LOG_FLASH_RECORD_SIZE(len)          (8U + (((len) + 3U) & ~3U))
+
+#define LOG_FLASH_READ_WORD(addr)           (*(const volatile uint32_t*) (uintptr_t) (addr))
+
+struct log_flash_sector_hdr_t
+{
+    uint32_t magic;
+    uint32_t sequence;
+    uint32_t sequence_inv;
+    uint32_t first_record;      /* Record sequence carried over from the previous sector */
+};
+
+struct log_flash_ctrl_t
+{
+    uint32_t write_addr;
+    uint32_t sector_end;
+    uint32_t sector_sequence;
+    uint32_t record_sequence;
+    uint16_t batch_len;
+    uint8_t sector;
+    uint8_t ready;
+    uint8_t batch[CONFIG_LOG_FLASH_BATCH_SIZE];
+};
+
+static struct log_flash_ctrl_t log_flash;
+
+static const uint16_t log_flash_crc_table[16] =
+{
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+/**
+ * @brief CRC-16/CCITT, one nibble at a time
+ */
+static uint16_t log_flash_crc16(uint16_t crc, const uint8_t* data, uint32_t len)
+{
+    while(len--)
+    {
+        crc = (crc << 4) ^ log_flash_crc_table[(crc >> 12) ^ (*data >> 4)];
+        crc = (crc << 4) ^ log_flash_crc_table[(crc >> 12) ^ (*data & 0x0F)];
+        ++data;
+    }
+
+    return crc;
+}
+
+static uint16_t log_flash_record_crc(uint32_t sequence, const uint8_t* payload, uint16_t len)
+{
+    uint16_t crc;
+
+    crc = log_flash_crc16(0xFFFF, (const uint8_t*) &sequence, sizeof(sequence));
+
+    return log_flash_crc16(crc, payload, len);
+}
+
+static uint8_t log_flash_sector_valid(uint8_t sector, uint32_t* sequence)
+{
+    const struct log_flash_sector_hdr_t* hdr;
+
+    hdr = (const struct log_flash_sector_hdr_t*) (uintptr_t) flash_hal_get_sector_address(sector);
+
+    if(hdr->magic != LOG_FLASH_SECTOR_MAGIC || hdr->sequence != ~hdr->sequence_inv)
+    {
+        return 0;
+    }
+
+    *sequence = hdr->sequence;
+
+    return 1;
+}
+
+/**
+ * @brief Program whole words, the largest size allowed without external Vpp
+ */
+static error_t log_flash_program(uint32_t address, const uint8_t* data, uint32_t len)
+{
+    uint32_t word;
+    uint32_t chunk;
+
+    while(len)
+    {
+        chunk = (len < sizeof(word)) ? len : sizeof(word);
+        word = LOG_FLASH_ERASED;
+        memcpy(&word, data, chunk);
+
+        if(flash_hal_program(FLASH_PROGRAM_WORD, address, &word) != OK)
+        {
+            return FAILED;
+        }
+
+        address += sizeof(word);
+        data += chunk;
+        len -= chunk;
+    }
+
+    return OK;
+}
+
+static error_t log_flash_open_sector(uint8_t sector, uint32_t sequence)
+{
+    struct log_flash_sector_hdr_t hdr;
+    uint32_t address;
+
+    address = flash_hal_get_sector_address(sector);
+
+    if(flash_hal_erase_sector(sector, LOG_FLASH_VOLTAGE_RANGE) != OK)
+    {
+        return FAILED;
+    }
+
+    hdr.magic = LOG_FLASH_SECTOR_MAGIC;
+    hdr.sequence = sequence;
+    hdr.sequence_inv = ~sequence;
+    hdr.first_record = log_flash.record_sequence;
+
+    if(log_flash_program(address, (const uint8_t*) &hdr, sizeof(hdr)) != OK)
+    {
+        return FAILED;
+    }
+
+    log_flash.sector = sector;
+    log_flash.sector_sequence = sequence;
+    log_flash.write_addr = address + sizeof(hdr);
+    log_flash.sector_end = address + flash_hal_get_sector_size(sector);
+
+    return OK;
+}
+
+/**
+ * @brief Step over the records of a sector up to the first erased header word.
+ *
+ * @param last_sequence updated with the sequence of the last valid record
+ * @return uint32_t address of the head, the sector end if the sector is full or damaged
+ */
+static uint32_t log_flash_find_head(uint8_t sector, uint32_t* last_sequence)
+{
+    uint32_t address;
+    uint32_t end;
+    uint32_t hdr;
+    uint16_t len;
+
+    address = flash_hal_get_sector_address(sector) + sizeof(struct log_flash_sector_hdr_t);
+    end = flash_hal_get_sector_address(sector) + flash_hal_get_sector_size(sector);
+
+    while(address + LOG_FLASH_RECORD_SIZE(0) <= end)
+    {
+        hdr = LOG_FLASH_READ_WORD(address);
+
+        if(hdr == LOG_FLASH_ERASED)
+        {
+            return address;
+        }
+
+        len = LOG_FLASH_RECORD_LEN(hdr);
+
+        if(len == 0 || address + LOG_FLASH_RECORD_SIZE(len) > end)
+        {
+            break;
+        }
+
+        if(log_flash_record_crc(LOG_FLASH_READ_WORD(address + 4),
+                    (const uint8_t*) (uintptr_t) (address + 8), len) == LOG_FLASH_RECORD_CRC(hdr))
+        {
+            *last_sequence = LOG_FLASH_READ_WORD(address + 4);
+        }
+
+        address += LOG_FLASH_RECORD_SIZE(len);
+    }
+
+    return end;
+}
+
+error_t log_flash_init(void)
+{
+    const struct log_flash_sector_hdr_t* hdr;
+    uint32_t sequence;
+    uint32_t newest_sequence;
+    uint32_t last_record;
+    uint8_t newest_sector;
+    uint8_t sector;
+    error_t ret;
+
+    memset(&log_flash, 0, sizeof(log_flash));
+    flash_hal_init();
+
+    newest_sector = FLASH_SECTOR_INV;
+    newest_sequence = 0;
+
+    /* Only sector headers are read to find the active sector */
+    for(sector = CONFIG_LOG_FLASH_FIRST_SECTOR; sector <= LOG_FLASH_LAST_SECTOR; sector++)
+    {
+        if(log_flash_sector_valid(sector, &sequence) &&
+                (newest_sector == FLASH_SECTOR_INV || sequence > newest_sequence))
+        {
+            newest_sector = sector;
+            newest_sequence = sequence;
+        }
+    }
+
+    if(newest_sector == FLASH_SECTOR_INV)
+    {
+        if(flash_hal_unlock() != OK)
+        {
+            return FAILED;
+        }
+
+        log_flash.record_sequence = 1;
+        ret = log_flash_open_sector(CONFIG_LOG_FLASH_FIRST_SECTOR, 1);
+        flash_hal_lock();
+
+        if(ret != OK)
+        {
+            return FAILED;
+        }
+    }
+    else
+    {
+        /* An empty sector continues the numbering of the previous one */
+        hdr = (const struct log_flash_sector_hdr_t*) (uintptr_t) 
+                                        flash_hal_get_sector_address(newest_sector);
+        last_record = hdr->first_record - 1;
+
+        log_flash.sector = newest_sector;
+        log_flash.sector_sequence = newest_sequence;
+        log_flash.write_addr = log_flash_find_head(newest_sector, &last_record);
+        log_flash.sector_end = flash_hal_get_sector_address(newest_sector) +
+                                                flash_hal_get_sector_size(newest_sector);
+        log_flash.record_sequence = last_record + 1;
+    }
+
+    log_flash.ready = 1;
+
+    return OK;
+}
+
+error_t log_flash_sync(void)
+{
+    uint32_t hdr;
+    uint32_t address;
+    uint32_t size;
+    uint8_t sector;
+    error_t ret;
+
+    if(!log_flash.ready)
+    {
+        return FAILED;
+    }
+
+    if(log_flash.batch_len == 0)
+    {
+        return OK;
+    }
+
+    if(flash_hal_unlock() != OK)
+    {
+        return FAILED;
+    }
+
+    ret = OK;
+    size = LOG_FLASH_RECORD_SIZE(log_flash.batch_len);
+
+    if(log_flash.write_addr + size > log_flash.sector_end)
+    {
+        /* Rotate, the oldest sector of the range is erased and reused */
+        sector = (log_flash.sector == LOG_FLASH_LAST_SECTOR) ?
+                            CONFIG_LOG_FLASH_FIRST_SECTOR : log_flash.sector + 1;
+
+        ret = log_flash_open_sector(sector, log_flash.sector_sequence + 1);
+    }
+
+    if(ret == OK)
+    {
+        address = log_flash.write_addr;
+        hdr = LOG_FLASH_RECORD_HEADER(log_flash.batch_len,
+                        log_flash_record_crc(log_flash.record_sequence,
+                                                log_flash.batch, log_flash.batch_len));
+
+        /* Space is consumed even if programming fails part way */
+        log_flash.write_addr += size;
+
+        if(flash_hal_program(FLASH_PROGRAM_WORD, address, &hdr) != OK ||
+            flash_hal_program(FLASH_PROGRAM_WORD, address + 4,
+                                                    &log_flash.record_sequence) != OK ||
+            log_flash_program(address + 8, log_flash.batch, log_flash.batch_len) != OK)
+        {
+            ret = FAILED;
+        }
+
+        ++log_flash.record_sequence;
+        log_flash.batch_len = 0;
+    }
+
+    flash_hal_lock();
+
+    return ret;
+}
+
+error_t log_flash_write(const char* data, uint16_t len)
+{
+    uint16_t to_copy;
+
+    if(!log_flash.ready || !data)
+    {
+        return FAILED;
+    }
+
+    while(len)
+    {
+        to_copy = sizeof(log_flash.batch) - log_flash.batch_len;
+        to_copy = (len < to_copy) ? len : to_copy;
+
+        memcpy(&log_flash.batch[log_flash.batch_len], data, to_copy);
+        log_flash.batch_len += to_copy;
+        data += to_copy;
+        len -= to_copy;
+
+        if(log_flash.batch_len == sizeof(log_flash.batch))
+        {
+            if(log_flash_sync() != OK)
+            {
+                return FAILED;
+            }
+        }
+    }
+
+    return OK;
+}
+
+int log_flash_putchar(char c)
+{
+    return (log_flash_write(&c, 1) == OK) ? (unsigned char) c : -1;
+}
+
+error_t log_flash_dump(putchar_like_t out)
+{
+    uint32_t sequences[CONFIG_LOG_FLASH_SECTORS];
+    uint32_t address;
+    uint32_t end;
+    uint32_t hdr;
+    uint32_t oldest;
+    uint16_t len;
+    uint16_t indx;
+    uint8_t valid[CONFIG_LOG_FLASH_SECTORS];
+    uint8_t sector;
+    uint8_t count;
+    uint8_t pick;
+
+    if(!out)
+    {
+        return FAILED;
+    }
+
+    for(count = 0; count < CONFIG_LOG_FLASH_SECTORS; count++)
+    {
+        sequences[count] = 0;
+        valid[count] = log_flash_sector_valid(CONFIG_LOG_FLASH_FIRST_SECTOR + count,
+                                                                    &sequences[count]);
+    }
+
+    /* Sectors from oldest to newest, a handful of them at most */
+    for(count = 0; count < CONFIG_LOG_FLASH_SECTORS; count++)
+    {
+        pick = CONFIG_LOG_FLASH_SECTORS;
+        oldest = 0;
+
+        for(indx = 0; indx < CONFIG_LOG_FLASH_SECTORS; indx++)
+        {
+            if(valid[indx] && (pick == CONFIG_LOG_FLASH_SECTORS || sequences[indx] < oldest))
+            {
+                pick = indx;
+                oldest = sequences[indx];
+            }
+        }
+
+        if(pick == CONFIG_LOG_FLASH_SECTORS)
+        {
+            break;
+        }
+
+        valid[pick] = 0;
+        sector = CONFIG_LOG_FLASH_FIRST_SECTOR + pick;
+
+        address = flash_hal_get_sector_address(sector) + sizeof(struct log_flash_sector_hdr_t);
+        end = flash_hal_get_sector_address(sector) + flash_hal_get_sector_size(sector);
+
+        while(address + LOG_FLASH_RECORD_SIZE(0) <= end)
+        {
+            hdr = LOG_FLASH_READ_WORD(address);
+            len = LOG_FLASH_RECORD_LEN(hdr);
+
+            if(hdr == LOG_FLASH_ERASED || len == 0 || address + LOG_FLASH_RECORD_SIZE(len) > end)
+            {
+                break;
+            }
+
+            if(log_flash_record_crc(LOG_FLASH_READ_WORD(address + 4),
+                        (const uint8_t*) (uintptr_t) (address + 8), len) == LOG_FLASH_RECORD_CRC(hdr))
+            {
+                for(indx = 0; indx < len; indx++)
+                {
+                    out(((const char*) (uintptr_t) (address + 8))[indx]);
+                }
+            }
+
+            address += LOG_FLASH_RECORD_SIZE(len);
+        }
+    }
+
+    return OK;
+}
+
+#endif  /* CONFIG_LOG_FLASH */
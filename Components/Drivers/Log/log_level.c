@@ -0,0 +1,288 @@
+#include "log.h"
+
+#include "stm32f446xx.h"
+#include "types.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if CONFIG_LOG_RUNTIME_LEVELS
+
+#if (CONFIG_LOG_TAG_TABLE_SIZE & (CONFIG_LOG_TAG_TABLE_SIZE - 1)) != 0
+#error "CONFIG_LOG_TAG_TABLE_SIZE must be a power of two"
+#endif
+
+#define LOG_TAG_TABLE_MASK          (CONFIG_LOG_TAG_TABLE_SIZE - 1)
+#define LOG_TAG_TABLE_BITS          __builtin_ctz(CONFIG_LOG_TAG_TABLE_SIZE)
+
+/*
+* Fibonacci hashing of the tag address, low bits are always zero for aligned strings.
+* The index is taken from the top bits of the product, the best mixed ones.
+*/
+#define LOG_TAG_HASH(tag)           ((((uint32_t) (uintptr_t) (tag) >> 2) * 2654435761U) >> \
+                                                        (32 - LOG_TAG_TABLE_BITS))
+
+/*
+* Entries are never removed and their name never changes once published, so the
+* table is searched with interrupts enabled. A writer masks interrupts only to
+* store, after checking no other context changed the table since its search.
+*
+* Call site entries are keyed by the tag pointer of the logging module, which lives
+* forever. Levels set for a string no call site has used yet are kept by name in an
+* entry of their own, holding a copy of the string.
+*/
+struct log_tag_entry_t
+{
+    const char* tag;            /* Call site tag, log_tag_named or NULL when free */
+    log_level_t level;
+    uint8_t is_set;
+    char name[LOG_TAG_NAME_SIZE];
+};
+
+const log_level_t log_level_unresolved = LOG_LEVEL_MAX;
+
+static const char log_tag_named[] = "";
+
+static log_level_t log_default_level = CONFIG_LOG_DEFAULT_LEVEL;
+
+static struct log_tag_entry_t log_tags[CONFIG_LOG_TAG_TABLE_SIZE];
+
+/* Incremented by every change, a search is only acted on if it is unchanged */
+static volatile uint32_t log_tags_generation;
+
+static const char* log_level_name(const struct log_tag_entry_t* entry)
+{
+    return (entry->tag == log_tag_named) ? entry->name : entry->tag;
+}
+
+/**
+ * @brief Find the entry of a tag pointer or the free slot it would be inserted at.
+ *
+ * @return struct log_tag_entry_t* NULL if not found and the table is full
+ */
+static struct log_tag_entry_t* log_level_find(const char* tag)
+{
+    struct log_tag_entry_t* entry;
+    uint32_t indx;
+    uint32_t probe;
+
+    indx = LOG_TAG_HASH(tag);
+
+    for(probe = 0; probe < CONFIG_LOG_TAG_TABLE_SIZE; probe++)
+    {
+        entry = &log_tags[(indx + probe) & LOG_TAG_TABLE_MASK];
+
+        if(entry->tag == tag || entry->tag == NULL)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief First entry set explicitly for the same string
+ *
+ * @return struct log_tag_entry_t* NULL if the string was never set
+ */
+static struct log_tag_entry_t* log_level_find_set(const char* tag)
+{
+    uint32_t indx;
+
+    for(indx = 0; indx < CONFIG_LOG_TAG_TABLE_SIZE; indx++)
+    {
+        if(log_tags[indx].tag && log_tags[indx].is_set &&
+                                strcmp(log_level_name(&log_tags[indx]), tag) == 0)
+        {
+            return &log_tags[indx];
+        }
+    }
+
+    return NULL;
+}
+
+error_t log_level_set(const char* tag, log_level_t level)
+{
+    uint32_t matches[(CONFIG_LOG_TAG_TABLE_SIZE + 31) / 32];
+    struct log_tag_entry_t* free_entry;
+    uint32_t generation;
+    uint32_t primask;
+    uint32_t indx;
+    uint8_t is_default;
+    uint8_t found;
+    error_t ret;
+
+    if(!tag)
+    {
+        return FAILED;
+    }
+
+    is_default = (strcmp(tag, "*") == 0);
+
+    if(!is_default && strlen(tag) >= LOG_TAG_NAME_SIZE)
+    {
+        return FAILED;
+    }
+
+    while(1)
+    {
+        generation = log_tags_generation;
+        free_entry = NULL;
+        found = 0;
+        memset(matches, 0, sizeof(matches));
+
+        /* Entries of the string, any pointer, cached call sites point into them */
+        for(indx = 0; !is_default && indx < CONFIG_LOG_TAG_TABLE_SIZE; indx++)
+        {
+            if(!log_tags[indx].tag)
+            {
+                if(!free_entry)
+                {
+                    free_entry = &log_tags[indx];
+                }
+            }
+            else if(strcmp(log_level_name(&log_tags[indx]), tag) == 0)
+            {
+                matches[indx / 32] |= (1UL << (indx % 32));
+                found = 1;
+            }
+        }
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        if(generation == log_tags_generation)
+        {
+            break;
+        }
+
+        /* Changed while searching, search again */
+        __set_PRIMASK(primask);
+    }
+
+    ret = OK;
+
+    if(is_default)
+    {
+        log_default_level = level;
+
+        for(indx = 0; indx < CONFIG_LOG_TAG_TABLE_SIZE; indx++)
+        {
+            if(log_tags[indx].tag && !log_tags[indx].is_set)
+            {
+                log_tags[indx].level = level;
+            }
+        }
+    }
+    else
+    {
+        for(indx = 0; indx < CONFIG_LOG_TAG_TABLE_SIZE; indx++)
+        {
+            if(matches[indx / 32] & (1UL << (indx % 32)))
+            {
+                log_tags[indx].level = level;
+                log_tags[indx].is_set = 1;
+            }
+        }
+
+        /* Kept by name until a call site of the tag shows up */
+        if(!found)
+        {
+            if(free_entry)
+            {
+                strcpy(free_entry->name, tag);
+                free_entry->level = level;
+                free_entry->is_set = 1;
+                free_entry->tag = log_tag_named;
+            }
+            else
+            {
+                ret = FAILED;
+            }
+        }
+    }
+
+    ++log_tags_generation;
+
+    __set_PRIMASK(primask);
+
+    return ret;
+}
+
+log_level_t log_level_get(const char* tag)
+{
+    struct log_tag_entry_t* entry;
+
+    if(!tag)
+    {
+        return log_default_level;
+    }
+
+    /* Nothing is inserted, tag may be a temporary string */
+    entry = log_level_find(tag);
+
+    if(entry && entry->tag == tag)
+    {
+        return entry->level;
+    }
+
+    entry = log_level_find_set(tag);
+
+    return entry ? entry->level : log_default_level;
+}
+
+const log_level_t* log_level_ref(const char* tag)
+{
+    struct log_tag_entry_t* entry;
+    struct log_tag_entry_t* set_entry;
+    uint32_t generation;
+    uint32_t primask;
+
+    if(!tag)
+    {
+        return &log_default_level;
+    }
+
+    entry = log_level_find(tag);
+
+    if(entry && entry->tag == tag)
+    {
+        return &entry->level;
+    }
+
+    while(1)
+    {
+        generation = log_tags_generation;
+
+        /* A tag pointer seen for the first time inherits the level set for its string */
+        entry = log_level_find(tag);
+        set_entry = log_level_find_set(tag);
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+
+        if(generation == log_tags_generation)
+        {
+            break;
+        }
+
+        __set_PRIMASK(primask);
+    }
+
+    if(entry && entry->tag == NULL)
+    {
+        entry->level = set_entry ? set_entry->level : log_default_level;
+        entry->is_set = (set_entry != NULL);
+        entry->tag = tag;
+
+        ++log_tags_generation;
+    }
+
+    __set_PRIMASK(primask);
+
+    return entry ? &entry->level : &log_default_level;
+}
+
+#endif  /* CONFIG_LOG_RUNTIME_LEVELS */
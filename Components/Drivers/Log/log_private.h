@@ -0,0 +1,51 @@
+#ifndef __LOG_PRIVATE_H__
+
+#define __LOG_PRIVATE_H__
+
+#include "log.h"
+
+#include <stdint.h>
+
+#define LOG_TIMESTAMP_MS        0
+#define LOG_TIMESTAMP_US        1
+#define LOG_TIMESTAMP_CYCLES    2
+
+#ifndef CONFIG_LOG_TIMESTAMP_SOURCE
+#define CONFIG_LOG_TIMESTAMP_SOURCE     LOG_TIMESTAMP_MS
+#endif
+
+#if CONFIG_LOG_COLORS
+#define LOG_COLOR_END           "\033[0m"
+#define LOG_LINE_END            "\r\n" LOG_COLOR_END
+#else
+#define LOG_LINE_END            "\r\n"
+#endif
+
+extern putchar_like_t putchar_like_func;
+
+/**
+ * @brief Timestamp printed in the log prefix, in the unit selected by 
+ * CONFIG_LOG_TIMESTAMP_SOURCE.
+ * 
+ * @return uint64_t 
+ */
+uint64_t log_get_timestamp(void);
+
+/**
+ * @brief Same as log_write but with the timestamp supplied by the caller, used to
+ * format deferred records with the time they were captured.
+ */
+void log_write_timestamped(uint64_t timestamp, log_level_t level, const char* tag, 
+                                                            const char* format, ...);
+
+/**
+ * @brief Hand a formatted line to every registered sink accepting its level.
+ * 
+ * @param level 
+ * @param line 
+ * @param len 
+ * @param body offset of the text following the timestamp
+ */
+void log_router_write(log_level_t level, const char* line, uint16_t len, uint16_t body);
+
+#endif
@@ -0,0 +1,487 @@
+#include "log.h"
+#include "log_private.h"
+
+#include "stm32f446xx.h"
+#include "stdio_public.h"
+#include "timer.h"
+#include "types.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if CONFIG_LOG_ROUTER
+
+/* Tokens are kept in thousandths of a line so the refill needs no division */
+#define LOG_ROUTER_TOKEN_SCALE      1000U
+
+#define LOG_ROUTER_NOTE_SIZE        64
+
+/* Longer bodies are told apart by their first bytes, length and hash */
+#define LOG_ROUTER_LAST_SIZE        128
+
+#define LOG_FNV_OFFSET              2166136261U
+#define LOG_FNV_PRIME               16777619U
+
+struct log_router_sink_t
+{
+    log_line_func_t func;
+    uint32_t tokens;
+    uint32_t last_refill;
+    uint32_t suppressed;
+    uint32_t suppressed_total;
+    uint16_t rate;
+    uint16_t burst;
+    log_level_t level;
+    uint8_t isr_safe;
+};
+
+struct log_router_t
+{
+    struct log_router_sink_t sinks[CONFIG_LOG_ROUTER_SINKS];
+    uint32_t last_hash;
+    uint32_t repeated;
+    uint16_t last_len;
+    log_level_t last_level;
+    uint8_t count;
+    char last_body[LOG_ROUTER_LAST_SIZE];
+};
+
+struct log_ram_ring_t
+{
+    char buffer[CONFIG_LOG_RAM_BUFFERSIZE];
+    uint16_t head;
+    uint16_t count;
+};
+
+/* No line has level LOG_LEVEL_MAX, the first line is never taken for a repeat */
+static struct log_router_t log_router = {.last_level = LOG_LEVEL_MAX};
+
+static struct log_ram_ring_t log_ram;
+
+/**
+ * @brief FNV-1a of the line without its timestamp, identical messages hash the same
+ */
+static uint32_t log_router_hash(const char* data, uint16_t len)
+{
+    uint32_t hash;
+
+    hash = LOG_FNV_OFFSET;
+
+    while(len--)
+    {
+        hash = (hash ^ (uint8_t) *data++) * LOG_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+static struct log_router_sink_t* log_router_find(log_line_func_t func)
+{
+    uint8_t indx;
+
+    for(indx = 0; indx < log_router.count; indx++)
+    {
+        if(log_router.sinks[indx].func == func)
+        {
+            return &log_router.sinks[indx];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Token bucket, refilled by rate lines per second up to burst lines.
+ * Called with interrupts masked.
+ */
+static uint8_t log_router_take_token(struct log_router_sink_t* sink, uint32_t now)
+{
+    uint32_t elapsed;
+    uint32_t capacity;
+
+    if(sink->rate == 0)
+    {
+        return 1;
+    }
+
+    capacity = (uint32_t) sink->burst * LOG_ROUTER_TOKEN_SCALE;
+    elapsed = now - sink->last_refill;
+    sink->last_refill = now;
+
+    if(elapsed >= capacity / sink->rate)
+    {
+        sink->tokens = capacity;
+    }
+    else
+    {
+        sink->tokens += elapsed * sink->rate;
+
+        if(sink->tokens > capacity)
+        {
+            sink->tokens = capacity;
+        }
+    }
+
+    if(sink->tokens < LOG_ROUTER_TOKEN_SCALE)
+    {
+        return 0;
+    }
+
+    sink->tokens -= LOG_ROUTER_TOKEN_SCALE;
+
+    return 1;
+}
+
+static void log_router_note(log_line_func_t func, const char* format, uint32_t count)
+{
+    char note[LOG_ROUTER_NOTE_SIZE];
+    int len;
+
+    len = snprintf_(note, sizeof(note), format, count);
+
+    if(len > 0)
+    {
+        func(note, (len < (int) sizeof(note)) ? (uint16_t) len : sizeof(note) - 1);
+    }
+}
+
+error_t log_router_add_sink(log_line_func_t func, log_level_t level,
+                                    uint16_t rate, uint16_t burst, uint8_t isr_safe)
+{
+    struct log_router_sink_t* sink;
+    uint32_t primask;
+    error_t ret;
+
+    if(!func || (rate && !burst))
+    {
+        return FAILED;
+    }
+
+    ret = OK;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    sink = log_router_find(func);
+
+    if(!sink && log_router.count < CONFIG_LOG_ROUTER_SINKS)
+    {
+        sink = &log_router.sinks[log_router.count];
+        memset(sink, 0, sizeof(*sink));
+        sink->func = func;
+        ++log_router.count;
+    }
+
+    if(sink)
+    {
+        sink->level = level;
+        sink->rate = rate;
+        sink->burst = burst;
+        sink->isr_safe = isr_safe;
+        sink->tokens = (uint32_t) burst * LOG_ROUTER_TOKEN_SCALE;
+        sink->last_refill = (uint32_t) timer_get_milliseconds();
+    }
+    else
+    {
+        ret = FAILED;
+    }
+
+    __set_PRIMASK(primask);
+
+    return ret;
+}
+
+error_t log_router_set_level(log_line_func_t func, log_level_t level)
+{
+    struct log_router_sink_t* sink;
+    uint32_t primask;
+    error_t ret;
+
+    ret = FAILED;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    sink = log_router_find(func);
+
+    if(sink)
+    {
+        sink->level = level;
+        ret = OK;
+    }
+
+    __set_PRIMASK(primask);
+
+    return ret;
+}
+
+uint32_t log_router_get_suppressed(log_line_func_t func)
+{
+    struct log_router_sink_t* sink;
+
+    sink = log_router_find(func);
+
+    return sink ? sink->suppressed_total : 0;
+}
+
+void log_router_write(log_level_t level, const char* line, uint16_t len, uint16_t body)
+{
+    struct log_router_sink_t* sink;
+    uint32_t suppressed[CONFIG_LOG_ROUTER_SINKS];
+    uint32_t hash;
+    uint32_t now;
+    uint32_t primask;
+    uint32_t repeated;
+    uint16_t body_len;
+    uint16_t kept;
+    log_level_t repeated_level;
+    uint8_t deliver;
+    uint8_t in_isr;
+    uint8_t count;
+    uint8_t indx;
+
+    if(log_router.count == 0)
+    {
+        log_console_write(line, len);
+
+        return;
+    }
+
+    body_len = len - body;
+    kept = (body_len < LOG_ROUTER_LAST_SIZE) ? body_len : LOG_ROUTER_LAST_SIZE;
+    hash = log_router_hash(&line[body], body_len);
+    now = (uint32_t) timer_get_milliseconds();
+    in_isr = (__get_IPSR() != 0);
+    deliver = 0;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* The hash only rules lines out, a match is confirmed on the body itself */
+    if(hash == log_router.last_hash && level == log_router.last_level && 
+            body_len == log_router.last_len && 
+            memcmp(log_router.last_body, &line[body], kept) == 0)
+    {
+        ++log_router.repeated;
+        __set_PRIMASK(primask);
+
+        return;
+    }
+
+    repeated = log_router.repeated;
+    repeated_level = log_router.last_level;
+
+    log_router.repeated = 0;
+    log_router.last_hash = hash;
+    log_router.last_level = level;
+    log_router.last_len = body_len;
+    memcpy(log_router.last_body, &line[body], kept);
+
+    count = log_router.count;
+
+    /* Limits are applied per sink, a storm on the console leaves flash untouched */
+    for(indx = 0; indx < count; indx++)
+    {
+        sink = &log_router.sinks[indx];
+        suppressed[indx] = 0;
+
+        if(level > sink->level)
+        {
+            continue;
+        }
+
+        /* Sinks that may block are left to the next line logged from a task */
+        if(in_isr && !sink->isr_safe)
+        {
+            ++sink->suppressed;
+            ++sink->suppressed_total;
+        }
+        else if(log_router_take_token(sink, now))
+        {
+            deliver |= (1U << indx);
+            suppressed[indx] = sink->suppressed;
+            sink->suppressed = 0;
+        }
+        else
+        {
+            ++sink->suppressed;
+            ++sink->suppressed_total;
+        }
+    }
+
+    __set_PRIMASK(primask);
+
+    /* The line was formatted once by the caller, every sink gets the same bytes */
+    for(indx = 0; indx < count; indx++)
+    {
+        sink = &log_router.sinks[indx];
+
+        if(repeated && repeated_level <= sink->level && (!in_isr || sink->isr_safe))
+        {
+            log_router_note(sink->func, "last message repeated %lu times" LOG_LINE_END,
+                                                                                repeated);
+        }
+
+        if(deliver & (1U << indx))
+        {
+            if(suppressed[indx])
+            {
+                log_router_note(sink->func, "%lu lines suppressed" LOG_LINE_END,
+                                                                        suppressed[indx]);
+            }
+
+            sink->func(line, len);
+        }
+    }
+}
+
+void log_router_flush(void)
+{
+    uint32_t primask;
+    uint32_t repeated;
+    log_level_t repeated_level;
+    uint8_t in_isr;
+    uint8_t count;
+    uint8_t indx;
+
+    in_isr = (__get_IPSR() != 0);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    repeated = log_router.repeated;
+    repeated_level = log_router.last_level;
+    log_router.repeated = 0;
+    count = log_router.count;
+
+    __set_PRIMASK(primask);
+
+    if(!repeated)
+    {
+        return;
+    }
+
+    for(indx = 0; indx < count; indx++)
+    {
+        if(repeated_level <= log_router.sinks[indx].level &&
+                                        (!in_isr || log_router.sinks[indx].isr_safe))
+        {
+            log_router_note(log_router.sinks[indx].func,
+                                "last message repeated %lu times" LOG_LINE_END, repeated);
+        }
+    }
+}
+
+error_t log_console_write(const char* line, uint16_t len)
+{
+    error_t ret;
+
+    ret = OK;
+
+    log_sink_lock();
+
+    while(len--)
+    {
+        if(putchar_like_func(*line++) == EOF)
+        {
+            ret = FAILED;
+            break;
+        }
+    }
+
+    log_sink_unlock();
+
+    return ret;
+}
+
+error_t log_ram_write(const char* line, uint16_t len)
+{
+    uint32_t primask;
+    uint16_t contiguous;
+
+    /* Only the tail of a line larger than the ring fits */
+    if(len > CONFIG_LOG_RAM_BUFFERSIZE)
+    {
+        line += len - CONFIG_LOG_RAM_BUFFERSIZE;
+        len = CONFIG_LOG_RAM_BUFFERSIZE;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* History ring, the oldest lines are overwritten */
+    contiguous = CONFIG_LOG_RAM_BUFFERSIZE - log_ram.head;
+
+    if(len > contiguous)
+    {
+        memcpy(&log_ram.buffer[log_ram.head], line, contiguous);
+        memcpy(&log_ram.buffer[0], line + contiguous, len - contiguous);
+        log_ram.head = len - contiguous;
+    }
+    else
+    {
+        memcpy(&log_ram.buffer[log_ram.head], line, len);
+        log_ram.head += len;
+
+        if(log_ram.head == CONFIG_LOG_RAM_BUFFERSIZE)
+        {
+            log_ram.head = 0;
+        }
+    }
+
+    log_ram.count = (log_ram.count + len > CONFIG_LOG_RAM_BUFFERSIZE) ?
+                                    CONFIG_LOG_RAM_BUFFERSIZE : log_ram.count + len;
+
+    __set_PRIMASK(primask);
+
+    return OK;
+}
+
+uint16_t log_ram_dump(putchar_like_t out)
+{
+    uint32_t primask;
+    uint16_t indx;
+    uint16_t count;
+    uint16_t sent;
+    uint8_t skip;
+
+    if(!out)
+    {
+        return 0;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    count = log_ram.count;
+    indx = (log_ram.head + CONFIG_LOG_RAM_BUFFERSIZE - count) % CONFIG_LOG_RAM_BUFFERSIZE;
+
+    __set_PRIMASK(primask);
+
+    /* Once wrapped the oldest line is cut, start from the next one */
+    skip = (count == CONFIG_LOG_RAM_BUFFERSIZE);
+    sent = 0;
+
+    while(count--)
+    {
+        if(skip)
+        {
+            skip = (log_ram.buffer[indx] != '\n');
+        }
+        else
+        {
+            out(log_ram.buffer[indx]);
+            ++sent;
+        }
+
+        if(++indx == CONFIG_LOG_RAM_BUFFERSIZE)
+        {
+            indx = 0;
+        }
+    }
+
+    return sent;
+}
+
+#endif  /* CONFIG_LOG_ROUTER */
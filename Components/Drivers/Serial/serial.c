@@ -1,5 +1,6 @@
 #include "serial.h"
 
+#include "stm32f446xx.h"
 #include "assert.h"
 
 #include <string.h>
@@ -125,6 +126,8 @@ error_t serial_tx(uint8_t port, const uint8_t* pdata, uint16_t buffer_size, uint
     uint16_t to_copy;
     uint16_t temp;
     uint16_t available;
+    uint32_t primask;
+    uint8_t start;
     serial_t* p_serial;
 
     ASSERT(SERIAL_IS_PORT(port));
@@ -132,15 +135,19 @@ error_t serial_tx(uint8_t port, const uint8_t* pdata, uint16_t buffer_size, uint
     ASSERT(buffer_size > 0);
 
     p_serial = &serial_ports[port];
+    start = 0;
+
+    /*
+    * The queue is shared with the Tx complete interrupt and with writers running
+    * from interrupts (its callback included), the copy is bounded by the queue size
+    */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
     available = p_serial->tx_queue_size - p_serial->tx_queue_cnt;
 
     to_copy = (buffer_size < available) ? buffer_size : available;
 
-    if(p_sent)
-    {
-        *p_sent = to_copy;
-    }
-
     if(to_copy > 0)
     {
         if((p_serial->tx_tail + to_copy) > p_serial->tx_queue_size)
@@ -163,16 +170,8 @@ error_t serial_tx(uint8_t port, const uint8_t* pdata, uint16_t buffer_size, uint
             p_serial->tx_tail -= p_serial->tx_queue_size;
         }
 
-        /*
-        * TODO: Enter critical section
-        */
-
         p_serial->tx_queue_cnt += to_copy; 
 
-        /*
-        * TODO: Exit critical section 
-        */
-
         if(p_serial->tx_status == SERIAL_TX_STATUS_IDLE)
         {
             if((p_serial->tx_head + p_serial->tx_queue_cnt) > p_serial->tx_queue_size)
@@ -184,14 +183,54 @@ error_t serial_tx(uint8_t port, const uint8_t* pdata, uint16_t buffer_size, uint
                 p_serial->tx_xfer_size = p_serial->tx_queue_cnt;
             }
 
+            /* Claimed here, head and transfer size only change on its completion */
             p_serial->tx_status = SERIAL_TX_STATUS_BUSY;
-            
-            usart_hal_transmit_dma(p_serial->usart,
-                            (const uint8_t*) &p_serial->tx_queue[p_serial->tx_head], 
-                            p_serial->tx_xfer_size);
+            start = 1;
         }
     }
 
+    __set_PRIMASK(primask);
+
+    if(p_sent)
+    {
+        *p_sent = to_copy;
+    }
+
+    if(start)
+    {
+        if(usart_hal_transmit_dma(p_serial->usart,
+                        (const uint8_t*) &p_serial->tx_queue[p_serial->tx_head], 
+                        p_serial->tx_xfer_size) != OK)
+        {
+            /* Bytes stay queued, the next serial_tx starts them again */
+            p_serial->tx_xfer_size = 0;
+            p_serial->tx_status = SERIAL_TX_STATUS_IDLE;
+
+            return FAILED;
+        }
+    }
+
+    return OK;
+}
+
+uint16_t serial_get_tx_free(uint8_t port)
+{
+    ASSERT(SERIAL_IS_PORT(port));
+
+    return serial_ports[port].tx_queue_size - serial_ports[port].tx_queue_cnt;
+}
+
+error_t serial_register_tx_callback(uint8_t port, serial_tx_callback_t callback)
+{
+    ASSERT(SERIAL_IS_PORT(port));
+
+    if(!serial_ports[port].usart)
+    {
+        return FAILED;
+    }
+
+    serial_ports[port].tx_done_callback = callback;
+
     return OK;
 }
 
@@ -287,12 +326,20 @@ error_t serial_rx(uint8_t port, uint8_t* pdata, uint16_t buffersize, uint16_t* n
 static void serial_tx_complete_handler(usart_hal_context_t* p_usart)
 {
     serial_t* p_serial = &serial_ports[p_usart->port];
+    uint32_t primask;
+    uint8_t start;
 
     if(!p_serial)
     {
         return;
     }
 
+    start = 0;
+
+    /* A higher priority interrupt may be queueing with serial_tx */
+    primask = __get_PRIMASK();
+    __disable_irq();
+
     p_serial->tx_queue_cnt -= p_serial->tx_xfer_size;
     p_serial->tx_head += p_serial->tx_xfer_size;
     p_serial->tx_xfer_size = 0;
@@ -314,15 +361,30 @@ static void serial_tx_complete_handler(usart_hal_context_t* p_usart)
         }
 
         p_serial->tx_status = SERIAL_TX_STATUS_BUSY;
-
-        usart_hal_transmit_dma(p_usart, 
-                    (const uint8_t*) &p_serial->tx_queue[p_serial->tx_head], 
-                    p_serial->tx_xfer_size);
+        start = 1;
     }
     else
     {
         p_serial->tx_status = SERIAL_TX_STATUS_IDLE;
     }
+
+    __set_PRIMASK(primask);
+
+    if(start)
+    {
+        if(usart_hal_transmit_dma(p_usart, 
+                    (const uint8_t*) &p_serial->tx_queue[p_serial->tx_head], 
+                    p_serial->tx_xfer_size) != OK)
+        {
+            p_serial->tx_xfer_size = 0;
+            p_serial->tx_status = SERIAL_TX_STATUS_IDLE;
+        }
+    }
+
+    if(p_serial->tx_done_callback)
+    {
+        p_serial->tx_done_callback(p_usart->port);
+    }
 }
 
 static void serial_rx_complete_handler(usart_hal_context_t* p_usart)
@@ -54,9 +54,12 @@ typedef struct
     uint8_t parity;
 } serial_config_t;
 
+typedef void (*serial_tx_callback_t) (uint8_t port);
+
 typedef struct 
 {
     usart_hal_context_t* usart;
+    serial_tx_callback_t tx_done_callback;
     serial_config_t config;
     uint16_t tx_xfer_size;
     uint16_t rx_xfer_size;
@@ -167,10 +170,30 @@ uint8_t serial_get_parity(uint8_t port);
  * @param pdata 
  * @param size 
  * @param sent 
- * @return error_t 
+ * @return error_t FAILED if the transfer could not be started, the bytes counted
+ *         in sent stay queued and go out with the next serial_tx
  */
 error_t serial_tx(uint8_t port, const uint8_t* pdata, uint16_t size, uint16_t* sent);
 
+/**
+ * @brief 
+ * 
+ * @param port 
+ * @return uint16_t number of bytes serial_tx can currently queue without truncating
+ */
+uint16_t serial_get_tx_free(uint8_t port);
+
+/**
+ * @brief Register a function called from the DMA interrupt each time a queued
+ * block has been transmitted, so writers can refill the Tx queue without polling.
+ * Must be called after serial_setup.
+ * 
+ * @param port 
+ * @param callback NULL to unregister
+ * @return error_t 
+ */
+error_t serial_register_tx_callback(uint8_t port, serial_tx_callback_t callback);
+
 /**
  * @brief 
  * 
@@ -0,0 +1,369 @@
+#include "timer_private.h"
+#include "timer.h"
+
+#include "stm32f446xx.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#if CONFIG_SOFT_TIMER_USE
+
+/*
+* Hierarchical timing wheel, each level has 64 slots and spans 64 times the
+* level below it. A timer is linked into the slot of the level its remaining
+* time falls in and moved one level down each time the level below wraps, so
+* starting, stopping and expiring are O(1) whatever the number of timers.
+*/
+#define SOFT_TIMER_SLOT_BITS        6
+#define SOFT_TIMER_SLOTS            (1U << SOFT_TIMER_SLOT_BITS)
+#define SOFT_TIMER_SLOT_MASK        (SOFT_TIMER_SLOTS - 1U)
+#define SOFT_TIMER_LEVELS           4
+
+/* Longer timeouts wait in the last level and are placed again when cascaded */
+#define SOFT_TIMER_MAX_DELTA        ((1UL << (SOFT_TIMER_SLOT_BITS * SOFT_TIMER_LEVELS)) - 1U)
+
+#define SOFT_TIMER_INDEX(tick, level)   \
+            (((tick) >> ((level) * SOFT_TIMER_SLOT_BITS)) & SOFT_TIMER_SLOT_MASK)
+
+#define SOFT_TIMER_NO_DEADLINE      UINT32_MAX
+
+struct soft_timer_wheel_t
+{
+    soft_timer_t* slots[SOFT_TIMER_LEVELS][SOFT_TIMER_SLOTS];
+    /* Next tick to be processed */
+    uint32_t now;
+    #if CONFIG_TIMER_TICKLESS
+    /* Millisecond clock read by soft_timer_process */
+    uint32_t ticks;
+    #else
+    /* Written by the tick interrupt only */
+    volatile uint32_t ticks;
+    #endif /* CONFIG_TIMER_TICKLESS */
+};
+
+static struct soft_timer_wheel_t soft_timer_wheel;
+
+static void soft_timer_link(soft_timer_t** pslot, soft_timer_t* p_timer)
+{
+    p_timer->next = *pslot;
+
+    if(p_timer->next)
+    {
+        p_timer->next->pprev = &p_timer->next;
+    }
+
+    p_timer->pprev = pslot;
+    *pslot = p_timer;
+}
+
+static void soft_timer_unlink(soft_timer_t* p_timer)
+{
+    *p_timer->pprev = p_timer->next;
+
+    if(p_timer->next)
+    {
+        p_timer->next->pprev = p_timer->pprev;
+    }
+
+    p_timer->next = NULL;
+    p_timer->pprev = NULL;
+}
+
+static void soft_timer_insert(soft_timer_t* p_timer)
+{
+    uint32_t delta;
+    uint32_t expires;
+    uint8_t level;
+
+    expires = p_timer->expires;
+    delta = expires - soft_timer_wheel.now;
+
+    /* Already due, run on the next processed tick */
+    if((int32_t) delta < 0)
+    {
+        expires = soft_timer_wheel.now;
+        delta = 0;
+    }
+    else if(delta > SOFT_TIMER_MAX_DELTA)
+    {
+        expires = soft_timer_wheel.now + SOFT_TIMER_MAX_DELTA;
+        delta = SOFT_TIMER_MAX_DELTA;
+    }
+
+    for(level = 0; level < SOFT_TIMER_LEVELS - 1; level++)
+    {
+        if(delta < (1UL << ((level + 1) * SOFT_TIMER_SLOT_BITS)))
+        {
+            break;
+        }
+    }
+
+    soft_timer_link(&soft_timer_wheel.slots[level][SOFT_TIMER_INDEX(expires, level)], p_timer);
+}
+
+/**
+ * @brief Move the timers of a slot to the levels below
+ *
+ * @return uint8_t index of the slot, 0 when the level wrapped as well
+ */
+static uint8_t soft_timer_cascade(uint8_t level)
+{
+    soft_timer_t* p_timer;
+    soft_timer_t* next;
+    uint8_t index;
+
+    index = SOFT_TIMER_INDEX(soft_timer_wheel.now, level);
+    p_timer = soft_timer_wheel.slots[level][index];
+    soft_timer_wheel.slots[level][index] = NULL;
+
+    while(p_timer)
+    {
+        next = p_timer->next;
+        soft_timer_insert(p_timer);
+        p_timer = next;
+    }
+
+    return index;
+}
+
+/**
+ * @brief Expire the timers of the current tick and advance the wheel by one tick
+ *
+ * @return uint32_t number of callbacks run
+ */
+static uint32_t soft_timer_run_tick(void)
+{
+    soft_timer_t* expired;
+    soft_timer_t* p_timer;
+    uint32_t count;
+    uint8_t index;
+    uint8_t level;
+
+    index = SOFT_TIMER_INDEX(soft_timer_wheel.now, 0);
+
+    if(index == 0)
+    {
+        for(level = 1; level < SOFT_TIMER_LEVELS; level++)
+        {
+            if(soft_timer_cascade(level) != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    /* Detached first, callbacks may start or stop any timer including their own */
+    expired = soft_timer_wheel.slots[0][index];
+    soft_timer_wheel.slots[0][index] = NULL;
+
+    if(expired)
+    {
+        expired->pprev = &expired;
+    }
+
+    ++soft_timer_wheel.now;
+    count = 0;
+
+    while(expired)
+    {
+        p_timer = expired;
+        soft_timer_unlink(p_timer);
+
+        /* Periodic timers keep their phase, the period is added to the due tick */
+        if(p_timer->period)
+        {
+            p_timer->expires += p_timer->period;
+            soft_timer_insert(p_timer);
+        }
+
+        p_timer->callback(p_timer, p_timer->arg);
+        ++count;
+    }
+
+    return count;
+}
+
+#if CONFIG_TIMER_TICKLESS
+
+/**
+ * @brief Ticks from the next processed one to the first tick with work, either an
+ * expiry or a cascade bringing timers down
+ *
+ * @return uint32_t SOFT_TIMER_NO_DEADLINE if no timer is active
+ */
+static uint32_t soft_timer_next_deadline(void)
+{
+    uint32_t now;
+    uint32_t span;
+    uint32_t round;
+    uint32_t deadline;
+    uint32_t candidate;
+    uint8_t current;
+    uint8_t index;
+    uint8_t level;
+
+    now = soft_timer_wheel.now;
+    deadline = SOFT_TIMER_NO_DEADLINE;
+
+    for(level = 0; level < SOFT_TIMER_LEVELS; level++)
+    {
+        span = 1UL << (level * SOFT_TIMER_SLOT_BITS);
+        round = now & ~((span << SOFT_TIMER_SLOT_BITS) - 1U);
+        current = SOFT_TIMER_INDEX(now, level);
+        candidate = SOFT_TIMER_NO_DEADLINE;
+
+        /*
+        * The current slot is cascaded by the next processed tick when it starts its
+        * span, otherwise it was already and what remains belongs to the next round,
+        * due when the level wraps at the latest
+        */
+        for(index = 0; index < SOFT_TIMER_SLOTS; index++)
+        {
+            if(!soft_timer_wheel.slots[level][index])
+            {
+                continue;
+            }
+
+            if(index > current || (index == current && (now & (span - 1U)) == 0))
+            {
+                candidate = round + index * span - now;
+                break;
+            }
+
+            candidate = round + (span << SOFT_TIMER_SLOT_BITS) - now;
+        }
+
+        /* A cascade of an upper level may come before the next slot of a lower one */
+        if(candidate < deadline)
+        {
+            deadline = candidate;
+        }
+    }
+
+    return deadline;
+}
+
+/**
+ * @brief Ask the time base to wake up for the tick after the expiry tick
+ */
+static void soft_timer_request_wakeup(uint32_t expires)
+{
+    uint64_t now_ms;
+
+    now_ms = timer_get_milliseconds();
+    now_ms += (int32_t) (expires + 1U - (uint32_t) now_ms);
+
+    timer_tickless_request(now_ms * TIMER_CYCLES_PER_MS);
+}
+
+#else
+
+void soft_timer_tick(void)
+{
+    ++soft_timer_wheel.ticks;
+}
+
+#endif /* CONFIG_TIMER_TICKLESS */
+
+error_t soft_timer_init(soft_timer_t* p_timer, soft_timer_callback_t callback, void* arg)
+{
+    if(!p_timer || !callback)
+    {
+        return FAILED;
+    }
+
+    memset(p_timer, 0, sizeof(soft_timer_t));
+    p_timer->callback = callback;
+    p_timer->arg = arg;
+
+    return OK;
+}
+
+error_t soft_timer_start(soft_timer_t* p_timer, uint32_t timeout_ms, uint32_t period_ms)
+{
+    if(!p_timer || !p_timer->callback)
+    {
+        return FAILED;
+    }
+
+    if(p_timer->pprev)
+    {
+        soft_timer_unlink(p_timer);
+    }
+
+    /* 2^31 ms or more would wrap the signed distance and fire at once */
+    timeout_ms = (timeout_ms > SOFT_TIMER_MAX_MS) ? SOFT_TIMER_MAX_MS : timeout_ms;
+    period_ms = (period_ms > SOFT_TIMER_MAX_MS) ? SOFT_TIMER_MAX_MS : period_ms;
+
+    /* Counted from the latest tick, the wheel itself may lag behind */
+    #if CONFIG_TIMER_TICKLESS
+    p_timer->expires = (uint32_t) timer_get_milliseconds() + timeout_ms;
+    #else
+    p_timer->expires = soft_timer_wheel.ticks + timeout_ms;
+    #endif /* CONFIG_TIMER_TICKLESS */
+    p_timer->period = period_ms;
+    soft_timer_insert(p_timer);
+
+    #if CONFIG_TIMER_TICKLESS
+    soft_timer_request_wakeup(p_timer->expires);
+    #endif /* CONFIG_TIMER_TICKLESS */
+
+    return OK;
+}
+
+error_t soft_timer_stop(soft_timer_t* p_timer)
+{
+    if(!p_timer)
+    {
+        return FAILED;
+    }
+
+    if(p_timer->pprev)
+    {
+        soft_timer_unlink(p_timer);
+    }
+
+    return OK;
+}
+
+uint8_t soft_timer_is_active(const soft_timer_t* p_timer)
+{
+    if(p_timer)
+    {
+        return (p_timer->pprev != NULL);
+    }
+
+    return 0;
+}
+
+uint32_t soft_timer_process(void)
+{
+    uint32_t count;
+    #if CONFIG_TIMER_TICKLESS
+    uint32_t deadline;
+
+    soft_timer_wheel.ticks = (uint32_t) timer_get_milliseconds();
+    #endif /* CONFIG_TIMER_TICKLESS */
+
+    count = 0;
+
+    while(soft_timer_wheel.now != soft_timer_wheel.ticks)
+    {
+        count += soft_timer_run_tick();
+    }
+
+    #if CONFIG_TIMER_TICKLESS
+    /* No interrupt until the next tick with work */
+    deadline = soft_timer_next_deadline();
+
+    if(deadline != SOFT_TIMER_NO_DEADLINE)
+    {
+        soft_timer_request_wakeup(soft_timer_wheel.now + deadline);
+    }
+    #endif /* CONFIG_TIMER_TICKLESS */
+
+    return count;
+}
+
+#endif  /* CONFIG_SOFT_TIMER_USE */
@@ -2,38 +2,247 @@
 #include "timer.h"
 
 #include "TIM_BASIC_hal.h"
+#include "stm32f446xx.h"
 
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
 
+#if CONFIG_TIMER_TICKLESS && CONFIG_OS_FREERTOS_USE
+#include "FreeRTOS.h"
+#include "task.h"
+#endif /* CONFIG_TIMER_TICKLESS && CONFIG_OS_FREERTOS_USE */
+
+#if CONFIG_TIMER_TICKLESS
+
+/*
+* TIM7 counts microseconds and is armed once for the nearest deadline. The longest
+* shot keeps the CYCCNT epoch sampled when nothing is due.
+*/
+#define TIMER_TICKLESS_MAX_US       0xFFFFU
+#define TIMER_TICKLESS_NONE         UINT64_MAX
+
+#endif /* CONFIG_TIMER_TICKLESS */
+
 static struct ms_timer_ctrl_t timer_ctrl;
 
+/**
+ * @brief Only writer of the epoch. Each copy is rewritten in turn, a reader interrupting
+ * the update reads the other one so it never waits on the tick.
+ */
+static void timer_epoch_update(void)
+{
+    uint32_t cycles;
+    uint32_t cycles_high;
+
+    cycles = DWT->CYCCNT;
+    cycles_high = timer_ctrl.epoch[timer_ctrl.seq & 1].cycles_high;
+
+    if(cycles < timer_ctrl.epoch[timer_ctrl.seq & 1].cycles_last)
+    {
+        ++cycles_high;
+    }
+
+    ++timer_ctrl.seq;
+    __DMB();
+    timer_ctrl.epoch[0].cycles_high = cycles_high;
+    timer_ctrl.epoch[0].cycles_last = cycles;
+    __DMB();
+    ++timer_ctrl.seq;
+    __DMB();
+    timer_ctrl.epoch[1].cycles_high = cycles_high;
+    timer_ctrl.epoch[1].cycles_last = cycles;
+    __DMB();
+}
+
+#if CONFIG_TIMER_TICKLESS
+
+/**
+ * @brief Arm TIM7 for the deadline or the longest shot, whichever comes first.
+ * Called with interrupts masked.
+ */
+static void timer_tickless_arm(uint64_t now, uint64_t deadline)
+{
+    uint64_t delay_us;
+
+    delay_us = TIMER_TICKLESS_MAX_US;
+
+    if(deadline <= now)
+    {
+        delay_us = 1;
+    }
+    else if(deadline - now < (uint64_t) TIMER_TICKLESS_MAX_US * TIMER_CYCLES_PER_US)
+    {
+        /* Rounded up, waking up early would need another shot */
+        delay_us = (deadline - now + TIMER_CYCLES_PER_US - 1U) / TIMER_CYCLES_PER_US;
+    }
+
+    timer_ctrl.armed = now + delay_us * TIMER_CYCLES_PER_US;
+    tim_basic_hal_start_once(timer_ctrl.hal_timer, (uint16_t) (delay_us - 1U));
+}
+
+void timer_deadline_reached(tim_basic_hal_context_t* p_timer)
+{
+    uint64_t now;
+
+    (void) p_timer;
+
+    timer_epoch_update();
+    now = timer_get_cycles();
+
+    /* The woken up context requests its next deadline, only longer ones remain */
+    if(timer_ctrl.deadline <= now)
+    {
+        timer_ctrl.deadline = TIMER_TICKLESS_NONE;
+    }
+
+    timer_tickless_arm(now, timer_ctrl.deadline);
+}
+
+void timer_tickless_request(uint64_t deadline_cycles)
+{
+    uint32_t primask;
+
+    if(!timer_ctrl.hal_timer)
+    {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if(deadline_cycles < timer_ctrl.deadline)
+    {
+        timer_ctrl.deadline = deadline_cycles;
+    }
+
+    if(deadline_cycles < timer_ctrl.armed)
+    {
+        timer_tickless_arm(timer_get_cycles(), deadline_cycles);
+    }
+
+    __set_PRIMASK(primask);
+}
+
+error_t timer_wakeup_at_us(uint64_t us)
+{
+    if(!timer_ctrl.hal_timer)
+    {
+        return FAILED;
+    }
+
+    timer_tickless_request(us * TIMER_CYCLES_PER_US);
+
+    return OK;
+}
+
+#if CONFIG_OS_FREERTOS_USE
+
+/* Idle sleep of the kernel, see configUSE_TICKLESS_IDLE */
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+    uint32_t cycles_per_tick;
+    uint32_t elapsed_ticks;
+    uint64_t start;
+    uint64_t elapsed;
+
+    cycles_per_tick = configCPU_CLOCK_HZ / configTICK_RATE_HZ;
+
+    __disable_irq();
+    __DSB();
+    __ISB();
+
+    if(eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        __enable_irq();
+
+        return;
+    }
+
+    /* The part of the current tick already counted by SysTick is carried over */
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    start = timer_get_cycles() - (SysTick->LOAD - SysTick->VAL);
+
+    timer_tickless_request(start + (uint64_t) xExpectedIdleTime * cycles_per_tick);
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    /* Woken up by TIM7 or any other interrupt, still masked until the tick is fixed */
+    elapsed = timer_get_cycles() - start;
+    elapsed_ticks = (uint32_t) (elapsed / cycles_per_tick);
+
+    if(elapsed_ticks >= xExpectedIdleTime)
+    {
+        /* The tick interrupt is due right away */
+        elapsed_ticks = xExpectedIdleTime - 1U;
+        SysTick->LOAD = 1U;
+    }
+    else
+    {
+        SysTick->LOAD = cycles_per_tick - (uint32_t) (elapsed % cycles_per_tick) - 1U;
+    }
+
+    SysTick->VAL = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    vTaskStepTick(elapsed_ticks);
+
+    /* Applied from the next reload on */
+    SysTick->LOAD = cycles_per_tick - 1U;
+
+    __enable_irq();
+}
+
+#endif /* CONFIG_OS_FREERTOS_USE */
+
+#else
+
 void timer_one_millisecond_passed(tim_basic_hal_context_t* p_timer)
 {
     (void) p_timer;
 
-    ++timer_ctrl.milliseconds_elapsed;
+    /* Sampling CYCCNT every tick never misses an overflow */
+    timer_epoch_update();
+
+    #if CONFIG_SOFT_TIMER_USE
+    soft_timer_tick();
+    #endif /* CONFIG_SOFT_TIMER_USE */
 }
 
+#endif /* CONFIG_TIMER_TICKLESS */
+
 error_t timer_time_base_init(void)
 {
     error_t l_ret;
     tim_basic_config_t tim_config;
 
     /* Calculations based on 16MhHz internal clock */
+    #if CONFIG_TIMER_TICKLESS
+    tim_config.prescaler = TIMER_CYCLES_PER_US - 1U;
+    tim_config.reload = TIMER_TICKLESS_MAX_US;
+    tim_config.callback = &timer_deadline_reached;
+    #else
     tim_config.prescaler = 1000;
     tim_config.reload = 15;
     tim_config.callback = &timer_one_millisecond_passed;
+    #endif /* CONFIG_TIMER_TICKLESS */
 
     l_ret = FAILED;
 
-    memset(&timer_ctrl, 0, sizeof(struct ms_timer_ctrl_t));
+    timer_ctrl.hal_timer = NULL;
+
+    timer_cycles_init();
 
     timer_ctrl.hal_timer = tim_basic_hal_init(TIM_BASIC_TIM7, &tim_config);
     if(timer_ctrl.hal_timer)
     {
+        #if CONFIG_TIMER_TICKLESS
+        timer_ctrl.deadline = TIMER_TICKLESS_NONE;
+        timer_tickless_arm(timer_get_cycles(), TIMER_TICKLESS_NONE);
+        #else
         tim_basic_hal_start(timer_ctrl.hal_timer);
+        #endif /* CONFIG_TIMER_TICKLESS */
         l_ret = OK;
     }
 
@@ -42,7 +251,60 @@ error_t timer_time_base_init(void)
 
 uint64_t timer_get_milliseconds(void)
 {
-    return timer_ctrl.milliseconds_elapsed;
+    return timer_get_cycles() / TIMER_CYCLES_PER_MS;
+}
+
+error_t timer_cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    timer_ctrl.seq = 0;
+    memset((void*) timer_ctrl.epoch, 0, sizeof(timer_ctrl.epoch));
+
+    return (DWT->CTRL & DWT_CTRL_NOCYCCNT_Msk) ? FAILED : OK;
+}
+
+uint64_t timer_get_cycles(void)
+{
+    struct timer_epoch_t epoch;
+    uint32_t seq;
+    uint32_t cycles;
+
+    /* Retried only when the tick ran in between, interrupts stay enabled */
+    do
+    {
+        seq = timer_ctrl.seq;
+        __DMB();
+        epoch.cycles_high = timer_ctrl.epoch[seq & 1].cycles_high;
+        epoch.cycles_last = timer_ctrl.epoch[seq & 1].cycles_last;
+        cycles = DWT->CYCCNT;
+        __DMB();
+    } while(seq != timer_ctrl.seq);
+
+    /* CYCCNT wrapped since the last tick */
+    if(cycles < epoch.cycles_last)
+    {
+        ++epoch.cycles_high;
+    }
+
+    return ((uint64_t) epoch.cycles_high << 32) | cycles;
+}
+
+uint64_t timer_cycles_to_us(uint64_t cycles)
+{
+    return cycles / TIMER_CYCLES_PER_US;
+}
+
+uint64_t timer_get_us(void)
+{
+    return timer_cycles_to_us(timer_get_cycles());
+}
+
+uint64_t timer_get_ns(void)
+{
+    return (timer_get_cycles() * 1000U) / TIMER_CYCLES_PER_US;
 }
 
 error_t timer_clear(ms_timer_t* p_timer)
@@ -6,12 +6,41 @@
 
 #include <stdint.h>
 
+/* Core clock, internal 16MHz oscillator */
+#define TIMER_CORE_CLOCK_HZ     16000000U
+
+#define TIMER_CYCLES_PER_US     (TIMER_CORE_CLOCK_HZ / 1000000U)
+
+#define TIMER_CYCLES_PER_MS     (TIMER_CORE_CLOCK_HZ / 1000U)
+
 typedef struct
 {
     uint8_t     started;
     uint64_t    start_milliseconds;
 } ms_timer_t;
 
+/*
+* Longest soft timer timeout and period, about 12.4 days. Expiries are compared as
+* signed 32-bit differences, the margin below 2^31 ms covers soft_timer_process
+* running late.
+*/
+#define SOFT_TIMER_MAX_MS       0x3FFFFFFFUL
+
+typedef struct soft_timer_t soft_timer_t;
+
+typedef void (*soft_timer_callback_t) (soft_timer_t* p_timer, void* arg);
+
+/* Owned by the caller and linked into the timer wheel while active, members are private */
+struct soft_timer_t
+{
+    soft_timer_t*   next;
+    soft_timer_t**  pprev;
+    uint32_t    expires;
+    uint32_t    period;
+    soft_timer_callback_t   callback;
+    void*   arg;
+};
+
 /**
  * @brief 
  * 
@@ -52,10 +81,107 @@ uint64_t timer_elapsed(const ms_timer_t* p_timer);
 uint8_t timer_is_started(const ms_timer_t* p_timer);
 
 /**
- * @brief 
+ * @brief Milliseconds since timer_time_base_init, derived from timer_get_cycles.
  * 
  * @return uint64_t 
  */
 uint64_t timer_get_milliseconds(void);
 
+/**
+ * @brief Enable the DWT cycle counter. Called by timer_time_base_init, whose 
+ * millisecond tick keeps track of the counter overflows.
+ * 
+ * @return error_t 
+ */
+error_t timer_cycles_init(void);
+
+/**
+ * @brief Core clock cycles since timer_cycles_init, DWT CYCCNT extended to 64 bits.
+ * Lock-free, safe from any task or interrupt without masking interrupts. The
+ * millisecond tick must run at least once per CYCCNT period.
+ * 
+ * @return uint64_t 
+ */
+uint64_t timer_get_cycles(void);
+
+/**
+ * @brief 
+ * 
+ * @param cycles 
+ * @return uint64_t cycles converted to microseconds
+ */
+uint64_t timer_cycles_to_us(uint64_t cycles);
+
+/**
+ * @brief Prepare a software timer, needed once before soft_timer_start.
+ * Requires CONFIG_SOFT_TIMER_USE, soft_timer functions must be called from the 
+ * context running soft_timer_process, never from interrupts.
+ * 
+ * @param p_timer 
+ * @param callback run by soft_timer_process when the timer expires
+ * @param arg passed to callback
+ * @return error_t 
+ */
+error_t soft_timer_init(soft_timer_t* p_timer, soft_timer_callback_t callback, void* arg);
+
+/**
+ * @brief Start or restart a timer, O(1) whatever the number of active timers.
+ * Timeout and period are clamped to SOFT_TIMER_MAX_MS.
+ * 
+ * @param p_timer 
+ * @param timeout_ms time to the first expiry, at most SOFT_TIMER_MAX_MS
+ * @param period_ms interval of the following expiries, 0 for a one-shot timer,
+ *        at most SOFT_TIMER_MAX_MS
+ * @return error_t 
+ */
+error_t soft_timer_start(soft_timer_t* p_timer, uint32_t timeout_ms, uint32_t period_ms);
+
+/**
+ * @brief Stop a timer, doing nothing if it is not active
+ * 
+ * @param p_timer 
+ * @return error_t 
+ */
+error_t soft_timer_stop(soft_timer_t* p_timer);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @return uint8_t 1 while the timer waits for its expiry
+ */
+uint8_t soft_timer_is_active(const soft_timer_t* p_timer);
+
+/**
+ * @brief Run the callbacks of expired timers, to be called from the main loop or a
+ * task. Ticks missed since the previous call are caught up in order.
+ * 
+ * @return uint32_t number of callbacks run
+ */
+uint32_t soft_timer_process(void);
+
+/**
+ * @brief Interrupt at the given time to wake up the CPU, with CONFIG_TIMER_TICKLESS.
+ * Allows deadlines finer than a millisecond, nothing else runs at that time. One
+ * wakeup is kept pending, an earlier request replaces a later one.
+ * 
+ * @param us absolute, in timer_get_us units
+ * @return error_t FAILED before timer_time_base_init
+ */
+error_t timer_wakeup_at_us(uint64_t us);
+
+/**
+ * @brief Monotonic microseconds since timer_cycles_init
+ * 
+ * @return uint64_t 
+ */
+uint64_t timer_get_us(void);
+
+/**
+ * @brief Monotonic nanoseconds since timer_cycles_init, in steps of one core clock cycle
+ * 
+ * @return uint64_t 
+ */
+uint64_t timer_get_ns(void);
+
 #endif
\ No newline at end of file
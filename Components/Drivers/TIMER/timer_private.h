@@ -6,10 +6,37 @@
 
 #include <stdint.h>
 
+/* CYCCNT sample taken by the tick and the number of CYCCNT overflows up to it */
+struct timer_epoch_t
+{
+    uint32_t    cycles_high;
+    uint32_t    cycles_last;
+};
+
 struct ms_timer_ctrl_t
 {
-    uint64_t    milliseconds_elapsed;
     tim_basic_hal_context_t*    hal_timer;
+    /* Odd while epoch[0] is written, epoch[seq & 1] is always consistent */
+    volatile uint32_t   seq;
+    volatile struct timer_epoch_t   epoch[2];
+    #if CONFIG_TIMER_TICKLESS
+    /* Earliest requested deadline and time TIM7 is armed for, in cycles */
+    uint64_t    deadline;
+    uint64_t    armed;
+    #endif /* CONFIG_TIMER_TICKLESS */
 };
 
+/**
+ * @brief Millisecond tick of the software timers, called from the TIM7 interrupt
+ */
+void soft_timer_tick(void);
+
+/**
+ * @brief Have the tickless time base interrupt at the deadline, unless an earlier one
+ * is already pending. A single interrupt serves all requests up to it.
+ * 
+ * @param deadline_cycles absolute, in timer_get_cycles units
+ */
+void timer_tickless_request(uint64_t deadline_cycles);
+
 #endif
\ No newline at end of file
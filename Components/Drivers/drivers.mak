@@ -20,11 +20,62 @@ DRIVERS_DEFINES := CONFIG_SERIAL_PORTS_USE='0'
 
 endif #CONFIG_SERIAL_PORTS_USE
 
+ifdef CONFIG_GPIO_WAVE_USE
+DRIVERS_DEFINES += CONFIG_GPIO_WAVE_USE='1'
+DRIVERS_DEFINES += CONFIG_GPIO_WAVE_TIMER=$(CONFIG_GPIO_WAVE_TIMER)
+else
+DRIVERS_DEFINES += CONFIG_GPIO_WAVE_USE='0'
+endif #CONFIG_GPIO_WAVE_USE
+
+ifdef CONFIG_GPIO_CAPTURE_USE
+DRIVERS_DEFINES += CONFIG_GPIO_CAPTURE_USE='1'
+DRIVERS_DEFINES += CONFIG_GPIO_CAPTURE_TIMER=$(CONFIG_GPIO_CAPTURE_TIMER)
+else
+DRIVERS_DEFINES += CONFIG_GPIO_CAPTURE_USE='0'
+endif #CONFIG_GPIO_CAPTURE_USE
+
+ifdef CONFIG_GPIO_EVENT_USE
+DRIVERS_DEFINES += CONFIG_GPIO_EVENT_USE='1'
+DRIVERS_DEFINES += CONFIG_GPIO_EVENT_QUEUE_SIZE=$(CONFIG_GPIO_EVENT_QUEUE_SIZE)
+else
+DRIVERS_DEFINES += CONFIG_GPIO_EVENT_USE='0'
+endif #CONFIG_GPIO_EVENT_USE
+
+ifdef CONFIG_GPIO_STORM_GUARD
+DRIVERS_DEFINES += CONFIG_GPIO_STORM_GUARD='1'
+DRIVERS_DEFINES += CONFIG_GPIO_STORM_MAX_EDGES=$(CONFIG_GPIO_STORM_MAX_EDGES)
+DRIVERS_DEFINES += CONFIG_GPIO_STORM_WINDOW_MS=$(CONFIG_GPIO_STORM_WINDOW_MS)
+DRIVERS_DEFINES += CONFIG_GPIO_STORM_BACKOFF_MS=$(CONFIG_GPIO_STORM_BACKOFF_MS)
+else
+DRIVERS_DEFINES += CONFIG_GPIO_STORM_GUARD='0'
+endif #CONFIG_GPIO_STORM_GUARD
+
+ifdef CONFIG_SOFT_TIMER_USE
+DRIVERS_DEFINES += CONFIG_SOFT_TIMER_USE='1'
+else
+DRIVERS_DEFINES += CONFIG_SOFT_TIMER_USE='0'
+endif #CONFIG_SOFT_TIMER_USE
+
+ifdef CONFIG_TIMER_TICKLESS
+DRIVERS_DEFINES += CONFIG_TIMER_TICKLESS='1'
+else
+DRIVERS_DEFINES += CONFIG_TIMER_TICKLESS='0'
+endif #CONFIG_TIMER_TICKLESS
+
 ifdef CONFIG_ENABLE_LOG
 DRIVERS_SRCDIRS += $(COMPONENT_PATH)/Log
 DRIVERS_INCDIRS += $(COMPONENT_PATH)/Log
 DRIVERS_DEFINES += CONFIG_ENABLE_LOG='1'
 DRIVERS_DEFINES += CONFIG_LOG_DEFAULT_LEVEL=$(CONFIG_LOG_DEFAULT_LEVEL)
+DRIVERS_DEFINES += CONFIG_LOG_TIMESTAMP_SOURCE=$(CONFIG_LOG_TIMESTAMP_SOURCE)
+
+ifdef CONFIG_LOG_RUNTIME_LEVELS
+DRIVERS_DEFINES += CONFIG_LOG_RUNTIME_LEVELS='1'
+DRIVERS_DEFINES += CONFIG_LOG_MAXIMUM_LEVEL=$(CONFIG_LOG_MAXIMUM_LEVEL)
+DRIVERS_DEFINES += CONFIG_LOG_TAG_TABLE_SIZE=$(CONFIG_LOG_TAG_TABLE_SIZE)
+else
+DRIVERS_DEFINES += CONFIG_LOG_RUNTIME_LEVELS='0'
+endif #CONFIG_LOG_RUNTIME_LEVELS
 
 ifdef CONFIG_LOG_COLORS
 DRIVERS_DEFINES += CONFIG_LOG_COLORS='1'
@@ -32,6 +83,37 @@ else
 DRIVERS_DEFINES += CONFIG_LOG_COLORS='0'
 endif #CONFIG_LOG_COLORS
 
+ifdef CONFIG_LOG_BINARY
+DRIVERS_DEFINES += CONFIG_LOG_BINARY='1'
+DRIVERS_DEFINES += CONFIG_LOG_BINARY_BUFFERSIZE=$(CONFIG_LOG_BINARY_BUFFERSIZE)
+else
+DRIVERS_DEFINES += CONFIG_LOG_BINARY='0'
+endif #CONFIG_LOG_BINARY
+
+ifdef CONFIG_LOG_ASYNC
+DRIVERS_DEFINES += CONFIG_LOG_ASYNC='1'
+DRIVERS_DEFINES += CONFIG_LOG_ASYNC_BUFFERSIZE=$(CONFIG_LOG_ASYNC_BUFFERSIZE)
+else
+DRIVERS_DEFINES += CONFIG_LOG_ASYNC='0'
+endif #CONFIG_LOG_ASYNC
+
+ifdef CONFIG_LOG_FLASH
+DRIVERS_DEFINES += CONFIG_LOG_FLASH='1'
+DRIVERS_DEFINES += CONFIG_LOG_FLASH_FIRST_SECTOR=$(CONFIG_LOG_FLASH_FIRST_SECTOR)
+DRIVERS_DEFINES += CONFIG_LOG_FLASH_SECTORS=$(CONFIG_LOG_FLASH_SECTORS)
+DRIVERS_DEFINES += CONFIG_LOG_FLASH_BATCH_SIZE=$(CONFIG_LOG_FLASH_BATCH_SIZE)
+else
+DRIVERS_DEFINES += CONFIG_LOG_FLASH='0'
+endif #CONFIG_LOG_FLASH
+
+ifdef CONFIG_LOG_ROUTER
+DRIVERS_DEFINES += CONFIG_LOG_ROUTER='1'
+DRIVERS_DEFINES += CONFIG_LOG_ROUTER_SINKS=$(CONFIG_LOG_ROUTER_SINKS)
+DRIVERS_DEFINES += CONFIG_LOG_RAM_BUFFERSIZE=$(CONFIG_LOG_RAM_BUFFERSIZE)
+else
+DRIVERS_DEFINES += CONFIG_LOG_ROUTER='0'
+endif #CONFIG_LOG_ROUTER
+
 else
 DRIVERS_DEFINES += CONFIG_ENABLE_LOG='0'
 
@@ -23,6 +23,14 @@
 #define DMA_IS_WORD_ALIGNED(_addr)  (((_addr) & 0x03) == 0)
 #define DMA_IS_HWORD_ALIGNED(_addr) (((_addr) & 0x01) == 0)
 
+/*
+* Reads of SxCR.EN after a disable request, a poll count rather than a time.
+* Each read is an AHB access plus the loop, roughly 10 HCLK cycles, so the
+* bound is about 0.5ms at 180MHz and longer at lower clocks. A stream releases
+* after its current burst (at most 16 beats), well inside either figure.
+*/
+#define DMA_HAL_DISABLE_TIMEOUT     10000U
+
 /* PRIVATE VARIABLES */
 
 static dma_hal_context_t hdma[DMA_LL_DEVS * DMA_STREAM_MAX];
@@ -30,6 +38,11 @@ static dma_hal_context_t hdma[DMA_LL_DEVS * DMA_STREAM_MAX];
 /* PRIVATE FUNCTIONS DECLARATION */
 
 static error_t dma_hal_check_config(dma_hal_context_t* dma);
+static error_t dma_hal_wait_for_disable(dma_hal_context_t* dma);
+static void dma_hal_apply_config(dma_hal_context_t* dma);
+static error_t dma_hal_apply_transfer(dma_hal_context_t* dma, 
+            uint32_t src_addr, uint32_t dest_addr, uint16_t len);
+static error_t dma_hal_finish_reconfig(dma_hal_context_t* dma);
 
 /* PUBLIC FUNCTIONS DEFINITION */
 
@@ -114,10 +127,23 @@ dma_hal_context_t* dma_hal_init(uint8_t dma_instance, uint8_t stream)
     DMA_HAL_GET_HW(dma, dma_instance);
     ASSERT(dma->dev);
     dma->stream = stream;
+    dma->state = DMA_STATE_READY;
 
     return dma;
 }
 
+dma_hal_context_t* dma_hal_get_claimed(uint8_t dma_instance, uint8_t stream)
+{
+    dma_hal_context_t* dma;
+
+    ASSERT(DMA_IS_INSTANCE(dma_instance));
+    ASSERT(DMA_IS_STREAM(stream));
+
+    dma = DMA_GET_HDMA(dma_instance, stream);
+
+    return (dma->state != DMA_STATE_RESET) ? dma : NULL;
+}
+
 error_t dma_hal_stream_init(dma_hal_context_t* dma)
 {
     dma_init_t* dma_config;
@@ -136,147 +162,88 @@ error_t dma_hal_stream_init(dma_hal_context_t* dma)
 
     dma_ll_disable_stream(dma->dev, dma->stream);
 
-    while(dma_ll_is_stream_enabled(dma->dev, dma->stream))
+    if(dma_hal_wait_for_disable(dma) != OK)
     {
-
+        return FAILED;
     }
 
-    dma_ll_set_channel(dma->dev, dma->stream, dma_config->channel);
-    dma_ll_set_priority(dma->dev, dma->stream, dma_config->priority);
-    dma_ll_set_periph_transfer_size(dma->dev, dma->stream, dma_config->periph_data_size);
+    dma_hal_apply_config(dma);
 
-    if(dma_config->mode & DMA_FIFO)
-    {
-        dma_ll_set_mem_transfer_size(dma->dev, dma->stream, dma_config->mem_data_size);
-    }
-    
-    if(dma_config->mem_increment)
-    {
-        dma_ll_enable_mem_inc(dma->dev, dma->stream);
-    }
-    else
-    {
-        dma_ll_disable_mem_inc(dma->dev, dma->stream);
-    }
+    return OK;
+}
 
-    if(dma_config->periph_increment)
-    {
-        dma_ll_enable_periph_inc(dma->dev, dma->stream);
-    }
-    else
-    {
-        dma_ll_disable_periph_inc(dma->dev, dma->stream);
-    }
+error_t dma_hal_set_transfer(dma_hal_context_t* dma, 
+            uint32_t src_addr, uint32_t dest_addr, uint16_t len)
+{
+    ASSERT(dma);
+    ASSERT(DMA_IS_STREAM(dma->stream));
 
-    if(dma_config->mode & DMA_NORMAL)
-    {
-        dma_ll_enable_direct_mode(dma->dev, dma->stream);
-    }
-    else
-    {
-        dma_ll_disable_direct_mode(dma->dev, dma->stream);
-    }
-    
-    if(dma_config->mode & DMA_CIRC)
-    {
-        dma_ll_enable_circular_mode(dma->dev, dma->stream);
-    }
-    else
+    /* The stream interrupt still has to program the pending transfer */
+    if(dma->state == DMA_STATE_RECONFIG_PENDING)
     {
-        dma_ll_disable_circular_mode(dma->dev, dma->stream);
+        return FAILED;
     }
 
-    if(dma_config->dbm_enable)
-    {
-        dma_ll_enable_double_buffer(dma->dev, dma->stream);
-    }
-    else
+    if(dma_hal_wait_for_disable(dma) != OK)
     {
-        dma_ll_disable_double_buffer(dma->dev, dma->stream);
+        return FAILED;
     }
 
-    dma_ll_set_direction(dma->dev, dma->stream, dma_config->dir);
-
-    dma_ll_clear_flags(dma->dev, dma->stream);
-
-    dma->error_code = DMA_ERROR_NONE;
-
-    return OK;
+    return dma_hal_apply_transfer(dma, src_addr, dest_addr, len);
 }
 
-error_t dma_hal_set_transfer(dma_hal_context_t* dma, 
-            uint32_t src_addr, uint32_t dest_addr, uint16_t len)
+error_t dma_hal_reconfigure_async(dma_hal_context_t* dma, 
+            uint32_t src_addr, uint32_t dest_addr, uint16_t len, uint8_t flags)
 {
-    dma_init_t* dma_config;
+    uint32_t primask;
+    error_t ret = OK;
 
     ASSERT(dma);
     ASSERT(DMA_IS_STREAM(dma->stream));
 
-    dma_config = &dma->dma_config;
+    primask = __get_PRIMASK();
+    __disable_irq();
 
-    while(dma_ll_is_stream_enabled(dma->dev, dma->stream))
+    if(dma->state == DMA_STATE_RECONFIG_PENDING)
     {
+        __set_PRIMASK(primask);
 
+        return FAILED;
     }
 
+    dma->reconfig.src_addr = src_addr;
+    dma->reconfig.dest_addr = dest_addr;
+    dma->reconfig.len = len;
+    dma->reconfig.flags = flags;
+    dma->state = DMA_STATE_RECONFIG_PENDING;
+
     /*
-    * TODO: Disable DBM mode
+    * A completed transfer whose TC is still unserviced is left to the ISR
+    * so its completion callback is not lost
     */
-
-    if(dma_config->dir == DMA_PERIPH_TO_MEM)
+    if(dma_ll_is_stream_enabled(dma->dev, dma->stream) || 
+        (dma_ll_get_transfer_complete_flag(dma->dev, dma->stream) && 
+            dma_ll_is_transfer_complete_it_enabled(dma->dev, dma->stream)))
     {
-        if(dma_config->periph_data_size == DMA_PERIPH_SIZE_WORD)
-        {
-            ASSERT(DMA_IS_WORD_ALIGNED(src_addr));
-        }
-        else if(dma_config->periph_data_size == DMA_PERIPH_SIZE_HALF_WORD)
-        {
-            ASSERT(DMA_IS_HWORD_ALIGNED(src_addr));
-        }
-
-        if(dma_config->mem_data_size == DMA_MEM_SIZE_WORD)
-        {
-            ASSERT(DMA_IS_WORD_ALIGNED(dest_addr));
-        }
-        else if(dma_config->mem_data_size == DMA_MEM_SIZE_HALF_WORD)
-        {
-            ASSERT(DMA_IS_HWORD_ALIGNED(dest_addr));
-        }
-
-        dma_ll_set_periph_addr(dma->dev, dma->stream, src_addr);
-        dma_ll_set_mem_addr_0(dma->dev, dma->stream, dest_addr);
-    }
-    else if(dma_config->dir == DMA_MEM_TO_PERIPH)
-    {
-        if(dma_config->periph_data_size == DMA_PERIPH_SIZE_WORD)
-        {
-            ASSERT(DMA_IS_WORD_ALIGNED(dest_addr));
-        }
-        else if(dma_config->periph_data_size == DMA_PERIPH_SIZE_HALF_WORD)
-        {
-            ASSERT(DMA_IS_HWORD_ALIGNED(dest_addr));
-        }
-
-        if(dma_config->mem_data_size == DMA_MEM_SIZE_WORD)
-        {
-            ASSERT(DMA_IS_WORD_ALIGNED(src_addr));
-        }
-        else if(dma_config->mem_data_size == DMA_MEM_SIZE_HALF_WORD)
-        {
-            ASSERT(DMA_IS_HWORD_ALIGNED(src_addr));
-        }
-
-        dma_ll_set_periph_addr(dma->dev, dma->stream, dest_addr);
-        dma_ll_set_mem_addr_0(dma->dev, dma->stream, src_addr);
+        /* Hardware sets TCIF once the stream is released after EN is cleared */
+        dma_ll_enable_complete_transfer_it(dma->dev, dma->stream);
+        dma_ll_disable_stream(dma->dev, dma->stream);
     }
     else
     {
-        return FAILED;
+        ret = dma_hal_finish_reconfig(dma);
     }
 
-    dma_ll_set_number_of_transfers(dma->dev, dma->stream, len);
+    __set_PRIMASK(primask);
 
-    return OK;
+    return ret;
+}
+
+uint8_t dma_hal_is_reconfig_pending(dma_hal_context_t* dma)
+{
+    ASSERT(dma);
+
+    return dma->state == DMA_STATE_RECONFIG_PENDING;
 }
 
 error_t dma_hal_start(dma_hal_context_t* dma)
@@ -287,6 +254,7 @@ error_t dma_hal_start(dma_hal_context_t* dma)
     dma->error_code = DMA_ERROR_NONE;
 
     dma_ll_clear_flags(dma->dev, dma->stream);
+    dma->state = DMA_STATE_BUSY;
     dma_ll_enable_stream(dma->dev, dma->stream);
 
     return OK;
@@ -310,6 +278,7 @@ error_t dma_hal_start_it(dma_hal_context_t* dma)
         dma_ll_enable_half_transfer_it(dma->dev, dma->stream);
     }
 
+    dma->state = DMA_STATE_BUSY;
     dma_ll_enable_stream(dma->dev, dma->stream);
 
     return OK;
@@ -391,14 +360,16 @@ error_t dma_hal_abort(dma_hal_context_t* dma)
     ASSERT(DMA_IS_STREAM(dma->stream));
 
     dma_ll_disable_stream(dma->dev, dma->stream);
-    while(dma_ll_is_stream_enabled(dma->dev, dma->stream))
-    {
 
+    if(dma_hal_wait_for_disable(dma) != OK)
+    {
+        return FAILED;
     }
 
     dma->remaining = dma_ll_get_remaining_items(dma->dev, dma->stream);
 
     dma_ll_clear_flags(dma->dev, dma->stream);
+    dma->state = DMA_STATE_READY;
 
     return OK;
 }
@@ -413,6 +384,7 @@ error_t dma_hal_abort_from_isr(dma_hal_context_t* dma)
     dma->remaining = dma_ll_get_remaining_items(dma->dev, dma->stream);
 
     dma_ll_clear_flags(dma->dev, dma->stream);
+    dma->state = DMA_STATE_READY;
 
     return OK;
 }
@@ -455,6 +427,190 @@ static error_t dma_hal_check_config(dma_hal_context_t* dma)
     return ret;
 }
 
+static error_t dma_hal_wait_for_disable(dma_hal_context_t* dma)
+{
+    uint32_t timeout = DMA_HAL_DISABLE_TIMEOUT;
+
+    while(dma_ll_is_stream_enabled(dma->dev, dma->stream))
+    {
+        if(timeout-- == 0)
+        {
+            dma->error_code |= DMA_ERROR_TIMEOUT;
+
+            return FAILED;
+        }
+    }
+
+    return OK;
+}
+
+static void dma_hal_apply_config(dma_hal_context_t* dma)
+{
+    dma_init_t* dma_config = &dma->dma_config;
+
+    dma_ll_set_channel(dma->dev, dma->stream, dma_config->channel);
+    dma_ll_set_priority(dma->dev, dma->stream, dma_config->priority);
+    dma_ll_set_periph_transfer_size(dma->dev, dma->stream, dma_config->periph_data_size);
+
+    if(dma_config->mode & DMA_FIFO)
+    {
+        dma_ll_set_mem_transfer_size(dma->dev, dma->stream, dma_config->mem_data_size);
+    }
+    
+    if(dma_config->mem_increment)
+    {
+        dma_ll_enable_mem_inc(dma->dev, dma->stream);
+    }
+    else
+    {
+        dma_ll_disable_mem_inc(dma->dev, dma->stream);
+    }
+
+    if(dma_config->periph_increment)
+    {
+        dma_ll_enable_periph_inc(dma->dev, dma->stream);
+    }
+    else
+    {
+        dma_ll_disable_periph_inc(dma->dev, dma->stream);
+    }
+
+    if(dma_config->mode & DMA_NORMAL)
+    {
+        dma_ll_enable_direct_mode(dma->dev, dma->stream);
+    }
+    else
+    {
+        dma_ll_disable_direct_mode(dma->dev, dma->stream);
+    }
+    
+    if(dma_config->mode & DMA_CIRC)
+    {
+        dma_ll_enable_circular_mode(dma->dev, dma->stream);
+    }
+    else
+    {
+        dma_ll_disable_circular_mode(dma->dev, dma->stream);
+    }
+
+    if(dma_config->dbm_enable)
+    {
+        dma_ll_enable_double_buffer(dma->dev, dma->stream);
+    }
+    else
+    {
+        dma_ll_disable_double_buffer(dma->dev, dma->stream);
+    }
+
+    dma_ll_set_direction(dma->dev, dma->stream, dma_config->dir);
+
+    dma_ll_clear_flags(dma->dev, dma->stream);
+
+    dma->error_code = DMA_ERROR_NONE;
+}
+
+static error_t dma_hal_apply_transfer(dma_hal_context_t* dma, 
+            uint32_t src_addr, uint32_t dest_addr, uint16_t len)
+{
+    dma_init_t* dma_config = &dma->dma_config;
+
+    /*
+    * TODO: Disable DBM mode
+    */
+
+    if(dma_config->dir == DMA_PERIPH_TO_MEM)
+    {
+        if(dma_config->periph_data_size == DMA_PERIPH_SIZE_WORD)
+        {
+            ASSERT(DMA_IS_WORD_ALIGNED(src_addr));
+        }
+        else if(dma_config->periph_data_size == DMA_PERIPH_SIZE_HALF_WORD)
+        {
+            ASSERT(DMA_IS_HWORD_ALIGNED(src_addr));
+        }
+
+        if(dma_config->mem_data_size == DMA_MEM_SIZE_WORD)
+        {
+            ASSERT(DMA_IS_WORD_ALIGNED(dest_addr));
+        }
+        else if(dma_config->mem_data_size == DMA_MEM_SIZE_HALF_WORD)
+        {
+            ASSERT(DMA_IS_HWORD_ALIGNED(dest_addr));
+        }
+
+        dma_ll_set_periph_addr(dma->dev, dma->stream, src_addr);
+        dma_ll_set_mem_addr_0(dma->dev, dma->stream, dest_addr);
+    }
+    else if(dma_config->dir == DMA_MEM_TO_PERIPH)
+    {
+        if(dma_config->periph_data_size == DMA_PERIPH_SIZE_WORD)
+        {
+            ASSERT(DMA_IS_WORD_ALIGNED(dest_addr));
+        }
+        else if(dma_config->periph_data_size == DMA_PERIPH_SIZE_HALF_WORD)
+        {
+            ASSERT(DMA_IS_HWORD_ALIGNED(dest_addr));
+        }
+
+        if(dma_config->mem_data_size == DMA_MEM_SIZE_WORD)
+        {
+            ASSERT(DMA_IS_WORD_ALIGNED(src_addr));
+        }
+        else if(dma_config->mem_data_size == DMA_MEM_SIZE_HALF_WORD)
+        {
+            ASSERT(DMA_IS_HWORD_ALIGNED(src_addr));
+        }
+
+        dma_ll_set_periph_addr(dma->dev, dma->stream, dest_addr);
+        dma_ll_set_mem_addr_0(dma->dev, dma->stream, src_addr);
+    }
+    else
+    {
+        return FAILED;
+    }
+
+    dma_ll_set_number_of_transfers(dma->dev, dma->stream, len);
+
+    return OK;
+}
+
+static error_t dma_hal_finish_reconfig(dma_hal_context_t* dma)
+{
+    dma_reconfig_t* reconfig = &dma->reconfig;
+    error_t ret;
+
+    /* Stream is released here, so neither path below can spin */
+    dma->remaining = dma_ll_get_remaining_items(dma->dev, dma->stream);
+    dma_ll_disable_complete_transfer_it(dma->dev, dma->stream);
+    dma_ll_disable_transfer_error_it(dma->dev, dma->stream);
+    dma_ll_disable_direct_mode_error_it(dma->dev, dma->stream);
+    dma_ll_disable_fifo_error_it(dma->dev, dma->stream);
+    dma_ll_disable_half_transfer_it(dma->dev, dma->stream);
+    dma_ll_clear_flags(dma->dev, dma->stream);
+
+    dma->state = DMA_STATE_READY;
+
+    if(reconfig->flags & DMA_RECONFIG_STREAM)
+    {
+        dma_hal_apply_config(dma);
+    }
+
+    ret = dma_hal_apply_transfer(dma, reconfig->src_addr, 
+                reconfig->dest_addr, reconfig->len);
+
+    if(ret == OK && (reconfig->flags & DMA_RECONFIG_START_IT))
+    {
+        dma_hal_start_it(dma);
+    }
+
+    if(dma->reconfig_callback)
+    {
+        dma->reconfig_callback(dma);
+    }
+
+    return ret;
+}
+
 WEAK void dma_irq_handler(dma_hal_context_t* dma)
 {
     /* TEI*/
@@ -506,7 +662,19 @@ WEAK void dma_irq_handler(dma_hal_context_t* dma)
 
     if(dma_ll_get_transfer_complete_flag(dma->dev, dma->stream))
     {
-        if(dma_ll_is_transfer_complete_it_enabled(dma->dev, dma->stream))
+        if(dma->state == DMA_STATE_RECONFIG_PENDING && 
+                    !dma_ll_is_stream_enabled(dma->dev, dma->stream))
+        {
+            /* Transfer ran to the end before the disable took effect */
+            if(dma_ll_get_remaining_items(dma->dev, dma->stream) == 0 && 
+                    dma->xfer_complete_callback)
+            {
+                dma->xfer_complete_callback(dma);
+            }
+
+            dma_hal_finish_reconfig(dma);
+        }
+        else if(dma_ll_is_transfer_complete_it_enabled(dma->dev, dma->stream))
         {
             if((dma->dma_config.mode & DMA_CIRC) == 0)
             {
@@ -515,6 +683,7 @@ WEAK void dma_irq_handler(dma_hal_context_t* dma)
                 dma_ll_disable_direct_mode_error_it(dma->dev, dma->stream);
                 dma_ll_disable_fifo_error_it(dma->dev, dma->stream);
                 dma_ll_disable_half_transfer_it(dma->dev, dma->stream);
+                dma->state = DMA_STATE_READY;
             }
 
             dma_ll_clear_transfer_complete_flag(dma->dev, dma->stream);
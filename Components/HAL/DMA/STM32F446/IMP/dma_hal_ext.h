@@ -21,6 +21,17 @@
  */
 dma_hal_context_t* dma_hal_init(uint8_t dma_instance, uint8_t stream);
 
+/**
+ * @brief Context of a stream already handed out by dma_hal_init, its parent tells
+ * which driver owns it. dma_hal_init does not check it, a driver sharing streams
+ * with others looks it up first.
+ * 
+ * @param dma_instance 
+ * @param stream 
+ * @return dma_hal_context_t* NULL if dma_hal_init was never called for the stream
+ */
+dma_hal_context_t* dma_hal_get_claimed(uint8_t dma_instance, uint8_t stream);
+
 /**
  * @brief Init DMA and set configuration parameters
  * 
@@ -36,11 +47,40 @@ error_t dma_hal_stream_init(dma_hal_context_t* dma);
  * @param src_addr 
  * @param dest_addr 
  * @param len 
- * @return error_t 
+ * @note  Spins while the stream is still enabled, for at most DMA_HAL_DISABLE_TIMEOUT
+ *        reads of EN. Drivers re-arming from an interrupt use dma_hal_reconfigure_async.
+ * @return error_t FAILED with DMA_ERROR_TIMEOUT if the stream is still enabled,
+ *         FAILED while a dma_hal_reconfigure_async is pending
  */
 error_t dma_hal_set_transfer(dma_hal_context_t* dma, 
             uint32_t src_addr, uint32_t dest_addr, uint16_t len);
 
+/**
+ * @brief Reprogram a stream without waiting for it to stop.
+ * 
+ * If the stream is idle the transfer is applied immediately. Otherwise a
+ * disable is requested and the reprogramming is finished from the stream
+ * interrupt once the hardware releases the stream, then reconfig_callback
+ * is called.
+ * 
+ * @param dma 
+ * @param src_addr 
+ * @param dest_addr 
+ * @param len 
+ * @param flags DMA_RECONFIG_STREAM and/or DMA_RECONFIG_START_IT
+ * @return error_t FAILED if a reconfiguration is already pending
+ */
+error_t dma_hal_reconfigure_async(dma_hal_context_t* dma, 
+            uint32_t src_addr, uint32_t dest_addr, uint16_t len, uint8_t flags);
+
+/**
+ * @brief 
+ * 
+ * @param dma 
+ * @return uint8_t 1 if an asynchronous reconfiguration is still pending
+ */
+uint8_t dma_hal_is_reconfig_pending(dma_hal_context_t* dma);
+
 /**
  * @brief Start DMA transfer in polling mode
  * 
@@ -97,6 +97,26 @@ typedef enum
 #define DMA_ERROR_TE            0x00000001
 #define DMA_ERROR_DME           0x00000002
 #define DMA_ERROR_FE            0x00000004
+#define DMA_ERROR_TIMEOUT       0x00000008
+
+typedef enum
+{
+    DMA_STATE_RESET,
+    DMA_STATE_READY,
+    DMA_STATE_BUSY,
+    DMA_STATE_RECONFIG_PENDING
+} dma_state_t;
+
+#define DMA_RECONFIG_STREAM     0x01    /* Re-apply dma_config before setting the transfer */
+#define DMA_RECONFIG_START_IT   0x02    /* Start the stream in interrupt mode once reprogrammed */
+
+typedef struct
+{
+    uint32_t src_addr;
+    uint32_t dest_addr;
+    uint16_t len;
+    uint8_t flags;
+} dma_reconfig_t;
 
 typedef struct 
 {
@@ -119,10 +139,12 @@ typedef struct s_dma_hal_context_t
     uint32_t state;
     uint16_t remaining;
     uint8_t stream;
+    dma_reconfig_t reconfig;
     void* parent;
     void (*error_callback) (struct s_dma_hal_context_t*);
     void (*xfer_half_callback) (struct s_dma_hal_context_t*);
     void (*xfer_complete_callback) (struct s_dma_hal_context_t*);
+    void (*reconfig_callback) (struct s_dma_hal_context_t*);
 }dma_hal_context_t;
 
 #endif
\ No newline at end of file
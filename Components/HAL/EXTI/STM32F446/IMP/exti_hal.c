@@ -11,21 +11,83 @@
 #define EXTI_IS_LINE(_line)         ((_line) < EXTI_MAX_LINES)
 #define EXTI_IS_PIN(_line)          ((_line) <= EXTI_LINE_15)
 #define EXTI_IS_PORT(_port)         ((_port) < EXTI_MAX_PORTS)
-
-#define EXTI_IS_EXTI9_5_CLEAR(_exti_lines)      (((_exti_lines) & (EXTI_BIT(EXTI_LINE_5) \
-                                                        | EXTI_BIT(EXTI_LINE_6) \
-                                                        | EXTI_BIT(EXTI_LINE_7) \
-                                                        | EXTI_BIT(EXTI_LINE_8) \
-                                                        | EXTI_BIT(EXTI_LINE_9))) == 0X00)
-
-#define EXTI_IS_EXTI15_10_CLEAR(_exti_lines)    (((_exti_lines) & (EXTI_BIT(EXTI_LINE_10) \
-                                                        | EXTI_BIT(EXTI_LINE_11) \
-                                                        | EXTI_BIT(EXTI_LINE_12) \
-                                                        | EXTI_BIT(EXTI_LINE_13) \
-                                                        | EXTI_BIT(EXTI_LINE_14) \
-                                                        | EXTI_BIT(EXTI_LINE_15))) == 0X00)
-
-static exti_hal_irq_callback_t callback_ptrs[EXTI_IRQ_LINES];
+#define EXTI_IS_MASK(_mask)         (((_mask) >> EXTI_MAX_LINES) == 0x00)
+#define EXTI_IS_PIN_MASK(_mask)     (((_mask) >> (EXTI_LINE_15 + 1)) == 0x00)
+
+/* Lines sharing an NVIC interrupt line */
+#define EXTI9_5_LINES               0x000003E0UL
+#define EXTI15_10_LINES             0x0000FC00UL
+
+typedef struct
+{
+    IRQn_Type   irqn;
+    uint32_t    lines;              /* All lines served by irqn */
+} exti_hal_irq_t;
+
+typedef struct
+{
+    exti_hal_irq_callback_t callback;
+    void*       arg;
+} exti_hal_line_callback_t;
+
+/* NVIC interrupt line of each GPIO EXTI line */
+static const exti_hal_irq_t exti_irqs[EXTI_IRQ_LINES] = {
+    {EXTI0_IRQn, EXTI_BIT(EXTI_LINE_0)},
+    {EXTI1_IRQn, EXTI_BIT(EXTI_LINE_1)},
+    {EXTI2_IRQn, EXTI_BIT(EXTI_LINE_2)},
+    {EXTI3_IRQn, EXTI_BIT(EXTI_LINE_3)},
+    {EXTI4_IRQn, EXTI_BIT(EXTI_LINE_4)},
+    {EXTI9_5_IRQn, EXTI9_5_LINES},
+    {EXTI9_5_IRQn, EXTI9_5_LINES},
+    {EXTI9_5_IRQn, EXTI9_5_LINES},
+    {EXTI9_5_IRQn, EXTI9_5_LINES},
+    {EXTI9_5_IRQn, EXTI9_5_LINES},
+    {EXTI15_10_IRQn, EXTI15_10_LINES},
+    {EXTI15_10_IRQn, EXTI15_10_LINES},
+    {EXTI15_10_IRQn, EXTI15_10_LINES},
+    {EXTI15_10_IRQn, EXTI15_10_LINES},
+    {EXTI15_10_IRQn, EXTI15_10_LINES},
+    {EXTI15_10_IRQn, EXTI15_10_LINES}
+};
+
+static exti_hal_line_callback_t callbacks[EXTI_IRQ_LINES];
+
+static void exti_hal_enable_irq(IRQn_Type exti)
+{
+    NVIC_ClearPendingIRQ(exti);
+    NVIC_EnableIRQ(exti);
+}
+
+/**
+ * @brief Serve all pending lines of an NVIC interrupt line in one entry. The lines
+ * are cleared with one write before their callbacks run, an edge during a callback
+ * pends its line again. Lines with no callback are cleared too. A masked line still
+ * pends on its edges, it is left pending and not served when a sibling line fires.
+ * 
+ * @param lines lines served by the interrupt
+ */
+static void exti_hal_dispatch(uint32_t lines)
+{
+    exti_dev_t dev;
+    uint32_t pending;
+    uint32_t line;
+
+    dev = EXTI_LL_GET_HW(EXTI);
+
+    pending = exti_ll_get_pending(dev) & exti_ll_get_interrupt_mask(dev) & lines;
+    exti_ll_clear_pending_mask(dev, pending);
+
+    while(pending)
+    {
+        line = 31UL - __CLZ(pending);
+        pending &= ~EXTI_BIT(line);
+
+        if(callbacks[line].callback)
+        {
+            callbacks[line].callback(line, callbacks[line].arg);
+        }
+    }
+}
 
 void exti_hal_init(exti_hal_context_t* hal)
 {
@@ -36,108 +98,51 @@ void exti_hal_init(exti_hal_context_t* hal)
 
 void exti_hal_enable_interrupt(exti_hal_context_t* hal, exti_line_t line)
 {
-    IRQn_Type exti;
-
     ASSERT(hal);
     ASSERT(EXTI_IS_LINE(line));
 
-    if(line == EXTI_LINE_0)
-    {
-        exti = EXTI0_IRQn;
-    }
-    else if(line == EXTI_LINE_1)
-    {
-        exti = EXTI1_IRQn;
-    }
-    else if(line == EXTI_LINE_2)
-    {
-        exti = EXTI2_IRQn;
-    }
-    else if(line == EXTI_LINE_3)
-    {
-        exti = EXTI3_IRQn;
-    }
-    else if(line == EXTI_LINE_4)
-    {
-        exti = EXTI4_IRQn;
-    }
-    else if(line >= EXTI_LINE_5 && line <= EXTI_LINE_9)
-    {
-        exti = EXTI9_5_IRQn;
-    }
-    else if(line >= EXTI_LINE_10 && line <= EXTI_LINE_15)
-    {
-        exti = EXTI15_10_IRQn;
-    }
-
     if(EXTI_IS_PIN(line))
     {
-        NVIC_ClearPendingIRQ(exti);
-        NVIC_EnableIRQ(exti);
+        exti_hal_enable_irq(exti_irqs[line].irqn);
     }
 
     exti_ll_enable_interrupt(hal->dev, line);
-
 }
 
-void exti_hal_disable_interrupt(exti_hal_context_t* hal, exti_line_t line)
+void exti_hal_enable_interrupt_mask(exti_hal_context_t* hal, uint32_t line_mask)
 {
-    uint32_t lines_mask;
-    IRQn_Type exti_mask;
-    uint8_t disable = 0;
+    uint32_t lines;
+    uint32_t line;
 
     ASSERT(hal);
-    ASSERT(EXTI_IS_LINE(line));
+    ASSERT(EXTI_IS_MASK(line_mask));
 
-    exti_ll_disable_interrupt(hal->dev, line);
+    /* Each NVIC line once, whatever the number of its lines in the mask */
+    lines = line_mask & (EXTI_BIT(EXTI_IRQ_LINES) - 1UL);
 
-    lines_mask = exti_ll_get_interrupt_mask(hal->dev);
-
-    if(line == EXTI_LINE_0)
-    {
-        exti_mask = EXTI0_IRQn;
-        disable = 1;
-    }
-    else if(line == EXTI_LINE_1)
-    {
-        exti_mask = EXTI1_IRQn;
-        disable = 1;
-    }
-    else if(line == EXTI_LINE_2)
-    {
-        exti_mask = EXTI2_IRQn;
-        disable = 1;
-    }
-    else if(line == EXTI_LINE_3)
-    {
-        exti_mask = EXTI3_IRQn;
-        disable = 1;
-    }
-    else if(line == EXTI_LINE_4)
-    {
-        exti_mask = EXTI4_IRQn;
-        disable = 1;
-    }
-    else if(line >= EXTI_LINE_5 && line <= EXTI_LINE_9)
-    {
-        if(EXTI_IS_EXTI9_5_CLEAR(lines_mask))
-        {
-            exti_mask = EXTI9_5_IRQn;
-            disable = 1;
-        }
-    }
-    else if(line >= EXTI_LINE_10 && line <= EXTI_LINE_15)
+    while(lines)
     {
-        if(EXTI_IS_EXTI15_10_CLEAR(lines_mask))
-        {
-            exti_mask = EXTI15_10_IRQn;
-            disable = 1;
-        }
+        line = 31UL - __CLZ(lines);
+        lines &= ~exti_irqs[line].lines;
+
+        exti_hal_enable_irq(exti_irqs[line].irqn);
     }
 
-    if(disable)
+    exti_ll_enable_interrupt_mask(hal->dev, line_mask);
+}
+
+void exti_hal_disable_interrupt(exti_hal_context_t* hal, exti_line_t line)
+{
+    ASSERT(hal);
+    ASSERT(EXTI_IS_LINE(line));
+
+    exti_ll_disable_interrupt(hal->dev, line);
+
+    /* The NVIC line is disabled with the last of its lines */
+    if(EXTI_IS_PIN(line) &&
+        (exti_ll_get_interrupt_mask(hal->dev) & exti_irqs[line].lines) == 0x00)
     {
-        NVIC_DisableIRQ(exti_mask);
+        NVIC_DisableIRQ(exti_irqs[line].irqn);
     }
 }
 
@@ -248,6 +253,29 @@ void exti_hal_set_port(exti_hal_context_t* hal, exti_line_t line, exti_port_t po
     syscfg_hal_set_exti_port(&syscfg, line, port);
 }
 
+void exti_hal_set_port_mask(exti_hal_context_t* hal, uint32_t line_mask, exti_port_t port)
+{
+    syscfg_hal_context_t syscfg;
+
+    ASSERT(hal);
+    ASSERT(EXTI_IS_PIN_MASK(line_mask));
+    ASSERT(EXTI_IS_PORT(port));
+    ASSERT(!(port > EXTI_PORT_G && (line_mask & ~0x0FUL) != 0x00));
+
+    SYSCFG_HAL_GET_HW(&syscfg);
+    syscfg_hal_set_exti_port_mask(&syscfg, line_mask, port);
+}
+
+void exti_hal_set_edges_mask(exti_hal_context_t* hal, uint32_t line_mask,
+                                        uint32_t rising_mask, uint32_t falling_mask)
+{
+    ASSERT(hal);
+    ASSERT(EXTI_IS_MASK(line_mask));
+
+    exti_ll_set_rising_mask(hal->dev, line_mask, rising_mask);
+    exti_ll_set_falling_mask(hal->dev, line_mask, falling_mask);
+}
+
 void exti_hal_clear_pending(exti_hal_context_t* hal, exti_line_t line)
 {
     ASSERT(hal);
@@ -274,14 +302,15 @@ void exti_hal_generate_sw_interrupt(exti_hal_context_t* hal, exti_line_t line)
     exti_ll_generate_sw_interrupt(hal->dev, line);
 }
 
-void exti_hal_register_callback
-            (exti_hal_context_t* hal, exti_line_t line, exti_hal_irq_callback_t callback)
+void exti_hal_register_callback(exti_hal_context_t* hal, exti_line_t line,
+                                        exti_hal_irq_callback_t callback, void* arg)
 {
     (void) hal;
 
     ASSERT(EXTI_IS_PIN(line));
     
-    callback_ptrs[line] = callback;
+    callbacks[line].callback = callback;
+    callbacks[line].arg = arg;
 }
 
 void exti_hal_unregister_callback(exti_hal_context_t* hal, exti_line_t line)
@@ -290,7 +319,8 @@ void exti_hal_unregister_callback(exti_hal_context_t* hal, exti_line_t line)
 
     ASSERT(EXTI_IS_PIN(line));
 
-    callback_ptrs[line] = NULL;
+    callbacks[line].callback = NULL;
+    callbacks[line].arg = NULL;
 }
 
 /* IRQ handler functions */
@@ -332,117 +362,35 @@ void exti15_10_irq_handler(void)
 
 __WEAK void exti0_irq_callback(void)
 {
-    if(callback_ptrs[EXTI_LINE_0])
-    {
-        callback_ptrs[EXTI_LINE_0]();
-    }
+    exti_hal_dispatch(EXTI_BIT(EXTI_LINE_0));
 }
 
 __WEAK void exti1_irq_callback(void)
 {
-    if(callback_ptrs[EXTI_LINE_1])
-    {
-        callback_ptrs[EXTI_LINE_1]();
-    }
+    exti_hal_dispatch(EXTI_BIT(EXTI_LINE_1));
 }
 
 __WEAK void exti2_irq_callback(void)
 {
-    if(callback_ptrs[EXTI_LINE_2])
-    {
-        callback_ptrs[EXTI_LINE_2]();
-    }
+    exti_hal_dispatch(EXTI_BIT(EXTI_LINE_2));
 }
 
 __WEAK void exti3_irq_callback(void)
 {
-    if(callback_ptrs[EXTI_LINE_3])
-    {
-        callback_ptrs[EXTI_LINE_3]();
-    }
+    exti_hal_dispatch(EXTI_BIT(EXTI_LINE_3));
 }
 
 __WEAK void exti4_irq_callback(void)
 {
-    if(callback_ptrs[EXTI_LINE_4])
-    {
-        callback_ptrs[EXTI_LINE_4]();
-    }
+    exti_hal_dispatch(EXTI_BIT(EXTI_LINE_4));
 }
 
 __WEAK void exti9_5_irq_callback(void)
 {
-    exti_hal_context_t hw;
-    uint32_t pending_lines;
-
-    hw.dev = EXTI_LL_GET_HW(EXTI);
-
-    pending_lines = exti_hal_get_pending(&hw);
-
-    if(callback_ptrs[EXTI_LINE_5] && (pending_lines & EXTI_BIT(EXTI_LINE_5)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_5]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_5);
-    }
-    else if(callback_ptrs[EXTI_LINE_6] && (pending_lines & EXTI_BIT(EXTI_LINE_6)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_6]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_6);
-    }
-    else if(callback_ptrs[EXTI_LINE_7] && (pending_lines & EXTI_BIT(EXTI_LINE_7)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_7]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_7);
-    }
-    else if(callback_ptrs[EXTI_LINE_8] && (pending_lines & EXTI_BIT(EXTI_LINE_8)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_8]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_8);
-    }
-    else if(callback_ptrs[EXTI_LINE_9] && (pending_lines & EXTI_BIT(EXTI_LINE_9)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_9]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_9);
-    }
+    exti_hal_dispatch(EXTI9_5_LINES);
 }
 
 __WEAK void exti15_10_irq_callback(void)
 {
-    exti_hal_context_t hw;
-    uint32_t pending_lines;
-
-    hw.dev = EXTI_LL_GET_HW(EXTI);
-
-    pending_lines = exti_hal_get_pending(&hw);
-
-    if(callback_ptrs[EXTI_LINE_10] && (pending_lines & EXTI_BIT(EXTI_LINE_10)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_10]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_10);
-    }
-    else if(callback_ptrs[EXTI_LINE_11] && (pending_lines & EXTI_BIT(EXTI_LINE_11)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_11]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_11);
-    }
-    else if(callback_ptrs[EXTI_LINE_12] && (pending_lines & EXTI_BIT(EXTI_LINE_12)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_12]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_12);
-    }
-    else if(callback_ptrs[EXTI_LINE_13] && (pending_lines & EXTI_BIT(EXTI_LINE_13)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_13]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_13);
-    }
-    else if(callback_ptrs[EXTI_LINE_14] && (pending_lines & EXTI_BIT(EXTI_LINE_14)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_14]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_14);
-    }
-    else if(callback_ptrs[EXTI_LINE_15] && (pending_lines & EXTI_BIT(EXTI_LINE_15)) != 0x00)
-    {
-        callback_ptrs[EXTI_LINE_15]();
-        exti_hal_clear_pending(&hw, EXTI_LINE_15);
-    }
+    exti_hal_dispatch(EXTI15_10_LINES);
 }
\ No newline at end of file
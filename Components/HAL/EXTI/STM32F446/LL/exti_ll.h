@@ -179,6 +179,41 @@ static inline uint32_t exti_ll_is_falling_enabled(exti_dev_t hw, uint32_t exti_n
     return REG_GET_BIT(hw->ftsr, EXTI_BIT(exti_num)) ? 1 : 0;
 }
 
+/**
+ * @brief Enable interrupt of all lines in mask
+ * 
+ * @param hw pointer to EXTI start address
+ * @param exti_mask EXTI lines, bit n for EXTIn
+ */
+static inline void exti_ll_enable_interrupt_mask(exti_dev_t hw, uint32_t exti_mask)
+{
+    REG_SET_BIT(hw->imr, exti_mask);
+}
+
+/**
+ * @brief Set rising edge trigger of all lines in mask
+ * 
+ * @param hw pointer to EXTI start address
+ * @param exti_mask EXTI lines, bit n for EXTIn
+ * @param enable_mask lines of exti_mask to enable, the rest of exti_mask is disabled
+ */
+static inline void exti_ll_set_rising_mask(exti_dev_t hw, uint32_t exti_mask, uint32_t enable_mask)
+{
+    REG_WRITE_BITS(hw->rtsr, 0, exti_mask, enable_mask);
+}
+
+/**
+ * @brief Set falling edge trigger of all lines in mask
+ * 
+ * @param hw pointer to EXTI start address
+ * @param exti_mask EXTI lines, bit n for EXTIn
+ * @param enable_mask lines of exti_mask to enable, the rest of exti_mask is disabled
+ */
+static inline void exti_ll_set_falling_mask(exti_dev_t hw, uint32_t exti_mask, uint32_t enable_mask)
+{
+    REG_WRITE_BITS(hw->ftsr, 0, exti_mask, enable_mask);
+}
+
 /**
  * @brief Generate a S.W interrupt on EXTI
  * 
@@ -214,9 +249,26 @@ static inline uint32_t exti_ll_is_pending(exti_dev_t hw, uint32_t exti_num)
     return REG_GET_BIT(hw->pr, EXTI_BIT(exti_num)) ? 1 : 0;
 }
 
+/**
+ * @brief Get pending status of all lines
+ * 
+ * @param hw pointer to EXTI start address
+ * @return uint32_t EXTI_PR value, bit n set if EXTIn is pending
+ */
 static inline uint32_t exti_ll_get_pending(exti_dev_t hw)
 {
     return hw->pr;
 }
 
+/**
+ * @brief Clear pending bit of all lines in mask with one write
+ * 
+ * @param hw pointer to EXTI start address
+ * @param exti_mask EXTI lines, bit n for EXTIn
+ */
+static inline void exti_ll_clear_pending_mask(exti_dev_t hw, uint32_t exti_mask)
+{
+    hw->pr = exti_mask;
+}
+
 #endif
@@ -10,7 +10,8 @@
 
 #define EXTI_HAL_GET_HW(context, num)    ((context)->dev = EXTI_LL_GET_HW(num))
 
-typedef void (*exti_hal_irq_callback_t) (void);
+/* Called from interrupt context with the line that triggered and the registered arg */
+typedef void (*exti_hal_irq_callback_t) (uint32_t line, void* arg);
 
 typedef struct 
 {
@@ -83,6 +84,37 @@ void exti_hal_disable_falling_edge(exti_hal_context_t* hal, exti_line_t line);
  */
 void exti_hal_set_port(exti_hal_context_t* hal, exti_line_t line, exti_port_t port);
 
+/**
+ * @brief Select the same GPIO port for all lines in mask, SYSCFG registers
+ *        are written once each
+ * 
+ * @param hal 
+ * @param line_mask lines EXTI_LINE_0 to EXTI_LINE_15, bit n for line n
+ * @param port 
+ */
+void exti_hal_set_port_mask(exti_hal_context_t* hal, uint32_t line_mask, exti_port_t port);
+
+/**
+ * @brief Set the triggering edges of all lines in mask, RTSR and FTSR are
+ *        written once each
+ * 
+ * @param hal 
+ * @param line_mask bit n for line n
+ * @param rising_mask lines of line_mask triggered by the rising edge
+ * @param falling_mask lines of line_mask triggered by the falling edge
+ */
+void exti_hal_set_edges_mask(exti_hal_context_t* hal, uint32_t line_mask,
+                                        uint32_t rising_mask, uint32_t falling_mask);
+
+/**
+ * @brief Enable external interrupt of all lines in mask
+ * @note  Each NVIC interrupt line serving lines of the mask is enabled once
+ * 
+ * @param hal 
+ * @param line_mask bit n for line n
+ */
+void exti_hal_enable_interrupt_mask(exti_hal_context_t* hal, uint32_t line_mask);
+
 /**
  * @brief Clear interrupt pending bit
  * 
@@ -92,14 +124,16 @@ void exti_hal_set_port(exti_hal_context_t* hal, exti_line_t line, exti_port_t po
 void exti_hal_clear_pending(exti_hal_context_t* hal, exti_line_t line);
 
 /**
- * @brief 
+ * @brief Set the function called when the line triggers. All pending lines of an
+ *        interrupt are served in one entry and cleared before their callbacks run
  * 
  * @param hal 
- * @param line 
+ * @param line EXTI_LINE_0 to EXTI_LINE_15
  * @param callback 
+ * @param arg user context passed to callback
  */
-void exti_hal_register_callback
-            (exti_hal_context_t* hal, exti_line_t line, exti_hal_irq_callback_t callback);
+void exti_hal_register_callback(exti_hal_context_t* hal, exti_line_t line,
+                                        exti_hal_irq_callback_t callback, void* arg);
 
 /**
  * @brief 
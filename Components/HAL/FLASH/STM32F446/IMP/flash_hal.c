@@ -4,7 +4,14 @@
 #include <stdint.h>
 #include <stddef.h>
 
-#define FLASH_TIMEOUT       5000U
+/*
+* Polls of BSY, a poll takes at least 4 cycles. Enough for the slowest operation up
+* to 180 MHz: 100 us to program a word, 4 s to erase a 128 KB sector, 16 s to erase
+* the whole flash.
+*/
+#define FLASH_PROGRAM_TIMEOUT       5000000U
+#define FLASH_ERASE_TIMEOUT         200000000U
+#define FLASH_MASS_ERASE_TIMEOUT    800000000U
 
 #define FLASH_IS_VOLTAGE_RANGE(vrange)      ((vrange) < FLASH_VOLTAGE_RANGE_INV)
 #define FLASH_IS_SECTOR(sector)             ((sector) < FLASH_SECTOR_INV)
@@ -12,6 +19,19 @@
 
 #define FLASH_IS_ADDRESS(addr)              (((addr) >= 0x08000000U) && ((addr) <= 0x0807FFFFU))
 
+/* Sectors 0-3: 16KB, sector 4: 64KB, sectors 5-7: 128KB */
+static const uint32_t flash_sector_addresses[FLASH_SECTOR_INV] = 
+{
+    0x08000000U,
+    0x08004000U,
+    0x08008000U,
+    0x0800C000U,
+    0x08010000U,
+    0x08020000U,
+    0x08040000U,
+    0x08060000U,
+};
+
 /* Private global variables */
 static flash_hal_context_t flash;
 
@@ -27,6 +47,100 @@ static void flash_hal_flush_caches(void);
 
 
 /* Function definitions */
+error_t flash_hal_init(void)
+{
+    FLASH_HAL_GET_HW(&flash);
+    ASSERT(flash.dev);
+
+    return OK;
+}
+
+error_t flash_hal_unlock(void)
+{
+    if(flash_ll_is_locked(flash.dev))
+    {
+        flash_ll_unlock(flash.dev);
+    }
+
+    return flash_ll_is_locked(flash.dev) ? FAILED : OK;
+}
+
+error_t flash_hal_lock(void)
+{
+    flash_ll_lock(flash.dev);
+
+    return OK;
+}
+
+error_t flash_hal_erase_sector(uint8_t sector, uint8_t voltage_range)
+{
+    error_t ret;
+
+    ret = flash_hal_wait_for_last_op(FLASH_PROGRAM_TIMEOUT);
+
+    if(ret == OK)
+    {
+        flash_hal_sector_erase(sector, voltage_range);
+
+        ret = flash_hal_wait_for_last_op(FLASH_ERASE_TIMEOUT);
+
+        flash_ll_disable_sector_erase(flash.dev);
+
+        /* Caches may still hold the erased contents */
+        flash_hal_flush_caches();
+    }
+
+    return ret;
+}
+
+error_t flash_hal_erase_mass(uint8_t voltage_range)
+{
+    error_t ret;
+
+    ret = flash_hal_wait_for_last_op(FLASH_PROGRAM_TIMEOUT);
+
+    if(ret == OK)
+    {
+        flash_hal_mass_erase(voltage_range);
+
+        ret = flash_hal_wait_for_last_op(FLASH_MASS_ERASE_TIMEOUT);
+
+        flash_ll_disable_mass_erase(flash.dev);
+
+        flash_hal_flush_caches();
+    }
+
+    return ret;
+}
+
+uint32_t flash_hal_get_error(void)
+{
+    return flash.error_code;
+}
+
+uint32_t flash_hal_get_sector_address(uint8_t sector)
+{
+    ASSERT(FLASH_IS_SECTOR(sector));
+
+    return flash_sector_addresses[sector];
+}
+
+uint32_t flash_hal_get_sector_size(uint8_t sector)
+{
+    ASSERT(FLASH_IS_SECTOR(sector));
+
+    if(sector < FLASH_SECTOR_4)
+    {
+        return 16 * 1024U;
+    }
+    else if(sector == FLASH_SECTOR_4)
+    {
+        return 64 * 1024U;
+    }
+
+    return 128 * 1024U;
+}
+
 error_t flash_hal_program(uint32_t data_type, uint32_t address, const void* pdata)
 {
     error_t ret = FAILED;
@@ -34,7 +148,7 @@ error_t flash_hal_program(uint32_t data_type, uint32_t address, const void* pdat
     ASSERT(FLASH_IS_PROGRAM_TYPE(data_type));
     ASSERT(pdata);
 
-    ret = flash_hal_wait_for_last_op(FLASH_TIMEOUT);
+    ret = flash_hal_wait_for_last_op(FLASH_PROGRAM_TIMEOUT);
 
     if(ret == OK)
     {
@@ -55,7 +169,7 @@ error_t flash_hal_program(uint32_t data_type, uint32_t address, const void* pdat
             flash_hal_program_doubleword(address, *((const uint64_t*) pdata));
         }
 
-        ret = flash_hal_wait_for_last_op(FLASH_TIMEOUT);
+        ret = flash_hal_wait_for_last_op(FLASH_PROGRAM_TIMEOUT);
 
         flash_ll_disable_programming(flash.dev);
     }
@@ -120,17 +234,39 @@ static error_t flash_hal_mass_erase(uint8_t voltage_range)
     return OK;
 }
 
+/**
+ * @brief Wait for the ongoing operation and collect its errors. Error flags are
+ * sticky and a set PGSERR blocks the next operation, they are cleared once read.
+ * 
+ * @param timeout polls of BSY
+ * @return error_t FAILED on timeout or error, see flash_hal_get_error()
+ */
 static error_t flash_hal_wait_for_last_op(uint32_t timeout)
 {
-    (void) timeout;
+    uint32_t errors;
 
     while(flash_ll_is_busy(flash.dev))
     {
-        /*
-            TODO: Check for timeout
-        */
+        if(timeout-- == 0)
+        {
+            flash.error_code = FLASH_ERROR_TIMEOUT;
+
+            return FAILED;
+        }
+    }
+
+    errors = flash_ll_get_errors(flash.dev);
+
+    if(errors)
+    {
+        flash_ll_clear_errors(flash.dev, errors);
+        flash.error_code = errors;
+
+        return FAILED;
     }
 
+    flash.error_code = FLASH_ERROR_NONE;
+
     return OK;
 }
 
@@ -34,9 +34,14 @@ enum
     FLASH_PROGRAM_DOUBLEWORD,
 };
 
+/* Error codes, the others are the FLASH_SR_*ERR_S flags of the failed operation */
+#define FLASH_ERROR_NONE        0x00000000
+#define FLASH_ERROR_TIMEOUT     0x80000000
+
 typedef struct 
 {
     flash_dev_t dev;
+    uint32_t error_code;
 } flash_hal_context_t;
 
 #endif
\ No newline at end of file
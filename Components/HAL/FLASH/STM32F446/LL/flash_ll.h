@@ -170,12 +170,22 @@ STATIC_INLINE void flash_ll_enable_mass_erase(flash_dev_t dev)
     REG_SET_BIT(dev->cr, FLASH_CR_MER_S);
 }
 
+STATIC_INLINE void flash_ll_disable_mass_erase(flash_dev_t dev)
+{
+    REG_CLR_BIT(dev->cr, FLASH_CR_MER_S);
+}
+
 STATIC_INLINE void flash_ll_enable_sector_erase(flash_dev_t dev)
 {
     REG_CLR_BIT(dev->cr, FLASH_CR_MER_S | FLASH_CR_SER_S | FLASH_CR_PG_S);
     REG_SET_BIT(dev->cr, FLASH_CR_SER_S);
 }
 
+STATIC_INLINE void flash_ll_disable_sector_erase(flash_dev_t dev)
+{
+    REG_CLR_BIT(dev->cr, FLASH_CR_SER_S);
+}
+
 STATIC_INLINE void flash_ll_enable_programming(flash_dev_t dev)
 {
     REG_CLR_BIT(dev->cr, FLASH_CR_MER_S | FLASH_CR_SER_S | FLASH_CR_PG_S);
@@ -192,4 +202,15 @@ STATIC_INLINE uint32_t flash_ll_is_busy(flash_dev_t dev)
     return REG_GET_BIT(dev->sr, FLASH_SR_BUSY_S) ? 1 : 0;
 }
 
+STATIC_INLINE uint32_t flash_ll_get_errors(flash_dev_t dev)
+{
+    return dev->sr & FLASH_SR_ERRORS_M;
+}
+
+STATIC_INLINE void flash_ll_clear_errors(flash_dev_t dev, uint32_t errors)
+{
+    /* Write 1 to clear, EOP and the other flags are left untouched */
+    dev->sr = errors & FLASH_SR_ERRORS_M;
+}
+
 #endif
\ No newline at end of file
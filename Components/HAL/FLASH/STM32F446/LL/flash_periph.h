@@ -24,8 +24,18 @@
 #define FLASH_CR_STRT_S         (BIT(16))
 #define FLASH_CR_LOCK_S         (BIT(31))
 
+#define FLASH_SR_EOP_S          (BIT(0))
+#define FLASH_SR_OPERR_S        (BIT(1))
+#define FLASH_SR_WRPERR_S       (BIT(4))
+#define FLASH_SR_PGAERR_S       (BIT(5))
+#define FLASH_SR_PGPERR_S       (BIT(6))
+#define FLASH_SR_PGSERR_S       (BIT(7))
+#define FLASH_SR_RDERR_S        (BIT(8))
 #define FLASH_SR_BUSY_S         (BIT(16))
 
+#define FLASH_SR_ERRORS_M       (FLASH_SR_OPERR_S | FLASH_SR_WRPERR_S | FLASH_SR_PGAERR_S | \
+                                FLASH_SR_PGPERR_S | FLASH_SR_PGSERR_S | FLASH_SR_RDERR_S)
+
 #define _FLASH_DEV ((flash_dev_t) 0x40023C00U)
 
 typedef struct
@@ -0,0 +1,88 @@
+#ifndef __FLASH_HAL_H__
+
+#define __FLASH_HAL_H__
+
+#include "flash_types.h"
+
+#include "types.h"
+
+#include <stdint.h>
+
+/* PUBLIC FUNCTION DECLARATIONS */
+
+/**
+ * @brief Initialize flash interface context. Must be called before any other flash
+ *        function.
+ * 
+ * @return error_t 
+ */
+error_t flash_hal_init(void);
+
+/**
+ * @brief Unlock flash control register to allow program and erase operations
+ * 
+ * @return error_t 
+ */
+error_t flash_hal_unlock(void);
+
+/**
+ * @brief 
+ * 
+ * @return error_t 
+ */
+error_t flash_hal_lock(void);
+
+/**
+ * @brief Program a byte, halfword, word or doubleword at a given address. Flash must
+ *        be unlocked. Doubleword needs external Vpp (FLASH_VOLTAGE_RANGE_4).
+ * 
+ * @param data_type One of FLASH_PROGRAM_BYTE..FLASH_PROGRAM_DOUBLEWORD
+ * @param address 
+ * @param pdata 
+ * @return error_t FAILED on timeout or programming error, see flash_hal_get_error()
+ */
+error_t flash_hal_program(uint32_t data_type, uint32_t address, const void* pdata);
+
+/**
+ * @brief Erase one sector and wait for completion. Flash must be unlocked.
+ * 
+ * @param sector 
+ * @param voltage_range Device supply range, selects erase parallelism
+ * @return error_t FAILED on timeout or erase error, see flash_hal_get_error()
+ */
+error_t flash_hal_erase_sector(uint8_t sector, uint8_t voltage_range);
+
+/**
+ * @brief Erase the whole flash and wait for completion. Flash must be unlocked and
+ *        the caller must run from RAM.
+ * 
+ * @param voltage_range Device supply range, selects erase parallelism
+ * @return error_t FAILED on timeout or erase error, see flash_hal_get_error()
+ */
+error_t flash_hal_erase_mass(uint8_t voltage_range);
+
+/**
+ * @brief 
+ * 
+ * @return uint32_t FLASH_ERROR_TIMEOUT or the error flags of the last operation,
+ *         FLASH_ERROR_NONE if it succeeded
+ */
+uint32_t flash_hal_get_error(void);
+
+/**
+ * @brief 
+ * 
+ * @param sector 
+ * @return uint32_t start address of the sector
+ */
+uint32_t flash_hal_get_sector_address(uint8_t sector);
+
+/**
+ * @brief 
+ * 
+ * @param sector 
+ * @return uint32_t size of the sector in bytes
+ */
+uint32_t flash_hal_get_sector_size(uint8_t sector);
+
+#endif
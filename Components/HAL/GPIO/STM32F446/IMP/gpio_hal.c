@@ -7,6 +7,7 @@
 #include "types.h"
 
 #define GPIO_IS_PIN(pin)        ((pin) < GPIO_PIN_ALL)
+#define GPIO_IS_MASK(mask)      (((mask) >> GPIO_PIN_ALL) == 0x00)
 
 error_t gpio_hal_init(gpio_port_t port)
 {
@@ -114,6 +115,84 @@ void gpio_hal_set_pull_down(gpio_hal_context_t* hal, gpio_pin_t pin)
     gpio_ll_set_pull_down(hal->dev, pin);
 }
 
+void gpio_hal_set_mode_input_mask(gpio_hal_context_t* hal, uint32_t mask)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_mode_mask(hal->dev, mask, LL_GPIO_MODE_INPUT);
+}
+
+void gpio_hal_set_mode_output_pp_mask(gpio_hal_context_t* hal, uint32_t mask)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_mode_mask(hal->dev, mask, LL_GPIO_MODE_OUTPUT);
+    gpio_ll_set_output_type_mask(hal->dev, mask, LL_GPIO_OUTPUT_PUSHPULL);
+}
+
+void gpio_hal_set_mode_output_od_mask(gpio_hal_context_t* hal, uint32_t mask)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_mode_mask(hal->dev, mask, LL_GPIO_MODE_OUTPUT);
+    gpio_ll_set_output_type_mask(hal->dev, mask, LL_GPIO_OUTPUT_OPENDRAIN);
+}
+
+void gpio_hal_set_mode_analog_mask(gpio_hal_context_t* hal, uint32_t mask)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_mode_mask(hal->dev, mask, LL_GPIO_MODE_ANALOG);
+}
+
+void gpio_hal_set_mode_alternate_pp_mask(gpio_hal_context_t* hal, uint32_t mask, uint8_t func)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_mode_mask(hal->dev, mask, LL_GPIO_MODE_ALTERNATE);
+    gpio_ll_set_output_type_mask(hal->dev, mask, LL_GPIO_OUTPUT_PUSHPULL);
+    gpio_ll_set_alternate_func_mask(hal->dev, mask, func);
+}
+
+void gpio_hal_set_mode_alternate_od_mask(gpio_hal_context_t* hal, uint32_t mask, uint8_t func)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_mode_mask(hal->dev, mask, LL_GPIO_MODE_ALTERNATE);
+    gpio_ll_set_output_type_mask(hal->dev, mask, LL_GPIO_OUTPUT_OPENDRAIN);
+    gpio_ll_set_alternate_func_mask(hal->dev, mask, func);
+}
+
+void gpio_hal_set_pull_disable_mask(gpio_hal_context_t* hal, uint32_t mask)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_pull_mask(hal->dev, mask, LL_GPIO_PULL_NO);
+}
+
+void gpio_hal_set_pull_up_mask(gpio_hal_context_t* hal, uint32_t mask)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_pull_mask(hal->dev, mask, LL_GPIO_PULL_UP);
+}
+
+void gpio_hal_set_pull_down_mask(gpio_hal_context_t* hal, uint32_t mask)
+{
+    ASSERT(hal);
+    ASSERT(GPIO_IS_MASK(mask));
+
+    gpio_ll_set_pull_mask(hal->dev, mask, LL_GPIO_PULL_DOWN);
+}
+
 uint32_t gpio_hal_in_read_pin(gpio_hal_context_t* hal, gpio_pin_t pin)
 {
     ASSERT(hal);
@@ -169,3 +248,17 @@ void gpio_hal_out_toggle_mask(gpio_hal_context_t* hal, uint32_t mask)
 
     gpio_ll_out_toggle_mask(hal->dev, mask);
 }
+
+uint32_t gpio_hal_get_bsrr_addr(gpio_hal_context_t* hal)
+{
+    ASSERT(hal);
+
+    return gpio_ll_get_bsrr_addr(hal->dev);
+}
+
+uint32_t gpio_hal_get_idr_addr(gpio_hal_context_t* hal)
+{
+    ASSERT(hal);
+
+    return gpio_ll_get_idr_addr(hal->dev);
+}
\ No newline at end of file
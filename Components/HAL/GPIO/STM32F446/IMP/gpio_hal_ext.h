@@ -20,4 +20,22 @@ void gpio_hal_set_mode_alternate_pp(gpio_hal_context_t* hal, gpio_pin_t pin, uin
  */
 void gpio_hal_set_mode_alternate_od(gpio_hal_context_t* hal, gpio_pin_t pin, uint8_t func);
 
+/**
+ * @brief Set all pins in mask to the same alternate function, push-pull
+ * 
+ * @param hal 
+ * @param mask 
+ * @param func 
+ */
+void gpio_hal_set_mode_alternate_pp_mask(gpio_hal_context_t* hal, uint32_t mask, uint8_t func);
+
+/**
+ * @brief Set all pins in mask to the same alternate function, open-drain
+ * 
+ * @param hal 
+ * @param mask 
+ * @param func 
+ */
+void gpio_hal_set_mode_alternate_od_mask(gpio_hal_context_t* hal, uint32_t mask, uint8_t func);
+
 #endif
\ No newline at end of file
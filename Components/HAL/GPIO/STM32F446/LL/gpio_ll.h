@@ -193,7 +193,7 @@ static inline void gpio_ll_set_pull_disable(gpio_dev_t hw, uint8_t pin)
  */
 static inline void gpio_ll_set_pull_up(gpio_dev_t hw, uint8_t pin)
 {
-    REG_WRITE_BITS(hw->ospeedr, GPIO_PUPD_S(pin), GPIO_PUPD_M, LL_GPIO_PULL_UP);
+    REG_WRITE_BITS(hw->pupdr, GPIO_PUPD_S(pin), GPIO_PUPD_M, LL_GPIO_PULL_UP);
 }
 
 /**
@@ -203,7 +203,7 @@ static inline void gpio_ll_set_pull_up(gpio_dev_t hw, uint8_t pin)
  */
 static inline void gpio_ll_set_pull_down(gpio_dev_t hw, uint8_t pin)
 {
-    REG_WRITE_BITS(hw->ospeedr, GPIO_PUPD_S(pin), GPIO_PUPD_M, LL_GPIO_PULL_DOWN);
+    REG_WRITE_BITS(hw->pupdr, GPIO_PUPD_S(pin), GPIO_PUPD_M, LL_GPIO_PULL_DOWN);
 }
 
 /**
@@ -332,6 +332,20 @@ static inline void gpio_ll_out_toggle_mask(gpio_dev_t hw, uint32_t pin_mask)
     hw->bsrr = ((odr & pin_mask) << GPIO_LL_PINS) | (~odr & pin_mask);
 }
 
+/**
+ * @brief Drive GPIO pins in mask to the levels of value with one write, the
+ *        pins set and the pins reset change at once
+ * 
+ * @param gpio_dev_t pointer to start address of GPIO
+ * @param pin_mask GPIO pins to drive. From GPIO0-GPIO15
+ * @param value levels of the pins, bit n for pin n
+ */
+
+static inline void gpio_ll_out_write_mask(gpio_dev_t hw, uint32_t pin_mask, uint32_t value)
+{
+    hw->bsrr = (value & pin_mask) | GPIO_BSR_RESET_M(~value & pin_mask);
+}
+
 /**
  * @brief Apply pin lock sequence.
  * 
@@ -377,4 +391,127 @@ static inline void gpio_ll_set_alternate_func(gpio_dev_t hw, gpio_pin_t pin, uin
     }
 }
 
+/**
+ * @brief Spread a pin mask over the 2 bits fields of MODER, OSPEEDR and PUPDR.
+ *        Multiplied by a field value it gives the register image of all the pins
+ * 
+ * @param pin_mask GPIO pins. From GPIO0-GPIO15
+ * @return uint32_t bit 2n set for each pin n of the mask
+ */
+static inline uint32_t gpio_ll_spread_mask_2(uint32_t pin_mask)
+{
+    pin_mask &= 0xFFFFUL;
+    pin_mask = (pin_mask | (pin_mask << 8)) & 0x00FF00FFUL;
+    pin_mask = (pin_mask | (pin_mask << 4)) & 0x0F0F0F0FUL;
+    pin_mask = (pin_mask | (pin_mask << 2)) & 0x33333333UL;
+    pin_mask = (pin_mask | (pin_mask << 1)) & 0x55555555UL;
+
+    return pin_mask;
+}
+
+/**
+ * @brief Spread 8 pins of a mask over the 4 bits fields of AFRL or AFRH
+ * 
+ * @param pin_mask GPIO pins. From GPIO0-GPIO7
+ * @return uint32_t bit 4n set for each pin n of the mask
+ */
+static inline uint32_t gpio_ll_spread_mask_4(uint32_t pin_mask)
+{
+    pin_mask &= 0xFFUL;
+    pin_mask = (pin_mask | (pin_mask << 12)) & 0x000F000FUL;
+    pin_mask = (pin_mask | (pin_mask << 6)) & 0x03030303UL;
+    pin_mask = (pin_mask | (pin_mask << 3)) & 0x11111111UL;
+
+    return pin_mask;
+}
+
+/**
+ * @brief Set the mode of all pins in mask with one write of MODER
+ * 
+ * @param hw pointer to start address of GPIO
+ * @param pin_mask GPIO pins. From GPIO0-GPIO15
+ * @param mode gpio_ll_mode_t
+ */
+static inline void gpio_ll_set_mode_mask(gpio_dev_t hw, uint32_t pin_mask, uint32_t mode)
+{
+    uint32_t fields = gpio_ll_spread_mask_2(pin_mask);
+
+    REG_WRITE_BITS(hw->moder, 0, (fields * GPIO_MODE_M), (fields * mode));
+}
+
+/**
+ * @brief Set the output type of all pins in mask with one write of OTYPER
+ * 
+ * @param hw pointer to start address of GPIO
+ * @param pin_mask GPIO pins. From GPIO0-GPIO15
+ * @param type gpio_ll_output_t
+ */
+static inline void gpio_ll_set_output_type_mask(gpio_dev_t hw, uint32_t pin_mask, uint32_t type)
+{
+    pin_mask &= 0xFFFFUL;
+
+    REG_WRITE_BITS(hw->otyper, 0, pin_mask, (type == LL_GPIO_OUTPUT_OPENDRAIN ? pin_mask : 0));
+}
+
+/**
+ * @brief Set the pull of all pins in mask with one write of PUPDR
+ * 
+ * @param hw pointer to start address of GPIO
+ * @param pin_mask GPIO pins. From GPIO0-GPIO15
+ * @param pull gpio_ll_pull_t
+ */
+static inline void gpio_ll_set_pull_mask(gpio_dev_t hw, uint32_t pin_mask, uint32_t pull)
+{
+    uint32_t fields = gpio_ll_spread_mask_2(pin_mask);
+
+    REG_WRITE_BITS(hw->pupdr, 0, (fields * GPIO_PUPD_M), (fields * pull));
+}
+
+/**
+ * @brief Set the alternate function of all pins in mask, AFRL and AFRH are
+ *        written once each and only if the mask has pins in them
+ * 
+ * @param hw pointer to start address of GPIO
+ * @param pin_mask GPIO pins. From GPIO0-GPIO15
+ * @param func alternate function from 0 to 15
+ */
+static inline void gpio_ll_set_alternate_func_mask(gpio_dev_t hw, uint32_t pin_mask, uint8_t func)
+{
+    uint32_t fields;
+
+    if((pin_mask & 0xFFUL) != 0x00)
+    {
+        fields = gpio_ll_spread_mask_4(pin_mask);
+        REG_WRITE_BITS(hw->afrl, 0, (fields * GPIO_AFR_M), (fields * (func & GPIO_AFR_M)));
+    }
+
+    if((pin_mask & 0xFF00UL) != 0x00)
+    {
+        fields = gpio_ll_spread_mask_4(pin_mask >> 8);
+        REG_WRITE_BITS(hw->afrh, 0, (fields * GPIO_AFR_M), (fields * (func & GPIO_AFR_M)));
+    }
+}
+
+/**
+ * @brief Address of BSRR, written by DMA to drive several pins at once
+ * 
+ * @param hw pointer to start address of GPIO
+ * @return uint32_t 
+ */
+static inline uint32_t gpio_ll_get_bsrr_addr(gpio_dev_t hw)
+{
+    return (uint32_t) (uintptr_t) &hw->bsrr;
+}
+
+/**
+ * @brief Address of IDR, read by DMA to sample all pins of a port at once
+ * 
+ * @param hw pointer to start address of GPIO
+ * @return uint32_t 
+ */
+static inline uint32_t gpio_ll_get_idr_addr(gpio_dev_t hw)
+{
+    return (uint32_t) (uintptr_t) &hw->idr;
+}
+
 #endif
\ No newline at end of file
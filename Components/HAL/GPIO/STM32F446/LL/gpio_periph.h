@@ -65,4 +65,8 @@ static const gpio_dev_t GPIO_LL_GPIOx[] = {
 
 #define GPIO_LL_GET_HW(num) (((num) < GPIO_LL_PORTS) ? GPIO_LL_GPIOx[(num)] : NULL)
 
+/* Ports are 0x400 apart, a constant port gives an address constant, no table lookup */
+#define GPIO_LL_PORT_SIZE   0x400UL
+#define GPIO_LL_HW(num)     ((gpio_dev_t) (0x40020000UL + ((num) * GPIO_LL_PORT_SIZE)))
+
 #endif
\ No newline at end of file
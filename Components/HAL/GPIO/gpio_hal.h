@@ -89,6 +89,57 @@ void gpio_hal_set_pull_up(gpio_hal_context_t* hal, gpio_pin_t pin);
  */
 void gpio_hal_set_pull_down(gpio_hal_context_t* hal, gpio_pin_t pin);
 
+/**
+ * @brief set all pins in mask to input, MODER is written once
+ * @param hal pointer to gpio_hal_context_t
+ * @param mask GPIO pin mask
+ */
+void gpio_hal_set_mode_input_mask(gpio_hal_context_t* hal, uint32_t mask);
+
+/**
+ * @brief set all pins in mask to output push-pull, MODER and OTYPER are
+ * written once each
+ * @param hal pointer to gpio_hal_context_t
+ * @param mask GPIO pin mask
+ */
+void gpio_hal_set_mode_output_pp_mask(gpio_hal_context_t* hal, uint32_t mask);
+
+/**
+ * @brief set all pins in mask to output open-drain, MODER and OTYPER are
+ * written once each
+ * @param hal pointer to gpio_hal_context_t
+ * @param mask GPIO pin mask
+ */
+void gpio_hal_set_mode_output_od_mask(gpio_hal_context_t* hal, uint32_t mask);
+
+/**
+ * @brief set all pins in mask to analog, MODER is written once
+ * @param hal pointer to gpio_hal_context_t
+ * @param mask GPIO pin mask
+ */
+void gpio_hal_set_mode_analog_mask(gpio_hal_context_t* hal, uint32_t mask);
+
+/**
+ * @brief disable pull up/down of all pins in mask, PUPDR is written once
+ * @param hal pointer to gpio_hal_context_t
+ * @param mask GPIO pin mask
+ */
+void gpio_hal_set_pull_disable_mask(gpio_hal_context_t* hal, uint32_t mask);
+
+/**
+ * @brief enable pull-up of all pins in mask, PUPDR is written once
+ * @param hal pointer to gpio_hal_context_t
+ * @param mask GPIO pin mask
+ */
+void gpio_hal_set_pull_up_mask(gpio_hal_context_t* hal, uint32_t mask);
+
+/**
+ * @brief enable pull-down of all pins in mask, PUPDR is written once
+ * @param hal pointer to gpio_hal_context_t
+ * @param mask GPIO pin mask
+ */
+void gpio_hal_set_pull_down_mask(gpio_hal_context_t* hal, uint32_t mask);
+
 /**
  * @brief get pin input value
  * @param hal pointer to gpio_hal_context_t
@@ -146,5 +197,21 @@ void gpio_hal_out_set_mask(gpio_hal_context_t* hal, uint32_t mask);
  */
 void gpio_hal_out_toggle_mask(gpio_hal_context_t* hal, uint32_t mask);
 
+/**
+ * @brief address of the set/reset register, a 32 bits word written to it sets 
+ * the pins of its low half and resets the pins of its high half at once
+ * @param hal pointer to gpio_hal_context_t
+ * @return uint32_t
+ */
+uint32_t gpio_hal_get_bsrr_addr(gpio_hal_context_t* hal);
+
+/**
+ * @brief address of the input data register, the levels of the 16 pins in its
+ * low half
+ * @param hal pointer to gpio_hal_context_t
+ * @return uint32_t
+ */
+uint32_t gpio_hal_get_idr_addr(gpio_hal_context_t* hal);
+
 
 #endif
\ No newline at end of file
@@ -37,6 +37,8 @@ typedef enum
 
 typedef enum
 {
+    RCC_HAL_TIM1 = 0,
+    RCC_HAL_TIM8 = 1,
     RCC_HAL_USART1 = 4,
     RCC_HAL_USART6 = 5,
     RCC_HAL_SYSCFG = 14,
@@ -16,4 +16,11 @@ void syscfg_hal_set_exti_port(syscfg_hal_context_t* hal, uint32_t line, uint32_t
     ASSERT(hal);
 
     syscfg_ll_set_exti_port(hal->dev, line, port);
+}
+
+void syscfg_hal_set_exti_port_mask(syscfg_hal_context_t* hal, uint32_t line_mask, uint32_t port)
+{
+    ASSERT(hal);
+
+    syscfg_ll_set_exti_port_mask(hal->dev, line_mask, port);
 }
\ No newline at end of file
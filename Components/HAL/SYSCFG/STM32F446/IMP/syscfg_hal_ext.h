@@ -18,4 +18,6 @@ void syscfg_hal_init(void);
 
 void syscfg_hal_set_exti_port(syscfg_hal_context_t* hal, uint32_t line, uint32_t port);
 
+void syscfg_hal_set_exti_port_mask(syscfg_hal_context_t* hal, uint32_t line_mask, uint32_t port);
+
 #endif
\ No newline at end of file
@@ -35,6 +35,37 @@ static inline void syscfg_ll_set_exti_port
     REG_WRITE_BITS(*exticr, SYSCFG_EXTICR_S(exti_num), SYSCFG_EXTICR_M, gpio_port);
 }
 
+/**
+ * @brief Set the same GPIO port for several EXTI lines, each EXTICR register
+ *        holding lines of the mask is written once
+ * 
+ * @param hw Pointer to start address of SYSCFG
+ * @param exti_mask EXTI lines from bit 0 to bit 15
+ * @param gpio_port GPIO port to select as source of interrupt
+ */
+static inline void syscfg_ll_set_exti_port_mask
+                    (syscfg_dev_t hw, uint32_t exti_mask, uint32_t gpio_port)
+{
+    uint32_t lines;
+    uint32_t fields;
+    uint32_t reg;
+
+    for(reg = 0; reg < 4; reg++)
+    {
+        lines = (exti_mask >> (reg << 2)) & 0x0FUL;
+
+        if(lines != 0x00)
+        {
+            /* Bit 4n set for each line n of the register */
+            fields = (lines & 0x01UL) | ((lines & 0x02UL) << 3) |
+                        ((lines & 0x04UL) << 6) | ((lines & 0x08UL) << 9);
+
+            REG_WRITE_BITS(hw->exticr[reg], 0, (fields * SYSCFG_EXTICR_M),
+                                                    (fields * gpio_port));
+        }
+    }
+}
+
 /**
  * @brief Get GPIO port configured for EXTI interrupt
  * 
@@ -107,5 +107,26 @@ error_t tim_basic_hal_stop(tim_basic_hal_context_t* p_timer)
 
     TIM_BASIC_LL_DISABLE_COUNTER(p_timer->dev);
 
+    return OK;
+}
+
+error_t tim_basic_hal_start_once(tim_basic_hal_context_t* p_timer, uint16_t reload)
+{
+    if(!p_timer)
+    {
+        return FAILED;
+    }
+
+    TIM_BASIC_LL_DISABLE_COUNTER(p_timer->dev);
+    TIM_BASIC_LL_ENABLE_ONE_PULSE(p_timer->dev);
+
+    /* The software update loads the new reload without raising the interrupt */
+    TIM_BASIC_LL_UEV_OVERFLOW_ONLY(p_timer->dev);
+    TIM_BASIC_LL_SET_ARR(p_timer->dev, reload);
+    TIM_BASIC_LL_SW_REINIT(p_timer->dev);
+    TIM_BASIC_LL_CLEAR_IRQ_FLAG(p_timer->dev);
+
+    TIM_BASIC_LL_ENABLE_COUNTER(p_timer->dev);
+
     return OK;
 }
\ No newline at end of file
@@ -23,6 +23,12 @@
 #define TIM_BASIC_LL_IS_PRELOAD_ENABLED(hw) \
                                             tim_basic_ll_is_preload_enabled(hw)
 
+#define TIM_BASIC_LL_ENABLE_ONE_PULSE(hw)   REG_SET_BIT((hw)->cr1, TIM_BASIC_CR1_OPM_S)
+#define TIM_BASIC_LL_DISABLE_ONE_PULSE(hw)  REG_CLR_BIT((hw)->cr1, TIM_BASIC_CR1_OPM_S)
+
+#define TIM_BASIC_LL_UEV_OVERFLOW_ONLY(hw)  REG_SET_BIT((hw)->cr1, TIM_BASIC_CR1_URS_S)
+#define TIM_BASIC_LL_UEV_ANY_SOURCE(hw)     REG_CLR_BIT((hw)->cr1, TIM_BASIC_CR1_URS_S)
+
 #define TIM_BASIC_LL_ENABLE_IRQ(hw)         REG_SET_BIT((hw)->dier, TIM_BASIC_DIER_UIE_S)
 #define TIM_BASIC_LL_DISABLE_IRQ(hw)        REG_CLR_BIT((hw)->dier, TIM_BASIC_DIER_UIE_S)
 
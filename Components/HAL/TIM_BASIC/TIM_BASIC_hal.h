@@ -36,5 +36,14 @@ error_t tim_basic_hal_start(tim_basic_hal_context_t* p_timer);
  */
 error_t tim_basic_hal_stop(tim_basic_hal_context_t* p_timer);
 
+/**
+ * @brief Count reload + 1 timer clocks once then stop, the callback runs at the end.
+ * Restarts the count if the timer is already running.
+ * 
+ * @param p_timer 
+ * @param reload 
+ * @return error_t 
+ */
+error_t tim_basic_hal_start_once(tim_basic_hal_context_t* p_timer, uint16_t reload);
 
 #endif
\ No newline at end of file
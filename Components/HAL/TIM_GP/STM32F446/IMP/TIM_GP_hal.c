@@ -0,0 +1,750 @@
+#include "TIM_GP_hal.h"
+#include "TIM_GP_types.h"
+#include "TIM_GP_ll.h"
+
+#include "dma_hal_ext.h"
+#include "rcc_hal_ext.h"
+#include "stm32f446xx.h"
+#include "assert.h"
+#include "types.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define TIM_GP_HAL_IS_TIMER(tim)        ((((tim) >= TIM_GP_TIM2) && ((tim) <= TIM_GP_TIM5)) || \
+                                        (tim) == TIM_GP_TIM1 || (tim) == TIM_GP_TIM8)
+#define TIM_GP_HAL_IS_ADVANCED(tim)     ((tim) == TIM_GP_TIM1 || (tim) == TIM_GP_TIM8)
+#define TIM_GP_HAL_IS_CHANNEL(ch)       ((ch) < TIM_GP_CHANNEL_MAX)
+
+/* Same order as TIM_GP_LL_TIMx, TIM1 and TIM8 after the general purpose timers */
+#define TIM_GP_HAL_INDEX(tim)           (((tim) == TIM_GP_TIM1) ? 4U : \
+                                        ((tim) == TIM_GP_TIM8) ? 5U : (tim) - TIM_GP_TIM2)
+
+#define TIM_GP_HAL_NO_DMA               0xFF
+
+/* 
+* DMA controller, stream and channel of the timer requests, RM0390 tables 28 and 29.
+* TIM1 and TIM8 are served by DMA2, the only controller reaching AHB peripherals
+*/
+struct tim_gp_dma_request_t
+{
+    uint8_t dma;
+    uint8_t stream;
+    uint8_t channel;
+};
+
+static const struct tim_gp_dma_request_t tim_gp_dma_requests[TIM_GP_LL_DEVS][TIM_GP_CHANNEL_MAX] =
+{
+    /* TIM2 */
+    {
+        {DMA1, DMA_STREAM_5, DMA_CHANNEL_3},
+        {DMA1, DMA_STREAM_6, DMA_CHANNEL_3},
+        {DMA1, DMA_STREAM_1, DMA_CHANNEL_3},
+        {DMA1, DMA_STREAM_7, DMA_CHANNEL_3},
+    },
+    /* TIM3 */
+    {
+        {DMA1, DMA_STREAM_4, DMA_CHANNEL_5},
+        {DMA1, DMA_STREAM_5, DMA_CHANNEL_5},
+        {DMA1, DMA_STREAM_7, DMA_CHANNEL_5},
+        {DMA1, DMA_STREAM_2, DMA_CHANNEL_5},
+    },
+    /* TIM4 */
+    {
+        {DMA1, DMA_STREAM_0, DMA_CHANNEL_2},
+        {DMA1, DMA_STREAM_3, DMA_CHANNEL_2},
+        {DMA1, DMA_STREAM_7, DMA_CHANNEL_2},
+        {DMA1, TIM_GP_HAL_NO_DMA, TIM_GP_HAL_NO_DMA},
+    },
+    /* TIM5 */
+    {
+        {DMA1, DMA_STREAM_2, DMA_CHANNEL_6},
+        {DMA1, DMA_STREAM_4, DMA_CHANNEL_6},
+        {DMA1, DMA_STREAM_0, DMA_CHANNEL_6},
+        {DMA1, DMA_STREAM_1, DMA_CHANNEL_6},
+    },
+    /* TIM1 */
+    {
+        {DMA2, DMA_STREAM_1, DMA_CHANNEL_6},
+        {DMA2, DMA_STREAM_2, DMA_CHANNEL_6},
+        {DMA2, DMA_STREAM_6, DMA_CHANNEL_6},
+        {DMA2, DMA_STREAM_4, DMA_CHANNEL_6},
+    },
+    /* TIM8 */
+    {
+        {DMA2, DMA_STREAM_2, DMA_CHANNEL_7},
+        {DMA2, DMA_STREAM_3, DMA_CHANNEL_7},
+        {DMA2, DMA_STREAM_4, DMA_CHANNEL_7},
+        {DMA2, DMA_STREAM_7, DMA_CHANNEL_7},
+    },
+};
+
+/* Update requests, on streams left free by the capture requests where possible */
+static const struct tim_gp_dma_request_t tim_gp_update_dma_requests[TIM_GP_LL_DEVS] =
+{
+    {DMA1, DMA_STREAM_7, DMA_CHANNEL_3},    /* TIM2 */
+    {DMA1, DMA_STREAM_2, DMA_CHANNEL_5},    /* TIM3 */
+    {DMA1, DMA_STREAM_6, DMA_CHANNEL_2},    /* TIM4 */
+    {DMA1, DMA_STREAM_6, DMA_CHANNEL_6},    /* TIM5 */
+    {DMA2, DMA_STREAM_5, DMA_CHANNEL_6},    /* TIM1 */
+    {DMA2, DMA_STREAM_1, DMA_CHANNEL_7},    /* TIM8 */
+};
+
+static tim_gp_hal_context_t gp_timers[TIM_GP_LL_DEVS];
+
+
+static void tim_gp_hal_irq_handler(tim_gp_hal_context_t* p_timer)
+{
+    uint8_t channel;
+
+    if(!p_timer->dev)
+    {
+        return;
+    }
+
+    if(TIM_GP_LL_GET_UPDATE_FLAG(p_timer->dev))
+    {
+        TIM_GP_LL_CLEAR_UPDATE_FLAG(p_timer->dev);
+
+        if(p_timer->callback)
+        {
+            p_timer->callback(p_timer);
+        }
+    }
+
+    for(channel = 0; channel < TIM_GP_CHANNEL_MAX; channel++)
+    {
+        if(TIM_GP_LL_IS_CC_IRQ_ENABLED(p_timer->dev, channel) && 
+                                TIM_GP_LL_GET_CC_FLAG(p_timer->dev, channel))
+        {
+            TIM_GP_LL_CLEAR_CC_FLAG(p_timer->dev, channel);
+
+            if(p_timer->channel_callback)
+            {
+                p_timer->channel_callback(p_timer, channel);
+            }
+        }
+    }
+}
+
+void tim2_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[0]);
+}
+
+void tim3_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[1]);
+}
+
+void tim4_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[2]);
+}
+
+void tim5_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[3]);
+}
+
+/* Update and capture/compare events of TIM1 and TIM8 have their own vectors */
+void tim1_up_tim10_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[4]);
+}
+
+void tim1_cc_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[4]);
+}
+
+void tim8_up_tim13_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[5]);
+}
+
+void tim8_cc_irq_handler(void)
+{
+    tim_gp_hal_irq_handler(&gp_timers[5]);
+}
+
+/**
+ * @brief End of a one-shot update DMA transfer, the timer stops on the last word
+ */
+static void tim_gp_hal_update_dma_complete(dma_hal_context_t* dma)
+{
+    tim_gp_hal_context_t* p_timer;
+
+    p_timer = (tim_gp_hal_context_t*) dma->parent;
+
+    TIM_GP_LL_DISABLE_COUNTER(p_timer->dev);
+    TIM_GP_LL_DISABLE_UPDATE_DMA_REQ(p_timer->dev);
+
+    if(p_timer->update_dma_callback)
+    {
+        p_timer->update_dma_callback(p_timer);
+    }
+}
+
+/**
+ * @brief Take the stream of a DMA request, unless another driver owns it. TIM1 and
+ * TIM8 requests share DMA2 streams with the USART1 and USART6 ones.
+ *
+ * @return dma_hal_context_t* NULL if the stream is used by another driver
+ */
+static dma_hal_context_t* tim_gp_hal_claim_dma(tim_gp_hal_context_t* p_timer,
+                                        const struct tim_gp_dma_request_t* request)
+{
+    dma_hal_context_t* dma;
+
+    dma = dma_hal_get_claimed(request->dma, request->stream);
+
+    if(dma && dma->parent != (void*) p_timer)
+    {
+        return NULL;
+    }
+
+    return dma_hal_init(request->dma, request->stream);
+}
+
+/**
+ * @brief Common setup of the update DMA stream, the counter is left stopped
+ */
+static error_t tim_gp_hal_setup_update_dma(tim_gp_hal_context_t* p_timer, uint8_t dir,
+                uint32_t src_addr, uint32_t dst_addr, uint16_t len, uint8_t data_size,
+                                                                    uint8_t circular)
+{
+    const struct tim_gp_dma_request_t* request;
+    dma_hal_context_t* dma;
+    dma_init_t* dma_config;
+
+    request = &tim_gp_update_dma_requests[TIM_GP_HAL_INDEX(p_timer->tim)];
+
+    if(!p_timer->update_dma)
+    {
+        p_timer->update_dma = tim_gp_hal_claim_dma(p_timer, request);
+
+        if(!p_timer->update_dma)
+        {
+            return FAILED;
+        }
+    }
+
+    dma = p_timer->update_dma;
+    dma->parent = (void*) p_timer;
+
+    dma_config = &dma->dma_config;
+    dma_config->channel = request->channel;
+    dma_config->dbm_enable = DMA_DBM_DISABLE;
+    dma_config->dir = dir;
+    dma_config->mem_increment = DMA_MEM_INC_ENABLE;
+    dma_config->periph_increment = DMA_PERIPH_INC_DISABLE;
+    /* Same width on both sides, DMA_MEM_SIZE_x and DMA_PERIPH_SIZE_x share values */
+    dma_config->periph_data_size = data_size;
+    dma_config->mem_data_size = data_size;
+    dma_config->priority = DMA_PRI_VERY_HIGH;
+    dma_config->mode = circular ? DMA_MODE_DIRECT_CIRC : DMA_MODE_DIRECT;
+
+    TIM_GP_LL_DISABLE_COUNTER(p_timer->dev);
+    TIM_GP_LL_DISABLE_UPDATE_DMA_REQ(p_timer->dev);
+
+    if(dma_hal_stream_init(dma) != OK)
+    {
+        return FAILED;
+    }
+
+    if(dma_hal_set_transfer(dma, src_addr, dst_addr, len) != OK)
+    {
+        return FAILED;
+    }
+
+    p_timer->update_dma_len = len;
+
+    return OK;
+}
+
+static void tim_gp_hal_update_dma_half(dma_hal_context_t* dma)
+{
+    tim_gp_hal_context_t* p_timer;
+
+    p_timer = (tim_gp_hal_context_t*) dma->parent;
+
+    if(p_timer->update_dma_half_callback)
+    {
+        p_timer->update_dma_half_callback(p_timer);
+    }
+}
+
+static void tim_gp_hal_update_dma_full(dma_hal_context_t* dma)
+{
+    tim_gp_hal_context_t* p_timer;
+
+    p_timer = (tim_gp_hal_context_t*) dma->parent;
+
+    if(p_timer->update_dma_callback)
+    {
+        p_timer->update_dma_callback(p_timer);
+    }
+}
+
+tim_gp_hal_context_t* tim_gp_hal_init(uint8_t tim, const tim_gp_config_t* config)
+{
+    rcc_hal_context_t rcc;
+    tim_gp_hal_context_t* p_timer;
+    uint32_t max_reload;
+
+    if(!TIM_GP_HAL_IS_TIMER(tim) || !config)
+    {
+        return NULL;
+    }
+
+    /* TIM2 and TIM5 are 32 bits counters */
+    max_reload = (tim == TIM_GP_TIM2 || tim == TIM_GP_TIM5) ? UINT32_MAX : UINT16_MAX;
+
+    if(config->reload > max_reload || config->count_mode >= TIM_GP_COUNT_MAX)
+    {
+        return NULL;
+    }
+
+    RCC_HAL_GET_HW(&rcc, RCC);
+
+    p_timer = &gp_timers[TIM_GP_HAL_INDEX(tim)];
+    memset(p_timer, 0, sizeof(tim_gp_hal_context_t));
+    TIM_GP_HAL_GET_HW(p_timer, TIM_GP_HAL_INDEX(tim));
+
+    switch(tim)
+    {
+        case TIM_GP_TIM2:
+            rcc_hal_apb1_en_clk(&rcc, RCC_HAL_TIM2);
+            NVIC_EnableIRQ(TIM2_IRQn);
+            break;
+        case TIM_GP_TIM3:
+            rcc_hal_apb1_en_clk(&rcc, RCC_HAL_TIM3);
+            NVIC_EnableIRQ(TIM3_IRQn);
+            break;
+        case TIM_GP_TIM4:
+            rcc_hal_apb1_en_clk(&rcc, RCC_HAL_TIM4);
+            NVIC_EnableIRQ(TIM4_IRQn);
+            break;
+        case TIM_GP_TIM1:
+            rcc_hal_apb2_en_clk(&rcc, RCC_HAL_TIM1);
+            NVIC_EnableIRQ(TIM1_UP_TIM10_IRQn);
+            NVIC_EnableIRQ(TIM1_CC_IRQn);
+            break;
+        case TIM_GP_TIM8:
+            rcc_hal_apb2_en_clk(&rcc, RCC_HAL_TIM8);
+            NVIC_EnableIRQ(TIM8_UP_TIM13_IRQn);
+            NVIC_EnableIRQ(TIM8_CC_IRQn);
+            break;
+        default:
+            rcc_hal_apb1_en_clk(&rcc, RCC_HAL_TIM5);
+            NVIC_EnableIRQ(TIM5_IRQn);
+            break;
+    }
+
+    p_timer->tim = tim;
+    p_timer->max_reload = max_reload;
+    p_timer->callback = config->callback;
+    p_timer->channel_callback = config->channel_callback;
+
+    TIM_GP_LL_DISABLE_COUNTER(p_timer->dev);
+    TIM_GP_LL_ENABLE_ARR_PRELOAD(p_timer->dev);
+
+    if(config->count_mode == TIM_GP_COUNT_DOWN)
+    {
+        TIM_GP_LL_SET_CENTER_ALIGNED(p_timer->dev, 0);
+        TIM_GP_LL_COUNT_DOWN(p_timer->dev);
+    }
+    else if(config->count_mode == TIM_GP_COUNT_UP)
+    {
+        TIM_GP_LL_SET_CENTER_ALIGNED(p_timer->dev, 0);
+        TIM_GP_LL_COUNT_UP(p_timer->dev);
+    }
+    else
+    {
+        /* Center aligned modes 1 to 3, the direction is then read only */
+        TIM_GP_LL_SET_CENTER_ALIGNED(p_timer->dev, config->count_mode - TIM_GP_COUNT_DOWN);
+    }
+
+    TIM_GP_LL_SET_COUNT(p_timer->dev, 0);
+    TIM_GP_LL_SET_PRESCALER(p_timer->dev, config->prescaler);
+    TIM_GP_LL_SET_ARR(p_timer->dev, config->reload);
+
+    /* Load prescaler and reload now, without an update interrupt */
+    TIM_GP_LL_UEV_OVERFLOW_ONLY(p_timer->dev);
+    TIM_GP_LL_SW_REINIT(p_timer->dev);
+    TIM_GP_LL_CLEAR_ALL_FLAGS(p_timer->dev);
+
+    /* Compare outputs of the advanced timers stay off without the main output enable */
+    if(TIM_GP_HAL_IS_ADVANCED(tim))
+    {
+        TIM_GP_LL_ENABLE_MAIN_OUTPUT(p_timer->dev);
+    }
+
+    /* Set or cleared, a previous init may have left it enabled */
+    if(config->callback)
+    {
+        TIM_GP_LL_ENABLE_UPDATE_IRQ(p_timer->dev);
+    }
+    else
+    {
+        TIM_GP_LL_DISABLE_UPDATE_IRQ(p_timer->dev);
+    }
+
+    return p_timer;
+}
+
+error_t tim_gp_hal_start(tim_gp_hal_context_t* p_timer)
+{
+    if(!p_timer)
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_ENABLE_COUNTER(p_timer->dev);
+
+    return OK;
+}
+
+error_t tim_gp_hal_stop(tim_gp_hal_context_t* p_timer)
+{
+    if(!p_timer)
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_DISABLE_COUNTER(p_timer->dev);
+
+    return OK;
+}
+
+uint32_t tim_gp_hal_get_count(tim_gp_hal_context_t* p_timer)
+{
+    ASSERT(p_timer);
+
+    return TIM_GP_LL_GET_COUNT(p_timer->dev);
+}
+
+error_t tim_gp_hal_set_reload(tim_gp_hal_context_t* p_timer, uint32_t reload)
+{
+    if(!p_timer || reload > p_timer->max_reload)
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_SET_ARR(p_timer->dev, reload);
+
+    return OK;
+}
+
+error_t tim_gp_hal_config_compare(tim_gp_hal_context_t* p_timer, uint8_t channel,
+                                    uint8_t mode, uint32_t compare, uint8_t polarity)
+{
+    uint8_t preload;
+
+    if(!p_timer || !TIM_GP_HAL_IS_CHANNEL(channel) || mode >= TIM_GP_OC_MAX ||
+                    polarity >= TIM_GP_POLARITY_MAX || compare > p_timer->max_reload)
+    {
+        return FAILED;
+    }
+
+    preload = (mode == TIM_GP_OC_PWM1 || mode == TIM_GP_OC_PWM2) ? 1 : 0;
+
+    TIM_GP_LL_DISABLE_CHANNEL(p_timer->dev, channel);
+
+    tim_gp_ll_set_output(p_timer->dev, channel, mode, preload);
+    tim_gp_ll_set_polarity(p_timer->dev, channel, polarity == TIM_GP_POLARITY_LOW, 0);
+    TIM_GP_LL_SET_CCR(p_timer->dev, channel, compare);
+
+    TIM_GP_LL_ENABLE_CHANNEL(p_timer->dev, channel);
+
+    return OK;
+}
+
+error_t tim_gp_hal_set_compare(tim_gp_hal_context_t* p_timer, uint8_t channel, 
+                                                                    uint32_t compare)
+{
+    if(!p_timer || !TIM_GP_HAL_IS_CHANNEL(channel) || compare > p_timer->max_reload)
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_SET_CCR(p_timer->dev, channel, compare);
+
+    return OK;
+}
+
+error_t tim_gp_hal_config_capture(tim_gp_hal_context_t* p_timer, uint8_t channel,
+                                    uint8_t edge, uint8_t prescaler, uint8_t filter)
+{
+    if(!p_timer || !TIM_GP_HAL_IS_CHANNEL(channel) || edge >= TIM_GP_EDGE_MAX ||
+                                    prescaler >= TIM_GP_IC_DIV_MAX || filter > 15)
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_DISABLE_CHANNEL(p_timer->dev, channel);
+
+    tim_gp_ll_set_input(p_timer->dev, channel, prescaler, filter);
+
+    /* CCxP alone selects the falling edge, with CCxNP both edges */
+    tim_gp_ll_set_polarity(p_timer->dev, channel, edge != TIM_GP_EDGE_RISING, 
+                                                            edge == TIM_GP_EDGE_BOTH);
+
+    TIM_GP_LL_CLEAR_CC_FLAG(p_timer->dev, channel);
+    TIM_GP_LL_CLEAR_OVERCAPTURE_FLAG(p_timer->dev, channel);
+    TIM_GP_LL_ENABLE_CHANNEL(p_timer->dev, channel);
+
+    return OK;
+}
+
+uint32_t tim_gp_hal_get_capture(tim_gp_hal_context_t* p_timer, uint8_t channel)
+{
+    ASSERT(p_timer);
+    ASSERT(TIM_GP_HAL_IS_CHANNEL(channel));
+
+    return TIM_GP_LL_GET_CCR(p_timer->dev, channel);
+}
+
+error_t tim_gp_hal_enable_channel_it(tim_gp_hal_context_t* p_timer, uint8_t channel)
+{
+    if(!p_timer || !TIM_GP_HAL_IS_CHANNEL(channel))
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_CLEAR_CC_FLAG(p_timer->dev, channel);
+    TIM_GP_LL_ENABLE_CC_IRQ(p_timer->dev, channel);
+
+    return OK;
+}
+
+error_t tim_gp_hal_disable_channel_it(tim_gp_hal_context_t* p_timer, uint8_t channel)
+{
+    if(!p_timer || !TIM_GP_HAL_IS_CHANNEL(channel))
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_DISABLE_CC_IRQ(p_timer->dev, channel);
+
+    return OK;
+}
+
+error_t tim_gp_hal_start_capture_dma(tim_gp_hal_context_t* p_timer, uint8_t channel,
+                                                            void* buffer, uint16_t len)
+{
+    const struct tim_gp_dma_request_t* request;
+    dma_hal_context_t* dma;
+    dma_init_t* dma_config;
+
+    if(!p_timer || !TIM_GP_HAL_IS_CHANNEL(channel) || !buffer || len == 0)
+    {
+        return FAILED;
+    }
+
+    request = &tim_gp_dma_requests[TIM_GP_HAL_INDEX(p_timer->tim)][channel];
+
+    if(request->stream == TIM_GP_HAL_NO_DMA)
+    {
+        return FAILED;
+    }
+
+    if(!p_timer->capture_dma[channel])
+    {
+        p_timer->capture_dma[channel] = tim_gp_hal_claim_dma(p_timer, request);
+
+        if(!p_timer->capture_dma[channel])
+        {
+            return FAILED;
+        }
+    }
+
+    dma = p_timer->capture_dma[channel];
+    dma->parent = (void*) p_timer;
+
+    dma_config = &dma->dma_config;
+    dma_config->channel = request->channel;
+    dma_config->dbm_enable = DMA_DBM_DISABLE;
+    dma_config->dir = DMA_PERIPH_TO_MEM;
+    dma_config->mem_increment = DMA_MEM_INC_ENABLE;
+    dma_config->periph_increment = DMA_PERIPH_INC_DISABLE;
+    dma_config->priority = DMA_PRI_HIGH;
+    dma_config->mode = DMA_MODE_DIRECT_CIRC;
+
+    /* A capture is moved whole, the width of the counter */
+    if(p_timer->max_reload == UINT32_MAX)
+    {
+        dma_config->periph_data_size = DMA_PERIPH_SIZE_WORD;
+        dma_config->mem_data_size = DMA_MEM_SIZE_WORD;
+    }
+    else
+    {
+        dma_config->periph_data_size = DMA_PERIPH_SIZE_HALF_WORD;
+        dma_config->mem_data_size = DMA_MEM_SIZE_HALF_WORD;
+    }
+
+    TIM_GP_LL_DISABLE_CC_DMA_REQ(p_timer->dev, channel);
+
+    if(dma_hal_stream_init(dma) != OK)
+    {
+        return FAILED;
+    }
+
+    if(dma_hal_set_transfer(dma, TIM_GP_LL_GET_CCR_ADDR(p_timer->dev, channel), 
+                                                    (uint32_t) (uintptr_t) buffer, len) != OK)
+    {
+        return FAILED;
+    }
+
+    p_timer->capture_len[channel] = len;
+    dma_hal_start(dma);
+
+    TIM_GP_LL_CLEAR_OVERCAPTURE_FLAG(p_timer->dev, channel);
+    TIM_GP_LL_ENABLE_CC_DMA_REQ(p_timer->dev, channel);
+
+    return OK;
+}
+
+uint16_t tim_gp_hal_get_capture_dma_index(tim_gp_hal_context_t* p_timer, uint8_t channel)
+{
+    uint16_t remaining;
+
+    ASSERT(p_timer);
+    ASSERT(TIM_GP_HAL_IS_CHANNEL(channel));
+
+    if(!p_timer->capture_dma[channel] || p_timer->capture_len[channel] == 0)
+    {
+        return 0;
+    }
+
+    remaining = dma_hal_get_remaining_items(p_timer->capture_dma[channel]);
+
+    /* NDTR is reloaded right after the last entry, it reads len at index 0 */
+    return (p_timer->capture_len[channel] - remaining) % p_timer->capture_len[channel];
+}
+
+error_t tim_gp_hal_stop_capture_dma(tim_gp_hal_context_t* p_timer, uint8_t channel)
+{
+    if(!p_timer || !TIM_GP_HAL_IS_CHANNEL(channel) || !p_timer->capture_dma[channel])
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_DISABLE_CC_DMA_REQ(p_timer->dev, channel);
+    p_timer->capture_len[channel] = 0;
+
+    return dma_hal_abort(p_timer->capture_dma[channel]);
+}
+
+error_t tim_gp_hal_start_update_dma(tim_gp_hal_context_t* p_timer, uint32_t periph_addr,
+                    const uint32_t* buffer, uint16_t len, uint8_t circular, 
+                                                        tim_gp_callback_t callback)
+{
+    if(!p_timer || !buffer || len == 0)
+    {
+        return FAILED;
+    }
+
+    if(tim_gp_hal_setup_update_dma(p_timer, DMA_MEM_TO_PERIPH, (uint32_t) (uintptr_t) buffer,
+                                periph_addr, len, DMA_PERIPH_SIZE_WORD, circular) != OK)
+    {
+        return FAILED;
+    }
+
+    p_timer->update_dma->xfer_half_callback = NULL;
+    p_timer->update_dma->xfer_complete_callback = 
+                                circular ? NULL : &tim_gp_hal_update_dma_complete;
+    p_timer->update_dma_callback = callback;
+    p_timer->update_dma_half_callback = NULL;
+
+    if(circular)
+    {
+        dma_hal_start(p_timer->update_dma);
+    }
+    else
+    {
+        dma_hal_start_it(p_timer->update_dma);
+    }
+
+    /* First word on the first update event, one period after the counter starts */
+    TIM_GP_LL_SET_COUNT(p_timer->dev, 0);
+    TIM_GP_LL_ENABLE_UPDATE_DMA_REQ(p_timer->dev);
+    TIM_GP_LL_ENABLE_COUNTER(p_timer->dev);
+
+    return OK;
+}
+
+error_t tim_gp_hal_start_update_dma_read(tim_gp_hal_context_t* p_timer, uint32_t periph_addr,
+            uint16_t* buffer, uint16_t len, tim_gp_callback_t half_callback, 
+                                                    tim_gp_callback_t complete_callback)
+{
+    if(!p_timer || !buffer || len < 2)
+    {
+        return FAILED;
+    }
+
+    if(tim_gp_hal_setup_update_dma(p_timer, DMA_PERIPH_TO_MEM, periph_addr, 
+                            (uint32_t) (uintptr_t) buffer, len, DMA_PERIPH_SIZE_HALF_WORD, 1) != OK)
+    {
+        return FAILED;
+    }
+
+    p_timer->update_dma_half_callback = half_callback;
+    p_timer->update_dma_callback = complete_callback;
+    p_timer->update_dma->xfer_half_callback = half_callback ? &tim_gp_hal_update_dma_half : NULL;
+    p_timer->update_dma->xfer_complete_callback = &tim_gp_hal_update_dma_full;
+
+    if(half_callback || complete_callback)
+    {
+        dma_hal_start_it(p_timer->update_dma);
+    }
+    else
+    {
+        dma_hal_start(p_timer->update_dma);
+    }
+
+    TIM_GP_LL_SET_COUNT(p_timer->dev, 0);
+    TIM_GP_LL_ENABLE_UPDATE_DMA_REQ(p_timer->dev);
+    TIM_GP_LL_ENABLE_COUNTER(p_timer->dev);
+
+    return OK;
+}
+
+uint16_t tim_gp_hal_get_update_dma_index(tim_gp_hal_context_t* p_timer)
+{
+    uint16_t remaining;
+
+    ASSERT(p_timer);
+
+    if(!p_timer->update_dma || p_timer->update_dma_len == 0)
+    {
+        return 0;
+    }
+
+    remaining = dma_hal_get_remaining_items(p_timer->update_dma);
+
+    return (p_timer->update_dma_len - remaining) % p_timer->update_dma_len;
+}
+
+uint8_t tim_gp_hal_is_update_dma_busy(tim_gp_hal_context_t* p_timer)
+{
+    ASSERT(p_timer);
+
+    return TIM_GP_LL_IS_COUNTER_ENABLED(p_timer->dev) && 
+                                    TIM_GP_LL_IS_UPDATE_DMA_REQ_ENABLED(p_timer->dev);
+}
+
+error_t tim_gp_hal_stop_update_dma(tim_gp_hal_context_t* p_timer)
+{
+    if(!p_timer || !p_timer->update_dma)
+    {
+        return FAILED;
+    }
+
+    TIM_GP_LL_DISABLE_COUNTER(p_timer->dev);
+    TIM_GP_LL_DISABLE_UPDATE_DMA_REQ(p_timer->dev);
+
+    return dma_hal_abort(p_timer->update_dma);
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#ifndef __TIM_GP_TYPES_H__
+
+#define __TIM_GP_TYPES_H__
+
+#include "TIM_GP_periph.h"
+#include "dma_hal_ext.h"
+
+#include <stdint.h>
+
+typedef struct TIM_GP_HAL_CONTEXT tim_gp_hal_context_t;
+
+typedef void (*tim_gp_callback_t) (tim_gp_hal_context_t*);
+
+typedef void (*tim_gp_channel_callback_t) (tim_gp_hal_context_t*, uint8_t channel);
+
+/* TIM1 and TIM8 are advanced timers, used here for their general purpose features */
+enum
+{
+    TIM_GP_TIM1 = 1,
+    TIM_GP_TIM2 = 2,
+    TIM_GP_TIM3 = 3,
+    TIM_GP_TIM4 = 4,
+    TIM_GP_TIM5 = 5,
+    TIM_GP_TIM8 = 8,
+};
+
+typedef enum
+{
+    TIM_GP_CHANNEL_1,
+    TIM_GP_CHANNEL_2,
+    TIM_GP_CHANNEL_3,
+    TIM_GP_CHANNEL_4,
+    TIM_GP_CHANNEL_MAX
+} tim_gp_channel_t;
+
+typedef enum
+{
+    TIM_GP_COUNT_UP,
+    TIM_GP_COUNT_DOWN,
+    TIM_GP_COUNT_CENTER_1,      /* Compare flags set while counting down */
+    TIM_GP_COUNT_CENTER_2,      /* Compare flags set while counting up */
+    TIM_GP_COUNT_CENTER_3,      /* Compare flags set both ways */
+    TIM_GP_COUNT_MAX
+} tim_gp_count_mode_t;
+
+/* Values of OCxM */
+typedef enum
+{
+    TIM_GP_OC_FROZEN,
+    TIM_GP_OC_ACTIVE,
+    TIM_GP_OC_INACTIVE,
+    TIM_GP_OC_TOGGLE,
+    TIM_GP_OC_FORCE_INACTIVE,
+    TIM_GP_OC_FORCE_ACTIVE,
+    TIM_GP_OC_PWM1,
+    TIM_GP_OC_PWM2,
+    TIM_GP_OC_MAX
+} tim_gp_oc_mode_t;
+
+typedef enum
+{
+    TIM_GP_POLARITY_HIGH,
+    TIM_GP_POLARITY_LOW,
+    TIM_GP_POLARITY_MAX
+} tim_gp_polarity_t;
+
+typedef enum
+{
+    TIM_GP_EDGE_RISING,
+    TIM_GP_EDGE_FALLING,
+    TIM_GP_EDGE_BOTH,
+    TIM_GP_EDGE_MAX
+} tim_gp_edge_t;
+
+/* Values of ICxPSC, one capture every 1, 2, 4 or 8 edges */
+typedef enum
+{
+    TIM_GP_IC_DIV_1,
+    TIM_GP_IC_DIV_2,
+    TIM_GP_IC_DIV_4,
+    TIM_GP_IC_DIV_8,
+    TIM_GP_IC_DIV_MAX
+} tim_gp_ic_prescaler_t;
+
+typedef struct
+{
+    uint16_t prescaler;
+    uint32_t reload;            /* 32 bits on TIM2 and TIM5, 16 bits on the others */
+    uint8_t count_mode;
+    tim_gp_callback_t callback;
+    tim_gp_channel_callback_t channel_callback;
+} tim_gp_config_t;
+
+struct TIM_GP_HAL_CONTEXT
+{
+    tim_gp_dev_t    dev;
+    uint32_t    max_reload;
+    tim_gp_callback_t   callback;
+    tim_gp_channel_callback_t   channel_callback;
+    dma_hal_context_t*  capture_dma[TIM_GP_CHANNEL_MAX];
+    uint16_t    capture_len[TIM_GP_CHANNEL_MAX];
+    dma_hal_context_t*  update_dma;
+    tim_gp_callback_t   update_dma_callback;
+    tim_gp_callback_t   update_dma_half_callback;
+    uint16_t    update_dma_len;
+    uint8_t     tim;
+};
+
+#endif
\ No newline at end of file
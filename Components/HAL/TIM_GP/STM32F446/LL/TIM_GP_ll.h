@@ -0,0 +1,148 @@
+#ifndef __TIM_GP_LL_H__
+
+#define __TIM_GP_LL_H__
+
+#include "TIM_GP_periph.h"
+
+#include "bit_math.h"
+#include "types.h"
+
+#include <stdint.h>
+
+
+#define TIM_GP_LL_ENABLE_COUNTER(hw)        REG_SET_BIT((hw)->cr1, TIM_GP_CR1_CEN_S)
+#define TIM_GP_LL_DISABLE_COUNTER(hw)       REG_CLR_BIT((hw)->cr1, TIM_GP_CR1_CEN_S)
+#define TIM_GP_LL_IS_COUNTER_ENABLED(hw)    (REG_GET_BIT((hw)->cr1, TIM_GP_CR1_CEN_S) ? 1 : 0)
+
+#define TIM_GP_LL_ENABLE_ARR_PRELOAD(hw)    REG_SET_BIT((hw)->cr1, TIM_GP_CR1_ARPE_S)
+#define TIM_GP_LL_DISABLE_ARR_PRELOAD(hw)   REG_CLR_BIT((hw)->cr1, TIM_GP_CR1_ARPE_S)
+
+#define TIM_GP_LL_UEV_OVERFLOW_ONLY(hw)     REG_SET_BIT((hw)->cr1, TIM_GP_CR1_URS_S)
+
+#define TIM_GP_LL_COUNT_UP(hw)              REG_CLR_BIT((hw)->cr1, TIM_GP_CR1_DIR_S)
+#define TIM_GP_LL_COUNT_DOWN(hw)            REG_SET_BIT((hw)->cr1, TIM_GP_CR1_DIR_S)
+#define TIM_GP_LL_SET_CENTER_ALIGNED(hw, cms) \
+                        REG_WRITE_BITS((hw)->cr1, TIM_GP_CR1_CMS_S, TIM_GP_CR1_CMS_M, (cms))
+
+#define TIM_GP_LL_ENABLE_UPDATE_IRQ(hw)     REG_SET_BIT((hw)->dier, TIM_GP_DIER_UIE_S)
+#define TIM_GP_LL_DISABLE_UPDATE_IRQ(hw)    REG_CLR_BIT((hw)->dier, TIM_GP_DIER_UIE_S)
+
+#define TIM_GP_LL_ENABLE_CC_IRQ(hw, ch)     REG_SET_BIT((hw)->dier, TIM_GP_DIER_CC1IE_S << (ch))
+#define TIM_GP_LL_DISABLE_CC_IRQ(hw, ch)    REG_CLR_BIT((hw)->dier, TIM_GP_DIER_CC1IE_S << (ch))
+#define TIM_GP_LL_IS_CC_IRQ_ENABLED(hw, ch) \
+                        (REG_GET_BIT((hw)->dier, TIM_GP_DIER_CC1IE_S << (ch)) ? 1 : 0)
+
+#define TIM_GP_LL_ENABLE_UPDATE_DMA_REQ(hw) REG_SET_BIT((hw)->dier, TIM_GP_DIER_UDE_S)
+#define TIM_GP_LL_DISABLE_UPDATE_DMA_REQ(hw) REG_CLR_BIT((hw)->dier, TIM_GP_DIER_UDE_S)
+#define TIM_GP_LL_IS_UPDATE_DMA_REQ_ENABLED(hw) \
+                        (REG_GET_BIT((hw)->dier, TIM_GP_DIER_UDE_S) ? 1 : 0)
+
+#define TIM_GP_LL_ENABLE_CC_DMA_REQ(hw, ch) REG_SET_BIT((hw)->dier, TIM_GP_DIER_CC1DE_S << (ch))
+#define TIM_GP_LL_DISABLE_CC_DMA_REQ(hw, ch) \
+                        REG_CLR_BIT((hw)->dier, TIM_GP_DIER_CC1DE_S << (ch))
+
+/* Status flags are cleared by writing 0, other flags are left untouched by writing 1 */
+#define TIM_GP_LL_GET_UPDATE_FLAG(hw)       REG_GET_BIT((hw)->sr, TIM_GP_SR_UIF_S)
+#define TIM_GP_LL_CLEAR_UPDATE_FLAG(hw)     ((hw)->sr = (uint32_t) ~TIM_GP_SR_UIF_S)
+#define TIM_GP_LL_GET_CC_FLAG(hw, ch)       REG_GET_BIT((hw)->sr, TIM_GP_SR_CC1IF_S << (ch))
+#define TIM_GP_LL_CLEAR_CC_FLAG(hw, ch)     ((hw)->sr = (uint32_t) ~(TIM_GP_SR_CC1IF_S << (ch)))
+#define TIM_GP_LL_GET_OVERCAPTURE_FLAG(hw, ch) \
+                        REG_GET_BIT((hw)->sr, TIM_GP_SR_CC1OF_S << (ch))
+#define TIM_GP_LL_CLEAR_OVERCAPTURE_FLAG(hw, ch) \
+                        ((hw)->sr = (uint32_t) ~(TIM_GP_SR_CC1OF_S << (ch)))
+#define TIM_GP_LL_CLEAR_ALL_FLAGS(hw)       ((hw)->sr = 0)
+
+#define TIM_GP_LL_SW_REINIT(hw)             REG_SET_BIT((hw)->egr, TIM_GP_EGR_UG_S)
+
+#define TIM_GP_LL_SET_COUNT(hw, count)      ((hw)->cnt = (count))
+#define TIM_GP_LL_GET_COUNT(hw)             ((hw)->cnt)
+
+#define TIM_GP_LL_SET_PRESCALER(hw, pre)    ((hw)->psc = ((pre) & 0xFFFF))
+#define TIM_GP_LL_GET_PRESCALER(hw)         (((hw)->psc) & 0xFFFF)
+
+#define TIM_GP_LL_SET_ARR(hw, reload)       ((hw)->arr = (reload))
+#define TIM_GP_LL_GET_ARR(hw)               ((hw)->arr)
+
+#define TIM_GP_LL_SET_CCR(hw, ch, value)    ((hw)->ccr[(ch)] = (value))
+#define TIM_GP_LL_GET_CCR(hw, ch)           ((hw)->ccr[(ch)])
+#define TIM_GP_LL_GET_CCR_ADDR(hw, ch)      ((uint32_t) (uintptr_t) &(hw)->ccr[(ch)])
+
+#define TIM_GP_LL_ENABLE_CHANNEL(hw, ch)    REG_SET_BIT((hw)->ccer, TIM_GP_CCER_CCE_S << ((ch) * 4))
+#define TIM_GP_LL_DISABLE_CHANNEL(hw, ch)   REG_CLR_BIT((hw)->ccer, TIM_GP_CCER_CCE_S << ((ch) * 4))
+
+#define TIM_GP_LL_ENABLE_MAIN_OUTPUT(hw)    REG_SET_BIT((hw)->bdtr, TIM_GP_BDTR_MOE_S)
+
+/* Channels 1 and 3 use the low byte of CCMR1 and CCMR2, channels 2 and 4 the high byte */
+#define TIM_GP_LL_CCMR_SHIFT(ch)            (((ch) & 1U) * 8U)
+
+
+/**
+ * @brief Channel as output compare, the channel must be disabled
+ * 
+ * @param hw 
+ * @param ch 0 to 3
+ * @param ocm output compare mode written to OCxM
+ * @param preload 1 to apply CCR writes on the next update event
+ */
+STATIC_INLINE void tim_gp_ll_set_output(tim_gp_dev_t hw, uint8_t ch, uint8_t ocm, uint8_t preload)
+{
+    uint32_t ccmr;
+
+    ccmr = (uint32_t) (ocm & TIM_GP_CCMR_OCM_M) << TIM_GP_CCMR_OCM_S;
+
+    if(preload)
+    {
+        ccmr |= TIM_GP_CCMR_OCPE_S;
+    }
+
+    REG_WRITE_BITS(hw->ccmr[ch >> 1], TIM_GP_LL_CCMR_SHIFT(ch), TIM_GP_CCMR_CHANNEL_M, ccmr);
+}
+
+/**
+ * @brief Channel as input capture of its own input TIx, the channel must be disabled
+ * 
+ * @param hw 
+ * @param ch 0 to 3
+ * @param psc capture every 1, 2, 4 or 8 edges, written to ICxPSC
+ * @param filter written to ICxF
+ */
+STATIC_INLINE void tim_gp_ll_set_input(tim_gp_dev_t hw, uint8_t ch, uint8_t psc, uint8_t filter)
+{
+    uint32_t ccmr;
+
+    /* CCxS = 01, ICx mapped on TIx */
+    ccmr = 1U << TIM_GP_CCMR_CCS_S;
+    ccmr |= (uint32_t) (psc & TIM_GP_CCMR_ICPSC_M) << TIM_GP_CCMR_ICPSC_S;
+    ccmr |= (uint32_t) (filter & TIM_GP_CCMR_ICF_M) << TIM_GP_CCMR_ICF_S;
+
+    REG_WRITE_BITS(hw->ccmr[ch >> 1], TIM_GP_LL_CCMR_SHIFT(ch), TIM_GP_CCMR_CHANNEL_M, ccmr);
+}
+
+/**
+ * @brief Output polarity, or capture edge of an input channel
+ * 
+ * @param hw 
+ * @param ch 0 to 3
+ * @param ccp CCxP, active low output or falling edge
+ * @param ccnp CCxNP, together with CCxP both edges for an input
+ */
+STATIC_INLINE void tim_gp_ll_set_polarity(tim_gp_dev_t hw, uint8_t ch, uint8_t ccp, uint8_t ccnp)
+{
+    uint32_t ccer;
+
+    ccer = 0;
+
+    if(ccp)
+    {
+        ccer |= TIM_GP_CCER_CCP_S;
+    }
+
+    if(ccnp)
+    {
+        ccer |= TIM_GP_CCER_CCNP_S;
+    }
+
+    REG_WRITE_BITS(hw->ccer, ch * 4U, TIM_GP_CCER_POLARITY_M, ccer);
+}
+
+#endif
\ No newline at end of file
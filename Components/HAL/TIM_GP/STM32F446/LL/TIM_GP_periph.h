@@ -0,0 +1,97 @@
+#ifndef __TIM_GP_PERIPH_H__
+
+#define __TIM_GP_PERIPH_H__
+
+#include "bit_math.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef volatile struct TIM_GP_PERIPH* tim_gp_dev_t;
+
+#define _TIM2   ((tim_gp_dev_t) 0x40000000UL)
+#define _TIM3   ((tim_gp_dev_t) 0x40000400UL)
+#define _TIM4   ((tim_gp_dev_t) 0x40000800UL)
+#define _TIM5   ((tim_gp_dev_t) 0x40000C00UL)
+#define _TIM1   ((tim_gp_dev_t) 0x40010000UL)
+#define _TIM8   ((tim_gp_dev_t) 0x40010400UL)
+
+#define TIM_GP_CR1_CEN_S        BIT(0)
+#define TIM_GP_CR1_UDIS_S       BIT(1)
+#define TIM_GP_CR1_URS_S        BIT(2)
+#define TIM_GP_CR1_OPM_S        BIT(3)
+#define TIM_GP_CR1_DIR_S        BIT(4)
+#define TIM_GP_CR1_CMS_S        (5)
+#define TIM_GP_CR1_CMS_M        (0x3)
+#define TIM_GP_CR1_ARPE_S       BIT(7)
+
+#define TIM_GP_DIER_UIE_S       BIT(0)
+#define TIM_GP_DIER_CC1IE_S     BIT(1)
+#define TIM_GP_DIER_UDE_S       BIT(8)
+#define TIM_GP_DIER_CC1DE_S     BIT(9)
+
+#define TIM_GP_SR_UIF_S         BIT(0)
+#define TIM_GP_SR_CC1IF_S       BIT(1)
+#define TIM_GP_SR_CC1OF_S       BIT(9)
+
+#define TIM_GP_EGR_UG_S         BIT(0)
+
+/* Each CCMR register holds two channels of 8 bits */
+#define TIM_GP_CCMR_CCS_S       (0)
+#define TIM_GP_CCMR_CCS_M       (0x3)
+#define TIM_GP_CCMR_OCPE_S      BIT(3)
+#define TIM_GP_CCMR_OCM_S       (4)
+#define TIM_GP_CCMR_OCM_M       (0x7)
+#define TIM_GP_CCMR_ICPSC_S     (2)
+#define TIM_GP_CCMR_ICPSC_M     (0x3)
+#define TIM_GP_CCMR_ICF_S       (4)
+#define TIM_GP_CCMR_ICF_M       (0xF)
+#define TIM_GP_CCMR_CHANNEL_M   (0xFF)
+
+/* Each channel has 4 bits in CCER */
+#define TIM_GP_CCER_CCE_S       BIT(0)
+#define TIM_GP_CCER_CCP_S       BIT(1)
+#define TIM_GP_CCER_CCNP_S      BIT(3)
+#define TIM_GP_CCER_POLARITY_M  (0xA)
+
+/* TIM1 and TIM8 only, outputs are driven once MOE is set */
+#define TIM_GP_BDTR_MOE_S       BIT(15)
+
+
+struct TIM_GP_PERIPH
+{
+    uint32_t cr1;
+    uint32_t cr2;
+    uint32_t smcr;
+    uint32_t dier;
+    uint32_t sr;
+    uint32_t egr;
+    uint32_t ccmr[2];
+    uint32_t ccer;
+    uint32_t cnt;
+    uint32_t psc;
+    uint32_t arr;
+    uint32_t rcr;               /* TIM1 and TIM8 only */
+    uint32_t ccr[4];
+    uint32_t bdtr;              /* TIM1 and TIM8 only */
+    uint32_t dcr;
+    uint32_t dmar;
+    uint32_t or;
+};
+
+static const tim_gp_dev_t TIM_GP_LL_TIMx[] = 
+{
+    _TIM2,
+    _TIM3,
+    _TIM4,
+    _TIM5,
+    _TIM1,
+    _TIM8
+};
+
+#define TIM_GP_LL_DEVS   (sizeof(TIM_GP_LL_TIMx) / sizeof(TIM_GP_LL_TIMx[0]))
+
+#define TIM_GP_LL_GET_HW(num) \
+                        (((num) < TIM_GP_LL_DEVS) ? TIM_GP_LL_TIMx[num] : NULL)
+
+#endif
\ No newline at end of file
@@ -0,0 +1,217 @@
+#ifndef __TIM_GP_HAL_H__
+
+#define __TIM_GP_HAL_H__
+
+#include "TIM_GP_types.h"
+#include "TIM_GP_periph.h"
+
+#include "types.h"
+
+#define TIM_GP_HAL_GET_HW(hw, tim)      ((hw)->dev = TIM_GP_LL_GET_HW(tim))
+
+
+/**
+ * @brief Clock the timer and set its time base, the counter is left stopped.
+ * Pins are set to their alternate function by the caller.
+ * 
+ * @param tim TIM_GP_TIM1 to TIM_GP_TIM5 or TIM_GP_TIM8
+ * @param config 
+ * @return tim_gp_hal_context_t* NULL if the timer or the configuration is invalid
+ */
+tim_gp_hal_context_t* tim_gp_hal_init(uint8_t tim, const tim_gp_config_t* config);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @return error_t 
+ */
+error_t tim_gp_hal_start(tim_gp_hal_context_t* p_timer);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @return error_t 
+ */
+error_t tim_gp_hal_stop(tim_gp_hal_context_t* p_timer);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @return uint32_t 
+ */
+uint32_t tim_gp_hal_get_count(tim_gp_hal_context_t* p_timer);
+
+/**
+ * @brief Change the period, applied on the next update event
+ * 
+ * @param p_timer 
+ * @param reload 
+ * @return error_t 
+ */
+error_t tim_gp_hal_set_reload(tim_gp_hal_context_t* p_timer, uint32_t reload);
+
+/**
+ * @brief Set a channel as output compare, the PWM modes take new compare values 
+ * on the next update event so a period is never cut.
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @param mode tim_gp_oc_mode_t
+ * @param compare 
+ * @param polarity tim_gp_polarity_t
+ * @return error_t 
+ */
+error_t tim_gp_hal_config_compare(tim_gp_hal_context_t* p_timer, uint8_t channel,
+                                    uint8_t mode, uint32_t compare, uint8_t polarity);
+
+/**
+ * @brief PWM duty cycle or compare value of an output channel
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @param compare 
+ * @return error_t 
+ */
+error_t tim_gp_hal_set_compare(tim_gp_hal_context_t* p_timer, uint8_t channel, 
+                                                                    uint32_t compare);
+
+/**
+ * @brief Set a channel as input capture of its own pin
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @param edge tim_gp_edge_t
+ * @param prescaler tim_gp_ic_prescaler_t
+ * @param filter 0 to 15, see ICxF
+ * @return error_t 
+ */
+error_t tim_gp_hal_config_capture(tim_gp_hal_context_t* p_timer, uint8_t channel,
+                                    uint8_t edge, uint8_t prescaler, uint8_t filter);
+
+/**
+ * @brief Latest captured counter value of a channel
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @return uint32_t 
+ */
+uint32_t tim_gp_hal_get_capture(tim_gp_hal_context_t* p_timer, uint8_t channel);
+
+/**
+ * @brief Call channel_callback on each compare match or capture of the channel
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @return error_t 
+ */
+error_t tim_gp_hal_enable_channel_it(tim_gp_hal_context_t* p_timer, uint8_t channel);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @return error_t 
+ */
+error_t tim_gp_hal_disable_channel_it(tim_gp_hal_context_t* p_timer, uint8_t channel);
+
+/**
+ * @brief Stream the captures of a channel into a circular buffer by DMA, no CPU is
+ * involved per edge. Entries are 32 bits on TIM2 and TIM5, 16 bits on the others.
+ * 
+ * @param p_timer 
+ * @param channel configured by tim_gp_hal_config_capture
+ * @param buffer 
+ * @param len number of entries
+ * @return error_t FAILED if the channel has no DMA request, TIM4 channel 4, or its
+ *         stream is used by another driver
+ */
+error_t tim_gp_hal_start_capture_dma(tim_gp_hal_context_t* p_timer, uint8_t channel,
+                                                            void* buffer, uint16_t len);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @return uint16_t index of the buffer entry the next capture is written to
+ */
+uint16_t tim_gp_hal_get_capture_dma_index(tim_gp_hal_context_t* p_timer, uint8_t channel);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @param channel 
+ * @return error_t 
+ */
+error_t tim_gp_hal_stop_capture_dma(tim_gp_hal_context_t* p_timer, uint8_t channel);
+
+/**
+ * @brief Write a buffer of words to a peripheral register by DMA, one word on each 
+ * update event, so the register changes at the exact period of the timer with no 
+ * CPU involved. The counter is started, the first word is written one period later.
+ * Only TIM1 and TIM8 are served by DMA2, which alone reaches AHB registers like GPIO.
+ * 
+ * @param p_timer 
+ * @param periph_addr register written
+ * @param buffer 
+ * @param len number of words
+ * @param circular 1 to repeat the buffer until tim_gp_hal_stop_update_dma
+ * @param callback called from the DMA interrupt once a one-shot buffer is written and
+ * the counter stopped, may be NULL
+ * @return error_t FAILED if the update stream is used by another driver, DMA2
+ *         stream 1 of TIM8 is the USART6 Rx stream
+ */
+error_t tim_gp_hal_start_update_dma(tim_gp_hal_context_t* p_timer, uint32_t periph_addr,
+                    const uint32_t* buffer, uint16_t len, uint8_t circular, 
+                                                        tim_gp_callback_t callback);
+
+/**
+ * @brief Sample a peripheral register into a circular buffer of half words by DMA, 
+ * one read on each update event, e.g. a GPIO input register. The counter is started.
+ * As for writes only TIM1 and TIM8 reach AHB registers.
+ * 
+ * @param p_timer 
+ * @param periph_addr register read
+ * @param buffer 
+ * @param len number of half words, the halves are filled in turn
+ * @param half_callback called from the DMA interrupt once the first half is filled,
+ * may be NULL
+ * @param complete_callback called from the DMA interrupt once the second half is 
+ * filled, may be NULL
+ * @return error_t FAILED if the update stream is used by another driver
+ */
+error_t tim_gp_hal_start_update_dma_read(tim_gp_hal_context_t* p_timer, uint32_t periph_addr,
+            uint16_t* buffer, uint16_t len, tim_gp_callback_t half_callback, 
+                                                    tim_gp_callback_t complete_callback);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @return uint16_t index of the buffer entry the next update DMA transfer moves
+ */
+uint16_t tim_gp_hal_get_update_dma_index(tim_gp_hal_context_t* p_timer);
+
+/**
+ * @brief 
+ * 
+ * @param p_timer 
+ * @return uint8_t 1 while an update DMA transfer runs
+ */
+uint8_t tim_gp_hal_is_update_dma_busy(tim_gp_hal_context_t* p_timer);
+
+/**
+ * @brief Stop the counter and the update DMA transfer, the register keeps the last
+ * word written
+ * 
+ * @param p_timer 
+ * @return error_t 
+ */
+error_t tim_gp_hal_stop_update_dma(tim_gp_hal_context_t* p_timer);
+
+#endif
\ No newline at end of file
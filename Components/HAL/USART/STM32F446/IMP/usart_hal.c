@@ -37,6 +37,7 @@ static error_t usart_hal_transmit_8b(usart_hal_context_t* usart,
                                         const uint8_t* pdata, uint16_t size);
 
 static void usart_hal_tx_dma_complete(dma_hal_context_t* dma);
+static void usart_hal_tx_dma_rearmed(dma_hal_context_t* dma);
 static void usart_hal_rx_dma_complete(dma_hal_context_t* dma);
 
 static void usart_hal_tx_dma_error(dma_hal_context_t* dma);
@@ -83,8 +84,7 @@ usart_hal_context_t* usart_hal_init(uint8_t port)
     {
         GPIO_HAL_GET_HW(&gpio, GPIOA);
         gpio_hal_init(GPIOA);
-        gpio_hal_set_mode_alternate_pp(&gpio, GPIO_PIN_9, 7);
-        gpio_hal_set_mode_alternate_pp(&gpio, GPIO_PIN_10, 7);
+        gpio_hal_set_mode_alternate_pp_mask(&gpio, BIT(GPIO_PIN_9) | BIT(GPIO_PIN_10), 7);
         rcc_hal_apb2_en_clk(&rcc, RCC_HAL_USART1);
         NVIC_EnableIRQ(USART1_IRQn);
     }
@@ -92,8 +92,7 @@ usart_hal_context_t* usart_hal_init(uint8_t port)
     {
         GPIO_HAL_GET_HW(&gpio, GPIOC);
         gpio_hal_init(GPIOC);
-        gpio_hal_set_mode_alternate_pp(&gpio, GPIO_PIN_6, 8);
-        gpio_hal_set_mode_alternate_pp(&gpio, GPIO_PIN_7, 8);
+        gpio_hal_set_mode_alternate_pp_mask(&gpio, BIT(GPIO_PIN_6) | BIT(GPIO_PIN_7), 8);
         rcc_hal_apb2_en_clk(&rcc, RCC_HAL_USART6);
         NVIC_EnableIRQ(USART6_IRQn);
     }
@@ -192,6 +191,7 @@ error_t usart_hal_tx_dma_setup(usart_hal_context_t* usart, uint8_t dma_circular)
 
     usart->tx_dma->parent = (void*) usart;
     usart->tx_dma->xfer_complete_callback = usart_hal_tx_dma_complete;
+    usart->tx_dma->reconfig_callback = usart_hal_tx_dma_rearmed;
     usart->tx_dma->error_callback = usart_hal_tx_dma_error;
 
     dma_config = &usart->tx_dma->dma_config;
@@ -388,16 +388,28 @@ error_t usart_hal_transmit_dma(usart_hal_context_t* usart, const uint8_t* pdata,
     ASSERT(pdata);
     ASSERT(sz);
 
+    /* A single transfer still moving data is never cut short */
+    if(usart->tx_dma->state == DMA_STATE_BUSY && 
+                (usart->tx_dma->dma_config.mode & DMA_CIRC) == 0)
+    {
+        return FAILED;
+    }
+
     usart->error_code = USART_ERROR_NONE;
     usart->tx_pbuffer = pdata;
     usart->tx_buffersize = sz;
     usart->tx_count = sz;
 
-    dma_hal_set_transfer(usart->tx_dma, (uint32_t) pdata, (uint32_t) &usart->dev->dr, sz);
-    dma_hal_start_it(usart->tx_dma);
-
-    REG_CLR_BIT(usart->dev->sr, USART_SR_TC_S);
-    usart_ll_enable_tx_dma(usart->dev);
+    /*
+    * Re-armed without spinning on EN: a stream that is still releasing is
+    * reprogrammed and started from its own interrupt, usart_hal_tx_dma_rearmed()
+    * then hands the USART over to it
+    */
+    if(dma_hal_reconfigure_async(usart->tx_dma, (uint32_t) pdata, 
+                        (uint32_t) &usart->dev->dr, sz, DMA_RECONFIG_START_IT) != OK)
+    {
+        return FAILED;
+    }
 
     return OK;
 }
@@ -587,6 +599,25 @@ static void usart_hal_tx_dma_complete(dma_hal_context_t* dma)
     }
 }
 
+static void usart_hal_tx_dma_rearmed(dma_hal_context_t* dma)
+{
+    ASSERT(dma);
+    ASSERT(dma->parent);
+
+    usart_hal_context_t* usart = (usart_hal_context_t*) (dma->parent);
+
+    /* Transfer could not be programmed, stream was left idle */
+    if(dma->state != DMA_STATE_BUSY)
+    {
+        usart->error_code |= USART_ERROR_DMA;
+
+        return;
+    }
+
+    REG_CLR_BIT(usart->dev->sr, USART_SR_TC_S);
+    usart_ll_enable_tx_dma(usart->dev);
+}
+
 static void usart_hal_tx_dma_error(dma_hal_context_t* dma)
 {
     ASSERT(dma);
@@ -148,12 +148,15 @@ error_t usart_hal_transmit_it(usart_hal_context_t* usart, const uint8_t* pdata,
  * @note  In Tx DMA, only USART_DMA_ERROR can occur. In this case transfer is aborted, and
  *        the number of remaining items can be obtained by usart_hal_get_remaining_tx(). Also,
  *        USART_ERROR_CALLBACK is called if provided.
+ * @note  Never waits for the Tx stream. If the stream is still releasing the new
+ *        transfer is programmed and started from the DMA stream interrupt.
  * @warning In DMA mode 9-bit data with no parity is not supported yet!
  * 
  * @param usart Pointer to usart_hal_context_t that was given by usart_hal_init()
  * @param pdata Pointer to data to be sent
  * @param sz    Size of data to be sent in bytes
- * @return error_t 
+ * @return error_t FAILED while a non-circular transfer is still running or a
+ *         previous re-arm is pending
  */
 error_t usart_hal_transmit_dma(usart_hal_context_t* usart, const uint8_t* pdata, uint16_t sz);
 
@@ -7,6 +7,12 @@ HAL_SRCDIRS += $(COMPONENT_PATH)/SYSCFG/$(TARGET_MCU)/IMP
 HAL_SRCDIRS += $(COMPONENT_PATH)/DMA/$(TARGET_MCU)/IMP
 HAL_SRCDIRS += $(COMPONENT_PATH)/USART/$(TARGET_MCU)/IMP
 HAL_SRCDIRS += $(COMPONENT_PATH)/TIM_BASIC/$(TARGET_MCU)/IMP
+HAL_SRCDIRS += $(COMPONENT_PATH)/TIM_GP/$(TARGET_MCU)/IMP
+
+#Only the flash log programs the flash
+ifdef CONFIG_LOG_FLASH
+HAL_SRCDIRS += $(COMPONENT_PATH)/FLASH/$(TARGET_MCU)/IMP
+endif #CONFIG_LOG_FLASH
 
 HAL_INCDIRS := $(COMPONENT_PATH)/CMSIS
 HAL_INCDIRS += $(COMPONENT_PATH)/CMSIS/Includes/$(TARGET_MCU)
@@ -36,3 +42,11 @@ HAL_INCDIRS += $(COMPONENT_PATH)/TIM_BASIC
 HAL_INCDIRS += $(COMPONENT_PATH)/TIM_BASIC/$(TARGET_MCU)/IMP
 HAL_INCDIRS += $(COMPONENT_PATH)/TIM_BASIC/$(TARGET_MCU)/LL
 
+HAL_INCDIRS += $(COMPONENT_PATH)/TIM_GP
+HAL_INCDIRS += $(COMPONENT_PATH)/TIM_GP/$(TARGET_MCU)/IMP
+HAL_INCDIRS += $(COMPONENT_PATH)/TIM_GP/$(TARGET_MCU)/LL
+
+HAL_INCDIRS += $(COMPONENT_PATH)/FLASH
+HAL_INCDIRS += $(COMPONENT_PATH)/FLASH/$(TARGET_MCU)/IMP
+HAL_INCDIRS += $(COMPONENT_PATH)/FLASH/$(TARGET_MCU)/LL
+
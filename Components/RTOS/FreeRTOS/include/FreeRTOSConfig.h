@@ -112,7 +112,12 @@ standard names - or at least those used in the unmodified vector table. */
 
 #define configHEAP_ALLOCATION_SCHEME            (HEAP_ALLOCATION_TYPE1)
 
+/* Idle sleep is provided by the tickless time base, see vPortSuppressTicksAndSleep */
+#if CONFIG_TIMER_TICKLESS
+#define configUSE_TICKLESS_IDLE                 2
+#else
 #define configUSE_TICKLESS_IDLE                 0
+#endif
 
 #define configUSE_NEWLIB_REENTRANT              0
 
@@ -8,4 +8,10 @@ RTOS_SRCDIRS += $(COMPONENT_PATH)/FreeRTOS/Protable/MemMang
 
 RTOS_INCDIRS := $(COMPONENT_PATH)/FreeRTOS/include
 
-endif
\ No newline at end of file
+RTOS_DEFINES := CONFIG_OS_FREERTOS_USE='1'
+
+else
+
+RTOS_DEFINES := CONFIG_OS_FREERTOS_USE='0'
+
+endif
@@ -77,6 +77,12 @@
 #define PRINTF_DECIMAL_BUFFER_SIZE    32
 #endif
 
+// Size of the on-stack chunk printf_()/vprintf_() collect their output in before handing it to
+// putblock_() in one call. Set to 0 to write every character through putchar_() instead.
+#ifndef PRINTF_STDOUT_CHUNK_SIZE
+#define PRINTF_STDOUT_CHUNK_SIZE      64
+#endif
+
 // Support for the decimal notation floating point conversion specifiers (%f, %F)
 #ifndef PRINTF_SUPPORT_DECIMAL_SPECIFIERS
 #define PRINTF_SUPPORT_DECIMAL_SPECIFIERS 1
@@ -87,6 +93,27 @@
 #define PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS 1
 #endif
 
+// Print %f and %F with integer arithmetic only, taking the mantissa and exponent straight from the
+// bits of the double. Avoids the software floating point library calls of the default path on cores
+// without a double precision FPU. Precisions above 9 and values beyond the decimal notation threshold
+// still go through the default path.
+#ifndef PRINTF_SUPPORT_FIXED_POINT_DECIMAL
+#define PRINTF_SUPPORT_FIXED_POINT_DECIMAL 0
+#endif
+
+// Support for the fixed point (Q format) specifier %k, printing a signed integer argument holding a
+// value scaled by 2^PRINTF_FIXED_POINT_FRACTIONAL_BITS (int, or long long with the ll modifier).
+// The first 18 fractional digits are exact, further ones are printed as zeros, which is exact too
+// for up to 18 fractional bits.
+#ifndef PRINTF_SUPPORT_FIXED_POINT_SPECIFIER
+#define PRINTF_SUPPORT_FIXED_POINT_SPECIFIER 0
+#endif
+
+// Number of fractional bits of the %k argument, e.g. 16 for Q15.16
+#ifndef PRINTF_FIXED_POINT_FRACTIONAL_BITS
+#define PRINTF_FIXED_POINT_FRACTIONAL_BITS 16
+#endif
+
 // Support for the length write-back specifier (%n)
 #ifndef PRINTF_SUPPORT_WRITEBACK_SPECIFIER
 #define PRINTF_SUPPORT_WRITEBACK_SPECIFIER 1
@@ -156,6 +183,8 @@
 #define FLAGS_POINTER   (1U << 13U)
   // Note: Similar, but not identical, effect as FLAGS_HASH
 #define FLAGS_SIGNED    (1U << 14U)
+#define FLAGS_WIDTH_ARG     (1U << 15U)
+#define FLAGS_PRECISION_ARG (1U << 16U)
   // Only used with PRINTF_SUPPORT_MSVC_STYLE_INTEGER_SPECIFIERS
 
 #ifdef PRINTF_SUPPORT_MSVC_STYLE_INTEGER_SPECIFIERS
@@ -307,14 +336,28 @@ static inline int get_exp2(double_with_bit_access x)
 // 3. function is non-null
 //
 // ... otherwise bad things will happen.
+//
+// With a block function, buffer is a chunk of chunk_size characters which is handed to the
+// block function whenever it fills up, and once more at the end of the output.
 typedef struct {
   void (*function)(char c, void* extra_arg);
+  void (*block_function)(const char* data, size_t len, void* extra_arg);
   void* extra_function_arg;
   char* buffer;
   printf_size_t pos;
   printf_size_t max_chars;
+  printf_size_t chunk_pos;
+  printf_size_t chunk_size;
 } output_gadget_t;
 
+static void flush_gadget(output_gadget_t* gadget)
+{
+  if ((gadget->block_function != NULL) && (gadget->chunk_pos > 0U)) {
+    gadget->block_function(gadget->buffer, gadget->chunk_pos, gadget->extra_function_arg);
+    gadget->chunk_pos = 0U;
+  }
+}
+
 // Note: This function currently assumes it is not passed a '\0' c,
 // or alternatively, that '\0' can be passed to the function in the output
 // gadget. The former assumption holds within the printf library. It also
@@ -331,6 +374,12 @@ static inline void putchar_via_gadget(output_gadget_t* gadget, char c)
     // No check for c == '\0' .
     gadget->function(c, gadget->extra_function_arg);
   }
+  else if (gadget->block_function != NULL) {
+    gadget->buffer[gadget->chunk_pos++] = c;
+    if (gadget->chunk_pos == gadget->chunk_size) {
+      flush_gadget(gadget);
+    }
+  }
   else {
     // it must be the case that gadget->buffer != NULL , due to the constraint
     // on output_gadget_t ; and note we're relying on write_pos being non-negative.
@@ -341,7 +390,7 @@ static inline void putchar_via_gadget(output_gadget_t* gadget, char c)
 // Possibly-write the string-terminating '\0' character
 static inline void append_termination_with_gadget(output_gadget_t* gadget)
 {
-  if (gadget->function != NULL || gadget->max_chars == 0) {
+  if (gadget->function != NULL || gadget->block_function != NULL || gadget->max_chars == 0) {
     return;
   }
   if (gadget->buffer == NULL) {
@@ -359,14 +408,25 @@ static inline void putchar_wrapper(char c, void* unused)
   putchar_(c);
 }
 
+#if PRINTF_STDOUT_CHUNK_SIZE
+static inline void putblock_wrapper(const char* data, size_t len, void* unused)
+{
+  (void) unused;
+  putblock_(data, len);
+}
+#endif
+
 static inline output_gadget_t discarding_gadget(void)
 {
   output_gadget_t gadget;
   gadget.function = NULL;
+  gadget.block_function = NULL;
   gadget.extra_function_arg = NULL;
   gadget.buffer = NULL;
   gadget.pos = 0;
   gadget.max_chars = 0;
+  gadget.chunk_pos = 0;
+  gadget.chunk_size = 0;
   return gadget;
 }
 
@@ -391,6 +451,20 @@ static inline output_gadget_t function_gadget(void (*function)(char, void*), voi
   return result;
 }
 
+static inline output_gadget_t block_gadget(void (*block_function)(const char*, size_t, void*), void* extra_arg, char* chunk, size_t chunk_size)
+{
+  output_gadget_t result = discarding_gadget();
+  if ((block_function != NULL) && (chunk != NULL) && (chunk_size > 0U)) {
+    result.block_function = block_function;
+    result.extra_function_arg = extra_arg;
+    result.buffer = chunk;
+    result.chunk_size = (chunk_size > PRINTF_MAX_POSSIBLE_BUFFER_SIZE) ?
+      PRINTF_MAX_POSSIBLE_BUFFER_SIZE : (printf_size_t) chunk_size;
+    result.max_chars = PRINTF_MAX_POSSIBLE_BUFFER_SIZE;
+  }
+  return result;
+}
+
 static inline output_gadget_t extern_putchar_gadget(void)
 {
   return function_gadget(putchar_wrapper, NULL);
@@ -521,6 +595,60 @@ static void print_integer_finalization(output_gadget_t* output, char* buf, print
   out_rev_(output, buf, len, width, flags);
 }
 
+// Two ASCII digits for each value 0..99, so a decimal number is converted two digits
+// at a time
+static const char decimal_digit_pairs[200] = {
+  '0','0', '0','1', '0','2', '0','3', '0','4', '0','5', '0','6', '0','7', '0','8', '0','9',
+  '1','0', '1','1', '1','2', '1','3', '1','4', '1','5', '1','6', '1','7', '1','8', '1','9',
+  '2','0', '2','1', '2','2', '2','3', '2','4', '2','5', '2','6', '2','7', '2','8', '2','9',
+  '3','0', '3','1', '3','2', '3','3', '3','4', '3','5', '3','6', '3','7', '3','8', '3','9',
+  '4','0', '4','1', '4','2', '4','3', '4','4', '4','5', '4','6', '4','7', '4','8', '4','9',
+  '5','0', '5','1', '5','2', '5','3', '5','4', '5','5', '5','6', '5','7', '5','8', '5','9',
+  '6','0', '6','1', '6','2', '6','3', '6','4', '6','5', '6','6', '6','7', '6','8', '6','9',
+  '7','0', '7','1', '7','2', '7','3', '7','4', '7','5', '7','6', '7','7', '7','8', '7','9',
+  '8','0', '8','1', '8','2', '8','3', '8','4', '8','5', '8','6', '8','7', '8','8', '8','9',
+  '9','0', '9','1', '9','2', '9','3', '9','4', '9','5', '9','6', '9','7', '9','8', '9','9'
+};
+
+// Writes the decimal digits of a non-zero value in reverse order, as print_integer_finalization
+// expects them. Divisions by constants of 32-bit values compile to a multiplication, so only values
+// above 32 bits need a (library) 64-bit division - one for every 9 digits rather than every digit.
+static printf_size_t print_decimal_reversed(char* buf, printf_unsigned_value_t value)
+{
+  printf_size_t len = 0U;
+  uint32_t chunk;
+  uint32_t pair;
+#if PRINTF_SUPPORT_LONG_LONG
+  while (value > UINT32_MAX) {
+    chunk = (uint32_t) (value % 1000000000U);
+    value /= 1000000000U;
+    // Inner chunks always have all 9 digits, leading zeros included
+    for (pair = 0U; pair < 4U; pair++) {
+      const uint32_t indx = (chunk % 100U) * 2U;
+      chunk /= 100U;
+      buf[len++] = decimal_digit_pairs[indx + 1];
+      buf[len++] = decimal_digit_pairs[indx];
+    }
+    buf[len++] = (char) ('0' + chunk);
+  }
+#endif
+  chunk = (uint32_t) value;
+  while (chunk >= 100U) {
+    pair = (chunk % 100U) * 2U;
+    chunk /= 100U;
+    buf[len++] = decimal_digit_pairs[pair + 1];
+    buf[len++] = decimal_digit_pairs[pair];
+  }
+  if (chunk >= 10U) {
+    buf[len++] = decimal_digit_pairs[chunk * 2U + 1];
+    buf[len++] = decimal_digit_pairs[chunk * 2U];
+  }
+  else {
+    buf[len++] = (char) ('0' + chunk);
+  }
+  return len;
+}
+
 // An internal itoa-like function
 static void print_integer(output_gadget_t* output, printf_unsigned_value_t value, bool negative, numeric_base_t base, printf_size_t precision, printf_size_t width, printf_flags_t flags)
 {
@@ -541,17 +669,184 @@ static void print_integer(output_gadget_t* output, printf_unsigned_value_t value
       // don't differ on 0 values
     }
   }
+  else if (base == BASE_DECIMAL) {
+    len = print_decimal_reversed(buf, value);
+  }
   else {
+    // The other bases are powers of two: digits are taken off with a shift and a mask
+    const char* digits = (flags & FLAGS_UPPERCASE) ? "0123456789ABCDEF" : "0123456789abcdef";
+    const unsigned int shift = (base == BASE_HEX) ? 4U : ((base == BASE_OCTAL) ? 3U : 1U);
+    const unsigned int mask = (unsigned int) base - 1U;
     do {
-      const char digit = (char)(value % base);
-      buf[len++] = (char)(digit < 10 ? '0' + digit : (flags & FLAGS_UPPERCASE ? 'A' : 'a') + digit - 10);
-      value /= base;
+      buf[len++] = digits[(unsigned int) value & mask];
+      value >>= shift;
     } while (value && (len < PRINTF_INTEGER_BUFFER_SIZE));
   }
 
   print_integer_finalization(output, buf, len, negative, base, precision, width, flags);
 }
 
+#if (PRINTF_SUPPORT_FIXED_POINT_DECIMAL || PRINTF_SUPPORT_FIXED_POINT_SPECIFIER)
+
+#define PRINTF_FIXED_POINT_MAX_PRECISION 9U
+
+// Fraction digits worked out by print_fixed_point: a leading block, then the rounded last 9.
+// A fraction of n bits has exactly n decimal digits, so the zeros printed past these are exact
+// for up to 18 fractional bits.
+#define PRINTF_FIXED_POINT_EXACT_DIGITS (2U * PRINTF_FIXED_POINT_MAX_PRECISION)
+
+static const uint32_t powers_of_10_u32[PRINTF_FIXED_POINT_MAX_PRECISION + 1U] = {
+  1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U
+};
+
+// value * factor in two 64-bit halves, the low one is returned
+static inline uint64_t multiply_u64_u32(uint64_t value, uint32_t factor, uint64_t* high_part)
+{
+  const uint64_t low = (value & 0xFFFFFFFFU) * factor;
+  const uint64_t high = (value >> 32U) * factor;
+  const uint64_t product_lo = low + (high << 32U);
+
+  *high_part = (high >> 32U) + (product_lo < low);
+  return product_lo;
+}
+
+// Prints magnitude / 2^shift in decimal notation. The last printed digit is rounded half-to-even
+// on the exact binary value, as glibc does. The fractional bits times 10^precision take up to 94 bits,
+// this product is kept in two 64-bit halves so no division and no floating point operation is needed.
+// Precisions above 9 (%k only, its shift is below 64) first take a leading block of digits off the
+// fraction the same way, the remainder gives the last 9.
+static void print_fixed_point(output_gadget_t* output, uint64_t magnitude, unsigned int shift, bool negative, printf_size_t precision, printf_size_t width, printf_flags_t flags)
+{
+  char buf[PRINTF_DECIMAL_BUFFER_SIZE];
+  char integral_buf[PRINTF_INTEGER_BUFFER_SIZE];
+  printf_size_t len = 0U;
+  printf_size_t integral_len;
+  printf_size_t leading_len = 0U;
+  uint64_t integral = (shift < 64U) ? (magnitude >> shift) : 0U;
+  uint64_t fraction = (shift == 0U) ? 0U : ((shift < 64U) ? (magnitude & ((1ULL << shift) - 1U)) : magnitude);
+  uint32_t leading = 0U;
+  uint32_t digits = 0U;
+  int compare_to_half = -1;
+
+  // Digits past the exact ones are printed as zeros, up to half of the buffer
+  while ((len < PRINTF_DECIMAL_BUFFER_SIZE / 2U) && (precision > PRINTF_FIXED_POINT_EXACT_DIGITS)) {
+    buf[len++] = '0';
+    precision--;
+  }
+  if (precision > PRINTF_FIXED_POINT_EXACT_DIGITS) {
+    precision = PRINTF_FIXED_POINT_EXACT_DIGITS;
+  }
+
+  if (precision > PRINTF_FIXED_POINT_MAX_PRECISION) {
+    leading_len = precision - PRINTF_FIXED_POINT_MAX_PRECISION;
+    precision = PRINTF_FIXED_POINT_MAX_PRECISION;
+
+    if (fraction && (shift < 64U)) {
+      uint64_t product_hi;
+      const uint64_t product_lo = multiply_u64_u32(fraction, powers_of_10_u32[leading_len], &product_hi);
+
+      leading = (uint32_t) ((product_hi << (64U - shift)) | (product_lo >> shift));
+      fraction = product_lo & ((1ULL << shift) - 1U);
+    }
+  }
+
+  if (fraction && (shift < 128U)) {
+    uint64_t product_hi;
+    const uint64_t product_lo = multiply_u64_u32(fraction, powers_of_10_u32[precision], &product_hi);
+    uint64_t remainder_hi;
+    uint64_t remainder_lo;
+    uint64_t half_hi;
+    uint64_t half_lo;
+
+    // digits = product >> shift, the remainder is compared against 2^(shift - 1)
+    if (shift < 64U) {
+      digits = (uint32_t) ((product_hi << (64U - shift)) | (product_lo >> shift));
+      remainder_hi = 0U;
+      remainder_lo = product_lo & ((1ULL << shift) - 1U);
+      half_hi = 0U;
+      half_lo = 1ULL << (shift - 1U);
+    }
+    else if (shift == 64U) {
+      digits = (uint32_t) product_hi;
+      remainder_hi = 0U;
+      remainder_lo = product_lo;
+      half_hi = 0U;
+      half_lo = 1ULL << 63U;
+    }
+    else {
+      digits = (uint32_t) (product_hi >> (shift - 64U));
+      remainder_hi = product_hi & ((1ULL << (shift - 64U)) - 1U);
+      remainder_lo = product_lo;
+      half_hi = 1ULL << (shift - 65U);
+      half_lo = 0U;
+    }
+
+    compare_to_half = (remainder_hi != half_hi) ? ((remainder_hi > half_hi) ? 1 : -1) :
+                      (remainder_lo != half_lo) ? ((remainder_lo > half_lo) ? 1 : -1) : 0;
+  }
+  // Beyond 128 bits of shift the product is far below half of the last digit
+
+  if ((compare_to_half > 0) ||
+      ((compare_to_half == 0) && ((precision ? digits : (uint32_t) integral) & 1U))) {
+    // handle rollover, e.g. case 0.99 with precision 1 is 1.0
+    if (++digits == powers_of_10_u32[precision]) {
+      digits = 0U;
+      if (!leading_len || (++leading == powers_of_10_u32[leading_len])) {
+        leading = 0U;
+        ++integral;
+      }
+    }
+  }
+
+  if (precision != 0U) {
+    while ((len < PRINTF_DECIMAL_BUFFER_SIZE) && precision--) {
+      buf[len++] = (char) ('0' + digits % 10U);
+      digits /= 10U;
+    }
+    while ((len < PRINTF_DECIMAL_BUFFER_SIZE) && leading_len--) {
+      buf[len++] = (char) ('0' + leading % 10U);
+      leading /= 10U;
+    }
+    if (len < PRINTF_DECIMAL_BUFFER_SIZE) {
+      buf[len++] = '.';
+    }
+  }
+  else if ((flags & FLAGS_HASH) && (len < PRINTF_DECIMAL_BUFFER_SIZE)) {
+    buf[len++] = '.';
+  }
+
+  integral_len = print_decimal_reversed(integral_buf, integral);
+  for (printf_size_t i = 0U; (i < integral_len) && (len < PRINTF_DECIMAL_BUFFER_SIZE); i++) {
+    buf[len++] = integral_buf[i];
+  }
+
+  // pad leading zeros
+  if (!(flags & FLAGS_LEFT) && (flags & FLAGS_ZEROPAD)) {
+    if (width && (negative || (flags & (FLAGS_PLUS | FLAGS_SPACE)))) {
+      width--;
+    }
+    while ((len < width) && (len < PRINTF_DECIMAL_BUFFER_SIZE)) {
+      buf[len++] = '0';
+    }
+  }
+
+  if (len < PRINTF_DECIMAL_BUFFER_SIZE) {
+    if (negative) {
+      buf[len++] = '-';
+    }
+    else if (flags & FLAGS_PLUS) {
+      buf[len++] = '+';  // ignore the space if the '+' exists
+    }
+    else if (flags & FLAGS_SPACE) {
+      buf[len++] = ' ';
+    }
+  }
+
+  out_rev_(output, buf, len, width, flags);
+}
+
+#endif // (PRINTF_SUPPORT_FIXED_POINT_DECIMAL || PRINTF_SUPPORT_FIXED_POINT_SPECIFIER)
+
 #if (PRINTF_SUPPORT_DECIMAL_SPECIFIERS || PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS)
 
 // Stores a fixed-precision representation of a double relative
@@ -1017,6 +1312,49 @@ static void print_floating_point(output_gadget_t* output, double value, printf_s
     print_decimal_number(output, value, precision, width, flags, buf, len);
 }
 
+#if PRINTF_SUPPORT_FIXED_POINT_DECIMAL
+
+#if DOUBLE_SIZE_IN_BITS != 64
+#error "The fixed point decimal formatter expects 64-bit doubles"
+#endif
+
+// %f through print_fixed_point: a finite double is its mantissa shifted by its exponent
+static void print_fixed_point_floating(output_gadget_t* output, double value, printf_size_t precision, printf_size_t width, printf_flags_t flags)
+{
+  const double_with_bit_access bits = get_bit_access(value);
+  const unsigned int biased_exp = (unsigned int) ((bits.U >> DOUBLE_STORED_MANTISSA_BITS) & DOUBLE_EXPONENT_MASK);
+  const uint64_t threshold = (uint64_t) PRINTF_FLOAT_NOTATION_THRESHOLD;
+  uint64_t mantissa = bits.U & ((1ULL << DOUBLE_STORED_MANTISSA_BITS) - 1U);
+  printf_size_t fixed_precision = (flags & FLAGS_PRECISION) ? precision : PRINTF_DEFAULT_FLOAT_PRECISION;
+  unsigned int shift;
+
+  // nan and inf, values of 2^52 and above, and long precisions take the default path
+  if ((biased_exp == DOUBLE_EXPONENT_MASK) || (biased_exp > DOUBLE_BASE_EXPONENT + DOUBLE_STORED_MANTISSA_BITS) ||
+      (fixed_precision > PRINTF_FIXED_POINT_MAX_PRECISION)) {
+    print_floating_point(output, value, precision, width, flags, PRINTF_PREFER_DECIMAL);
+    return;
+  }
+
+  if (biased_exp == 0U) {
+    // subnormal, no implicit leading bit
+    shift = DOUBLE_BASE_EXPONENT + DOUBLE_STORED_MANTISSA_BITS - 1U;
+  }
+  else {
+    mantissa |= 1ULL << DOUBLE_STORED_MANTISSA_BITS;
+    shift = DOUBLE_BASE_EXPONENT + DOUBLE_STORED_MANTISSA_BITS - biased_exp;
+  }
+
+  if ((shift < 64U) && (((mantissa >> shift) > threshold) ||
+      (((mantissa >> shift) == threshold) && (mantissa & ((1ULL << shift) - 1U))))) {
+    print_floating_point(output, value, precision, width, flags, PRINTF_PREFER_DECIMAL);
+    return;
+  }
+
+  print_fixed_point(output, mantissa, shift, get_sign_bit(value), fixed_precision, width, flags);
+}
+
+#endif  // PRINTF_SUPPORT_FIXED_POINT_DECIMAL
+
 #endif  // (PRINTF_SUPPORT_DECIMAL_SPECIFIERS || PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS)
 
 // Advances the format pointer past the flags, and returns the parsed flags
@@ -1036,316 +1374,366 @@ static printf_flags_t parse_flags(const char** format)
   } while (true);
 }
 
-static inline void format_string_loop(output_gadget_t* output, const char* format, va_list args)
+// Parses a conversion specification, %[flags][width][.precision][length]specifier, following a '%'.
+// Widths and precisions given as '*' are only marked, their arguments are fetched by print_conversion.
+// Returns false if the format string ends within the specification.
+static bool parse_conversion_spec(const char** format, printf_format_spec_t* spec)
 {
 #if PRINTF_CHECK_FOR_NUL_IN_FORMAT_SPECIFIER
-#define ADVANCE_IN_FORMAT_STRING(cptr_) do { (cptr_)++; if (!*(cptr_)) return; } while(0)
+#define ADVANCE_IN_FORMAT_STRING(cptr_) do { (cptr_)++; if (!*(cptr_)) return false; } while(0)
 #else
 #define ADVANCE_IN_FORMAT_STRING(cptr_) (cptr_)++
 #endif
 
+  printf_flags_t flags = parse_flags(format);
 
-  while (*format)
-  {
-    if (*format != '%') {
-      // A regular content character
-      putchar_via_gadget(output, *format);
-      format++;
-      continue;
-    }
-    // We're parsing a format specifier: %[flags][width][.precision][length]
-    ADVANCE_IN_FORMAT_STRING(format);
-
-    printf_flags_t flags = parse_flags(&format);
+  // evaluate width field
+  printf_size_t width = 0U;
+  if (is_digit_(**format)) {
+    width = (printf_size_t) atou_(format);
+  }
+  else if (**format == '*') {
+    flags |= FLAGS_WIDTH_ARG;
+    ADVANCE_IN_FORMAT_STRING(*format);
+  }
 
-    // evaluate width field
-    printf_size_t width = 0U;
-    if (is_digit_(*format)) {
-      width = (printf_size_t) atou_(&format);
+  // evaluate precision field
+  printf_size_t precision = 0U;
+  if (**format == '.') {
+    flags |= FLAGS_PRECISION;
+    ADVANCE_IN_FORMAT_STRING(*format);
+    if (is_digit_(**format)) {
+      precision = (printf_size_t) atou_(format);
     }
-    else if (*format == '*') {
-      const int w = va_arg(args, int);
-      if (w < 0) {
-        flags |= FLAGS_LEFT;    // reverse padding
-        width = (printf_size_t)-w;
-      }
-      else {
-        width = (printf_size_t)w;
-      }
-      ADVANCE_IN_FORMAT_STRING(format);
+    else if (**format == '*') {
+      flags |= FLAGS_PRECISION_ARG;
+      ADVANCE_IN_FORMAT_STRING(*format);
     }
+  }
 
-    // evaluate precision field
-    printf_size_t precision = 0U;
-    if (*format == '.') {
-      flags |= FLAGS_PRECISION;
-      ADVANCE_IN_FORMAT_STRING(format);
-      if (is_digit_(*format)) {
-        precision = (printf_size_t) atou_(&format);
+  // evaluate length field
+  switch (**format) {
+#ifdef PRINTF_SUPPORT_MSVC_STYLE_INTEGER_SPECIFIERS
+    case 'I' : {
+      ADVANCE_IN_FORMAT_STRING(*format);
+      // Greedily parse for size in bits: 8, 16, 32 or 64
+      switch(**format) {
+        case '8':               flags |= FLAGS_INT8;
+          ADVANCE_IN_FORMAT_STRING(*format);
+          break;
+        case '1':
+          ADVANCE_IN_FORMAT_STRING(*format);
+        if (**format == '6') { (*format)++; flags |= FLAGS_INT16; }
+          break;
+        case '3':
+          ADVANCE_IN_FORMAT_STRING(*format);
+          if (**format == '2') { ADVANCE_IN_FORMAT_STRING(*format); flags |= FLAGS_INT32; }
+          break;
+        case '6':
+          ADVANCE_IN_FORMAT_STRING(*format);
+          if (**format == '4') { ADVANCE_IN_FORMAT_STRING(*format); flags |= FLAGS_INT64; }
+          break;
+        default: break;
       }
-      else if (*format == '*') {
-        const int precision_ = va_arg(args, int);
-        precision = precision_ > 0 ? (printf_size_t) precision_ : 0U;
-        ADVANCE_IN_FORMAT_STRING(format);
+      break;
+    }
+#endif
+    case 'l' :
+      flags |= FLAGS_LONG;
+      ADVANCE_IN_FORMAT_STRING(*format);
+      if (**format == 'l') {
+        flags |= FLAGS_LONG_LONG;
+        ADVANCE_IN_FORMAT_STRING(*format);
       }
+      break;
+    case 'h' :
+      flags |= FLAGS_SHORT;
+      ADVANCE_IN_FORMAT_STRING(*format);
+      if (**format == 'h') {
+        flags |= FLAGS_CHAR;
+        ADVANCE_IN_FORMAT_STRING(*format);
+      }
+      break;
+    case 't' :
+      flags |= (sizeof(ptrdiff_t) == sizeof(long) ? FLAGS_LONG : FLAGS_LONG_LONG);
+      ADVANCE_IN_FORMAT_STRING(*format);
+      break;
+    case 'j' :
+      flags |= (sizeof(intmax_t) == sizeof(long) ? FLAGS_LONG : FLAGS_LONG_LONG);
+      ADVANCE_IN_FORMAT_STRING(*format);
+      break;
+    case 'z' :
+      flags |= (sizeof(size_t) == sizeof(long) ? FLAGS_LONG : FLAGS_LONG_LONG);
+      ADVANCE_IN_FORMAT_STRING(*format);
+      break;
+    default:
+      break;
+  }
+
+  spec->flags = flags;
+  spec->width = width;
+  spec->precision = precision;
+  spec->specifier = **format;
+  if (**format) {
+    (*format)++;
+  }
+  return true;
+
+#undef ADVANCE_IN_FORMAT_STRING
+}
+
+// Prints one parsed conversion, fetching its arguments
+static void print_conversion(output_gadget_t* output, const printf_format_spec_t* spec, va_list* args)
+{
+  printf_flags_t flags = spec->flags;
+  printf_size_t width = spec->width;
+  printf_size_t precision = spec->precision;
+
+  if (flags & FLAGS_WIDTH_ARG) {
+    const int w = va_arg(*args, int);
+    if (w < 0) {
+      flags |= FLAGS_LEFT;    // reverse padding
+      width = (printf_size_t)-w;
+    }
+    else {
+      width = (printf_size_t)w;
     }
+  }
+  if (flags & FLAGS_PRECISION_ARG) {
+    const int precision_ = va_arg(*args, int);
+    precision = precision_ > 0 ? (printf_size_t) precision_ : 0U;
+  }
 
-    // evaluate length field
-    switch (*format) {
-#ifdef PRINTF_SUPPORT_MSVC_STYLE_INTEGER_SPECIFIERS
-      case 'I' : {
-        ADVANCE_IN_FORMAT_STRING(format);
-        // Greedily parse for size in bits: 8, 16, 32 or 64
-        switch(*format) {
-          case '8':               flags |= FLAGS_INT8;
-            ADVANCE_IN_FORMAT_STRING(format);
-            break;
-          case '1':
-            ADVANCE_IN_FORMAT_STRING(format);
-          if (*format == '6') { format++; flags |= FLAGS_INT16; }
-            break;
-          case '3':
-            ADVANCE_IN_FORMAT_STRING(format);
-            if (*format == '2') { ADVANCE_IN_FORMAT_STRING(format); flags |= FLAGS_INT32; }
-            break;
-          case '6':
-            ADVANCE_IN_FORMAT_STRING(format);
-            if (*format == '4') { ADVANCE_IN_FORMAT_STRING(format); flags |= FLAGS_INT64; }
-            break;
-          default: break;
-        }
-        break;
+  switch (spec->specifier) {
+    case 'd' :
+    case 'i' :
+    case 'u' :
+    case 'x' :
+    case 'X' :
+    case 'o' :
+    case 'b' : {
+
+      if (spec->specifier == 'd' || spec->specifier == 'i') {
+        flags |= FLAGS_SIGNED;
       }
-#endif
-      case 'l' :
-        flags |= FLAGS_LONG;
-        ADVANCE_IN_FORMAT_STRING(format);
-        if (*format == 'l') {
-          flags |= FLAGS_LONG_LONG;
-          ADVANCE_IN_FORMAT_STRING(format);
-        }
-        break;
-      case 'h' :
-        flags |= FLAGS_SHORT;
-        ADVANCE_IN_FORMAT_STRING(format);
-        if (*format == 'h') {
-          flags |= FLAGS_CHAR;
-          ADVANCE_IN_FORMAT_STRING(format);
-        }
-        break;
-      case 't' :
-        flags |= (sizeof(ptrdiff_t) == sizeof(long) ? FLAGS_LONG : FLAGS_LONG_LONG);
-        ADVANCE_IN_FORMAT_STRING(format);
-        break;
-      case 'j' :
-        flags |= (sizeof(intmax_t) == sizeof(long) ? FLAGS_LONG : FLAGS_LONG_LONG);
-        ADVANCE_IN_FORMAT_STRING(format);
-        break;
-      case 'z' :
-        flags |= (sizeof(size_t) == sizeof(long) ? FLAGS_LONG : FLAGS_LONG_LONG);
-        ADVANCE_IN_FORMAT_STRING(format);
-        break;
-      default:
-        break;
-    }
-
-    // evaluate specifier
-    switch (*format) {
-      case 'd' :
-      case 'i' :
-      case 'u' :
-      case 'x' :
-      case 'X' :
-      case 'o' :
-      case 'b' : {
-
-        if (*format == 'd' || *format == 'i') {
-          flags |= FLAGS_SIGNED;
-        }
 
-        numeric_base_t base;
-        if (*format == 'x' || *format == 'X') {
-          base = BASE_HEX;
-        }
-        else if (*format == 'o') {
-          base =  BASE_OCTAL;
-        }
-        else if (*format == 'b') {
-          base =  BASE_BINARY;
-        }
-        else {
-          base = BASE_DECIMAL;
-          flags &= ~FLAGS_HASH; // decimal integers have no alternative presentation
-        }
+      numeric_base_t base;
+      if (spec->specifier == 'x' || spec->specifier == 'X') {
+        base = BASE_HEX;
+      }
+      else if (spec->specifier == 'o') {
+        base =  BASE_OCTAL;
+      }
+      else if (spec->specifier == 'b') {
+        base =  BASE_BINARY;
+      }
+      else {
+        base = BASE_DECIMAL;
+        flags &= ~FLAGS_HASH; // decimal integers have no alternative presentation
+      }
 
-        if (*format == 'X') {
-          flags |= FLAGS_UPPERCASE;
-        }
+      if (spec->specifier == 'X') {
+        flags |= FLAGS_UPPERCASE;
+      }
 
-        format++;
-        // ignore '0' flag when precision is given
-        if (flags & FLAGS_PRECISION) {
-          flags &= ~FLAGS_ZEROPAD;
-        }
+      // ignore '0' flag when precision is given
+      if (flags & FLAGS_PRECISION) {
+        flags &= ~FLAGS_ZEROPAD;
+      }
 
-        if (flags & FLAGS_SIGNED) {
-          // A signed specifier: d, i or possibly I + bit size if enabled
+      if (flags & FLAGS_SIGNED) {
+        // A signed specifier: d, i or possibly I + bit size if enabled
 
-          if (flags & FLAGS_LONG_LONG) {
+        if (flags & FLAGS_LONG_LONG) {
 #if PRINTF_SUPPORT_LONG_LONG
-            const long long value = va_arg(args, long long);
-            print_integer(output, ABS_FOR_PRINTING(value), value < 0, base, precision, width, flags);
+          const long long value = va_arg(*args, long long);
+          print_integer(output, ABS_FOR_PRINTING(value), value < 0, base, precision, width, flags);
 #endif
-          }
-          else if (flags & FLAGS_LONG) {
-            const long value = va_arg(args, long);
-            print_integer(output, ABS_FOR_PRINTING(value), value < 0, base, precision, width, flags);
-          }
-          else {
-            // We never try to interpret the argument as something potentially-smaller than int,
-            // due to integer promotion rules: Even if the user passed a short int, short unsigned
-            // etc. - these will come in after promotion, as int's (or unsigned for the case of
-            // short unsigned when it has the same size as int)
-            const int value =
-              (flags & FLAGS_CHAR) ? (signed char) va_arg(args, int) :
-              (flags & FLAGS_SHORT) ? (short int) va_arg(args, int) :
-              va_arg(args, int);
-            print_integer(output, ABS_FOR_PRINTING(value), value < 0, base, precision, width, flags);
-          }
+        }
+        else if (flags & FLAGS_LONG) {
+          const long value = va_arg(*args, long);
+          print_integer(output, ABS_FOR_PRINTING(value), value < 0, base, precision, width, flags);
         }
         else {
-          // An unsigned specifier: u, x, X, o, b
+          // We never try to interpret the argument as something potentially-smaller than int,
+          // due to integer promotion rules: Even if the user passed a short int, short unsigned
+          // etc. - these will come in after promotion, as int's (or unsigned for the case of
+          // short unsigned when it has the same size as int)
+          const int value =
+            (flags & FLAGS_CHAR) ? (signed char) va_arg(*args, int) :
+            (flags & FLAGS_SHORT) ? (short int) va_arg(*args, int) :
+            va_arg(*args, int);
+          print_integer(output, ABS_FOR_PRINTING(value), value < 0, base, precision, width, flags);
+        }
+      }
+      else {
+        // An unsigned specifier: u, x, X, o, b
 
-          flags &= ~(FLAGS_PLUS | FLAGS_SPACE);
+        flags &= ~(FLAGS_PLUS | FLAGS_SPACE);
 
-          if (flags & FLAGS_LONG_LONG) {
+        if (flags & FLAGS_LONG_LONG) {
 #if PRINTF_SUPPORT_LONG_LONG
-            print_integer(output, (printf_unsigned_value_t) va_arg(args, unsigned long long), false, base, precision, width, flags);
+          print_integer(output, (printf_unsigned_value_t) va_arg(*args, unsigned long long), false, base, precision, width, flags);
 #endif
-          }
-          else if (flags & FLAGS_LONG) {
-            print_integer(output, (printf_unsigned_value_t) va_arg(args, unsigned long), false, base, precision, width, flags);
-          }
-          else {
-            const unsigned int value =
-              (flags & FLAGS_CHAR) ? (unsigned char)va_arg(args, unsigned int) :
-              (flags & FLAGS_SHORT) ? (unsigned short int)va_arg(args, unsigned int) :
-              va_arg(args, unsigned int);
-            print_integer(output, (printf_unsigned_value_t) value, false, base, precision, width, flags);
-          }
         }
-        break;
+        else if (flags & FLAGS_LONG) {
+          print_integer(output, (printf_unsigned_value_t) va_arg(*args, unsigned long), false, base, precision, width, flags);
+        }
+        else {
+          const unsigned int value =
+            (flags & FLAGS_CHAR) ? (unsigned char)va_arg(*args, unsigned int) :
+            (flags & FLAGS_SHORT) ? (unsigned short int)va_arg(*args, unsigned int) :
+            va_arg(*args, unsigned int);
+          print_integer(output, (printf_unsigned_value_t) value, false, base, precision, width, flags);
+        }
       }
+      break;
+    }
 #if PRINTF_SUPPORT_DECIMAL_SPECIFIERS
-      case 'f' :
-      case 'F' :
-        if (*format == 'F') flags |= FLAGS_UPPERCASE;
-        print_floating_point(output, va_arg(args, double), precision, width, flags, PRINTF_PREFER_DECIMAL);
-        format++;
-        break;
+    case 'f' :
+    case 'F' :
+      if (spec->specifier == 'F') flags |= FLAGS_UPPERCASE;
+#if PRINTF_SUPPORT_FIXED_POINT_DECIMAL
+      print_fixed_point_floating(output, va_arg(*args, double), precision, width, flags);
+#else
+      print_floating_point(output, va_arg(*args, double), precision, width, flags, PRINTF_PREFER_DECIMAL);
 #endif
+      break;
+#endif
+#if PRINTF_SUPPORT_FIXED_POINT_SPECIFIER
+    case 'k' : {
+      const long long value =
+#if PRINTF_SUPPORT_LONG_LONG
+        (flags & FLAGS_LONG_LONG) ? va_arg(*args, long long) :
+#endif
+        (flags & FLAGS_LONG) ? (long long) va_arg(*args, long) :
+        (long long) va_arg(*args, int);
+      print_fixed_point(output, (value < 0) ? (uint64_t) -(value + 1) + 1U : (uint64_t) value,
+        PRINTF_FIXED_POINT_FRACTIONAL_BITS, value < 0,
+        (flags & FLAGS_PRECISION) ? precision : PRINTF_DEFAULT_FLOAT_PRECISION, width, flags);
+      break;
+    }
+#endif  // PRINTF_SUPPORT_FIXED_POINT_SPECIFIER
 #if PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS
-      case 'e':
-      case 'E':
-      case 'g':
-      case 'G':
-        if ((*format == 'g')||(*format == 'G')) flags |= FLAGS_ADAPT_EXP;
-        if ((*format == 'E')||(*format == 'G')) flags |= FLAGS_UPPERCASE;
-        print_floating_point(output, va_arg(args, double), precision, width, flags, PRINTF_PREFER_EXPONENTIAL);
-        format++;
-        break;
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+      if ((spec->specifier == 'g')||(spec->specifier == 'G')) flags |= FLAGS_ADAPT_EXP;
+      if ((spec->specifier == 'E')||(spec->specifier == 'G')) flags |= FLAGS_UPPERCASE;
+      print_floating_point(output, va_arg(*args, double), precision, width, flags, PRINTF_PREFER_EXPONENTIAL);
+      break;
 #endif  // PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS
-      case 'c' : {
-        printf_size_t l = 1U;
+    case 'c' : {
+      printf_size_t l = 1U;
+      // pre padding
+      if (!(flags & FLAGS_LEFT)) {
+        while (l++ < width) {
+          putchar_via_gadget(output, ' ');
+        }
+      }
+      // char output
+      putchar_via_gadget(output, (char) va_arg(*args, int) );
+      // post padding
+      if (flags & FLAGS_LEFT) {
+        while (l++ < width) {
+          putchar_via_gadget(output, ' ');
+        }
+      }
+      break;
+    }
+
+    case 's' : {
+      const char* p = va_arg(*args, char*);
+      if (p == NULL) {
+        out_rev_(output, ")llun(", 6, width, flags);
+      }
+      else {
+        printf_size_t l = strnlen_s_(p, precision ? precision : PRINTF_MAX_POSSIBLE_BUFFER_SIZE);
         // pre padding
+        if (flags & FLAGS_PRECISION) {
+          l = (l < precision ? l : precision);
+        }
         if (!(flags & FLAGS_LEFT)) {
           while (l++ < width) {
             putchar_via_gadget(output, ' ');
           }
         }
-        // char output
-        putchar_via_gadget(output, (char) va_arg(args, int) );
+        // string output
+        while ((*p != 0) && (!(flags & FLAGS_PRECISION) || precision)) {
+          putchar_via_gadget(output, *(p++));
+          --precision;
+        }
         // post padding
         if (flags & FLAGS_LEFT) {
           while (l++ < width) {
             putchar_via_gadget(output, ' ');
           }
         }
-        format++;
-        break;
-      }
-
-      case 's' : {
-        const char* p = va_arg(args, char*);
-        if (p == NULL) {
-          out_rev_(output, ")llun(", 6, width, flags);
-        }
-        else {
-          printf_size_t l = strnlen_s_(p, precision ? precision : PRINTF_MAX_POSSIBLE_BUFFER_SIZE);
-          // pre padding
-          if (flags & FLAGS_PRECISION) {
-            l = (l < precision ? l : precision);
-          }
-          if (!(flags & FLAGS_LEFT)) {
-            while (l++ < width) {
-              putchar_via_gadget(output, ' ');
-            }
-          }
-          // string output
-          while ((*p != 0) && (!(flags & FLAGS_PRECISION) || precision)) {
-            putchar_via_gadget(output, *(p++));
-            --precision;
-          }
-          // post padding
-          if (flags & FLAGS_LEFT) {
-            while (l++ < width) {
-              putchar_via_gadget(output, ' ');
-            }
-          }
-        }
-        format++;
-        break;
       }
+      break;
+    }
 
-      case 'p' : {
-        width = sizeof(void*) * 2U + 2; // 2 hex chars per byte + the "0x" prefix
-        flags |= FLAGS_ZEROPAD | FLAGS_POINTER;
-        uintptr_t value = (uintptr_t)va_arg(args, void*);
-        (value == (uintptr_t) NULL) ?
-          out_rev_(output, ")lin(", 5, width, flags) :
-          print_integer(output, (printf_unsigned_value_t) value, false, BASE_HEX, precision, width, flags);
-        format++;
-        break;
-      }
+    case 'p' : {
+      width = sizeof(void*) * 2U + 2; // 2 hex chars per byte + the "0x" prefix
+      flags |= FLAGS_ZEROPAD | FLAGS_POINTER;
+      uintptr_t value = (uintptr_t)va_arg(*args, void*);
+      (value == (uintptr_t) NULL) ?
+        out_rev_(output, ")lin(", 5, width, flags) :
+        print_integer(output, (printf_unsigned_value_t) value, false, BASE_HEX, precision, width, flags);
+      break;
+    }
 
-      case '%' :
-        putchar_via_gadget(output, '%');
-        format++;
-        break;
+    case '%' :
+      putchar_via_gadget(output, '%');
+      break;
 
-      // Many people prefer to disable support for %n, as it lets the caller
-      // engineer a write to an arbitrary location, of a value the caller
-      // effectively controls - which could be a security concern in some cases.
+    // Many people prefer to disable support for %n, as it lets the caller
+    // engineer a write to an arbitrary location, of a value the caller
+    // effectively controls - which could be a security concern in some cases.
 #if PRINTF_SUPPORT_WRITEBACK_SPECIFIER
-      case 'n' : {
-        if       (flags & FLAGS_CHAR)      *(va_arg(args, char*))      = (char) output->pos;
-        else if  (flags & FLAGS_SHORT)     *(va_arg(args, short*))     = (short) output->pos;
-        else if  (flags & FLAGS_LONG)      *(va_arg(args, long*))      = (long) output->pos;
+    case 'n' : {
+      if       (flags & FLAGS_CHAR)      *(va_arg(*args, char*))      = (char) output->pos;
+      else if  (flags & FLAGS_SHORT)     *(va_arg(*args, short*))     = (short) output->pos;
+      else if  (flags & FLAGS_LONG)      *(va_arg(*args, long*))      = (long) output->pos;
 #if PRINTF_SUPPORT_LONG_LONG
-        else if  (flags & FLAGS_LONG_LONG) *(va_arg(args, long long*)) = (long long int) output->pos;
+      else if  (flags & FLAGS_LONG_LONG) *(va_arg(*args, long long*)) = (long long int) output->pos;
 #endif // PRINTF_SUPPORT_LONG_LONG
-        else                               *(va_arg(args, int*))       = (int) output->pos;
-        format++;
-        break;
-      }
+      else                               *(va_arg(*args, int*))       = (int) output->pos;
+      break;
+    }
 #endif // PRINTF_SUPPORT_WRITEBACK_SPECIFIER
 
-      default :
-        putchar_via_gadget(output, *format);
-        format++;
-        break;
+    default :
+      putchar_via_gadget(output, spec->specifier);
+      break;
+  }
+}
+
+static inline void format_string_loop(output_gadget_t* output, const char* format, va_list args)
+{
+  printf_format_spec_t spec;
+  va_list args_copy;
+
+  // A va_list may be an array type, only a local copy can safely be passed by address
+  va_copy(args_copy, args);
+
+  while (*format)
+  {
+    if (*format != '%') {
+      // A regular content character
+      putchar_via_gadget(output, *format);
+      format++;
+      continue;
     }
+    format++;
+    if (!*format || !parse_conversion_spec(&format, &spec)) {
+      break;
+    }
+    print_conversion(output, &spec, &args_copy);
   }
+
+  va_end(args_copy);
 }
 
 // internal vsnprintf - used for implementing _all library functions
@@ -1355,6 +1743,9 @@ static int vsnprintf_impl(output_gadget_t* output, const char* format, va_list a
   // possible to call this function with a non-zero pos value for some "remedial printing".
   format_string_loop(output, format, args);
 
+  // hand over what is left in the chunk
+  flush_gadget(output);
+
   // termination
   append_termination_with_gadget(output);
 
@@ -1362,11 +1753,64 @@ static int vsnprintf_impl(output_gadget_t* output, const char* format, va_list a
   return (int)output->pos;
 }
 
+// Only the conversions the library was built with pass printf_compile
+static bool is_supported_specifier(char specifier)
+{
+  switch (specifier) {
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'b':
+    case 'c': case 's': case 'p': case '%':
+#if PRINTF_SUPPORT_DECIMAL_SPECIFIERS
+    case 'f': case 'F':
+#endif
+#if PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS
+    case 'e': case 'E': case 'g': case 'G':
+#endif
+#if PRINTF_SUPPORT_FIXED_POINT_SPECIFIER
+    case 'k':
+#endif
+#if PRINTF_SUPPORT_WRITEBACK_SPECIFIER
+    case 'n':
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
+static int vsnprintf_compiled_impl(output_gadget_t* output, const printf_format_spec_t* specs, va_list args)
+{
+  va_list args_copy;
+
+  va_copy(args_copy, args);
+
+  for (;; specs++) {
+    for (printf_size_t i = 0U; i < specs->literal_len; i++) {
+      putchar_via_gadget(output, specs->literal[i]);
+    }
+    if (specs->specifier == '\0') {
+      break;
+    }
+    print_conversion(output, specs, &args_copy);
+  }
+
+  va_end(args_copy);
+
+  flush_gadget(output);
+  append_termination_with_gadget(output);
+
+  return (int)output->pos;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 int vprintf_(const char* format, va_list arg)
 {
+#if PRINTF_STDOUT_CHUNK_SIZE
+  char chunk[PRINTF_STDOUT_CHUNK_SIZE];
+  output_gadget_t gadget = block_gadget(putblock_wrapper, NULL, chunk, sizeof(chunk));
+#else
   output_gadget_t gadget = extern_putchar_gadget();
+#endif
   return vsnprintf_impl(&gadget, format, arg);
 }
 
@@ -1387,6 +1831,16 @@ int vfctprintf(void (*out)(char c, void* extra_arg), void* extra_arg, const char
   return vsnprintf_impl(&gadget, format, arg);
 }
 
+int vbprintf(void (*write)(const char* data, size_t len, void* extra_arg), void* extra_arg, char* chunk, size_t chunk_size, const char* format, va_list arg)
+{
+  // Without a chunk to collect into, the output would be dropped while its length is returned
+  if ((write == NULL) || (chunk == NULL) || (chunk_size == 0U)) {
+    return -1;
+  }
+  output_gadget_t gadget = block_gadget(write, extra_arg, chunk, chunk_size);
+  return vsnprintf_impl(&gadget, format, arg);
+}
+
 int printf_(const char* format, ...)
 {
   va_list args;
@@ -1422,3 +1876,81 @@ int fctprintf(void (*out)(char c, void* extra_arg), void* extra_arg, const char*
   va_end(args);
   return ret;
 }
+
+int bprintf(void (*write)(const char* data, size_t len, void* extra_arg), void* extra_arg, char* chunk, size_t chunk_size, const char* format, ...)
+{
+  va_list args;
+  va_start(args, format);
+  const int ret = vbprintf(write, extra_arg, chunk, chunk_size, format, args);
+  va_end(args);
+  return ret;
+}
+
+int printf_compile(const char* format, printf_format_spec_t* specs, size_t max_specs)
+{
+  size_t count = 0U;
+
+  if ((format == NULL) || (specs == NULL)) {
+    return -1;
+  }
+
+  while (count < max_specs) {
+    printf_format_spec_t* spec = &specs[count++];
+
+    spec->literal = format;
+    while (*format && (*format != '%')) {
+      format++;
+    }
+    spec->literal_len = (unsigned int) (format - spec->literal);
+
+    if (!*format) {
+      spec->flags = 0U;
+      spec->width = 0U;
+      spec->precision = 0U;
+      spec->specifier = '\0';
+      return (int) count;
+    }
+
+    format++;
+    if (!*format || !parse_conversion_spec(&format, spec) || !is_supported_specifier(spec->specifier)) {
+      return -1;
+    }
+  }
+
+  return -1;
+}
+
+int vprintf_compiled(const printf_format_spec_t* specs, va_list arg)
+{
+#if PRINTF_STDOUT_CHUNK_SIZE
+  char chunk[PRINTF_STDOUT_CHUNK_SIZE];
+  output_gadget_t gadget = block_gadget(putblock_wrapper, NULL, chunk, sizeof(chunk));
+#else
+  output_gadget_t gadget = extern_putchar_gadget();
+#endif
+  return vsnprintf_compiled_impl(&gadget, specs, arg);
+}
+
+int vsnprintf_compiled(char* s, size_t n, const printf_format_spec_t* specs, va_list arg)
+{
+  output_gadget_t gadget = buffer_gadget(s, n);
+  return vsnprintf_compiled_impl(&gadget, specs, arg);
+}
+
+int printf_compiled(const printf_format_spec_t* specs, ...)
+{
+  va_list args;
+  va_start(args, specs);
+  const int ret = vprintf_compiled(specs, args);
+  va_end(args);
+  return ret;
+}
+
+int snprintf_compiled(char* s, size_t n, const printf_format_spec_t* specs, ...)
+{
+  va_list args;
+  va_start(args, specs);
+  const int ret = vsnprintf_compiled(s, n, specs, args);
+  va_end(args);
+  return ret;
+}
@@ -105,6 +105,16 @@ __attribute__((format(printf, (one_based_format_index), (first_arg))))
 PRINTF_VISIBILITY
 void putchar_(char c);
 
+/**
+ * Block counterpart of @ref putchar_ , used by @ref printf_ to output whole chunks of formatted text
+ * (see PRINTF_STDOUT_CHUNK_SIZE). Must return only once all @p len characters are written.
+ *
+ * @param data the characters to print, not null-terminated
+ * @param len the number of characters in @p data
+ */
+PRINTF_VISIBILITY
+void putblock_(const char* data, size_t len);
+
 
 /**
  * An implementation of the C standard's printf/vprintf
@@ -190,6 +200,71 @@ int fctprintf(void (*out)(char c, void* extra_arg), void* extra_arg, const char*
 PRINTF_VISIBILITY
 int vfctprintf(void (*out)(char c, void* extra_arg), void* extra_arg, const char* format, va_list arg) ATTR_VPRINTF(3);
 
+
+/**
+ * One element of a compiled format string: a run of literal text followed by one conversion.
+ * The last element has a specifier of '\0' and only carries the text after the last conversion.
+ * Elements point into the format string they were compiled from, which must outlive them.
+ */
+typedef struct {
+  const char* literal;
+  unsigned int literal_len;
+  unsigned int flags;
+  unsigned int width;
+  unsigned int precision;
+  char specifier;
+} printf_format_spec_t;
+
+/**
+ * Parse and validate a format string once, for use with @ref printf_compiled and the like
+ *
+ * @param format A string specifying the format of the output
+ * @param specs An array receiving the compiled format, one element per conversion plus one
+ * @param max_specs The number of elements of @p specs
+ * @return The number of elements used, or -1 if @p format holds an unsupported or incomplete
+ * conversion, or does not fit in @p specs
+ */
+PRINTF_VISIBILITY
+int printf_compile(const char* format, printf_format_spec_t* specs, size_t max_specs);
+
+/**
+ * printf/vprintf and snprintf/vsnprintf for a format compiled with @ref printf_compile ; only
+ * the conversions are carried out, the format string is not parsed again. Arguments are not
+ * checked against the format by the compiler.
+ */
+///@{
+PRINTF_VISIBILITY
+int printf_compiled(const printf_format_spec_t* specs, ...);
+PRINTF_VISIBILITY
+int vprintf_compiled(const printf_format_spec_t* specs, va_list arg);
+PRINTF_VISIBILITY
+int snprintf_compiled(char* s, size_t n, const printf_format_spec_t* specs, ...);
+PRINTF_VISIBILITY
+int vsnprintf_compiled(char* s, size_t n, const printf_format_spec_t* specs, va_list arg);
+///@}
+
+/**
+ * printf/vprintf with a user-specified block output function
+ *
+ * Formatted output is collected in @p chunk and handed to @p write each time the chunk fills up, and
+ * once more for the remainder, so the output function runs once per chunk rather than per character.
+ *
+ * @param write An output function which takes a run of characters (not null-terminated), their number
+ * and a type-erased additional parameter
+ * @param extra_arg The type-erased argument to pass to @p write with each call
+ * @param chunk A caller-provided buffer the output is collected in
+ * @param chunk_size The size of @p chunk in characters
+ * @param format A string specifying the format of the output, with %-marked specifiers of how to interpret
+ * additional arguments.
+ * @param arg Additional arguments to the function, one for each specifier in @p format
+ * @return The number of characters written, not counting the terminating null character, or -1
+ * (nothing written) if @p write or @p chunk is NULL or @p chunk_size is 0
+ */
+PRINTF_VISIBILITY
+int bprintf(void (*write)(const char* data, size_t len, void* extra_arg), void* extra_arg, char* chunk, size_t chunk_size, const char* format, ...) ATTR_PRINTF(5, 6);
+PRINTF_VISIBILITY
+int vbprintf(void (*write)(const char* data, size_t len, void* extra_arg), void* extra_arg, char* chunk, size_t chunk_size, const char* format, va_list arg) ATTR_VPRINTF(5);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -1,5 +1,7 @@
 #include "stdio_public.h"
 
+#include <string.h>
+
 int putch_(char ch)
 {
     unsigned char u_ch;
@@ -13,23 +15,17 @@ int putch_(char ch)
 
 int puts_(const char* s)
 {
-    int cnt;
+    size_t cnt;
 
     if(!s)
     {
         return EOF;
     }
 
-    cnt = 0;
-
-    while(*s)
-    {
-        putchar_(*s++);
-        cnt++;
-    }
+    cnt = strlen(s);
 
-    putchar_('\r');
-    putchar_('\n');
+    putblock_(s, cnt);
+    putblock_("\r\n", 2);
 
-    return cnt;
+    return (int) cnt;
 }
\ No newline at end of file
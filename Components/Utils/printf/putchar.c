@@ -1,18 +1,255 @@
+#include "stdio_public.h"
 #include "serial.h"
 #include "assert.h"
 
+#if CONFIG_PRINTF_TASK_BUFFERS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#endif /* CONFIG_PRINTF_TASK_BUFFERS */
+
 #ifdef CONFIG_PRINTF_SERIAL_PORT
 #define PUTCH_SERIAL_PORT   CONFIG_PRINTF_SERIAL_PORT
 #else
 #error No serial port specified to use by putch_
 #endif /* CONFIG_PRINTF_SERIAL_PORT */
 
-void putchar_(char ch)
+#if CONFIG_PRINTF_TASK_BUFFERS
+
+#if (CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX >= configNUM_THREAD_LOCAL_STORAGE_POINTERS)
+#error "CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX must be below configNUM_THREAD_LOCAL_STORAGE_POINTERS"
+#endif
+
+/* A line longer than the Tx queue can not be queued whole */
+#if (CONFIG_PRINTF_TASK_BUFFER_SIZE > CONFIG_SERIAL_TX_BUFFERSIZE)
+#error "CONFIG_PRINTF_TASK_BUFFER_SIZE must not exceed CONFIG_SERIAL_TX_BUFFERSIZE"
+#endif
+
+struct putch_task_buffer_t
+{
+    uint16_t len;
+    char data[CONFIG_PRINTF_TASK_BUFFER_SIZE];
+};
+
+#endif /* CONFIG_PRINTF_TASK_BUFFERS */
+
+static void putch_write(const char* data, size_t len)
+{
+    uint16_t sent;
+    uint16_t to_send;
+
+    /* One call per chunk, only repeated while the Tx queue is full */
+    while(len)
+    {
+        to_send = (len > UINT16_MAX) ? UINT16_MAX : (uint16_t) len;
+
+        serial_tx(PUTCH_SERIAL_PORT, (const uint8_t*) data, to_send, &sent);
+
+        data += sent;
+        len -= sent;
+    }
+}
+
+#if CONFIG_PRINTF_TASK_BUFFERS
+
+/* Held while a task line is being queued, serial_tx is called outside any critical section */
+static SemaphoreHandle_t putch_line_mutex;
+
+/**
+ * @brief Queue a task line all at once, lines of other tasks go before or after it.
+ * Blocks on the line mutex while another line is being queued, then waits a tick at
+ * a time until the Tx queue has room for the whole line.
+ */
+static void putch_enqueue_line(const char* data, uint16_t len)
 {
     uint16_t sent;
 
-    do
+    xSemaphoreTake(putch_line_mutex, portMAX_DELAY);
+
+    /* Room is made by the Tx interrupt, there is nothing to block on */
+    while(serial_get_tx_free(PUTCH_SERIAL_PORT) < len)
+    {
+        vTaskDelay(1);
+    }
+
+    /* Interrupt writers may take some of the room, the rest of the line follows */
+    while(len)
+    {
+        sent = 0;
+        serial_tx(PUTCH_SERIAL_PORT, (const uint8_t*) data, len, &sent);
+
+        if(sent == 0)
+        {
+            vTaskDelay(1);
+        }
+
+        data += sent;
+        len -= sent;
+    }
+
+    xSemaphoreGive(putch_line_mutex);
+}
+
+/**
+ * @brief Create the line mutex on the first task output, tasks may race to do it.
+ *
+ * @return error_t FAILED if the heap is exhausted
+ */
+static error_t putch_create_line_mutex(void)
+{
+    SemaphoreHandle_t mutex;
+
+    if(putch_line_mutex)
+    {
+        return OK;
+    }
+
+    mutex = xSemaphoreCreateMutex();
+
+    if(!mutex)
+    {
+        return FAILED;
+    }
+
+    taskENTER_CRITICAL();
+
+    if(!putch_line_mutex)
+    {
+        putch_line_mutex = mutex;
+        mutex = NULL;
+    }
+
+    taskEXIT_CRITICAL();
+
+    /* Another task got there first */
+    if(mutex)
+    {
+        vSemaphoreDelete(mutex);
+    }
+
+    return OK;
+}
+
+/**
+ * @brief Buffer of the calling task, allocated on its first output.
+ *
+ * @return struct putch_task_buffer_t* NULL outside of a running task or if the heap is exhausted,
+ * output then goes to the serial port unbuffered
+ */
+static struct putch_task_buffer_t* putch_get_task_buffer(void)
+{
+    struct putch_task_buffer_t* buffer;
+
+    if(xPortIsInsideInterrupt() || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        return NULL;
+    }
+
+    buffer = (struct putch_task_buffer_t*)
+            pvTaskGetThreadLocalStoragePointer(NULL, CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX);
+
+    if(!buffer && putch_create_line_mutex() == OK)
+    {
+        buffer = (struct putch_task_buffer_t*) pvPortMalloc(sizeof(*buffer));
+
+        if(buffer)
+        {
+            buffer->len = 0;
+            vTaskSetThreadLocalStoragePointer(NULL, CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX, buffer);
+        }
+    }
+
+    return buffer;
+}
+
+static void putch_buffer_write(struct putch_task_buffer_t* buffer, const char* data, size_t len)
+{
+    char ch;
+
+    while(len--)
+    {
+        ch = *data++;
+        buffer->data[buffer->len++] = ch;
+
+        if(ch == '\n' || buffer->len == sizeof(buffer->data))
+        {
+            putch_enqueue_line(buffer->data, buffer->len);
+            buffer->len = 0;
+        }
+    }
+}
+
+void putch_task_flush(void)
+{
+    struct putch_task_buffer_t* buffer;
+
+    buffer = putch_get_task_buffer();
+
+    if(buffer && buffer->len)
+    {
+        putch_enqueue_line(buffer->data, buffer->len);
+        buffer->len = 0;
+    }
+}
+
+void putch_task_release(void)
+{
+    struct putch_task_buffer_t* buffer;
+
+    if(xPortIsInsideInterrupt() || xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
     {
-        serial_tx(PUTCH_SERIAL_PORT, (const uint8_t*) &ch, sizeof(ch), &sent);
-    } while(sent != sizeof(ch));
-}
\ No newline at end of file
+        return;
+    }
+
+    buffer = (struct putch_task_buffer_t*)
+            pvTaskGetThreadLocalStoragePointer(NULL, CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX);
+
+    if(buffer)
+    {
+        if(buffer->len)
+        {
+            putch_enqueue_line(buffer->data, buffer->len);
+        }
+
+        vTaskSetThreadLocalStoragePointer(NULL, CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX, NULL);
+        vPortFree(buffer);
+    }
+}
+
+#endif /* CONFIG_PRINTF_TASK_BUFFERS */
+
+void putchar_(char ch)
+{
+    #if CONFIG_PRINTF_TASK_BUFFERS
+    struct putch_task_buffer_t* buffer;
+
+    buffer = putch_get_task_buffer();
+
+    if(buffer)
+    {
+        putch_buffer_write(buffer, &ch, 1);
+
+        return;
+    }
+    #endif /* CONFIG_PRINTF_TASK_BUFFERS */
+
+    putch_write(&ch, 1);
+}
+
+void putblock_(const char* data, size_t len)
+{
+    #if CONFIG_PRINTF_TASK_BUFFERS
+    struct putch_task_buffer_t* buffer;
+
+    buffer = putch_get_task_buffer();
+
+    if(buffer)
+    {
+        putch_buffer_write(buffer, data, len);
+
+        return;
+    }
+    #endif /* CONFIG_PRINTF_TASK_BUFFERS */
+
+    putch_write(data, len);
+}
@@ -32,6 +32,23 @@ int putch_(char ch);
 PRINTF_VISIBILITY
 int puts_(const char* s);
 
+/**
+ * @brief With CONFIG_PRINTF_TASK_BUFFERS, each task collects its output in its own line
+ * buffer, queued to the serial port whole on newline or when full. Call this to queue a
+ * partial line right away.
+ */
+void putch_task_flush(void);
+
+/**
+ * @brief Queue what is left and free the line buffer of the calling task.
+ *
+ * @warning With CONFIG_PRINTF_TASK_BUFFERS, every task that printed MUST call this before
+ * it is deleted, whether it deletes itself or another task does. The call has to come from
+ * the task itself, the buffer is found through its thread local storage pointer, and
+ * FreeRTOS 10.4.6 has no callback to free those on deletion: the buffer leaks otherwise.
+ */
+void putch_task_release(void);
+
 #if PRINTF_ALIAS_STANDARD_FUNCTION_NAMES_SOFT
 #define putchar     putch_
 #define puts        puts_
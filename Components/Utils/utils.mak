@@ -29,6 +29,31 @@ else
 UTILS_DEFINES += PRINTF_SUPPORT_EXPONENTIAL_SPECIFIERS='0'
 endif
 
+ifdef CONFIG_PRINTF_FIXED_POINT_DECIMAL_USE
+UTILS_DEFINES += PRINTF_SUPPORT_FIXED_POINT_DECIMAL='1'
+else
+UTILS_DEFINES += PRINTF_SUPPORT_FIXED_POINT_DECIMAL='0'
+endif
+
+ifdef CONFIG_PRINTF_FIXED_POINT_SPECIFIER_USE
+UTILS_DEFINES += PRINTF_SUPPORT_FIXED_POINT_SPECIFIER='1'
+UTILS_DEFINES += PRINTF_FIXED_POINT_FRACTIONAL_BITS=$(CONFIG_PRINTF_FIXED_POINT_FRACTIONAL_BITS)
+else
+UTILS_DEFINES += PRINTF_SUPPORT_FIXED_POINT_SPECIFIER='0'
+endif
+
+ifdef CONFIG_PRINTF_STDOUT_CHUNK_SIZE
+UTILS_DEFINES += PRINTF_STDOUT_CHUNK_SIZE=$(CONFIG_PRINTF_STDOUT_CHUNK_SIZE)
+endif
+
+ifdef CONFIG_PRINTF_TASK_BUFFERS
+UTILS_DEFINES += CONFIG_PRINTF_TASK_BUFFERS='1'
+UTILS_DEFINES += CONFIG_PRINTF_TASK_BUFFER_SIZE=$(CONFIG_PRINTF_TASK_BUFFER_SIZE)
+UTILS_DEFINES += CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX=$(CONFIG_PRINTF_TASK_BUFFER_TLS_INDEX)
+else
+UTILS_DEFINES += CONFIG_PRINTF_TASK_BUFFERS='0'
+endif
+
 ifdef CONFIG_PRINTF_SERIAL_PORT
 UTILS_DEFINES += CONFIG_PRINTF_SERIAL_PORT=$(CONFIG_PRINTF_SERIAL_PORT)
 endif
@@ -59,8 +59,16 @@ void usart4_irq_handler(void) __attribute__((weak, alias("default_handler")));
 void usart5_irq_handler(void) __attribute__((weak, alias("default_handler")));
 void usart6_irq_handler(void) __attribute__((weak, alias("default_handler")));
 
+void tim1_up_tim10_irq_handler(void)	__attribute__((weak, alias("default_handler")));
+void tim1_cc_irq_handler(void)	__attribute__((weak, alias("default_handler")));
+void tim2_irq_handler(void)	__attribute__((weak, alias("default_handler")));
+void tim3_irq_handler(void)	__attribute__((weak, alias("default_handler")));
+void tim4_irq_handler(void)	__attribute__((weak, alias("default_handler")));
+void tim5_irq_handler(void)	__attribute__((weak, alias("default_handler")));
 void tim6_irq_handler(void)	__attribute__((weak, alias("default_handler")));
 void tim7_irq_handler(void)	__attribute__((weak, alias("default_handler")));
+void tim8_up_tim13_irq_handler(void)	__attribute__((weak, alias("default_handler")));
+void tim8_cc_irq_handler(void)	__attribute__((weak, alias("default_handler")));
 
 __attribute__((section(".reset_vector")))
 uint32_t reset_vector[RESET_VECTOR_SIZE] = 
@@ -106,12 +114,12 @@ uint32_t reset_vector[RESET_VECTOR_SIZE] =
 	0,
 	(uint32_t) &exti9_5_irq_handler,
 	0,
+	(uint32_t) &tim1_up_tim10_irq_handler,
 	0,
-	0,
-	0,
-	0,
-	0,
-	0,
+	(uint32_t) &tim1_cc_irq_handler,
+	(uint32_t) &tim2_irq_handler,
+	(uint32_t) &tim3_irq_handler,
+	(uint32_t) &tim4_irq_handler,
 	0,
 	0,
 	0,
@@ -125,13 +133,13 @@ uint32_t reset_vector[RESET_VECTOR_SIZE] =
 	0,
 	0,
 	0,
+	(uint32_t) &tim8_up_tim13_irq_handler,
 	0,
-	0,
-	0,
+	(uint32_t) &tim8_cc_irq_handler,
 	(uint32_t) &dma1_stream7_irq_handler,
 	0,
 	0,
-	0,
+	(uint32_t) &tim5_irq_handler,
 	0,
 	(uint32_t) &usart4_irq_handler,
 	(uint32_t) &usart5_irq_handler,
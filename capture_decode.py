@@ -0,0 +1,195 @@
+#! /usr/bin/python3
+
+import os
+import argparse
+import struct
+import sys
+
+
+"""
+Convert a run-length encoded GPIO capture from gpio_capture_send_rle() to a VCD
+file, viewable with GTKWave or PulseView.
+
+The capture is read from --capture-file, a recording of the serial output.
+Anything before the "GCAP" header is skipped. Each recorded pin becomes a wire
+named after its number, or after --names given in pin order. The trigger
+sample is marked with a comment and a "trigger" wire pulsed high on it.
+
+"""
+
+CAPTURE_MAGIC = b'GCAP'
+CAPTURE_VERSION = 1
+CAPTURE_HEADER = '<4sBBHIII'
+CAPTURE_OVERRUN = 0x01
+
+# Printable VCD identifiers, one per pin and one for the trigger
+VCD_FIRST_ID = 33
+
+
+class Capture:
+
+    def __init__(self, data):
+        start = data.find(CAPTURE_MAGIC)
+
+        if start < 0:
+            raise ValueError('no capture header found')
+
+        (_, version, flags, pin_mask, sample_hz, samples, trigger) = \
+            struct.unpack_from(CAPTURE_HEADER, data, start)
+
+        if version != CAPTURE_VERSION:
+            raise ValueError('unsupported capture version {}'.format(version))
+
+        self.overrun = bool(flags & CAPTURE_OVERRUN)
+        self.pin_mask = pin_mask
+        self.sample_hz = sample_hz
+        self.samples = samples
+        self.trigger = trigger
+        self.runs = []
+
+        pos = start + struct.calcsize(CAPTURE_HEADER)
+        total = 0
+
+        while total < samples:
+            if pos + 2 > len(data):
+                raise ValueError('capture truncated after {} samples'.format(total))
+
+            value, = struct.unpack_from('<H', data, pos)
+            pos += 2
+            count = 0
+            shift = 0
+
+            while True:
+                if pos >= len(data):
+                    raise ValueError('capture truncated after {} samples'.format(total))
+
+                byte = data[pos]
+                pos += 1
+                count |= (byte & 0x7F) << shift
+                shift += 7
+
+                if (byte & 0x80) == 0:
+                    break
+
+            if count == 0:
+                raise ValueError('empty run at sample {}'.format(total))
+
+            self.runs.append((value, count))
+            total += count
+
+        if total != samples:
+            raise ValueError('runs hold {} samples, {} expected'.format(total, samples))
+
+    def pins(self):
+        return [pin for pin in range(16) if self.pin_mask & (1 << pin)]
+
+
+def write_vcd(capture, names, out_file):
+    pins = capture.pins()
+    ids = {pin: chr(VCD_FIRST_ID + indx) for indx, pin in enumerate(pins)}
+    trigger_id = chr(VCD_FIRST_ID + len(pins))
+
+    # Sample period in ns, the timescale of the dump
+    period_ns = 1e9 / capture.sample_hz
+
+    out_file.write('$comment GPIO capture, {} samples at {} Hz{} $end\n'.format(
+        capture.samples, capture.sample_hz, ', overrun' if capture.overrun else ''))
+    out_file.write('$timescale 1 ns $end\n')
+    out_file.write('$scope module gpio $end\n')
+
+    for indx, pin in enumerate(pins):
+        name = names[indx] if indx < len(names) else 'pin{}'.format(pin)
+        out_file.write('$var wire 1 {} {} $end\n'.format(ids[pin], name))
+
+    out_file.write('$var wire 1 {} trigger $end\n'.format(trigger_id))
+    out_file.write('$upscope $end\n')
+    out_file.write('$enddefinitions $end\n')
+
+    # Value changes by sample index, the trigger pulse merged with the pin changes
+    events = {0: ['0{}'.format(trigger_id)]}
+    previous = None
+    sample = 0
+
+    for (value, count) in capture.runs:
+        for pin in pins:
+            level = (value >> pin) & 1
+            if previous is None or ((previous >> pin) & 1) != level:
+                events.setdefault(sample, []).append('{}{}'.format(level, ids[pin]))
+
+        previous = value
+        sample += count
+
+    events.setdefault(capture.trigger, []).append('1{}'.format(trigger_id))
+    events.setdefault(capture.trigger + 1, []).append('0{}'.format(trigger_id))
+
+    if capture.trigger == 0:
+        events[0].remove('0{}'.format(trigger_id))
+
+    for index in sorted(events):
+        out_file.write('#{}\n'.format(int(round(index * period_ns))))
+
+        if index == capture.trigger:
+            out_file.write('$comment trigger $end\n')
+
+        for change in events[index]:
+            out_file.write(change + '\n')
+
+    if sample not in events:
+        out_file.write('#{}\n'.format(int(round(sample * period_ns))))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        description=__doc__)
+
+    parser.add_argument(
+        "--capture-file",
+        metavar="CAPTURE_FILE",
+        required=True,
+        help="""
+        Recorded output of gpio_capture_send_rle()""")
+
+    parser.add_argument(
+        "--names",
+        metavar="NAME",
+        nargs='+',
+        default=[],
+        help="""
+        Signal names of the recorded pins, lowest pin first""")
+
+    parser.add_argument(
+        "--output-file",
+        metavar="OUTPUT_FILE",
+        help="""
+        Write the VCD dump to this file. If not specified, it is written to
+        stdout
+        """)
+
+    args = parser.parse_args()
+
+    if os.path.isfile(args.capture_file) is False:
+        print('Error: {} no such file'.format(args.capture_file))
+        exit(-1)
+
+    with open(args.capture_file, 'rb') as in_file:
+        data = in_file.read()
+
+    try:
+        capture = Capture(data)
+    except ValueError as error:
+        print('Error: {}'.format(error))
+        exit(-1)
+
+    if args.output_file is not None:
+        with open(args.output_file, 'w') as out_file:
+            write_vcd(capture, args.names, out_file)
+    else:
+        write_vcd(capture, args.names, sys.stdout)
+
+    print('{} sample(s) in {} run(s){}'.format(capture.samples, len(capture.runs),
+          ', samples were overwritten before the capture stopped' if capture.overrun
+          else ''), file=sys.stderr)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,221 @@
+#! /usr/bin/python3
+
+import os
+import argparse
+import re
+import struct
+import sys
+
+
+"""
+Decode binary log records captured from log_binary_dump().
+
+Records hold the addresses of the tag and format strings, so the firmware
+ELF the records were produced by is needed to resolve them. Raw records are
+read from --dump-file, a capture of the log output or a memory dump of the
+log ring. Anything between records is skipped until the next sync byte.
+
+"""
+
+LOG_BINARY_SYNC = 0xA5
+LOG_BINARY_HEADER_WORDS = 5
+
+LOG_PREFIXES = ['N', 'E', 'W', 'I', 'D']
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+format_spec_regex = re.compile(
+    r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|j|z|t)?([diuxXoscpb%])')
+
+
+class ElfImage:
+
+    def __init__(self, elf_file):
+        self.sections = []
+
+        with open(elf_file, 'rb') as in_file:
+            data = in_file.read()
+
+        if data[:4] != b'\x7fELF' or data[4] != 1:
+            print('Error: {} is not a 32-bit ELF file'.format(elf_file))
+            exit(-1)
+
+        endian = '<' if data[5] == 1 else '>'
+        shoff, = struct.unpack_from(endian + 'I', data, 0x20)
+        shentsize, shnum = struct.unpack_from(endian + 'HH', data, 0x2E)
+
+        for indx in range(shnum):
+            (_, sh_type, sh_flags, sh_addr, sh_offset, sh_size) = \
+                struct.unpack_from(endian + 'IIIIII', data, shoff + indx * shentsize)
+
+            if sh_type == SHT_PROGBITS and (sh_flags & SHF_ALLOC) and sh_size:
+                self.sections.append((sh_addr, data[sh_offset:sh_offset + sh_size]))
+
+    def read_string(self, addr):
+        for (base, content) in self.sections:
+            if base <= addr < base + len(content):
+                end = content.find(b'\0', addr - base)
+                if end < 0:
+                    end = len(content)
+                return content[addr - base:end].decode('latin-1')
+
+        return None
+
+
+def to_signed(value, length):
+    if length == 'hh':
+        value &= 0xFF
+        return value - 0x100 if value & 0x80 else value
+    if length == 'h':
+        value &= 0xFFFF
+        return value - 0x10000 if value & 0x8000 else value
+
+    return value - 0x100000000 if value & 0x80000000 else value
+
+
+def format_record(elf, fmt, args):
+    out = []
+    arg_iter = iter(args)
+    pos = 0
+
+    def next_arg():
+        return next(arg_iter, 0)
+
+    for match in format_spec_regex.finditer(fmt):
+        out.append(fmt[pos:match.start()])
+        pos = match.end()
+
+        flags, width, precision, length, conv = match.groups()
+
+        if conv == '%':
+            out.append('%')
+            continue
+
+        if width == '*':
+            width = str(to_signed(next_arg(), None))
+        if precision == '*':
+            precision = str(to_signed(next_arg(), None))
+
+        spec = '%' + flags + (width or '') + ('.' + precision if precision else '')
+        value = next_arg()
+
+        if conv in 'di':
+            out.append((spec + 'd') % to_signed(value, length))
+        elif conv == 'u':
+            if length == 'hh':
+                value &= 0xFF
+            elif length == 'h':
+                value &= 0xFFFF
+            out.append((spec + 'd') % value)
+        elif conv in 'xXo':
+            out.append((spec + conv) % value)
+        elif conv == 'b':
+            out.append((spec + 's') % format(value, 'b'))
+        elif conv == 'c':
+            out.append((spec + 'c') % chr(value & 0xFF))
+        elif conv == 'p':
+            out.append((spec + 's') % '0x{:08x}'.format(value))
+        elif conv == 's':
+            string = elf.read_string(value)
+            if string is None:
+                string = '<0x{:08x}>'.format(value)
+            out.append((spec + 's') % string)
+
+    out.append(fmt[pos:])
+
+    return ''.join(out)
+
+
+def decode_records(elf, data, out_file):
+    last_seq = None
+    decoded = 0
+    pos = 0
+
+    while pos + LOG_BINARY_HEADER_WORDS * 4 <= len(data):
+        if data[pos + 3] != LOG_BINARY_SYNC:
+            pos += 1
+            continue
+
+        (header, timestamp_low, timestamp_high, tag_addr, fmt_addr) = \
+            struct.unpack_from('<IIIII', data, pos)
+
+        level = (header >> 20) & 0x0F
+        nargs = (header >> 16) & 0x0F
+        seq = header & 0xFFFF
+        timestamp = (timestamp_high << 32) | timestamp_low
+
+        tag = elf.read_string(tag_addr)
+        fmt = elf.read_string(fmt_addr)
+        end = pos + (LOG_BINARY_HEADER_WORDS + nargs) * 4
+
+        # A sync byte inside the payload, resynchronize on the next byte
+        if tag is None or fmt is None or end > len(data):
+            pos += 1
+            continue
+
+        args = struct.unpack_from('<{}I'.format(nargs), data, pos + LOG_BINARY_HEADER_WORDS * 4)
+
+        if last_seq is not None and seq != ((last_seq + 1) & 0xFFFF):
+            out_file.write('--- {} record(s) lost ---\n'.format((seq - last_seq - 1) & 0xFFFF))
+        last_seq = seq
+
+        prefix = LOG_PREFIXES[level] if level < len(LOG_PREFIXES) else LOG_PREFIXES[0]
+        out_file.write('{} ({}) {}: {}\n'.format(prefix, timestamp, tag,
+                                                   format_record(elf, fmt, args)))
+
+        decoded += 1
+        pos = end
+
+    return decoded
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+        description=__doc__)
+
+    parser.add_argument(
+        "--elf-file",
+        metavar="ELF_FILE",
+        required=True,
+        help="""
+        Firmware ELF the records were produced by""")
+
+    parser.add_argument(
+        "--dump-file",
+        metavar="DUMP_FILE",
+        required=True,
+        help="""
+        Captured binary log records""")
+
+    parser.add_argument(
+        "--output-file",
+        metavar="OUTPUT_FILE",
+        help="""
+        Write decoded log lines to this file. If not specified, they are
+        written to stdout
+        """)
+
+    args = parser.parse_args()
+
+    for file in (args.elf_file, args.dump_file):
+        if os.path.isfile(file) is False:
+            print('Error: {} no such file'.format(file))
+            exit(-1)
+
+    elf = ElfImage(args.elf_file)
+
+    with open(args.dump_file, 'rb') as in_file:
+        data = in_file.read()
+
+    if args.output_file is not None:
+        with open(args.output_file, 'w') as out_file:
+            decoded = decode_records(elf, data, out_file)
+    else:
+        decoded = decode_records(elf, data, sys.stdout)
+
+    print('{} record(s) decoded'.format(decoded), file=sys.stderr)
+
+if __name__ == "__main__":
+    main()
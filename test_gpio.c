@@ -0,0 +1,478 @@
+/*
+* Host test of gpio_init (gpio.c) and the port-wide GPIO, EXTI and SYSCFG setters it
+* uses, against a register image. The GPIO ports, SYSCFG, EXTI and RCC blocks are
+* backed by RAM mapped at their own addresses and filled with random contents. For
+* random ports, pin masks, modes and pulls, every register of every block must read
+* what RM0390 says the configuration leaves there: MODER, OTYPER and PUPDR fields of
+* the pins set, OSPEEDR and the other pins untouched, EXTICR, RTSR, FTSR and IMR of
+* interrupt lines, the clocks enabled, and each NVIC line of the pins enabled once.
+* The alternate function setters over a mask must leave the same image as the per
+* pin setters.
+*
+* An EXTI interrupt shared by several lines must serve only the pending lines that are
+* not masked in IMR, and clear only those. A line masked by the storm guard must be
+* neither counted nor passed on, however it is reached, until its release.
+*
+* The device header is kept out with its include guard, NVIC, PRIMASK, the cycle clock
+* and the software timers are faked below and the sources are included directly.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_GPIO_STORM_GUARD=1 \
+*       -DCONFIG_GPIO_STORM_MAX_EDGES=100 -DCONFIG_GPIO_STORM_WINDOW_MS=10 -DCONFIG_GPIO_STORM_BACKOFF_MS=100 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_gpio.c -o test_gpio && ./test_gpio
+*/
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+/* From SYSCFG up to the end of RCC */
+#define PERIPH_BASE         0x40010000UL
+#define PERIPH_SIZE         0x14000UL
+#define PERIPH_WORDS        (PERIPH_SIZE / 4U)
+
+#define REG(addr)           (*(volatile uint32_t*) (uintptr_t) (addr))
+#define WORD(addr)          (((addr) - PERIPH_BASE) / 4U)
+
+#define GPIO_BASE(port)     (0x40020000UL + (port) * 0x400UL)
+#define GPIO_MODER          0x00UL
+#define GPIO_OTYPER         0x04UL
+#define GPIO_PUPDR          0x0CUL
+#define GPIO_AFRL           0x20UL
+#define GPIO_AFRH           0x24UL
+#define SYSCFG_EXTICR(n)    (0x40013808UL + (n) * 4UL)
+#define EXTI_IMR            0x40013C00UL
+#define EXTI_RTSR           0x40013C08UL
+#define EXTI_FTSR           0x40013C0CUL
+#define EXTI_PR             0x40013C14UL
+#define RCC_AHB1ENR         0x40023830UL
+#define RCC_APB2ENR         0x40023844UL
+
+#define CONFIGS             20000
+
+typedef enum
+{
+    EXTI0_IRQn = 6,
+    EXTI1_IRQn = 7,
+    EXTI2_IRQn = 8,
+    EXTI3_IRQn = 9,
+    EXTI4_IRQn = 10,
+    EXTI9_5_IRQn = 23,
+    EXTI15_10_IRQn = 40,
+} IRQn_Type;
+
+static uint64_t nvic_enabled;
+static uint32_t nvic_enables;
+
+static void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    nvic_enabled |= 1ULL << irq;
+    nvic_enables++;
+}
+
+static void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    nvic_enabled &= ~(1ULL << irq);
+}
+
+static void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+    (void) irq;
+}
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return 0;
+}
+
+static inline void __disable_irq(void)
+{
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    (void) primask;
+}
+
+#define __CLZ(x)        ((uint32_t) __builtin_clz(x))
+#define __WEAK          __attribute__((weak))
+
+#include "Components/Drivers/GPIO/gpio.c"
+#include "Components/HAL/GPIO/STM32F446/IMP/gpio_hal.c"
+#include "Components/HAL/EXTI/STM32F446/IMP/exti_hal.c"
+#include "Components/HAL/SYSCFG/STM32F446/IMP/syscfg_hal.c"
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+/* Cycle clock and software timers, the storm guard release timer is run by hand */
+static uint64_t fake_cycles;
+static uint64_t fake_ms;
+static soft_timer_t* release_timer;
+
+uint64_t timer_get_cycles(void)
+{
+    return fake_cycles;
+}
+
+uint64_t timer_get_milliseconds(void)
+{
+    return fake_ms;
+}
+
+error_t soft_timer_init(soft_timer_t* p_timer, soft_timer_callback_t callback, void* arg)
+{
+    p_timer->callback = callback;
+    p_timer->arg = arg;
+    release_timer = p_timer;
+
+    return OK;
+}
+
+error_t soft_timer_start(soft_timer_t* p_timer, uint32_t timeout_ms, uint32_t period_ms)
+{
+    CHECK(p_timer == release_timer && period_ms == CONFIG_GPIO_STORM_WINDOW_MS);
+
+    return OK;
+}
+
+static uint32_t expected[PERIPH_WORDS];
+
+static void randomize(void)
+{
+    uint32_t indx;
+
+    for(indx = 0; indx < PERIPH_WORDS; indx++)
+    {
+        REG(PERIPH_BASE + indx * 4U) = ((uint32_t) rand() << 16) ^ (uint32_t) rand();
+    }
+}
+
+static void snapshot(void)
+{
+    uint32_t indx;
+
+    for(indx = 0; indx < PERIPH_WORDS; indx++)
+    {
+        expected[indx] = REG(PERIPH_BASE + indx * 4U);
+    }
+}
+
+/* Sets the field of a pin in the expected image */
+static void expect_field(uint32_t addr, uint32_t pin, uint32_t width, uint32_t value)
+{
+    uint32_t mask;
+
+    mask = (1UL << width) - 1UL;
+    expected[WORD(addr)] &= ~(mask << (pin * width));
+    expected[WORD(addr)] |= value << (pin * width);
+}
+
+static void check_image(void)
+{
+    uint32_t indx;
+
+    for(indx = 0; indx < PERIPH_WORDS; indx++)
+    {
+        if(REG(PERIPH_BASE + indx * 4U) != expected[indx])
+        {
+            printf("register 0x%08lX: 0x%08X, expected 0x%08X\n", PERIPH_BASE + indx * 4UL,
+                                                REG(PERIPH_BASE + indx * 4U), expected[indx]);
+            CHECK(0);
+        }
+    }
+}
+
+static uint64_t nvic_of_mask(uint32_t mask)
+{
+    static const IRQn_Type irqs[16] = {EXTI0_IRQn, EXTI1_IRQn, EXTI2_IRQn, EXTI3_IRQn,
+                    EXTI4_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn,
+                    EXTI9_5_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn,
+                    EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn};
+    uint64_t enabled;
+    uint32_t pin;
+
+    enabled = 0;
+
+    for(pin = 0; pin < 16; pin++)
+    {
+        if((mask >> pin) & 0x01)
+        {
+            enabled |= 1ULL << irqs[pin];
+        }
+    }
+
+    return enabled;
+}
+
+static uint32_t served[16];
+static uint32_t served_order;           /* Lines served, one hex digit each */
+
+static void irq_callback(uint32_t pin, void* arg)
+{
+    CHECK(arg == &served[pin]);
+
+    served[pin]++;
+    served_order = (served_order << 4) | pin;
+}
+
+int main(void)
+{
+    static const uint32_t modes[] = {GPIO_MODE_INPUT, GPIO_MODE_OUTPUT_PP, GPIO_MODE_OUTPUT_OD,
+                                    GPIO_MODE_ANALOG, GPIO_MODE_IT_RISING, GPIO_MODE_IT_FALLING,
+                                    GPIO_MODE_IT_RISING_FALLING};
+    static const uint32_t pulls[] = {GPIO_NOPULL, GPIO_PULLUP, GPIO_PULLDOWN};
+    static uint32_t per_pin[PERIPH_WORDS];
+    gpio_hal_context_t gpio_hal;
+    exti_hal_context_t exti_hal;
+    gpio_storm_stats_t stats;
+    gpio_config_t config;
+    gpio_port_t port;
+    uint32_t interrupts;
+    uint32_t edges;
+    uint32_t mode_bits;
+    uint32_t pin;
+    uint32_t func;
+    uint32_t indx;
+    uint32_t run;
+    void* periph;
+
+    periph = mmap((void*) PERIPH_BASE, PERIPH_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    CHECK(periph == (void*) PERIPH_BASE);
+
+    srand(7);
+    interrupts = 0;
+
+    for(run = 0; run < CONFIGS; run++)
+    {
+        randomize();
+        nvic_enabled = 0;
+        nvic_enables = 0;
+
+        port = (gpio_port_t) (rand() % GPIO_PORT_ALL);
+        config.mode = modes[rand() % (sizeof(modes) / sizeof(modes[0]))];
+        config.pull = pulls[rand() % 3];
+        config.pin_mask = (uint32_t) rand() & 0xFFFFU;
+        config.irq_callback = (rand() & 1) ? irq_callback : NULL;
+        config.irq_arg = NULL;
+
+        /* EXTI lines 4 to 15 have no port H */
+        if((config.mode & MODE_INTERRUPT) && port == GPIOH)
+        {
+            config.pin_mask &= 0x0FU;
+        }
+
+        if(!config.pin_mask)
+        {
+            config.pin_mask = 1U << (rand() % 4);
+        }
+
+        snapshot();
+        expected[WORD(RCC_AHB1ENR)] |= 1UL << port;
+
+        mode_bits = (config.mode & MODE_OUTPUT) ? 0x1U : (config.mode & MODE_ANALOG) ? 0x3U : 0x0U;
+
+        for(pin = 0; pin < 16; pin++)
+        {
+            if(!((config.pin_mask >> pin) & 0x01))
+            {
+                continue;
+            }
+
+            expect_field(GPIO_BASE(port) + GPIO_MODER, pin, 2, mode_bits);
+
+            if(config.mode & MODE_OUTPUT)
+            {
+                expect_field(GPIO_BASE(port) + GPIO_OTYPER, pin, 1, (config.mode & OUTPUT_OD) ? 1U : 0U);
+            }
+
+            if(!(config.mode & MODE_ANALOG))
+            {
+                expect_field(GPIO_BASE(port) + GPIO_PUPDR, pin, 2, config.pull);
+            }
+
+            if(config.mode & MODE_INTERRUPT)
+            {
+                expect_field(SYSCFG_EXTICR(pin / 4U), pin % 4U, 4, (uint32_t) port);
+                expect_field(EXTI_RTSR, pin, 1, (config.mode & TRIGGER_RISING) ? 1U : 0U);
+                expect_field(EXTI_FTSR, pin, 1, (config.mode & TRIGGER_FALLING) ? 1U : 0U);
+                expect_field(EXTI_IMR, pin, 1, 1U);
+            }
+        }
+
+        if(config.mode & MODE_INTERRUPT)
+        {
+            expected[WORD(RCC_APB2ENR)] |= 1UL << 14;
+            interrupts++;
+        }
+
+        CHECK(gpio_init(port, &config) == OK);
+        check_image();
+
+        CHECK(nvic_enabled == ((config.mode & MODE_INTERRUPT) ? nvic_of_mask(config.pin_mask) : 0));
+        CHECK(nvic_enables == (uint32_t) __builtin_popcountll(nvic_enabled));
+    }
+
+    printf("gpio_init: %u configurations, %u with interrupts, register images as expected\n",
+                                                                        CONFIGS, interrupts);
+
+    /* A masked line keeps its NVIC line while a sibling is enabled */
+    randomize();
+    REG(EXTI_IMR) = 0;
+    nvic_enabled = 0;
+    config.pin_mask = GPIO_PIN_MASK(GPIO_PIN_5) | GPIO_PIN_MASK(GPIO_PIN_6);
+    config.mode = GPIO_MODE_IT_RISING;
+    config.pull = GPIO_NOPULL;
+    CHECK(gpio_init(GPIOB, &config) == OK);
+    CHECK(nvic_enabled == (1ULL << EXTI9_5_IRQn));
+
+    EXTI_HAL_GET_HW(&exti_hal, EXTI);
+    exti_hal_disable_interrupt(&exti_hal, EXTI_LINE_5);
+    CHECK(REG(EXTI_IMR) == 0x40U && nvic_enabled == (1ULL << EXTI9_5_IRQn));
+    exti_hal_disable_interrupt(&exti_hal, EXTI_LINE_6);
+    CHECK(REG(EXTI_IMR) == 0 && nvic_enabled == 0);
+    printf("exti_hal_disable_interrupt: the NVIC line goes with its last line\n");
+
+    /* Lines 5, 6 and 7 on EXTI9_5, 8 pends but never had its interrupt enabled */
+    REG(EXTI_IMR) = 0;
+
+    for(pin = 5; pin <= 7; pin++)
+    {
+        config.pin_mask = GPIO_PIN_MASK(pin);
+        config.irq_callback = irq_callback;
+        config.irq_arg = &served[pin];
+        CHECK(gpio_init(GPIOB, &config) == OK);
+    }
+
+    CHECK(REG(EXTI_IMR) == 0xE0U);
+    exti_hal_disable_interrupt(&exti_hal, EXTI_LINE_6);
+
+    /* PR is rc_w1, the image keeps the last value written */
+    REG(EXTI_PR) = 0x1E0U;
+    served_order = 0;
+    exti9_5_irq_handler();
+    CHECK(served_order == 0x75U && served[6] == 0);
+    CHECK(REG(EXTI_PR) == 0xA0U);
+
+    REG(EXTI_PR) = 0x140U;
+    exti9_5_irq_handler();
+    CHECK(served_order == 0x75U && REG(EXTI_PR) == 0);
+    printf("dispatch: masked lines are left pending and not served\n");
+
+    /* A line over the rate is masked, then ignored until its release */
+    exti_hal_enable_interrupt(&exti_hal, EXTI_LINE_6);
+    memset(served, 0, sizeof(served));
+    fake_cycles += (uint64_t) CONFIG_GPIO_STORM_WINDOW_MS * TIMER_CYCLES_PER_MS;
+    CHECK(gpio_get_storm_stats(GPIO_PIN_5, &stats) == OK && stats.trips == 0);
+    edges = stats.edges;
+
+    for(indx = 0; indx < CONFIG_GPIO_STORM_MAX_EDGES + 1U; indx++)
+    {
+        REG(EXTI_PR) = 0x20U;
+        exti9_5_irq_handler();
+    }
+
+    CHECK(gpio_get_storm_stats(GPIO_PIN_5, &stats) == OK);
+    CHECK(stats.masked && stats.trips == 1 && stats.edges == edges + CONFIG_GPIO_STORM_MAX_EDGES);
+    CHECK(served[5] == CONFIG_GPIO_STORM_MAX_EDGES && REG(EXTI_IMR) == 0xC0U);
+
+    /* Reached from a sibling, or straight from an interrupt already being served */
+    REG(EXTI_PR) = 0x60U;
+    exti9_5_irq_handler();
+    CHECK(served[5] == CONFIG_GPIO_STORM_MAX_EDGES && served[6] == 1 && REG(EXTI_PR) == 0x40U);
+
+    gpio_storm_isr(GPIO_PIN_5, NULL);
+    CHECK(gpio_get_storm_stats(GPIO_PIN_5, &stats) == OK);
+    CHECK(stats.trips == 1 && stats.edges == edges + CONFIG_GPIO_STORM_MAX_EDGES);
+    CHECK(stats.backoff_ms == CONFIG_GPIO_STORM_BACKOFF_MS);
+    CHECK(served[5] == CONFIG_GPIO_STORM_MAX_EDGES);
+
+    /* Released after the back-off, stale edges dropped */
+    fake_ms = CONFIG_GPIO_STORM_BACKOFF_MS - 1U;
+    release_timer->callback(release_timer, release_timer->arg);
+    CHECK(REG(EXTI_IMR) == 0xC0U);
+
+    fake_ms = CONFIG_GPIO_STORM_BACKOFF_MS;
+    fake_cycles += (uint64_t) CONFIG_GPIO_STORM_WINDOW_MS * TIMER_CYCLES_PER_MS;
+    release_timer->callback(release_timer, release_timer->arg);
+    CHECK(REG(EXTI_IMR) == 0xE0U && REG(EXTI_PR) == 0x20U);
+
+    REG(EXTI_PR) = 0x20U;
+    exti9_5_irq_handler();
+    CHECK(served[5] == CONFIG_GPIO_STORM_MAX_EDGES + 1U);
+    CHECK(gpio_get_storm_stats(GPIO_PIN_5, &stats) == OK && !stats.masked);
+    printf("storm guard: a masked line is not counted nor served until released\n");
+
+    /* Alternate functions over a mask against the per pin setters */
+    for(run = 0; run < 1000; run++)
+    {
+        port = (gpio_port_t) (rand() % GPIO_PORT_ALL);
+        config.pin_mask = (uint32_t) rand() & 0xFFFFU;
+        func = (uint32_t) rand() % 16U;
+
+        GPIO_HAL_GET_HW(&gpio_hal, port);
+        randomize();
+        snapshot();
+
+        for(pin = 0; pin < 16; pin++)
+        {
+            if((config.pin_mask >> pin) & 0x01)
+            {
+                if(run & 1)
+                {
+                    gpio_hal_set_mode_alternate_od(&gpio_hal, (gpio_pin_t) pin, (uint8_t) func);
+                }
+                else
+                {
+                    gpio_hal_set_mode_alternate_pp(&gpio_hal, (gpio_pin_t) pin, (uint8_t) func);
+                }
+            }
+        }
+
+        for(indx = 0; indx < PERIPH_WORDS; indx++)
+        {
+            per_pin[indx] = REG(PERIPH_BASE + indx * 4U);
+            REG(PERIPH_BASE + indx * 4U) = expected[indx];
+        }
+
+        if(run & 1)
+        {
+            gpio_hal_set_mode_alternate_od_mask(&gpio_hal, config.pin_mask, (uint8_t) func);
+        }
+        else
+        {
+            gpio_hal_set_mode_alternate_pp_mask(&gpio_hal, config.pin_mask, (uint8_t) func);
+        }
+
+        memcpy(expected, per_pin, sizeof(expected));
+        check_image();
+
+        /* And the values RM0390 gives */
+        for(pin = 0; pin < 16; pin++)
+        {
+            if((config.pin_mask >> pin) & 0x01)
+            {
+                CHECK(((REG(GPIO_BASE(port) + GPIO_MODER) >> (2U * pin)) & 0x3U) == 0x2U);
+                CHECK(((REG(GPIO_BASE(port) + GPIO_OTYPER) >> pin) & 0x1U) == (run & 1));
+                CHECK(((REG(GPIO_BASE(port) + ((pin < 8U) ? GPIO_AFRL : GPIO_AFRH)) >>
+                                                            (4U * (pin % 8U))) & 0xFU) == func);
+            }
+        }
+    }
+
+    printf("alternate functions: mask setters match the per pin setters\n");
+
+    return 0;
+}
@@ -0,0 +1,471 @@
+/*
+* Host test of the GPIO logic analyzer (gpio_capture.c). The timer-triggered DMA read
+* of the input register is simulated: samples of a known signal are written to the
+* ring and the half and full transfer callbacks run as the DMA interrupts would, with
+* a few more samples written before the timer stops. Each trigger mode must keep the
+* samples from pre_samples before the trigger on, no edge may be seen on the very
+* first sample, and a stop coming too late must report the overrun.
+*
+* The run-length encoding is decoded back with the layout capture_decode.py reads and
+* compared sample by sample, for runs needing one to three count bytes and for chunks
+* handed out 64 bytes at a time. Serial output must give up once the Tx queue stops
+* draining or serial_tx fails. Given a file name, the test writes the last encoding
+* there so it can be checked with capture_decode.py as well.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_GPIO_CAPTURE_USE=1 -DCONFIG_GPIO_CAPTURE_TIMER=1 \
+*       -DCONFIG_SERIAL_PORTS_USE=1 -DCONFIG_SERIAL_TX_BUFFERSIZE=256 -DCONFIG_SERIAL_RX_BUFFERSIZE=256 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_gpio_capture.c Components/Drivers/GPIO/gpio_capture.c -o test_gpio_capture && \
+*       ./test_gpio_capture capture.bin && python3 capture_decode.py --capture-file capture.bin
+*/
+
+#include "gpio_capture.h"
+#include "TIM_GP_hal.h"
+#include "serial.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define LONG_SIZE       40000
+#define STREAM_SIZE     0x20000
+#define CHUNK_SIZE      64          /* GPIO_CAPTURE_RLE_CHUNK_SIZE */
+
+typedef uint16_t (*signal_t) (uint32_t n);
+
+/* Simulated DMA, samples of the input stream written to the ring in turn */
+static tim_gp_hal_context_t fake_timer;
+static tim_gp_callback_t half_callback;
+static tim_gp_callback_t full_callback;
+static uint16_t* ring;
+static uint16_t ring_len;
+static uint32_t pos;
+static uint8_t running;
+static uint32_t latency;            /* Samples written from the interrupt to the stop */
+static signal_t input;
+
+static uint64_t now_ms;
+static int32_t tx_room;             /* Bytes the Tx queue takes, -1: any */
+static uint8_t tx_fail;
+static uint32_t tx_bytes;
+
+static uint8_t stream[STREAM_SIZE];
+static uint32_t stream_len;
+static uint32_t chunks;
+static uint32_t short_chunks;
+static uint32_t fail_after;         /* Chunk out fails on, 0: never */
+
+static uint16_t decoded[LONG_SIZE];
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+tim_gp_hal_context_t* tim_gp_hal_init(uint8_t tim, const tim_gp_config_t* config)
+{
+    CHECK(tim == CONFIG_GPIO_CAPTURE_TIMER);
+    CHECK(config->count_mode == TIM_GP_COUNT_UP);
+
+    return &fake_timer;
+}
+
+error_t tim_gp_hal_start_update_dma_read(tim_gp_hal_context_t* p_timer, uint32_t periph_addr,
+                    uint16_t* buffer, uint16_t len, tim_gp_callback_t half_complete,
+                                                            tim_gp_callback_t complete)
+{
+    (void) periph_addr;
+
+    CHECK(p_timer == &fake_timer);
+
+    ring = buffer;
+    ring_len = len;
+    half_callback = half_complete;
+    full_callback = complete;
+    pos = 0;
+    running = 1;
+
+    return OK;
+}
+
+uint16_t tim_gp_hal_get_update_dma_index(tim_gp_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    return (uint16_t) ((pos + latency) % ring_len);
+}
+
+error_t tim_gp_hal_stop(tim_gp_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    running = 0;
+
+    return OK;
+}
+
+error_t tim_gp_hal_stop_update_dma(tim_gp_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    running = 0;
+
+    return OK;
+}
+
+uint32_t gpio_hal_get_idr_addr(gpio_hal_context_t* hal)
+{
+    return (uint32_t) (uintptr_t) &hal->dev->idr;
+}
+
+uint64_t timer_get_milliseconds(void)
+{
+    return now_ms++;
+}
+
+error_t serial_tx(uint8_t port, const uint8_t* data, uint16_t len, uint16_t* sent)
+{
+    (void) port;
+    (void) data;
+
+    if(tx_fail)
+    {
+        *sent = 0;
+
+        return FAILED;
+    }
+
+    *sent = (tx_room < 0 || len < tx_room) ? len : (uint16_t) tx_room;
+
+    if(tx_room >= 0)
+    {
+        tx_room -= *sent;
+    }
+
+    tx_bytes += *sent;
+
+    return OK;
+}
+
+static void run(uint32_t max)
+{
+    while(running && max--)
+    {
+        ring[pos % ring_len] = input(pos);
+        pos++;
+
+        if(pos % ring_len == ring_len / 2U)
+        {
+            half_callback(&fake_timer);
+        }
+        else if(pos % ring_len == 0)
+        {
+            full_callback(&fake_timer);
+        }
+    }
+}
+
+/* Pins 0 to 2 move, pins 12 and 15 stay high, outside of the recorded pins */
+static uint16_t signal_short(uint32_t n)
+{
+    return (uint16_t) (((n / 7U) & 1U) | ((n >= 1000U) << 1) | (((n * 13U) >> 4) & 0x4U) | 0x9000U);
+}
+
+/* Fast edges, then pin 0 high for 17000 samples */
+static uint16_t signal_long(uint32_t n)
+{
+    return (uint16_t) ((n >= 5000U && n < 22000U) | ((n < 5000U) ? ((n / 10U) & 1U) << 1 : 0U) |
+                                                                        ((n & 1U) << 3));
+}
+
+static error_t stream_out(const uint8_t* data, uint16_t len, void* arg)
+{
+    CHECK(arg == stream);
+    CHECK(len > 0 && len <= CHUNK_SIZE && stream_len + len <= STREAM_SIZE);
+
+    if(len < CHUNK_SIZE)
+    {
+        short_chunks++;
+    }
+
+    memcpy(&stream[stream_len], data, len);
+    stream_len += len;
+
+    return (++chunks == fail_after) ? FAILED : OK;
+}
+
+static uint32_t get_le(const uint8_t* data, uint8_t size)
+{
+    uint32_t value;
+
+    value = 0;
+
+    while(size--)
+    {
+        value = (value << 8) | data[size];
+    }
+
+    return value;
+}
+
+/* The layout read by capture_decode.py, returns the number of samples */
+static uint32_t decode(uint8_t* flags, uint32_t* longest_varint)
+{
+    uint32_t at;
+    uint32_t samples;
+    uint32_t total;
+    uint32_t count;
+    uint32_t bytes;
+    uint16_t value;
+
+    CHECK(stream_len >= 20 && memcmp(stream, GPIO_CAPTURE_RLE_MAGIC, 4) == 0);
+    CHECK(stream[4] == GPIO_CAPTURE_RLE_VERSION);
+
+    *flags = stream[5];
+    samples = get_le(&stream[12], 4);
+    at = 20;
+    total = 0;
+    *longest_varint = 0;
+
+    while(total < samples)
+    {
+        CHECK(at + 3 <= stream_len);
+        value = (uint16_t) get_le(&stream[at], 2);
+        at += 2;
+        count = 0;
+        bytes = 0;
+
+        do
+        {
+            CHECK(at < stream_len && bytes < 5);
+            count |= (uint32_t) (stream[at] & 0x7FU) << (7U * bytes);
+            bytes++;
+        } while(stream[at++] & 0x80U);
+
+        CHECK(count > 0 && total + count <= samples && total + count <= LONG_SIZE);
+
+        /* Runs are maximal */
+        CHECK(total == 0 || decoded[total - 1] != value);
+
+        *longest_varint = (bytes > *longest_varint) ? bytes : *longest_varint;
+
+        while(count--)
+        {
+            decoded[total++] = value;
+        }
+    }
+
+    CHECK(at == stream_len);
+
+    return total;
+}
+
+/* Encodes the finished capture and checks it decodes to the samples it holds */
+static void round_trip(uint16_t pin_mask, uint32_t sample_hz, uint16_t trigger,
+                                                                uint32_t* longest_varint)
+{
+    uint32_t length;
+    uint32_t indx;
+    uint8_t flags;
+
+    stream_len = 0;
+    chunks = 0;
+    short_chunks = 0;
+
+    CHECK(gpio_capture_write_rle(stream_out, stream) == OK);
+    CHECK(short_chunks <= 1);
+
+    length = gpio_capture_get_length();
+    CHECK(decode(&flags, longest_varint) == length);
+    CHECK(get_le(&stream[6], 2) == pin_mask);
+    CHECK(get_le(&stream[8], 4) == sample_hz);
+    CHECK(get_le(&stream[16], 4) == trigger);
+    CHECK(flags == ((gpio_capture_get_state() == GPIO_CAPTURE_OVERRUN) ? GPIO_CAPTURE_RLE_OVERRUN : 0));
+
+    for(indx = 0; indx < length; indx++)
+    {
+        CHECK(decoded[indx] == gpio_capture_get_sample(indx));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    static uint16_t buffer[512];
+    static uint16_t long_buffer[LONG_SIZE];
+    gpio_capture_config_t config = {buffer, 512, 0x0007, 1000000, 100, 150,
+                                    GPIO_CAPTURE_TRIGGER_ENTER, 0x2, 0x2, NULL};
+    uint32_t longest_varint;
+    uint32_t indx;
+    FILE* file;
+
+    input = signal_short;
+    latency = 3;
+
+    CHECK(gpio_capture_write_rle(stream_out, stream) == FAILED);
+
+    /* Pin 1 rises on sample 1000 */
+    CHECK(gpio_capture_start(GPIOA, &config) == OK);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_ARMED && gpio_capture_get_length() == 0);
+    run(100000);
+    CHECK(!running && gpio_capture_get_state() == GPIO_CAPTURE_DONE);
+    CHECK(gpio_capture_get_length() == 250);
+
+    for(indx = 0; indx < 250; indx++)
+    {
+        CHECK(gpio_capture_get_sample(indx) == (signal_short(1000 - 100 + indx) & 0x7U));
+    }
+
+    round_trip(0x0007, 1000000, 100, &longest_varint);
+    printf("enter: trigger on sample 1000, %u samples round trip in %u bytes\n",
+                                                        gpio_capture_get_length(), stream_len);
+
+    /* A pattern present from the start waits for the history */
+    config.trigger = GPIO_CAPTURE_TRIGGER_PATTERN;
+    config.trigger_mask = 0x1;
+    config.trigger_value = 0;
+    config.pre_samples = 200;
+    config.post_samples = 56;
+    CHECK(gpio_capture_start(GPIOA, &config) == OK);
+    run(100000);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_DONE);
+
+    for(indx = 0; indx < 256; indx++)
+    {
+        CHECK(gpio_capture_get_sample(indx) == (signal_short(indx) & 0x7U));
+    }
+
+    round_trip(0x0007, 1000000, 200, &longest_varint);
+    printf("pattern: trigger once the history is sampled\n");
+
+    /* A stop too late for the capture to survive */
+    config.trigger = GPIO_CAPTURE_TRIGGER_CHANGE;
+    config.trigger_mask = 0x2;
+    config.pre_samples = 250;
+    config.post_samples = 6;
+    latency = 239;
+    CHECK(gpio_capture_start(GPIOA, &config) == OK);
+    run(100000);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_OVERRUN);
+    round_trip(0x0007, 1000000, 250, &longest_varint);
+
+    latency = 3;
+    CHECK(gpio_capture_start(GPIOA, &config) == OK);
+    run(100000);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_DONE);
+
+    for(indx = 0; indx < 256; indx++)
+    {
+        CHECK(gpio_capture_get_sample(indx) == (signal_short(1000 - 250 + indx) & 0x7U));
+    }
+
+    round_trip(0x0007, 1000000, 250, &longest_varint);
+    printf("change: overrun flagged with a late stop, done otherwise\n");
+
+    /* No edge on the first sample, pins 12 and 15 are high from the start */
+    config.pre_samples = 0;
+    config.post_samples = 10;
+    config.trigger_mask = 0x8000;
+    CHECK(gpio_capture_start(GPIOA, &config) == OK);
+    run(100000);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_ARMED);
+    CHECK(gpio_capture_stop() == OK && gpio_capture_get_state() == GPIO_CAPTURE_IDLE);
+
+    config.trigger = GPIO_CAPTURE_TRIGGER_ENTER;
+    config.trigger_mask = 0x1000;
+    config.trigger_value = 0x1000;
+    CHECK(gpio_capture_start(GPIOA, &config) == OK);
+    run(100000);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_ARMED);
+    CHECK(gpio_capture_stop() == OK);
+
+    config.trigger = GPIO_CAPTURE_TRIGGER_CHANGE;
+    config.trigger_mask = 0x1;
+    CHECK(gpio_capture_start(GPIOA, &config) == OK);
+    run(100000);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_DONE);
+
+    for(indx = 0; indx < 10; indx++)
+    {
+        CHECK(gpio_capture_get_sample(indx) == (signal_short(7 + indx) & 0x7U));
+    }
+
+    printf("first sample: no edge seen on it\n");
+
+    /* Refused configurations */
+    config.pre_samples = 250;
+    config.post_samples = 7;
+    CHECK(gpio_capture_start(GPIOA, &config) == FAILED);
+    config.post_samples = 0;
+    CHECK(gpio_capture_start(GPIOA, &config) == FAILED);
+    config.post_samples = 6;
+    config.sample_hz = 8000000;
+    CHECK(gpio_capture_start(GPIOA, &config) == FAILED);
+    config.sample_hz = 1000000;
+    CHECK(gpio_capture_start(GPIO_PORT_ALL, &config) == FAILED);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_DONE);
+
+    /* Serial output: a queue that never drains is given up, a Tx failure bails out */
+    tx_room = -1;
+    CHECK(gpio_capture_send_rle(0) == OK && tx_bytes > 20);
+    tx_room = 10;
+    now_ms = 0;
+    CHECK(gpio_capture_send_rle(0) == FAILED);
+    CHECK(now_ms >= 1000 && now_ms < 1100);
+    tx_room = -1;
+    tx_fail = 1;
+    now_ms = 0;
+    CHECK(gpio_capture_send_rle(0) == FAILED && now_ms < 10);
+    tx_fail = 0;
+    printf("serial: stops on a stuck queue and on a Tx failure\n");
+
+    /* Long runs, counts of three varint bytes and many chunks */
+    input = signal_long;
+    config.buffer = long_buffer;
+    config.size = LONG_SIZE;
+    config.pin_mask = 0x0003;
+    config.sample_hz = 100000;
+    config.pre_samples = 3000;
+    config.post_samples = 17000;
+    config.trigger = GPIO_CAPTURE_TRIGGER_ENTER;
+    config.trigger_mask = 0x1;
+    config.trigger_value = 0x1;
+    CHECK(gpio_capture_start(GPIOC, &config) == OK);
+    run(1000000);
+    CHECK(gpio_capture_get_state() == GPIO_CAPTURE_DONE && gpio_capture_get_length() == 20000);
+
+    round_trip(0x0003, 100000, 3000, &longest_varint);
+    CHECK(longest_varint == 3 && chunks > 1);
+
+    for(indx = 0; indx < 20000; indx++)
+    {
+        CHECK(decoded[indx] == (signal_long(2000 + indx) & 0x3U));
+    }
+
+    printf("long runs: %u samples in %u bytes, %u chunks\n", gpio_capture_get_length(),
+                                                                    stream_len, chunks);
+
+    /* Nothing more is handed out once out failed */
+    stream_len = 0;
+    chunks = 0;
+    fail_after = 2;
+    CHECK(gpio_capture_write_rle(stream_out, stream) == FAILED && chunks == 2);
+    fail_after = 0;
+    printf("out failing: nothing handed out after it\n");
+
+    if(argc > 1)
+    {
+        round_trip(0x0003, 100000, 3000, &longest_varint);
+
+        file = fopen(argv[1], "wb");
+        CHECK(file && fwrite(stream, 1, stream_len, file) == stream_len);
+        fclose(file);
+    }
+
+    return 0;
+}
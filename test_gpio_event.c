@@ -0,0 +1,254 @@
+/*
+* Host test of the GPIO edge event queue (gpio_event.c). The exclusive monitor of
+* LDREX/STREX is modelled, exception return clearing it as on the Cortex-M4, and
+* higher priority edge interrupts preempt a writer at each step of its reservation:
+* once the timestamp is taken and before LDREX, right after LDREX and right before
+* STREX, nested up to three deep. Events must always be read in
+* timestamp order, once each, with every edge either read, still queued or counted
+* as dropped. A full queue keeps its oldest events and drops the newest.
+*
+* The device header is kept out with its include guard, the exclusive access
+* intrinsics and barriers are provided below and gpio_event.c is included directly.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_GPIO_EVENT_USE=1 -DCONFIG_GPIO_EVENT_QUEUE_SIZE=64 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_gpio_event.c -o test_gpio_event && ./test_gpio_event
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define EDGES           2000000UL
+#define MAX_NESTING     3
+
+typedef enum
+{
+    PREEMPT_NONE,
+    PREEMPT_TIMESTAMP,          /* From inside timer_get_cycles, before LDREX */
+    PREEMPT_LDREX,              /* Right after LDREX */
+    PREEMPT_STREX,              /* Right before STREX */
+} preempt_t;
+
+static uint8_t monitor;
+static preempt_t preempt_at;
+static uint32_t nesting;
+static uint32_t preemptions[PREEMPT_STREX + 1];
+
+static void preempt(preempt_t point);
+
+static inline uint32_t __LDREXW(volatile uint32_t* addr)
+{
+    uint32_t value;
+
+    value = *addr;
+    monitor = 1;
+    preempt(PREEMPT_LDREX);
+
+    return value;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t* addr)
+{
+    preempt(PREEMPT_STREX);
+
+    if(!monitor)
+    {
+        return 1;
+    }
+
+    *addr = value;
+    monitor = 0;
+
+    return 0;
+}
+
+static inline void __CLREX(void)
+{
+    monitor = 0;
+}
+
+#define __DMB()     do { } while(0)
+
+#include "Components/Drivers/GPIO/gpio_event.c"
+
+static gpio_callback_t isr;
+static uint64_t cycles;
+static uint32_t levels;
+static unsigned long edges;
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+error_t gpio_init(gpio_port_t port, const gpio_config_t* config)
+{
+    (void) port;
+
+    isr = config->irq_callback;
+
+    return OK;
+}
+
+uint32_t gpio_hal_in_read_pin(gpio_hal_context_t* hal, gpio_pin_t pin)
+{
+    (void) hal;
+
+    return (levels >> pin) & 0x01;
+}
+
+uint64_t timer_get_cycles(void)
+{
+    uint64_t now;
+
+    now = cycles++;
+    preempt(PREEMPT_TIMESTAMP);
+
+    return now;
+}
+
+/* An edge interrupt of higher priority, exception return clears the monitor */
+static void preempt(preempt_t point)
+{
+    if(point != preempt_at || nesting >= MAX_NESTING || (rand() & 3) != 0)
+    {
+        return;
+    }
+
+    preemptions[point]++;
+    nesting++;
+    preempt_at = (preempt_t) (1 + rand() % 3);
+    edges++;
+    isr((uint32_t) (rand() & 7), NULL);
+    nesting--;
+    monitor = 0;
+}
+
+static void edge(uint32_t pin)
+{
+    preempt_at = (preempt_t) (rand() % 4);
+    edges++;
+    isr(pin, NULL);
+    preempt_at = PREEMPT_NONE;
+}
+
+int main(void)
+{
+    gpio_event_t events[CONFIG_GPIO_EVENT_QUEUE_SIZE];
+    uint64_t last;
+    unsigned long read;
+    uint32_t indx;
+    uint16_t count;
+    uint16_t ev;
+
+    CHECK(gpio_event_init(GPIOA, 0x00FF, GPIO_MODE_INPUT, GPIO_NOPULL) == FAILED);
+    CHECK(gpio_event_init(GPIOB, 0x00F0, GPIO_MODE_IT_RISING, GPIO_PULLUP) == OK);
+    CHECK(gpio_event_init(GPIOC, 0x000F, GPIO_MODE_IT_RISING_FALLING, GPIO_PULLUP) == OK);
+
+    /* Single edge lines report their edge, both-edge lines the level read */
+    levels = 0x0004;
+    isr(4, NULL);
+    isr(2, NULL);
+    levels = 0;
+    isr(2, NULL);
+
+    CHECK(gpio_event_read(events, 8) == 3);
+    CHECK(events[0].pin == 4 && events[0].port == GPIOB && events[0].edge == GPIO_EVENT_RISING);
+    CHECK(events[0].level == 0);
+    CHECK(events[1].pin == 2 && events[1].port == GPIOC && events[1].edge == GPIO_EVENT_RISING);
+    CHECK(events[1].level == 1);
+    CHECK(events[2].edge == GPIO_EVENT_FALLING && events[2].timestamp > events[1].timestamp);
+    printf("edges: configured edge or level of both-edge lines\n");
+
+    /* Preempted before LDREX, the nested edge is older and must come first */
+    srand(0);
+
+    while(!preemptions[PREEMPT_TIMESTAMP])
+    {
+        preempt_at = PREEMPT_TIMESTAMP;
+        isr(5, NULL);
+        preempt_at = PREEMPT_NONE;
+        count = gpio_event_read(events, 8);
+        CHECK(count >= 1 && count <= 2);
+        CHECK(count == 1 || events[0].timestamp < events[1].timestamp);
+    }
+
+    CHECK(gpio_event_get_count() == 0);
+
+    /* Full: the oldest kept, the newest dropped */
+    for(indx = 0; indx < 100; indx++)
+    {
+        isr(4 + (indx & 3), NULL);
+    }
+
+    CHECK(gpio_event_get_count() == CONFIG_GPIO_EVENT_QUEUE_SIZE);
+    CHECK(gpio_event_get_dropped() == 100 - CONFIG_GPIO_EVENT_QUEUE_SIZE);
+    CHECK(gpio_event_read(events, 10) == 10);
+    last = events[9].timestamp;
+
+    for(indx = 0; indx < 30; indx++)
+    {
+        isr(4, NULL);
+    }
+
+    CHECK(gpio_event_get_dropped() == 100 - CONFIG_GPIO_EVENT_QUEUE_SIZE + 20);
+
+    read = 10;
+
+    while((count = gpio_event_read(events, 16)) != 0)
+    {
+        for(indx = 0; indx < count; indx++)
+        {
+            CHECK(events[indx].timestamp > last);
+            last = events[indx].timestamp;
+        }
+
+        read += count;
+    }
+
+    CHECK(read == CONFIG_GPIO_EVENT_QUEUE_SIZE + 10 && gpio_event_get_count() == 0);
+    printf("overflow: oldest kept, %u dropped\n", gpio_event_get_dropped());
+
+    /* Edges preempted at every step, read in batches of random size */
+    srand(11);
+    edges = 0;
+    read = 0;
+    memset(preemptions, 0, sizeof(preemptions));
+    indx = gpio_event_get_dropped();
+
+    while(edges < EDGES)
+    {
+        levels = (uint32_t) rand();
+        edge((uint32_t) (rand() & 7));
+
+        if((rand() & 7) == 0)
+        {
+            count = gpio_event_read(events, (uint16_t) (1 + rand() % CONFIG_GPIO_EVENT_QUEUE_SIZE));
+
+            for(ev = 0; ev < count; ev++)
+            {
+                CHECK(events[ev].timestamp > last);
+                last = events[ev].timestamp;
+            }
+
+            read += count;
+        }
+    }
+
+    CHECK(read + gpio_event_get_count() + (gpio_event_get_dropped() - indx) == edges);
+    CHECK(gpio_event_get_dropped() - indx > 0);
+    CHECK(preemptions[PREEMPT_TIMESTAMP] && preemptions[PREEMPT_LDREX] && preemptions[PREEMPT_STREX]);
+    printf("preemption: %lu edges, %lu read in timestamp order, %u dropped, %u queued, "
+            "preempted %u/%u/%u times before LDREX/after LDREX/before STREX\n", edges, read,
+            gpio_event_get_dropped() - indx, gpio_event_get_count(), preemptions[PREEMPT_TIMESTAMP],
+            preemptions[PREEMPT_LDREX], preemptions[PREEMPT_STREX]);
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+/*
+* Host test of the GPIO waveform engine (gpio_wave.c). Encoded words are applied to a
+* model of a port output register the way BSRR would, and the pin levels sample by
+* sample are compared with the expected line coding: WS2812 on two lanes at once,
+* Manchester, fixed levels, pins of other waveforms left alone, and overflow of the
+* word buffer. gpio_wave_start is checked for the timer prescaler and reload of each
+* sample rate and for the DMA transfer it asks for, against a faked TIM_GP HAL.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_GPIO_WAVE_USE=1 -DCONFIG_GPIO_WAVE_TIMER=1 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_gpio_wave.c Components/Drivers/GPIO/gpio_wave.c -o test_gpio_wave && ./test_gpio_wave
+*/
+
+#include "gpio_wave.h"
+#include "TIM_GP_hal.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define WAVE_SIZE       256
+#define GPIOA_BSRR      0x40020018UL
+#define GPIOC_BSRR      0x40020818UL
+
+static tim_gp_hal_context_t fake_timer;
+static tim_gp_config_t started_config;
+static uint8_t started_tim;
+static uint32_t started_addr;
+static const uint32_t* started_words;
+static uint16_t started_len;
+static uint8_t started_circular;
+static tim_gp_callback_t started_callback;
+static uint8_t dma_busy;
+static uint32_t done_calls;
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+tim_gp_hal_context_t* tim_gp_hal_init(uint8_t tim, const tim_gp_config_t* config)
+{
+    started_tim = tim;
+    started_config = *config;
+
+    return &fake_timer;
+}
+
+error_t tim_gp_hal_start_update_dma(tim_gp_hal_context_t* p_timer, uint32_t periph_addr,
+                    const uint32_t* buffer, uint16_t len, uint8_t circular,
+                                                        tim_gp_callback_t callback)
+{
+    CHECK(p_timer == &fake_timer);
+
+    started_addr = periph_addr;
+    started_words = buffer;
+    started_len = len;
+    started_circular = circular;
+    started_callback = callback;
+    dma_busy = 1;
+
+    return OK;
+}
+
+uint8_t tim_gp_hal_is_update_dma_busy(tim_gp_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    return dma_busy;
+}
+
+error_t tim_gp_hal_stop_update_dma(tim_gp_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    dma_busy = 0;
+
+    return OK;
+}
+
+/* Only the address is taken, the register block is never touched */
+uint32_t gpio_hal_get_bsrr_addr(gpio_hal_context_t* hal)
+{
+    return (uint32_t) (uintptr_t) &hal->dev->bsrr;
+}
+
+static void wave_done(void)
+{
+    done_calls++;
+}
+
+/* BSRR: set pins of the low half, reset pins of the high half, never both for one pin */
+static uint16_t odr;
+
+static void apply(uint32_t word)
+{
+    CHECK(((word & 0xFFFFU) & (word >> 16)) == 0);
+
+    odr |= (uint16_t) (word & 0xFFFFU);
+    odr &= (uint16_t) ~(word >> 16);
+}
+
+int main(void)
+{
+    static uint32_t words[WAVE_SIZE];
+    static const uint8_t data3[] = {0xA5};
+    static const uint8_t data7[] = {0x0F};
+    static const uint8_t manchester_data[] = {0x80, 0x40};
+    const gpio_wave_coding_t ws2812 = {{0x4, 0x6}, 3};
+    const gpio_wave_coding_t manchester = {{0x2, 0x1}, 2};
+    const gpio_wave_lane_t lanes[] = {{data3, GPIO_PIN_3}, {data7, GPIO_PIN_7}};
+    const gpio_wave_lane_t manchester_lane = {manchester_data, GPIO_PIN_0};
+    gpio_wave_t wave;
+    uint32_t bit;
+    uint32_t step;
+    uint32_t expected3;
+    uint32_t expected7;
+    uint32_t indx;
+
+    CHECK(gpio_wave_init(NULL, words, WAVE_SIZE) == FAILED);
+    CHECK(gpio_wave_init(&wave, words, 0) == FAILED);
+    CHECK(gpio_wave_init(&wave, words, WAVE_SIZE) == OK);
+
+    /* WS2812 on pins 3 and 7 after a reset level, 3 samples per bit */
+    CHECK(gpio_wave_add_level(&wave, (1U << 3) | (1U << 7), 0, 5) == OK);
+    CHECK(gpio_wave_add_bits(&wave, lanes, 2, 8, &ws2812) == OK);
+    CHECK(wave.len == 5 + 8 * 3);
+
+    /* Pin 15 belongs to another waveform and must keep its level */
+    odr = 0x8000U | (1U << 3) | (1U << 7);
+
+    for(indx = 0; indx < 5; indx++)
+    {
+        apply(words[indx]);
+        CHECK((odr & 0x88U) == 0);
+    }
+
+    for(bit = 0; bit < 8; bit++)
+    {
+        for(step = 0; step < 3; step++)
+        {
+            apply(words[5 + bit * 3 + step]);
+
+            /* High, the bit, low */
+            expected3 = (step == 0) ? 1U : (step == 1) ? (data3[0] >> (7 - bit)) & 1U : 0U;
+            expected7 = (step == 0) ? 1U : (step == 1) ? (data7[0] >> (7 - bit)) & 1U : 0U;
+
+            CHECK(((odr >> 3) & 1U) == expected3 && ((odr >> 7) & 1U) == expected7);
+            CHECK(odr & 0x8000U);
+        }
+    }
+
+    printf("ws2812: 2 lanes, 8 bits, other pins untouched\n");
+
+    /* Manchester, a 1 is low then high */
+    gpio_wave_clear(&wave);
+    CHECK(gpio_wave_add_bits(&wave, &manchester_lane, 1, 10, &manchester) == OK && wave.len == 20);
+    CHECK(words[0] == 0x10000U && words[1] == 0x1U);
+    CHECK(words[2] == 0x1U && words[3] == 0x10000U);
+    CHECK(words[18] == 0x10000U && words[19] == 0x1U);
+    printf("manchester: 10 bits over a byte boundary\n");
+
+    /* Refused input and overflow leave the wave unchanged */
+    CHECK(gpio_wave_add_bits(&wave, &manchester_lane, 1, 200, &manchester) == FAILED);
+    CHECK(gpio_wave_add_bits(&wave, &manchester_lane, 0, 1, &manchester) == FAILED);
+    CHECK(gpio_wave_add_bits(&wave, lanes, 2, 1, NULL) == FAILED);
+    CHECK(wave.len == 20);
+    CHECK(gpio_wave_add_level(&wave, 1, 1, WAVE_SIZE - 20 + 1) == FAILED && wave.len == 20);
+    CHECK(gpio_wave_add_level(&wave, 1, 1, WAVE_SIZE - 20) == OK && wave.len == WAVE_SIZE);
+    CHECK(words[WAVE_SIZE - 1] == 0x1U);
+    printf("overflow: refused, the wave is left as it was\n");
+
+    /* Timer period from the sample rate, 16 MHz timer clock */
+    CHECK(gpio_wave_start(GPIOA, &wave, 1000000, 0, wave_done) == OK);
+    CHECK(started_tim == CONFIG_GPIO_WAVE_TIMER);
+    CHECK(started_config.prescaler == 0 && started_config.reload == 15);
+    CHECK(started_config.count_mode == TIM_GP_COUNT_UP && !started_config.callback);
+    CHECK(started_addr == GPIOA_BSRR && started_words == words && started_len == WAVE_SIZE);
+    CHECK(!started_circular && gpio_wave_is_busy());
+
+    /* Busy until the transfer completes */
+    CHECK(gpio_wave_start(GPIOA, &wave, 1000000, 0, wave_done) == FAILED);
+    dma_busy = 0;
+    started_callback(&fake_timer);
+    CHECK(done_calls == 1 && !gpio_wave_is_busy());
+
+    /* 6.4 ticks rounded to 6 */
+    CHECK(gpio_wave_start(GPIOA, &wave, 2500000, 1, NULL) == OK);
+    CHECK(started_config.prescaler == 0 && started_config.reload == 5 && started_circular);
+    CHECK(gpio_wave_stop() == OK && !gpio_wave_is_busy());
+
+    /* 6.96 ticks rounded to 7, not truncated */
+    CHECK(gpio_wave_start(GPIOA, &wave, 2300000, 0, NULL) == OK);
+    CHECK(started_config.prescaler == 0 && started_config.reload == 6);
+    CHECK(gpio_wave_stop() == OK);
+
+    /* 65306 ticks still fit the reload without a prescaler */
+    CHECK(gpio_wave_start(GPIOA, &wave, 245, 0, NULL) == OK);
+    CHECK(started_config.prescaler == 0 && started_config.reload == 65305);
+    CHECK(gpio_wave_stop() == OK);
+
+    /* Faster than DMA can follow */
+    CHECK(gpio_wave_start(GPIOA, &wave, 8000000, 0, NULL) == FAILED);
+
+    /* 160000 ticks, prescaled by 3 */
+    CHECK(gpio_wave_start(GPIOA, &wave, 100, 0, NULL) == OK);
+    CHECK(started_config.prescaler == 2 && started_config.reload == 53332);
+    CHECK(gpio_wave_stop() == OK);
+
+    CHECK(gpio_wave_start(GPIOC, &wave, 100, 0, NULL) == OK && started_addr == GPIOC_BSRR);
+    CHECK(gpio_wave_stop() == OK);
+
+    CHECK(gpio_wave_start(GPIO_PORT_ALL, &wave, 100, 0, NULL) == FAILED);
+    CHECK(gpio_wave_start(GPIOA, &wave, 0, 0, NULL) == FAILED);
+    printf("start: prescaler and reload per sample rate, BSRR transfer\n");
+
+    return 0;
+}
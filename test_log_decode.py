@@ -0,0 +1,135 @@
+#! /usr/bin/python3
+
+import io
+import os
+import re
+import struct
+import tempfile
+import unittest
+
+import log_decode
+
+
+"""
+Round trip of binary log records through log_decode.py: records are encoded
+with the layout of log_binary.c against a synthetic ELF holding the tag and
+format strings, then decoded back to text.
+
+Run with: python3 -m unittest test_log_decode
+
+"""
+
+LOG_BINARY_SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                 'Components', 'Drivers', 'Log', 'log_binary.c')
+
+STRINGS_ADDR = 0x08001000
+
+SHT_PROGBITS = 1
+SHF_ALLOC = 0x2
+
+
+def make_elf(strings):
+    """32-bit little endian ELF with a single allocated section of strings,
+    returns its content and the address of each string"""
+    content = b''
+    addrs = {}
+
+    for string in strings:
+        addrs[string] = STRINGS_ADDR + len(content)
+        content += string.encode('latin-1') + b'\0'
+
+    shoff = 52 + len(content)
+    header = b'\x7fELF' + bytes([1, 1, 1]) + bytes(9)
+    header += struct.pack('<HHIIIIIHHHHHH', 2, 40, 1, 0, 0, shoff, 0, 52, 0, 0, 40, 2, 0)
+
+    null_section = bytes(40)
+    section = struct.pack('<IIIIIIIIII', 0, SHT_PROGBITS, SHF_ALLOC, STRINGS_ADDR,
+                          52, len(content), 0, 0, 4, 0)
+
+    return header + content + null_section + section, addrs
+
+
+def encode_record(level, seq, timestamp, tag_addr, fmt_addr, args):
+    header = (log_decode.LOG_BINARY_SYNC << 24) | ((level & 0x0F) << 20) | \
+        ((len(args) & 0x0F) << 16) | (seq & 0xFFFF)
+
+    return struct.pack('<{}I'.format(log_decode.LOG_BINARY_HEADER_WORDS + len(args)),
+                       header, timestamp & 0xFFFFFFFF, timestamp >> 32,
+                       tag_addr, fmt_addr, *args)
+
+
+class LogDecodeTest(unittest.TestCase):
+
+    def setUp(self):
+        data, self.addrs = make_elf(['main', 'uart', 'boot %s, %d tries',
+                                     'rx %u bytes 0x%04x', 'level %c%b', 'done'])
+
+        handle, self.elf_file = tempfile.mkstemp(suffix='.elf')
+        with os.fdopen(handle, 'wb') as out_file:
+            out_file.write(data)
+
+        self.elf = log_decode.ElfImage(self.elf_file)
+
+    def tearDown(self):
+        os.remove(self.elf_file)
+
+    def decode(self, data):
+        out_file = io.StringIO()
+        decoded = log_decode.decode_records(self.elf, data, out_file)
+
+        return decoded, out_file.getvalue().splitlines()
+
+    def test_layout_matches_firmware(self):
+        with open(LOG_BINARY_SOURCE) as in_file:
+            source = in_file.read()
+
+        sync = re.search(r'#define LOG_BINARY_SYNC\s+0x([0-9A-Fa-f]+)', source)
+        words = re.search(r'#define LOG_BINARY_HEADER_WORDS\s+(\d+)', source)
+
+        self.assertEqual(int(sync.group(1), 16), log_decode.LOG_BINARY_SYNC)
+        self.assertEqual(int(words.group(1)), log_decode.LOG_BINARY_HEADER_WORDS)
+
+    def test_round_trip(self):
+        addrs = self.addrs
+        data = encode_record(3, 7, 1234, addrs['main'], addrs['boot %s, %d tries'],
+                             [addrs['uart'], 0xFFFFFFFE])
+        data += encode_record(4, 8, 1235, addrs['uart'], addrs['rx %u bytes 0x%04x'],
+                              [512, 0xBEEF])
+        data += encode_record(1, 9, 1236, addrs['main'], addrs['level %c%b'],
+                              [ord('E'), 5])
+
+        decoded, lines = self.decode(data)
+
+        self.assertEqual(decoded, 3)
+        self.assertEqual(lines, ['I (1234) main: boot uart, -2 tries',
+                                 'D (1235) uart: rx 512 bytes 0xbeef',
+                                 'E (1236) main: level E101'])
+
+    def test_timestamp_above_32_bits(self):
+        # Cycle timestamps pass 2^32 after about 268 s at 16 MHz
+        timestamp = (3 << 32) | 0x10
+        data = encode_record(3, 0, timestamp, self.addrs['main'], self.addrs['done'], [])
+
+        decoded, lines = self.decode(data)
+
+        self.assertEqual(decoded, 1)
+        self.assertEqual(lines, ['I ({}) main: done'.format(timestamp)])
+
+    def test_lost_records_and_resync(self):
+        addrs = self.addrs
+        data = encode_record(3, 0xFFFE, 1, addrs['main'], addrs['done'], [])
+        # Partial record and a stray sync byte between records
+        data += b'\x00\x01\xA5' + encode_record(3, 0xFFFF, 2, addrs['main'],
+                                               addrs['done'], [])[:7]
+        data += encode_record(3, 2, 3, addrs['main'], addrs['done'], [])
+
+        decoded, lines = self.decode(data)
+
+        self.assertEqual(decoded, 2)
+        self.assertEqual(lines, ['I (1) main: done',
+                                 '--- 3 record(s) lost ---',
+                                 'I (3) main: done'])
+
+
+if __name__ == '__main__':
+    unittest.main()
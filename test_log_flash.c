@@ -0,0 +1,483 @@
+/*
+* Host test of the flash log ring (log_flash.c) on a simulated NOR flash: bits only
+* go from 1 to 0 when programmed, erase sets a whole sector back to 0xFF, and power
+* can be cut after a given number of program or erase operations, leaving the last
+* one half done. Covers ring wrap, torn records, interrupted sector erase and
+* error reporting of the flash HAL.
+*
+* Nothing here touches a register, so the device header is kept out with its include
+* guard and the build is warning-clean on 64-bit hosts.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_LOG_FLASH=1 \
+*       -DCONFIG_LOG_FLASH_FIRST_SECTOR=5 -DCONFIG_LOG_FLASH_SECTORS=3 -DCONFIG_LOG_FLASH_BATCH_SIZE=64 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_log_flash.c Components/Drivers/Log/log_flash.c -o test_log_flash && ./test_log_flash
+*/
+
+#define _GNU_SOURCE
+
+#include "log.h"
+#include "flash_hal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+/* Small sectors so the ring wraps quickly, placed below 4 GB for 32-bit addresses */
+#define NOR_BASE            0x20000000UL
+#define NOR_SECTOR_SIZE     512U
+#define NOR_SIZE            (CONFIG_LOG_FLASH_SECTORS * NOR_SECTOR_SIZE)
+
+/* Layout from log_flash.c */
+#define SECTOR_MAGIC        0x31474F4CU
+#define SECTOR_HDR_SIZE     16U
+#define RECORD_SIZE(len)    (8U + (((len) + 3U) & ~3U))
+#define RECORD_LEN_OF(hdr)  ((hdr) & 0xFFFF)
+
+#define RECORD_LEN          CONFIG_LOG_FLASH_BATCH_SIZE
+#define RECORDS_PER_SECTOR  ((NOR_SECTOR_SIZE - SECTOR_HDR_SIZE) / RECORD_SIZE(RECORD_LEN))
+
+static uint8_t* nor;
+static uint8_t locked = 1;
+static int power_budget = -1;       /* Operations completed before the cut, -1: never */
+static uint8_t power_off;
+static uint32_t fail_errors;        /* Flags returned by the next operation */
+static uint32_t last_error;
+
+static char dumped[NOR_SIZE];
+static uint32_t dumped_len;
+
+enum
+{
+    NOR_POWER_OFF,
+    NOR_POWER_ON,
+    NOR_POWER_CUT,      /* The operation is left half done */
+};
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+static int nor_power(void)
+{
+    if(power_off)
+    {
+        return NOR_POWER_OFF;
+    }
+
+    if(power_budget < 0)
+    {
+        return NOR_POWER_ON;
+    }
+
+    if(power_budget == 0)
+    {
+        power_off = 1;
+
+        return NOR_POWER_CUT;
+    }
+
+    --power_budget;
+
+    return NOR_POWER_ON;
+}
+
+/* Power back on, the caller runs log_flash_init() as after a reset */
+static void nor_power_restore(void)
+{
+    power_budget = -1;
+    power_off = 0;
+}
+
+error_t flash_hal_init(void)
+{
+    return OK;
+}
+
+error_t flash_hal_unlock(void)
+{
+    locked = 0;
+
+    return OK;
+}
+
+error_t flash_hal_lock(void)
+{
+    locked = 1;
+
+    return OK;
+}
+
+error_t flash_hal_program(uint32_t data_type, uint32_t address, const void* pdata)
+{
+    uint32_t word;
+    uint32_t* cell;
+    int power;
+
+    CHECK(!locked && data_type == FLASH_PROGRAM_WORD && (address & 3) == 0);
+    CHECK(address >= NOR_BASE && address + 4 <= NOR_BASE + NOR_SIZE);
+
+    if(fail_errors)
+    {
+        last_error = fail_errors;
+        fail_errors = 0;
+
+        return FAILED;
+    }
+
+    power = nor_power();
+
+    if(power == NOR_POWER_OFF)
+    {
+        return FAILED;
+    }
+
+    cell = (uint32_t*) (uintptr_t) address;
+    memcpy(&word, pdata, sizeof(word));
+
+    if(power == NOR_POWER_CUT)
+    {
+        /* Only the low half word reaches the cell */
+        word |= 0xFFFF0000U;
+    }
+
+    *cell &= word;
+    last_error = FLASH_ERROR_NONE;
+
+    return (power == NOR_POWER_ON) ? OK : FAILED;
+}
+
+error_t flash_hal_erase_sector(uint8_t sector, uint8_t voltage_range)
+{
+    uint8_t* start;
+    int power;
+
+    (void) voltage_range;
+
+    CHECK(!locked && sector >= CONFIG_LOG_FLASH_FIRST_SECTOR &&
+            sector < CONFIG_LOG_FLASH_FIRST_SECTOR + CONFIG_LOG_FLASH_SECTORS);
+
+    if(fail_errors)
+    {
+        last_error = fail_errors;
+        fail_errors = 0;
+
+        return FAILED;
+    }
+
+    power = nor_power();
+
+    if(power == NOR_POWER_OFF)
+    {
+        return FAILED;
+    }
+
+    start = nor + (sector - CONFIG_LOG_FLASH_FIRST_SECTOR) * NOR_SECTOR_SIZE;
+
+    if(power == NOR_POWER_CUT)
+    {
+        /* The end of the sector is erased, the header at the start is not */
+        memset(start + NOR_SECTOR_SIZE / 2, 0xFF, NOR_SECTOR_SIZE / 2);
+
+        return FAILED;
+    }
+
+    memset(start, 0xFF, NOR_SECTOR_SIZE);
+    last_error = FLASH_ERROR_NONE;
+
+    return OK;
+}
+
+uint32_t flash_hal_get_error(void)
+{
+    return last_error;
+}
+
+uint32_t flash_hal_get_sector_address(uint8_t sector)
+{
+    return NOR_BASE + (sector - CONFIG_LOG_FLASH_FIRST_SECTOR) * NOR_SECTOR_SIZE;
+}
+
+uint32_t flash_hal_get_sector_size(uint8_t sector)
+{
+    (void) sector;
+
+    return NOR_SECTOR_SIZE;
+}
+
+static int dump_out(char c)
+{
+    CHECK(dumped_len < sizeof(dumped));
+    dumped[dumped_len++] = c;
+
+    return (unsigned char) c;
+}
+
+/* One record holding its number, a whole batch so every write programs it */
+static error_t write_record(uint32_t number)
+{
+    char record[RECORD_LEN];
+
+    memset(record, '.', sizeof(record));
+    snprintf(record, sizeof(record), "record %06u", number);
+    record[strlen(record)] = '.';
+
+    return log_flash_write(record, sizeof(record));
+}
+
+/**
+ * @brief Dump the ring and check the records come out oldest first
+ *
+ * @return uint32_t number of records, first and last numbers in *first and *last
+ */
+static uint32_t dump_records(uint32_t* first, uint32_t* last)
+{
+    uint32_t count;
+    uint32_t number;
+    uint32_t previous;
+    uint32_t indx;
+
+    dumped_len = 0;
+    CHECK(log_flash_dump(dump_out) == OK);
+    CHECK(dumped_len % RECORD_LEN == 0);
+
+    count = dumped_len / RECORD_LEN;
+    previous = 0;
+
+    for(indx = 0; indx < count; indx++)
+    {
+        CHECK(sscanf(&dumped[indx * RECORD_LEN], "record %06u", &number) == 1);
+        CHECK(indx == 0 || number > previous);
+
+        if(indx == 0)
+        {
+            *first = number;
+        }
+
+        previous = number;
+    }
+
+    *last = previous;
+
+    return count;
+}
+
+/* Highest record sequence number programmed in the ring */
+static uint32_t newest_record_sequence(void)
+{
+    uint32_t best;
+    uint32_t addr;
+    uint32_t end;
+    uint32_t hdr;
+    uint32_t sequence;
+    uint32_t sector;
+
+    best = 0;
+
+    for(sector = 0; sector < CONFIG_LOG_FLASH_SECTORS; sector++)
+    {
+        addr = NOR_BASE + sector * NOR_SECTOR_SIZE + SECTOR_HDR_SIZE;
+        end = NOR_BASE + (sector + 1) * NOR_SECTOR_SIZE;
+
+        while(addr + RECORD_SIZE(0) <= end)
+        {
+            hdr = *(const uint32_t*) (uintptr_t) addr;
+
+            if(hdr == 0xFFFFFFFFU || RECORD_LEN_OF(hdr) == 0 ||
+                                addr + RECORD_SIZE(RECORD_LEN_OF(hdr)) > end)
+            {
+                break;
+            }
+
+            sequence = *(const uint32_t*) (uintptr_t) (addr + 4);
+
+            if(sequence != 0xFFFFFFFFU && sequence > best)
+            {
+                best = sequence;
+            }
+
+            addr += RECORD_SIZE(RECORD_LEN_OF(hdr));
+        }
+    }
+
+    return best;
+}
+
+/* Whether the next record makes the ring open a new sector */
+static int active_sector_full(void)
+{
+    const uint32_t* hdr;
+    uint32_t newest;
+    uint32_t addr;
+    uint32_t end;
+    uint32_t word;
+    uint32_t sector;
+    int found;
+
+    found = 0;
+    newest = 0;
+    addr = 0;
+
+    for(sector = 0; sector < CONFIG_LOG_FLASH_SECTORS; sector++)
+    {
+        hdr = (const uint32_t*) (uintptr_t) (NOR_BASE + sector * NOR_SECTOR_SIZE);
+
+        if(hdr[0] == SECTOR_MAGIC && hdr[1] == ~hdr[2] && (!found || hdr[1] > newest))
+        {
+            found = 1;
+            newest = hdr[1];
+            addr = (uint32_t) (uintptr_t) hdr;
+        }
+    }
+
+    CHECK(found);
+    end = addr + NOR_SECTOR_SIZE;
+    addr += SECTOR_HDR_SIZE;
+
+    while(addr + RECORD_SIZE(0) <= end)
+    {
+        word = *(const uint32_t*) (uintptr_t) addr;
+
+        if(word == 0xFFFFFFFFU)
+        {
+            return addr + RECORD_SIZE(RECORD_LEN) > end;
+        }
+
+        if(RECORD_LEN_OF(word) == 0 || addr + RECORD_SIZE(RECORD_LEN_OF(word)) > end)
+        {
+            break;
+        }
+
+        addr += RECORD_SIZE(RECORD_LEN_OF(word));
+    }
+
+    return 1;
+}
+
+static void fill_active_sector(uint32_t* number)
+{
+    while(!active_sector_full())
+    {
+        CHECK(write_record(++*number) == OK);
+    }
+}
+
+int main(void)
+{
+    uint32_t first;
+    uint32_t last;
+    uint32_t count;
+    uint32_t number;
+    uint32_t sequence;
+    char torn[16];
+
+    nor = mmap((void*) NOR_BASE, NOR_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    CHECK(nor == (uint8_t*) NOR_BASE);
+
+    /* Never erased, no sector holds a header */
+    memset(nor, 0x00, NOR_SIZE);
+
+    /* Wrap the ring several times, whole sectors are dropped oldest first */
+    CHECK(log_flash_init() == OK);
+    CHECK(newest_record_sequence() == 0);
+    number = 0;
+
+    while(number < 10 * RECORDS_PER_SECTOR)
+    {
+        CHECK(write_record(++number) == OK);
+    }
+
+    count = dump_records(&first, &last);
+    CHECK(last == number && last - first + 1 == count);
+    CHECK(count > (CONFIG_LOG_FLASH_SECTORS - 1) * RECORDS_PER_SECTOR);
+    CHECK(newest_record_sequence() == number);
+    printf("wrap: %u records kept out of %u, oldest first\n", count, number);
+
+    /* Reset with the active sector full, the next record opens a new one */
+    fill_active_sector(&number);
+    sequence = newest_record_sequence();
+    CHECK(log_flash_init() == OK);
+    CHECK(write_record(++number) == OK);
+    CHECK(newest_record_sequence() == sequence + 1);
+
+    /* Reset after a sector is opened but before any record in it is complete */
+    fill_active_sector(&number);
+    sequence = newest_record_sequence();
+    power_budget = 1 + SECTOR_HDR_SIZE / 4;     /* Erase and sector header */
+    CHECK(write_record(++number) == FAILED);
+    nor_power_restore();
+    CHECK(log_flash_init() == OK);
+    CHECK(write_record(++number) == OK);
+    CHECK(newest_record_sequence() == sequence + 1);
+    printf("sequence: carried over resets and sectors without records\n");
+
+    /* Reset while programming a payload: the record is skipped, writing resumes after it */
+    if(active_sector_full())
+    {
+        CHECK(write_record(++number) == OK);
+    }
+
+    power_budget = 3;                           /* Record header, sequence, a payload word */
+    CHECK(write_record(++number) == FAILED);
+    nor_power_restore();
+    CHECK(log_flash_init() == OK);
+    CHECK(write_record(++number) == OK);
+    CHECK(write_record(++number) == OK);
+
+    count = dump_records(&first, &last);
+    CHECK(last == number);
+    snprintf(torn, sizeof(torn), "record %06u", number - 2);
+    CHECK(memmem(dumped, dumped_len, torn, strlen(torn)) == NULL);
+    snprintf(torn, sizeof(torn), "record %06u", number - 3);
+    CHECK(memmem(dumped, dumped_len, torn, strlen(torn)) != NULL);
+    printf("torn record: skipped, %u records after reset\n", count);
+
+    /* Reset during the sector erase, then while programming the sector header */
+    for(count = 0; count <= 1; count++)
+    {
+        fill_active_sector(&number);
+        sequence = newest_record_sequence();
+
+        power_budget = count;
+        CHECK(write_record(++number) == FAILED);
+        nor_power_restore();
+
+        CHECK(log_flash_init() == OK);
+        CHECK(write_record(++number) == OK);
+        CHECK(newest_record_sequence() == sequence + 1);
+        CHECK(!active_sector_full());
+
+        dump_records(&first, &last);
+        CHECK(last == number);
+    }
+
+    printf("interrupted erase: ring recovered, records still in order\n");
+
+    /* Flash errors reach the caller */
+    fail_errors = FLASH_SR_PGPERR_S;
+    CHECK(write_record(++number) == FAILED);
+    CHECK(flash_hal_get_error() == FLASH_SR_PGPERR_S);
+    CHECK(write_record(++number) == OK);
+
+    fill_active_sector(&number);
+    fail_errors = FLASH_SR_PGSERR_S;
+    CHECK(write_record(++number) == FAILED);
+    CHECK(flash_hal_get_error() == FLASH_SR_PGSERR_S);
+    CHECK(write_record(++number) == OK);
+
+    dump_records(&first, &last);
+    CHECK(last == number);
+    printf("errors: program and erase failures returned\n");
+
+    printf("OK\n");
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+* Host test and benchmark of log_hexdump (log.c). Every row is compared with a
+* reference built with snprintf, including a short last row, bytes outside the
+* printable range and level filtering, then dump throughput is measured.
+*
+* Build and run from the repository root, written straight to the log output:
+*   gcc -std=gnu99 -O2 -Wall -DCONFIG_LOG_ROUTER=0 -DCONFIG_LOG_ASYNC=0 -DCONFIG_LOG_COLORS=0 \
+*       -DCONFIG_LOG_DEFAULT_LEVEL=3 -DCONFIG_LOG_RUNTIME_LEVELS=0 -DCONFIG_LOG_TIMESTAMP_SOURCE=0 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_log_hexdump.c Components/Utils/printf/printf.c -o test_log_hexdump && ./test_log_hexdump
+*
+* Add -DCONFIG_LOG_ROUTER=1 -DCONFIG_LOG_ROUTER_SINKS=2 -DCONFIG_LOG_RAM_BUFFERSIZE=512
+* instead of -DCONFIG_LOG_ROUTER=0 to run the rows through the log router.
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Stand-ins for the CMSIS core functions, the device header is kept out */
+#define __STM32F446XX_H__
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return 0;
+}
+
+static inline void __disable_irq(void)
+{
+
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    (void) primask;
+}
+
+static inline uint32_t __get_IPSR(void)
+{
+    return 0;
+}
+
+#include "Components/Drivers/Log/log.c"
+#if CONFIG_LOG_ROUTER
+#include "Components/Drivers/Log/log_router.c"
+#endif /* CONFIG_LOG_ROUTER */
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define CAPTURE_SIZE        8192
+#define BENCH_BUFFER_SIZE   4096
+#define BENCH_ROUNDS        2000
+
+static char captured[CAPTURE_SIZE];
+static uint32_t captured_len;
+static uint64_t output_bytes;
+static uint8_t counting;
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+uint64_t timer_get_milliseconds(void)
+{
+    return 42;
+}
+
+uint64_t timer_get_cycles(void)
+{
+    return 0;
+}
+
+uint64_t timer_cycles_to_us(uint64_t cycles)
+{
+    return cycles;
+}
+
+int putch_(char ch)
+{
+    return (unsigned char) ch;
+}
+
+void putchar_(char c)
+{
+    (void) c;
+}
+
+void putblock_(const char* data, size_t len)
+{
+    (void) data;
+    (void) len;
+}
+
+static int capture_char(char c)
+{
+    if(counting)
+    {
+        output_bytes++;
+    }
+    else
+    {
+        CHECK(captured_len < CAPTURE_SIZE - 1);
+        captured[captured_len++] = c;
+        captured[captured_len] = '\0';
+    }
+
+    return (unsigned char) c;
+}
+
+#if CONFIG_LOG_ROUTER
+static error_t capture_line(const char* line, uint16_t len)
+{
+    while(len--)
+    {
+        capture_char(*line++);
+    }
+
+    return OK;
+}
+#endif /* CONFIG_LOG_ROUTER */
+
+/**
+ * @brief Expected output of log_hexdump, one line per 16 bytes
+ */
+static uint32_t reference_dump(char* out, char prefix, const char* tag,
+                                                const uint8_t* buffer, uint16_t size)
+{
+    uint32_t addr;
+    uint32_t len;
+    uint16_t to_copy;
+    uint16_t indx;
+
+    len = 0;
+    addr = (uint32_t) (uintptr_t) buffer;
+
+    while(size)
+    {
+        to_copy = (size > 16) ? 16 : size;
+        len += sprintf(&out[len], "%c (42) %s: %08x  ", prefix, tag, addr);
+
+        for(indx = 0; indx < 16; indx++)
+        {
+            if(indx < to_copy)
+            {
+                len += sprintf(&out[len], "%02x ", buffer[indx]);
+            }
+            else
+            {
+                len += sprintf(&out[len], "   ");
+            }
+
+            if(indx == 7)
+            {
+                len += sprintf(&out[len], " ");
+            }
+        }
+
+        len += sprintf(&out[len], " |");
+
+        for(indx = 0; indx < to_copy; indx++)
+        {
+            out[len++] = (buffer[indx] >= ' ' && buffer[indx] <= '~') ? buffer[indx] : '.';
+        }
+
+        len += sprintf(&out[len], "|\r\n");
+
+        buffer += to_copy;
+        addr += to_copy;
+        size -= to_copy;
+    }
+
+    return len;
+}
+
+int main(void)
+{
+    static uint8_t bench[BENCH_BUFFER_SIZE];
+    static char expected[CAPTURE_SIZE];
+    struct timespec start;
+    struct timespec end;
+    uint8_t data[512];
+    uint16_t sizes[] = {1, 7, 8, 15, 16, 17, 40, 256};
+    double elapsed_us;
+    uint32_t indx;
+
+    for(indx = 0; indx < sizeof(data); indx++)
+    {
+        data[indx] = (uint8_t) (indx & 0xFF);
+    }
+
+    #if CONFIG_LOG_ROUTER
+    CHECK(log_router_add_sink(capture_line, LOG_LEVEL_DEBUG, 0, 0, 1) == OK);
+    #endif /* CONFIG_LOG_ROUTER */
+    log_set_putchar(capture_char);
+
+    /* Every byte value, rows from a single byte to many, unaligned starts */
+    for(indx = 0; indx < sizeof(sizes) / sizeof(sizes[0]); indx++)
+    {
+        captured_len = 0;
+        log_hexdump(LOG_LEVEL_INFO, "HD", &data[indx], sizes[indx]);
+        reference_dump(expected, 'I', "HD", &data[indx], sizes[indx]);
+        CHECK(strcmp(captured, expected) == 0);
+    }
+
+    printf("rows: %u sizes match the reference\n", indx);
+
+    /* Filtered levels, empty and missing buffers write nothing */
+    captured_len = 0;
+    captured[0] = '\0';
+    log_hexdump(LOG_LEVEL_DEBUG, "HD", data, 16);
+    log_hexdump(LOG_LEVEL_INFO, "HD", data, 0);
+    log_hexdump(LOG_LEVEL_INFO, "HD", NULL, 16);
+    log_hexdump(LOG_LEVEL_INFO, NULL, data, 16);
+    CHECK(captured_len == 0);
+
+    log_hexdump(LOG_LEVEL_ERROR, "HD", data, 16);
+    reference_dump(expected, 'E', "HD", data, 16);
+    CHECK(strcmp(captured, expected) == 0);
+    printf("levels: filtered rows and bad arguments write nothing\n");
+
+    /* Throughput of the formatting, output is only counted */
+    for(indx = 0; indx < sizeof(bench); indx++)
+    {
+        bench[indx] = (uint8_t) (indx * 7);
+    }
+
+    counting = 1;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(indx = 0; indx < BENCH_ROUNDS; indx++)
+    {
+        log_hexdump(LOG_LEVEL_INFO, "HD", bench, sizeof(bench));
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    counting = 0;
+
+    elapsed_us = (end.tv_sec - start.tv_sec) * 1e6 + (end.tv_nsec - start.tv_nsec) / 1e3;
+    CHECK(output_bytes == (uint64_t) BENCH_ROUNDS * (sizeof(bench) / 16) *
+                                        reference_dump(expected, 'I', "HD", bench, 16));
+    printf("bench: %.1f bytes/us dumped, %.0f ns/row\n",
+                (double) BENCH_ROUNDS * sizeof(bench) / elapsed_us,
+                elapsed_us * 1e3 / (BENCH_ROUNDS * (sizeof(bench) / 16)));
+
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*
+* Host test of the runtime log level table (log_level.c). Covers copied tag names,
+* the catch-all "*" level, a full table, and an interrupt registering a call site
+* while log_level_set searches, which must not make the search run with
+* interrupts masked.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -DCONFIG_LOG_RUNTIME_LEVELS=1 -DCONFIG_LOG_TAG_TABLE_SIZE=32 \
+*       -DCONFIG_LOG_DEFAULT_LEVEL=3 -DCONFIG_LOG_MAXIMUM_LEVEL=4 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_log_level.c -o test_log_level && ./test_log_level
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Stand-ins for the CMSIS interrupt mask, the device header is kept out */
+#define __STM32F446XX_H__
+
+static uint32_t irq_masked;
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return irq_masked;
+}
+
+static inline void __disable_irq(void)
+{
+    irq_masked = 1;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    irq_masked = primask;
+}
+
+/* Every comparison of log_level.c goes through here */
+static int test_strcmp(const char* a, const char* b);
+#define strcmp  test_strcmp
+
+#include "Components/Drivers/Log/log_level.c"
+
+#undef strcmp
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+static const char uart_tag[] = "uart";
+static const char isr_tag[] = "uart";       /* Same string, another call site */
+
+static uint32_t compares;
+static uint32_t masked_compares;
+static uint32_t preempt_at;                 /* Compare that is interrupted, 0: none */
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+static int test_strcmp(const char* a, const char* b)
+{
+    compares++;
+
+    if(irq_masked)
+    {
+        masked_compares++;
+    }
+
+    if(compares == preempt_at)
+    {
+        preempt_at = 0;
+        (void) log_level_ref(isr_tag);
+    }
+
+    return strcmp(a, b);
+}
+
+int main(void)
+{
+    char buffer[32];
+    char names[CONFIG_LOG_TAG_TABLE_SIZE + 8][8];
+    const log_level_t* uart;
+    const log_level_t* spi;
+    const log_level_t* late;
+    uint32_t i;
+
+    /* The name is copied, the caller may reuse its buffer */
+    strcpy(buffer, "uart");
+    CHECK(log_level_set(buffer, LOG_LEVEL_DEBUG) == OK);
+    memset(buffer, 'x', sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    uart = log_level_ref(uart_tag);
+    CHECK(*uart == LOG_LEVEL_DEBUG);
+    strcpy(buffer, "uart");
+    CHECK(log_level_get(buffer) == LOG_LEVEL_DEBUG);
+
+    /* A call site registered first takes a later level by name */
+    spi = log_level_ref("spi");
+    CHECK(*spi == CONFIG_LOG_DEFAULT_LEVEL);
+    strcpy(buffer, "spi");
+    CHECK(log_level_set(buffer, LOG_LEVEL_ERROR) == OK);
+    CHECK(*spi == LOG_LEVEL_ERROR);
+    printf("names: copied on set, resolved by string\n");
+
+    /* "*" changes the default only, levels already set are kept */
+    CHECK(log_level_set("*", LOG_LEVEL_NONE) == OK);
+    CHECK(*uart == LOG_LEVEL_DEBUG && *spi == LOG_LEVEL_ERROR);
+    late = log_level_ref("late");
+    CHECK(*late == LOG_LEVEL_NONE);
+    strcpy(buffer, "unknown");
+    CHECK(log_level_get(buffer) == LOG_LEVEL_NONE);
+    CHECK(log_level_set("a_tag_way_too_long", LOG_LEVEL_INFO) == FAILED);
+    printf("default: \"*\" applies to tags without a level\n");
+
+    /* An interrupt adds a call site of the same string while set searches */
+    compares = 0;
+    preempt_at = 2;
+    strcpy(buffer, "uart");
+    CHECK(log_level_set(buffer, LOG_LEVEL_WARNING) == OK);
+    CHECK(preempt_at == 0);
+    CHECK(*uart == LOG_LEVEL_WARNING);
+    CHECK(*log_level_ref(isr_tag) == LOG_LEVEL_WARNING);
+    CHECK(irq_masked == 0);
+    printf("preemption: set retries after a concurrent insert\n");
+
+    /* Fill the table, five entries are in use already */
+    for(i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        sprintf(names[i], "t%u", i);
+
+        if(log_level_set(names[i], LOG_LEVEL_INFO) != OK)
+        {
+            break;
+        }
+    }
+
+    CHECK(i == CONFIG_LOG_TAG_TABLE_SIZE - 5);
+    CHECK(log_level_get(names[0]) == LOG_LEVEL_INFO);
+    printf("full table: %u names added, then refused\n", i);
+
+    CHECK(masked_compares == 0);
+    printf("no string compare with interrupts masked\n");
+
+    return 0;
+}
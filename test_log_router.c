@@ -0,0 +1,246 @@
+/*
+* Host test of the log router (log_router.c) behind log_write (log.c): repeated
+* lines collapsed into a count, lines whose body hashes the same kept apart, per
+* sink rate limits and sinks skipped for lines logged from an interrupt.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -DCONFIG_LOG_ROUTER=1 -DCONFIG_LOG_ROUTER_SINKS=4 \
+*       -DCONFIG_LOG_RAM_BUFFERSIZE=512 -DCONFIG_LOG_ASYNC=0 -DCONFIG_LOG_COLORS=0 \
+*       -DCONFIG_LOG_DEFAULT_LEVEL=4 -DCONFIG_LOG_RUNTIME_LEVELS=0 -DCONFIG_LOG_TIMESTAMP_SOURCE=0 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_log_router.c Components/Utils/printf/printf.c -o test_log_router && ./test_log_router
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Stand-ins for the CMSIS core functions, the device header is kept out */
+#define __STM32F446XX_H__
+
+static uint32_t irq_masked;
+static uint32_t ipsr;
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return irq_masked;
+}
+
+static inline void __disable_irq(void)
+{
+    irq_masked = 1;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    irq_masked = primask;
+}
+
+static inline uint32_t __get_IPSR(void)
+{
+    return ipsr;
+}
+
+#include "Components/Drivers/Log/log.c"
+#include "Components/Drivers/Log/log_router.c"
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+/* Two bodies, "T: msg 539198\r\n" and "T: msg 722783\r\n", with the same FNV-1a */
+#define COLLIDING_A     "msg 539198"
+#define COLLIDING_B     "msg 722783"
+
+#define CAPTURE_SIZE    2048
+
+struct capture_t
+{
+    char text[CAPTURE_SIZE];
+    uint32_t len;
+    uint32_t lines;
+};
+
+static struct capture_t task_sink;
+static struct capture_t isr_sink;
+static uint64_t now_ms;
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+uint64_t timer_get_milliseconds(void)
+{
+    return now_ms;
+}
+
+uint64_t timer_get_cycles(void)
+{
+    return now_ms * 180000U;
+}
+
+uint64_t timer_cycles_to_us(uint64_t cycles)
+{
+    return cycles / 180U;
+}
+
+int putch_(char ch)
+{
+    return (unsigned char) ch;
+}
+
+void putchar_(char c)
+{
+    (void) c;
+}
+
+void putblock_(const char* data, size_t len)
+{
+    (void) data;
+    (void) len;
+}
+
+static error_t capture(struct capture_t* out, const char* line, uint16_t len)
+{
+    CHECK(out->len + len < CAPTURE_SIZE);
+
+    memcpy(&out->text[out->len], line, len);
+    out->len += len;
+    out->text[out->len] = '\0';
+    out->lines++;
+
+    return OK;
+}
+
+static error_t task_sink_write(const char* line, uint16_t len)
+{
+    return capture(&task_sink, line, len);
+}
+
+static error_t isr_sink_write(const char* line, uint16_t len)
+{
+    return capture(&isr_sink, line, len);
+}
+
+static void capture_reset(void)
+{
+    memset(&task_sink, 0, sizeof(task_sink));
+    memset(&isr_sink, 0, sizeof(isr_sink));
+}
+
+static uint32_t occurrences(const char* text, const char* what)
+{
+    uint32_t count;
+
+    count = 0;
+
+    while((text = strstr(text, what)) != NULL)
+    {
+        count++;
+        text += strlen(what);
+    }
+
+    return count;
+}
+
+static uint32_t body_hash(const char* body)
+{
+    return log_router_hash(body, strlen(body));
+}
+
+int main(void)
+{
+    uint32_t indx;
+
+    CHECK(log_router_add_sink(task_sink_write, LOG_LEVEL_DEBUG, 2, 3, 0) == OK);
+    CHECK(log_router_add_sink(isr_sink_write, LOG_LEVEL_INFO, 0, 0, 1) == OK);
+    CHECK(log_router_add_sink(NULL, LOG_LEVEL_INFO, 0, 0, 1) == FAILED);
+
+    /* Identical lines are counted, the count comes with the next different line */
+    capture_reset();
+    now_ms = 1000;
+
+    for(indx = 0; indx < 3; indx++)
+    {
+        now_ms += 10;
+        log_write(LOG_LEVEL_INFO, "T", "same");
+    }
+
+    CHECK(task_sink.lines == 1 && isr_sink.lines == 1);
+    log_write(LOG_LEVEL_INFO, "T", "other");
+    CHECK(occurrences(task_sink.text, "last message repeated 2 times") == 1);
+    CHECK(occurrences(isr_sink.text, "last message repeated 2 times") == 1);
+    CHECK(occurrences(task_sink.text, "T: other") == 1);
+
+    log_write(LOG_LEVEL_INFO, "T", "other");
+    log_router_flush();
+    CHECK(occurrences(isr_sink.text, "last message repeated 1 times") == 1);
+    printf("repeats: collapsed into a count\n");
+
+    /* Same body at another level is a different message */
+    capture_reset();
+    now_ms += 10000;
+    log_write(LOG_LEVEL_INFO, "T", "level");
+    log_write(LOG_LEVEL_WARNING, "T", "level");
+    CHECK(occurrences(isr_sink.text, "T: level") == 2);
+    CHECK(occurrences(isr_sink.text, "repeated") == 0);
+
+    /* A hash collision is not a repeat */
+    CHECK(body_hash("T: " COLLIDING_A LOG_LINE_END) == 
+                                            body_hash("T: " COLLIDING_B LOG_LINE_END));
+    capture_reset();
+    now_ms += 10000;
+    log_write(LOG_LEVEL_INFO, "T", COLLIDING_A);
+    log_write(LOG_LEVEL_INFO, "T", COLLIDING_B);
+    CHECK(occurrences(isr_sink.text, COLLIDING_A) == 1);
+    CHECK(occurrences(isr_sink.text, COLLIDING_B) == 1);
+    CHECK(occurrences(isr_sink.text, "repeated") == 0);
+    printf("collisions: lines with the same hash both written\n");
+
+    /* Burst of 3 then 2 lines per second on the limited sink only */
+    capture_reset();
+    now_ms += 10000;
+
+    for(indx = 0; indx < 5; indx++)
+    {
+        log_write(LOG_LEVEL_INFO, "T", "burst %u", indx);
+    }
+
+    CHECK(task_sink.lines == 3 && isr_sink.lines == 5);
+    CHECK(log_router_get_suppressed(task_sink_write) == 2);
+    CHECK(log_router_get_suppressed(isr_sink_write) == 0);
+
+    now_ms += 1000;
+    log_write(LOG_LEVEL_INFO, "T", "after");
+    CHECK(occurrences(task_sink.text, "2 lines suppressed") == 1);
+    CHECK(occurrences(task_sink.text, "T: after") == 1);
+    printf("rate limit: burst kept, the rest counted and reported\n");
+
+    /* From an interrupt only isr_safe sinks are called */
+    capture_reset();
+    now_ms += 10000;
+    ipsr = 16 + 37;
+    log_write(LOG_LEVEL_ERROR, "T", "from isr");
+    ipsr = 0;
+    CHECK(task_sink.lines == 0 && isr_sink.lines == 1);
+    CHECK(log_router_get_suppressed(task_sink_write) == 3);
+
+    log_write(LOG_LEVEL_ERROR, "T", "from task");
+    CHECK(occurrences(task_sink.text, "1 lines suppressed") == 1);
+    CHECK(occurrences(task_sink.text, "T: from task") == 1);
+    printf("interrupts: blocking sinks skipped and counted\n");
+
+    /* Levels are per sink */
+    capture_reset();
+    CHECK(log_router_set_level(isr_sink_write, LOG_LEVEL_ERROR) == OK);
+    CHECK(log_router_set_level(log_ram_write, LOG_LEVEL_ERROR) == FAILED);
+    now_ms += 10000;
+    log_write(LOG_LEVEL_DEBUG, "T", "debug");
+    CHECK(task_sink.lines == 1 && isr_sink.lines == 0);
+    CHECK(irq_masked == 0);
+    printf("levels: applied per sink\n");
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+/*
+* Host test and benchmark of the block output of printf.c: bprintf and printf_ through
+* putblock_. For every chunk size from 1 up the chunks handed to the write function
+* must concatenate to the snprintf_ output, all of them full but the last, and the
+* return value must be the output length. A missing or empty chunk is refused.
+* The benchmark counts output calls and time against the per-character fctprintf.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -DPRINTF_STDOUT_CHUNK_SIZE=64 -IComponents/Utils/printf \
+*       test_printf_bprintf.c Components/Utils/printf/printf.c -o test_printf_bprintf && ./test_printf_bprintf
+*/
+
+#include "printf.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define OUTPUT_SIZE     1024
+#define MAX_CHUNK_SIZE  300
+#define BENCH_ROUNDS    200000
+
+/* A telemetry line, longer than a stdout chunk */
+#define LINE_FORMAT     "t=%llu id=%-8s x=%+.3f y=%08x n=%d msg=%s\n"
+#define LINE_ARGS       123456789012ULL, "sensor", -12.3456, 0xBEEFU, -42, \
+                        "a message that goes past the sixty-four characters of a chunk"
+
+struct collected_t
+{
+    char text[OUTPUT_SIZE];
+    size_t len;
+    uint32_t calls;
+    size_t chunk_size;
+    size_t short_chunks;
+};
+
+static struct collected_t stdout_out;
+static uint32_t putchar_calls;
+static volatile uint32_t sink;
+
+void putchar_(char c)
+{
+    putchar_calls++;
+    sink += (uint8_t) c;
+}
+
+void putblock_(const char* data, size_t len)
+{
+    CHECK(stdout_out.len + len < OUTPUT_SIZE);
+
+    memcpy(&stdout_out.text[stdout_out.len], data, len);
+    stdout_out.len += len;
+    stdout_out.calls++;
+}
+
+static void collect(const char* data, size_t len, void* extra_arg)
+{
+    struct collected_t* out = (struct collected_t*) extra_arg;
+
+    CHECK(len > 0 && len <= out->chunk_size);
+    CHECK(out->len + len < OUTPUT_SIZE);
+
+    if(len < out->chunk_size)
+    {
+        out->short_chunks++;
+    }
+
+    memcpy(&out->text[out->len], data, len);
+    out->len += len;
+    out->calls++;
+}
+
+static void count_block(const char* data, size_t len, void* extra_arg)
+{
+    (void) extra_arg;
+
+    sink += (uint8_t) data[len - 1];
+}
+
+static void count_char(char c, void* extra_arg)
+{
+    (void) extra_arg;
+
+    sink += (uint8_t) c;
+}
+
+static double elapsed_ns(const struct timespec* start, const struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+int main(void)
+{
+    static struct collected_t out;
+    char expected[OUTPUT_SIZE];
+    char chunk[MAX_CHUNK_SIZE];
+    struct timespec start;
+    struct timespec end;
+    size_t chunk_size;
+    uint32_t round;
+    int expected_len;
+    int ret;
+
+    expected_len = snprintf_(expected, sizeof(expected), LINE_FORMAT, LINE_ARGS);
+    CHECK(expected_len > 64 && expected_len < MAX_CHUNK_SIZE);
+
+    /* Chunks smaller, equal and larger than the output */
+    for(chunk_size = 1; chunk_size < MAX_CHUNK_SIZE; chunk_size++)
+    {
+        memset(&out, 0, sizeof(out));
+        out.chunk_size = chunk_size;
+
+        ret = bprintf(collect, &out, chunk, chunk_size, LINE_FORMAT, LINE_ARGS);
+
+        CHECK(ret == expected_len);
+        CHECK(out.len == (size_t) expected_len);
+        CHECK(memcmp(out.text, expected, out.len) == 0);
+        CHECK(out.calls == (expected_len + chunk_size - 1) / chunk_size);
+        CHECK(out.short_chunks == ((expected_len % chunk_size) ? 1U : 0U));
+    }
+
+    /* Empty output, no call at all */
+    memset(&out, 0, sizeof(out));
+    out.chunk_size = 8;
+    CHECK(bprintf(collect, &out, chunk, 8, "%s", "") == 0);
+    CHECK(out.calls == 0);
+    printf("bprintf: chunks of 1 to %u concatenate to the snprintf_ output\n", MAX_CHUNK_SIZE - 1);
+
+    /* Nowhere to collect the output, nothing is written and -1 returned */
+    memset(&out, 0, sizeof(out));
+    out.chunk_size = 8;
+    CHECK(bprintf(collect, &out, chunk, 0, LINE_FORMAT, LINE_ARGS) == -1);
+    CHECK(bprintf(collect, &out, NULL, 8, LINE_FORMAT, LINE_ARGS) == -1);
+    CHECK(bprintf(NULL, &out, chunk, 8, LINE_FORMAT, LINE_ARGS) == -1);
+    CHECK(out.calls == 0);
+    printf("bprintf: missing or empty chunk refused\n");
+
+    /* stdout goes to putblock_ a chunk at a time */
+    ret = printf_(LINE_FORMAT, LINE_ARGS);
+    CHECK(ret == expected_len);
+    CHECK(stdout_out.len == (size_t) expected_len);
+    CHECK(memcmp(stdout_out.text, expected, stdout_out.len) == 0);
+    CHECK(stdout_out.calls == (expected_len + PRINTF_STDOUT_CHUNK_SIZE - 1) / PRINTF_STDOUT_CHUNK_SIZE);
+    CHECK(putchar_calls == 0);
+    printf("printf_: %d characters in %u putblock_ calls\n", ret, stdout_out.calls);
+
+    /* Output calls and time per line, block against per character */
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(round = 0; round < BENCH_ROUNDS; round++)
+    {
+        bprintf(count_block, NULL, chunk, 64, LINE_FORMAT, LINE_ARGS);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("bench: bprintf   %6.1f ns/line, %d output calls\n",
+            elapsed_ns(&start, &end) / BENCH_ROUNDS, (expected_len + 63) / 64);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(round = 0; round < BENCH_ROUNDS; round++)
+    {
+        fctprintf(count_char, NULL, LINE_FORMAT, LINE_ARGS);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("bench: fctprintf %6.1f ns/line, %d output calls\n",
+            elapsed_ns(&start, &end) / BENCH_ROUNDS, expected_len);
+
+    return 0;
+}
@@ -0,0 +1,173 @@
+/*
+* Host test and benchmark of compiled format strings (printf_compile and
+* snprintf_compiled in printf.c). Each format is printed with random arguments both
+* compiled and through snprintf_, and the output and return value must match,
+* including * width and precision taken from the arguments, negative ones among
+* them, and truncation. Invalid formats must be refused at compile time. The
+* benchmark runs representative telemetry formats both ways.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -DPRINTF_STDOUT_CHUNK_SIZE=64 -IComponents/Utils/printf \
+*       test_printf_compiled.c Components/Utils/printf/printf.c -o test_printf_compiled && ./test_printf_compiled
+*/
+
+#include "printf.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define MAX_SPECS       16
+#define ROUNDS          20000
+#define BENCH_ROUNDS    1000000
+
+static char stdout_text[512];
+static size_t stdout_len;
+static uint32_t compared;
+
+void putchar_(char c)
+{
+    (void) c;
+}
+
+void putblock_(const char* data, size_t len)
+{
+    CHECK(stdout_len + len < sizeof(stdout_text));
+
+    memcpy(&stdout_text[stdout_len], data, len);
+    stdout_len += len;
+}
+
+/* Same format and arguments both ways, into a full and a truncating buffer */
+#define COMPARE(fmt, ...)                                                               \
+    do                                                                                  \
+    {                                                                                   \
+        printf_format_spec_t specs[MAX_SPECS];                                          \
+        char compiled[256];                                                             \
+        char runtime[256];                                                              \
+        int compiled_ret;                                                               \
+        int runtime_ret;                                                                \
+        CHECK(printf_compile(fmt, specs, MAX_SPECS) > 0);                               \
+        compiled_ret = snprintf_compiled(compiled, sizeof(compiled), specs, __VA_ARGS__); \
+        runtime_ret = snprintf_(runtime, sizeof(runtime), fmt, __VA_ARGS__);            \
+        if(compiled_ret != runtime_ret || strcmp(compiled, runtime) != 0)               \
+        {                                                                               \
+            printf("MISMATCH %s: [%s] %d, runtime [%s] %d\n", fmt,                      \
+                                    compiled, compiled_ret, runtime, runtime_ret);      \
+            exit(1);                                                                    \
+        }                                                                               \
+        compiled_ret = snprintf_compiled(compiled, 7, specs, __VA_ARGS__);              \
+        runtime_ret = snprintf_(runtime, 7, fmt, __VA_ARGS__);                          \
+        CHECK(compiled_ret == runtime_ret && strcmp(compiled, runtime) == 0);           \
+        compared++;                                                                     \
+    } while(0)
+
+static int random_int(int low, int high)
+{
+    return low + rand() % (high - low + 1);
+}
+
+static double elapsed_ns(const struct timespec* start, const struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+int main(void)
+{
+    static const char* words[] = {"", "a", "sensor", "a longer string argument"};
+    printf_format_spec_t specs[MAX_SPECS];
+    char out[256];
+    struct timespec start;
+    struct timespec end;
+    unsigned long long timestamp;
+    const char* word;
+    uint32_t round;
+    int value;
+    int width;
+    int precision;
+    double x;
+
+    srand(7);
+
+    for(round = 0; round < ROUNDS; round++)
+    {
+        timestamp = ((unsigned long long) rand() << 31) ^ (unsigned long long) rand();
+        value = rand() - RAND_MAX / 2;
+        width = random_int(-12, 12);
+        precision = random_int(-3, 10);
+        word = words[rand() % 4];
+        x = (rand() - RAND_MAX / 2) / 1024.0;
+
+        /* Telemetry lines */
+        COMPARE("ts=%llu ch=%u val=%d st=%02x\n", timestamp, value & 7, value, value & 0xFF);
+        COMPARE("T=%llu id=%04X v=%-6d|%s|%5.1f%% %c end", timestamp, value & 0xFFFF,
+                                                            value, word, x, 'A' + (value & 15));
+        COMPARE("%s", word);
+        COMPARE("no conversion at the end %d", value);
+
+        /* Width and precision from the arguments, negative ones included */
+        COMPARE("|%*d|", width, value);
+        COMPARE("|%.*d|", precision, value);
+        COMPARE("|%*.*s|", width, precision, word);
+        COMPARE("|%-*.*x|", width, precision, (unsigned int) value);
+        COMPARE("|%0*lld|", width, (long long) timestamp);
+        COMPARE("|%*.*f|", width, precision, x);
+        COMPARE("|%+*i|%*c|", width, value, width, 'z');
+
+        /* Flags and lengths */
+        COMPARE("%#o %#x %#X % d %+d %hhu %hd %lu %zu", (unsigned int) value, (unsigned int) value,
+                (unsigned int) value, value, value, (unsigned char) value, (short) value,
+                (unsigned long) timestamp, (size_t) value);
+        COMPARE("%p %e %g %%", (void*) (uintptr_t) timestamp, x, x);
+    }
+
+    printf("formats: %u compiled conversions match snprintf_\n", compared);
+
+    /* Validation happens once, when compiling */
+    CHECK(printf_compile("x %q", specs, MAX_SPECS) == -1);
+    CHECK(printf_compile("x %", specs, MAX_SPECS) == -1);
+    CHECK(printf_compile("x %5", specs, MAX_SPECS) == -1);
+    CHECK(printf_compile("%d%d%d", specs, 3) == -1);
+    CHECK(printf_compile("%d%d%d", specs, 4) == 4);
+    CHECK(printf_compile("plain", specs, 1) == 1);
+    CHECK(specs[0].specifier == '\0' && specs[0].literal_len == 5);
+    printf("validation: bad conversions and short spec arrays refused\n");
+
+    /* stdout through putblock_ */
+    CHECK(printf_compile("t=%llu %*s|\n", specs, MAX_SPECS) == 3);
+    CHECK(printf_compiled(specs, 99ULL, -6, "ab") == 13);
+    CHECK(stdout_len == 13 && memcmp(stdout_text, "t=99 ab    |\n", 13) == 0);
+    printf("printf_compiled: written through putblock_\n");
+
+    /* Telemetry format, runtime parse against compiled */
+    CHECK(printf_compile("ts=%llu ch=%u val=%d st=%02x\n", specs, MAX_SPECS) > 0);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(round = 0; round < BENCH_ROUNDS; round++)
+    {
+        snprintf_(out, sizeof(out), "ts=%llu ch=%u val=%d st=%02x\n",
+                    (unsigned long long) round * 1000U, round & 7, (int) round - 1000, round & 0xFF);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("bench: snprintf_          %6.1f ns/line\n", elapsed_ns(&start, &end) / BENCH_ROUNDS);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(round = 0; round < BENCH_ROUNDS; round++)
+    {
+        snprintf_compiled(out, sizeof(out), specs,
+                    (unsigned long long) round * 1000U, round & 7, (int) round - 1000, round & 0xFF);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("bench: snprintf_compiled  %6.1f ns/line\n", elapsed_ns(&start, &end) / BENCH_ROUNDS);
+
+    return 0;
+}
@@ -0,0 +1,183 @@
+/*
+* Host accuracy test of the integer-only %f formatter and of the %k fixed point
+* specifier (printf.c). %f output is compared with glibc for random doubles below
+* 1e9 in magnitude and precisions up to 9, which is what the integer path prints:
+* random bit patterns, decimal fractions and exact ties. %k is
+* compared with glibc printing the same value as a long double, where it is exact.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -DPRINTF_SUPPORT_FIXED_POINT_DECIMAL=1 \
+*       -DPRINTF_SUPPORT_FIXED_POINT_SPECIFIER=1 -IComponents/Utils/printf \
+*       test_printf_float.c Components/Utils/printf/printf.c -lm -o test_printf_float && ./test_printf_float
+*/
+
+#include "printf.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define FLOAT_ROUNDS        300000
+#define FIXED_ROUNDS        200000
+#define REPORTED_MISMATCHES 10
+
+static uint32_t mismatches;
+
+void putchar_(char c)
+{
+    (void) c;
+}
+
+void putblock_(const char* data, size_t len)
+{
+    (void) data;
+    (void) len;
+}
+
+/* Not declared with the printf attribute, the compiler does not know %k */
+static int format(char* s, size_t n, const char* fmt, ...)
+{
+    va_list args;
+    int ret;
+
+    va_start(args, fmt);
+    ret = vsnprintf_(s, n, fmt, args);
+    va_end(args);
+
+    return ret;
+}
+
+static void compare(const char* fmt, const char* value, const char* ours, const char* expected)
+{
+    if(strcmp(ours, expected) != 0)
+    {
+        if(mismatches++ < REPORTED_MISMATCHES)
+        {
+            printf("MISMATCH %s of %s: [%s] glibc [%s]\n", fmt, value, ours, expected);
+        }
+    }
+}
+
+static double random_double(void)
+{
+    uint64_t bits;
+    double value;
+
+    bits = ((uint64_t) rand() << 42) ^ ((uint64_t) rand() << 21) ^ (uint64_t) rand();
+
+    switch(rand() % 4)
+    {
+        case 0:
+            /* Exponents from 2^-40 to 2^30 */
+            bits = (bits & 0x800FFFFFFFFFFFFFULL) | ((uint64_t) (1023 - 40 + rand() % 71) << 52);
+            break;
+        case 1:
+            return (rand() % 2000000 - 1000000) / 1000.0;
+        case 2:
+            /* Exact ties at every precision up to 6 */
+            return (rand() % 20001 - 10000) / 64.0;
+        default:
+            break;
+    }
+
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+int main(void)
+{
+    static const char* formats[] =
+    {
+        "%f", "%.0f", "%.1f", "%.2f", "%.3f", "%.9f", "%#.0f", "%+012.4f", "%-14.5f|", "% .7f",
+        "%F",
+    };
+    static const double specials[] =
+    {
+        0.0, -0.0, 0.5, 1.5, 2.5, -0.5, 1e9, 999999999.9999999, 0.125, 1e-300, 5e-324,
+        -1e-7, 0.05, 0.15, 0.25, 0.35,
+    };
+    static const int32_t q16[] =
+    {
+        0, 1, -1, 32768, -32768, 65536, -65536, 98304, 205887, 21845, INT32_MAX, INT32_MIN,
+    };
+    char ours[128];
+    char expected[128];
+    char value[40];
+    uint32_t round;
+    uint32_t indx;
+    uint32_t compared;
+    int precision;
+    long long q;
+    double x;
+
+    srand(3);
+    compared = 0;
+
+    /* %f against glibc, values below 1e9 take the integer path */
+    for(round = 0; round < FLOAT_ROUNDS; round++)
+    {
+        x = (round < sizeof(specials) / sizeof(specials[0])) ? specials[round] : random_double();
+
+        if(!isfinite(x) || fabs(x) > 1e9)
+        {
+            continue;
+        }
+
+        snprintf(value, sizeof(value), "%.17g", x);
+
+        for(indx = 0; indx < sizeof(formats) / sizeof(formats[0]); indx++)
+        {
+            snprintf_(ours, sizeof(ours), formats[indx], x);
+            snprintf(expected, sizeof(expected), formats[indx], x);
+            compare(formats[indx], value, ours, expected);
+            compared++;
+        }
+    }
+
+    CHECK(mismatches == 0);
+    printf("%%f: %u conversions match glibc\n", compared);
+
+    /* %k, a Q15.16 value has 16 fractional digits at most and is exact as a long double */
+    format(ours, sizeof(ours), "%.12k", 21845);
+    CHECK(strcmp(ours, "0.333328247070") == 0);
+
+    compared = 0;
+
+    for(indx = 0; indx < sizeof(q16) / sizeof(q16[0]); indx++)
+    {
+        for(precision = 0; precision <= 20; precision++)
+        {
+            format(ours, sizeof(ours), "%.*k", precision, q16[indx]);
+            snprintf(expected, sizeof(expected), "%.*Lf", precision, q16[indx] / 65536.0L);
+            snprintf(value, sizeof(value), "%d", q16[indx]);
+            compare("%k", value, ours, expected);
+            compared++;
+        }
+    }
+
+    for(round = 0; round < FIXED_ROUNDS; round++)
+    {
+        /* Up to 2^29 in magnitude, 20 digits and the integral part fit the buffer */
+        q = (long long) ((((uint64_t) rand() << 15) ^ (uint64_t) rand()) & ((1ULL << 46) - 1U)) - 
+                                                                                (1LL << 45);
+        precision = rand() % 21;
+
+        format(ours, sizeof(ours), "%.*llk", precision, q);
+        snprintf(expected, sizeof(expected), "%.*Lf", precision, q / 65536.0L);
+        snprintf(value, sizeof(value), "%lld", q);
+        compare("%llk", value, ours, expected);
+        compared++;
+    }
+
+    CHECK(mismatches == 0);
+    printf("%%k: %u conversions match glibc, up to 20 digits\n", compared);
+
+    return 0;
+}
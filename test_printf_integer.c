@@ -0,0 +1,148 @@
+/*
+* Host test and benchmark of integer conversions in printf.c. Random 8 to 64-bit
+* values are printed with every integer specifier, length, flag, width and precision
+* combination below and compared with glibc, then the time per %llu, %u and %x is
+* measured next to glibc's snprintf.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -IComponents/Utils/printf \
+*       test_printf_integer.c Components/Utils/printf/printf.c -o test_printf_integer && ./test_printf_integer
+*/
+
+#include "printf.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define ROUNDS              200000
+#define BENCH_ROUNDS        2000000
+#define REPORTED_MISMATCHES 10
+
+static uint32_t mismatches;
+static uint32_t compared;
+
+void putchar_(char c)
+{
+    (void) c;
+}
+
+void putblock_(const char* data, size_t len)
+{
+    (void) data;
+    (void) len;
+}
+
+#define COMPARE(fmt, ...)                                                               \
+    do                                                                                  \
+    {                                                                                   \
+        char ours[128];                                                                 \
+        char expected[128];                                                             \
+        snprintf_(ours, sizeof(ours), fmt, __VA_ARGS__);                                \
+        snprintf(expected, sizeof(expected), fmt, __VA_ARGS__);                         \
+        compared++;                                                                     \
+        if(strcmp(ours, expected) != 0 && mismatches++ < REPORTED_MISMATCHES)           \
+        {                                                                               \
+            printf("MISMATCH %s: [%s] glibc [%s]\n", fmt, ours, expected);              \
+        }                                                                               \
+    } while(0)
+
+static uint64_t random_u64(void)
+{
+    uint64_t value;
+
+    value = ((uint64_t) rand() << 62) ^ ((uint64_t) rand() << 31) ^ (uint64_t) rand();
+
+    /* Every magnitude, not only 19 and 20 digit numbers */
+    return value >> (rand() % 64);
+}
+
+static double elapsed_ns(const struct timespec* start, const struct timespec* end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+/* call is run BENCH_ROUNDS times, with indx counting the rounds */
+#define BENCH(name, call)                                                               \
+    do                                                                                  \
+    {                                                                                   \
+        struct timespec start;                                                          \
+        struct timespec end;                                                            \
+        uint32_t indx;                                                                  \
+        clock_gettime(CLOCK_MONOTONIC, &start);                                         \
+        for(indx = 0; indx < BENCH_ROUNDS; indx++)                                      \
+        {                                                                               \
+            call;                                                                       \
+        }                                                                               \
+        clock_gettime(CLOCK_MONOTONIC, &end);                                           \
+        printf("  %-24s %6.1f ns\n", name, elapsed_ns(&start, &end) / BENCH_ROUNDS);   \
+    } while(0)
+
+int main(void)
+{
+    static uint64_t samples[1024];
+    char out[64];
+    uint64_t value;
+    int64_t signed_value;
+    uint32_t round;
+    uint32_t mask;
+
+    srand(1);
+
+    for(round = 0; round < ROUNDS; round++)
+    {
+        value = random_u64();
+        signed_value = (int64_t) value * ((rand() & 1) ? -1 : 1);
+
+        COMPARE("%llu", (unsigned long long) value);
+        COMPARE("%lld", (long long) signed_value);
+        COMPARE("%llx", (unsigned long long) value);
+        COMPARE("%llo", (unsigned long long) value);
+        COMPARE("%#llX", (unsigned long long) value);
+        COMPARE("%020llu", (unsigned long long) value);
+        COMPARE("%-25lld|", (long long) signed_value);
+        COMPARE("%+.22lld", (long long) signed_value);
+        COMPARE("%u", (unsigned int) value);
+        COMPARE("% d", (int) value);
+        COMPARE("%5.3i", (int) value);
+        COMPARE("%#o", (unsigned int) value);
+        COMPARE("%#x", (unsigned int) value);
+        COMPARE("%08lx", (unsigned long) value);
+        COMPARE("%hu", (unsigned short) value);
+        COMPARE("%hhd", (signed char) value);
+    }
+
+    COMPARE("%.0u", 0U);
+    COMPARE("%#.0o", 0U);
+    COMPARE("%#x", 0U);
+    COMPARE("%lld", (long long) INT64_MIN);
+    COMPARE("%llu", (unsigned long long) UINT64_MAX);
+    COMPARE("%llo", (unsigned long long) UINT64_MAX);
+    COMPARE("%d", INT32_MIN);
+
+    CHECK(mismatches == 0);
+    printf("integers: %u conversions match glibc\n", compared);
+
+    /* Same values for both, the index wraps without a division */
+    for(round = 0; round < sizeof(samples) / sizeof(samples[0]); round++)
+    {
+        samples[round] = random_u64();
+    }
+
+    mask = sizeof(samples) / sizeof(samples[0]) - 1U;
+
+    printf("time per conversion:\n");
+    BENCH("%llu", snprintf_(out, sizeof(out), "%llu", (unsigned long long) samples[indx & mask]));
+    BENCH("%llu glibc", snprintf(out, sizeof(out), "%llu", (unsigned long long) samples[indx & mask]));
+    BENCH("%u", snprintf_(out, sizeof(out), "%u", (unsigned int) samples[indx & mask]));
+    BENCH("%u glibc", snprintf(out, sizeof(out), "%u", (unsigned int) samples[indx & mask]));
+    BENCH("%x", snprintf_(out, sizeof(out), "%x", (unsigned int) samples[indx & mask]));
+    BENCH("%x glibc", snprintf(out, sizeof(out), "%x", (unsigned int) samples[indx & mask]));
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+/*
+* Host test of the software timers (soft_timer.c) on the timing wheel, ticked by hand.
+* Thousands of one-shot and periodic timers, from a few ticks to hours long, must each
+* fire on their exact due tick and in tick order, while callbacks restart, stop and
+* stop other timers. Timeouts and periods of 2^31 ms and above are clamped to
+* SOFT_TIMER_MAX_MS instead of wrapping the signed distance and firing at once. The
+* tick counter starts just below its 32-bit wrap.
+*
+* The device header is kept out with its include guard and soft_timer.c is included
+* directly, to start the wheel near the wrap.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_SOFT_TIMER_USE=1 -DCONFIG_TIMER_TICKLESS=0 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_soft_timer.c -o test_soft_timer && ./test_soft_timer
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "Components/Drivers/TIMER/soft_timer.c"
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define TIMERS          10000
+#define TICKS           20000000UL
+#define START_TICK      0xFFFFF000UL
+#define NOT_DUE         UINT32_MAX
+
+static soft_timer_t timers[TIMERS];
+static uint32_t due[TIMERS];            /* Ticks after START_TICK, NOT_DUE when stopped */
+static uint32_t period[TIMERS];
+static uint32_t fired[TIMERS];
+static uint32_t tick;                   /* Tick being processed, from START_TICK */
+static uint32_t last_tick;
+static uint32_t callbacks;
+
+static void wheel_callback(soft_timer_t* p_timer, void* arg)
+{
+    uint32_t indx;
+    uint32_t other;
+
+    indx = (uint32_t) (uintptr_t) arg;
+
+    CHECK(p_timer == &timers[indx]);
+    CHECK(due[indx] == tick);
+    CHECK(tick >= last_tick);
+    last_tick = tick;
+
+    fired[indx]++;
+    callbacks++;
+    due[indx] = period[indx] ? due[indx] + period[indx] : NOT_DUE;
+
+    /* A periodic timer stopping itself */
+    if(indx % 97 == 0 && period[indx] && fired[indx] == 3)
+    {
+        CHECK(soft_timer_stop(p_timer) == OK);
+        due[indx] = NOT_DUE;
+    }
+
+    /* A one-shot timer restarted from its callback, counted from the next tick */
+    if(indx % 101 == 0 && !period[indx] && fired[indx] < 3)
+    {
+        CHECK(soft_timer_start(p_timer, 500, 0) == OK);
+        due[indx] = tick + 1U + 500U;
+    }
+
+    /* Another timer stopped, possibly one due on this same tick */
+    if(indx % 103 == 0)
+    {
+        other = (indx + 1U) % TIMERS;
+
+        if(soft_timer_is_active(&timers[other]))
+        {
+            CHECK(soft_timer_stop(&timers[other]) == OK);
+            due[other] = NOT_DUE;
+        }
+    }
+}
+
+static uint32_t clamp_fired;
+
+static void clamp_callback(soft_timer_t* p_timer, void* arg)
+{
+    (void) p_timer;
+    (void) arg;
+
+    clamp_fired++;
+}
+
+int main(void)
+{
+    soft_timer_t long_timer;
+    soft_timer_t huge_timer;
+    struct timespec start;
+    struct timespec end;
+    uint32_t timeout;
+    uint32_t indx;
+    uint32_t missing;
+    double elapsed_ns;
+
+    CHECK(soft_timer_init(NULL, wheel_callback, NULL) == FAILED);
+    CHECK(soft_timer_init(&long_timer, NULL, NULL) == FAILED);
+    CHECK(soft_timer_start(NULL, 1, 0) == FAILED);
+    CHECK(soft_timer_stop(NULL) == FAILED);
+    CHECK(!soft_timer_is_active(NULL));
+
+    soft_timer_wheel.now = START_TICK;
+    soft_timer_wheel.ticks = START_TICK;
+
+    srand(1);
+
+    for(indx = 0; indx < TIMERS; indx++)
+    {
+        /* Every tenth timer beyond the last wheel level, up to hours long */
+        timeout = (indx % 10 == 0) ? (uint32_t) (rand() % 40000000) : (uint32_t) (rand() % 70000);
+        period[indx] = (indx % 3 == 0) ? 1U + (uint32_t) (rand() % 5000) : 0U;
+
+        CHECK(soft_timer_init(&timers[indx], wheel_callback, (void*) (uintptr_t) indx) == OK);
+        CHECK(soft_timer_start(&timers[indx], timeout, period[indx]) == OK);
+        CHECK(soft_timer_is_active(&timers[indx]));
+        due[indx] = timeout;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    /* Tick k expires on the k + 1th tick interrupt */
+    for(tick = 0; tick < TICKS; tick++)
+    {
+        soft_timer_tick();
+        soft_timer_process();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed_ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+
+    missing = 0;
+
+    for(indx = 0; indx < TIMERS; indx++)
+    {
+        if(due[indx] < TICKS)
+        {
+            missing++;
+        }
+
+        CHECK(soft_timer_is_active(&timers[indx]) == (due[indx] != NOT_DUE));
+    }
+
+    CHECK(missing == 0);
+    CHECK(soft_timer_wheel.now == (uint32_t) (START_TICK + TICKS));
+    printf("wheel: %u timers, %u callbacks on their due tick over %lu ticks through the wrap, "
+                                "%.1f ns/tick\n", TIMERS, callbacks, TICKS, elapsed_ns / TICKS);
+
+    for(indx = 0; indx < TIMERS; indx++)
+    {
+        CHECK(soft_timer_stop(&timers[indx]) == OK);
+    }
+
+    /* 2^31 ms and above, clamped rather than due at once */
+    CHECK(soft_timer_init(&long_timer, clamp_callback, NULL) == OK);
+    CHECK(soft_timer_init(&huge_timer, clamp_callback, NULL) == OK);
+    CHECK(soft_timer_start(&long_timer, 0x80000000UL, 0) == OK);
+    CHECK(soft_timer_start(&huge_timer, 0xFFFFFFF0UL, 0xFFFFFFFFUL) == OK);
+    CHECK(long_timer.expires == soft_timer_wheel.ticks + SOFT_TIMER_MAX_MS);
+    CHECK(huge_timer.period == SOFT_TIMER_MAX_MS);
+
+    for(tick = 0; tick < 100000; tick++)
+    {
+        soft_timer_tick();
+        soft_timer_process();
+    }
+
+    CHECK(clamp_fired == 0);
+    CHECK(soft_timer_is_active(&long_timer) && soft_timer_is_active(&huge_timer));
+
+    /* Up to the tick before SOFT_TIMER_MAX_MS in one go, then the expiry tick */
+    for(; tick < SOFT_TIMER_MAX_MS; tick++)
+    {
+        soft_timer_tick();
+    }
+
+    CHECK(soft_timer_process() == 0 && clamp_fired == 0);
+
+    soft_timer_tick();
+    CHECK(soft_timer_process() == 2 && clamp_fired == 2);
+    CHECK(!soft_timer_is_active(&long_timer) && soft_timer_is_active(&huge_timer));
+    printf("clamp: timeouts of 2^31 ms and above fire after SOFT_TIMER_MAX_MS\n");
+
+    return 0;
+}
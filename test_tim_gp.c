@@ -0,0 +1,478 @@
+/*
+* Host test of the general-purpose timer HAL (TIM_GP_hal.c) against a register image.
+* The TIM2-TIM5, TIM1, TIM8 and RCC register blocks are backed by RAM mapped at their
+* own addresses, the HAL runs unchanged and the registers it leaves behind are checked
+* against RM0390: block offsets, counting modes, CCMR/CCER encodings of compare and
+* capture channels, rc_w0 flag clears that leave other flags alone, and the DMA
+* requests used for capture and update transfers. The DMA HAL is faked and records
+* what it is asked to do.
+*
+* The device header is kept out with its include guard, NVIC is faked below and
+* TIM_GP_hal.c is included directly.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_tim_gp.c -o test_tim_gp && ./test_tim_gp
+*/
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <sys/mman.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+/* From TIM2 up to the end of RCC */
+#define PERIPH_BASE         0x40000000UL
+#define PERIPH_SIZE         0x24000UL
+
+typedef enum
+{
+    TIM1_UP_TIM10_IRQn = 25,
+    TIM1_CC_IRQn = 27,
+    TIM2_IRQn = 28,
+    TIM3_IRQn = 29,
+    TIM4_IRQn = 30,
+    TIM8_UP_TIM13_IRQn = 44,
+    TIM8_CC_IRQn = 46,
+    TIM5_IRQn = 50,
+} IRQn_Type;
+
+static uint64_t nvic_enabled;
+
+static void NVIC_EnableIRQ(IRQn_Type irq)
+{
+    nvic_enabled |= 1ULL << irq;
+}
+
+#include "Components/HAL/TIM_GP/STM32F446/IMP/TIM_GP_hal.c"
+
+void __assert(const char* file, uint32_t line)
+{
+    printf("ASSERT %s:%u\n", file, line);
+    exit(1);
+}
+
+/* DMA HAL fake, one context per stream */
+static dma_hal_context_t fake_streams[2][DMA_STREAM_MAX];
+static uint8_t fake_claimed[2][DMA_STREAM_MAX];
+static uint8_t fake_started_it[2][DMA_STREAM_MAX];
+
+dma_hal_context_t* dma_hal_init(uint8_t dma_instance, uint8_t stream)
+{
+    fake_claimed[dma_instance][stream] = 1;
+    fake_streams[dma_instance][stream].stream = stream;
+
+    return &fake_streams[dma_instance][stream];
+}
+
+dma_hal_context_t* dma_hal_get_claimed(uint8_t dma_instance, uint8_t stream)
+{
+    return fake_claimed[dma_instance][stream] ? &fake_streams[dma_instance][stream] : NULL;
+}
+
+error_t dma_hal_stream_init(dma_hal_context_t* dma)
+{
+    dma->state = DMA_STATE_READY;
+
+    return OK;
+}
+
+error_t dma_hal_set_transfer(dma_hal_context_t* dma, uint32_t src_addr, uint32_t dest_addr,
+                                                                                uint16_t len)
+{
+    dma->reconfig.src_addr = src_addr;
+    dma->reconfig.dest_addr = dest_addr;
+    dma->reconfig.len = len;
+    dma->remaining = len;
+
+    return OK;
+}
+
+error_t dma_hal_start(dma_hal_context_t* dma)
+{
+    dma->state = DMA_STATE_BUSY;
+
+    return OK;
+}
+
+error_t dma_hal_start_it(dma_hal_context_t* dma)
+{
+    fake_started_it[(dma >= fake_streams[DMA2]) ? DMA2 : DMA1][dma->stream] = 1;
+
+    return dma_hal_start(dma);
+}
+
+error_t dma_hal_abort(dma_hal_context_t* dma)
+{
+    dma->state = DMA_STATE_READY;
+
+    return OK;
+}
+
+uint16_t dma_hal_get_remaining_items(dma_hal_context_t* dma)
+{
+    return dma->remaining;
+}
+
+/* Value a write of w leaves in an rc_w0 register holding old */
+static uint32_t rc_w0(uint32_t old, uint32_t w)
+{
+    return old & w;
+}
+
+static uint32_t update_calls;
+static uint32_t channel_calls[TIM_GP_CHANNEL_MAX];
+
+static void update_callback(tim_gp_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    update_calls++;
+}
+
+static void channel_callback(tim_gp_hal_context_t* p_timer, uint8_t channel)
+{
+    (void) p_timer;
+
+    channel_calls[channel]++;
+}
+
+static void check_layout(void)
+{
+    /* RM0390 18.4.21 and 17.4.21, TIMx register maps */
+    CHECK(offsetof(struct TIM_GP_PERIPH, cr1) == 0x00);
+    CHECK(offsetof(struct TIM_GP_PERIPH, smcr) == 0x08);
+    CHECK(offsetof(struct TIM_GP_PERIPH, dier) == 0x0C);
+    CHECK(offsetof(struct TIM_GP_PERIPH, sr) == 0x10);
+    CHECK(offsetof(struct TIM_GP_PERIPH, egr) == 0x14);
+    CHECK(offsetof(struct TIM_GP_PERIPH, ccmr) == 0x18);
+    CHECK(offsetof(struct TIM_GP_PERIPH, ccer) == 0x20);
+    CHECK(offsetof(struct TIM_GP_PERIPH, cnt) == 0x24);
+    CHECK(offsetof(struct TIM_GP_PERIPH, psc) == 0x28);
+    CHECK(offsetof(struct TIM_GP_PERIPH, arr) == 0x2C);
+    CHECK(offsetof(struct TIM_GP_PERIPH, rcr) == 0x30);
+    CHECK(offsetof(struct TIM_GP_PERIPH, ccr) == 0x34);
+    CHECK(offsetof(struct TIM_GP_PERIPH, bdtr) == 0x44);
+    CHECK(offsetof(struct TIM_GP_PERIPH, dcr) == 0x48);
+    CHECK(offsetof(struct TIM_GP_PERIPH, dmar) == 0x4C);
+    CHECK(offsetof(struct TIM_GP_PERIPH, or) == 0x50);
+
+    CHECK(TIM_GP_LL_GET_HW(TIM_GP_HAL_INDEX(TIM_GP_TIM2)) == _TIM2);
+    CHECK(TIM_GP_LL_GET_HW(TIM_GP_HAL_INDEX(TIM_GP_TIM5)) == _TIM5);
+    CHECK(TIM_GP_LL_GET_HW(TIM_GP_HAL_INDEX(TIM_GP_TIM1)) == _TIM1);
+    CHECK(TIM_GP_LL_GET_HW(TIM_GP_HAL_INDEX(TIM_GP_TIM8)) == _TIM8);
+}
+
+static void check_init(void)
+{
+    static const struct
+    {
+        uint8_t tim;
+        uint8_t apb2;
+        uint32_t rcc_bit;
+        IRQn_Type irq;
+    } timers[] =
+    {
+        {TIM_GP_TIM2, 0, 0, TIM2_IRQn},
+        {TIM_GP_TIM3, 0, 1, TIM3_IRQn},
+        {TIM_GP_TIM4, 0, 2, TIM4_IRQn},
+        {TIM_GP_TIM5, 0, 3, TIM5_IRQn},
+        {TIM_GP_TIM1, 1, 0, TIM1_CC_IRQn},
+        {TIM_GP_TIM8, 1, 1, TIM8_CC_IRQn},
+    };
+    tim_gp_config_t config;
+    tim_gp_hal_context_t* p_timer;
+    rcc_dev_t rcc;
+    uint32_t indx;
+    uint8_t mode;
+
+    rcc = RCC_LL_GET_HW(0);
+
+    memset(&config, 0, sizeof(config));
+    config.prescaler = 15;
+    config.reload = 0x10000;
+
+    /* Only TIM2 and TIM5 take a reload past 16 bits */
+    CHECK(tim_gp_hal_init(TIM_GP_TIM3, &config) == NULL);
+    CHECK(tim_gp_hal_init(TIM_GP_TIM2, &config) != NULL);
+    CHECK(tim_gp_hal_init(6, &config) == NULL);
+    CHECK(tim_gp_hal_init(TIM_GP_TIM2, NULL) == NULL);
+
+    config.reload = 999;
+    config.count_mode = TIM_GP_COUNT_MAX;
+    CHECK(tim_gp_hal_init(TIM_GP_TIM2, &config) == NULL);
+
+    for(indx = 0; indx < sizeof(timers) / sizeof(timers[0]); indx++)
+    {
+        for(mode = TIM_GP_COUNT_UP; mode < TIM_GP_COUNT_MAX; mode++)
+        {
+            config.count_mode = mode;
+            config.callback = (mode == TIM_GP_COUNT_UP) ? update_callback : NULL;
+
+            p_timer = tim_gp_hal_init(timers[indx].tim, &config);
+            CHECK(p_timer);
+            p_timer->dev->sr = 0x1F;        /* Stale flags from before */
+
+            p_timer = tim_gp_hal_init(timers[indx].tim, &config);
+            CHECK(p_timer && p_timer->dev == TIM_GP_LL_GET_HW(TIM_GP_HAL_INDEX(timers[indx].tim)));
+
+            CHECK(!(p_timer->dev->cr1 & TIM_GP_CR1_CEN_S));
+            CHECK(p_timer->dev->cr1 & TIM_GP_CR1_ARPE_S);
+            CHECK(p_timer->dev->cr1 & TIM_GP_CR1_URS_S);
+            CHECK(p_timer->dev->psc == 15 && p_timer->dev->arr == 999 && p_timer->dev->cnt == 0);
+            CHECK(p_timer->dev->egr & TIM_GP_EGR_UG_S);
+            CHECK(p_timer->dev->sr == 0);
+            CHECK(!!(p_timer->dev->dier & TIM_GP_DIER_UIE_S) == (mode == TIM_GP_COUNT_UP));
+            CHECK(!!(p_timer->dev->bdtr & TIM_GP_BDTR_MOE_S) == timers[indx].apb2);
+
+            /* CMS 00 with DIR for edge aligned, CMS 01 to 11 for center aligned */
+            switch(mode)
+            {
+                case TIM_GP_COUNT_UP:
+                    CHECK((p_timer->dev->cr1 & 0x70) == 0x00);
+                    break;
+                case TIM_GP_COUNT_DOWN:
+                    CHECK((p_timer->dev->cr1 & 0x70) == 0x10);
+                    break;
+                default:
+                    CHECK(((p_timer->dev->cr1 >> 5) & 3) == (uint32_t) (mode - TIM_GP_COUNT_DOWN));
+                    break;
+            }
+        }
+
+        CHECK(((timers[indx].apb2 ? rcc->apb2_enr : rcc->apb1_enr) >> timers[indx].rcc_bit) & 1);
+        CHECK(nvic_enabled & (1ULL << timers[indx].irq));
+    }
+
+    CHECK(nvic_enabled & (1ULL << TIM1_UP_TIM10_IRQn) && nvic_enabled & (1ULL << TIM8_UP_TIM13_IRQn));
+    printf("init: 6 timers, 5 counting modes, RCC and NVIC\n");
+}
+
+static void check_channels(void)
+{
+    tim_gp_config_t config;
+    tim_gp_hal_context_t* p_timer;
+    uint32_t byte;
+    uint32_t ccer;
+    uint8_t channel;
+    uint8_t mode;
+    uint8_t edge;
+
+    memset(&config, 0, sizeof(config));
+    config.reload = 0xFFFF;
+    p_timer = tim_gp_hal_init(TIM_GP_TIM3, &config);
+    CHECK(p_timer);
+
+    CHECK(tim_gp_hal_config_compare(p_timer, 4, TIM_GP_OC_PWM1, 0, 0) == FAILED);
+    CHECK(tim_gp_hal_config_compare(p_timer, 0, TIM_GP_OC_MAX, 0, 0) == FAILED);
+    CHECK(tim_gp_hal_config_compare(p_timer, 0, TIM_GP_OC_PWM1, 0x10000, 0) == FAILED);
+    CHECK(tim_gp_hal_set_compare(p_timer, 0, 0x10000) == FAILED);
+    CHECK(tim_gp_hal_set_reload(p_timer, 0x10000) == FAILED);
+
+    /* Compare: OCxM and OCxPE in the channel byte of CCMR1 or CCMR2, CCxE and CCxP in CCER */
+    for(channel = 0; channel < TIM_GP_CHANNEL_MAX; channel++)
+    {
+        for(mode = 0; mode < TIM_GP_OC_MAX; mode++)
+        {
+            p_timer->dev->ccmr[0] = 0;
+            p_timer->dev->ccmr[1] = 0;
+            p_timer->dev->ccer = 0;
+
+            CHECK(tim_gp_hal_config_compare(p_timer, channel, mode, 1000U + channel,
+                                                    mode & 1 ? TIM_GP_POLARITY_LOW : TIM_GP_POLARITY_HIGH) == OK);
+
+            byte = (p_timer->dev->ccmr[channel / 2] >> ((channel % 2) * 8)) & 0xFF;
+            CHECK(byte == (((uint32_t) mode << 4) | ((mode >= TIM_GP_OC_PWM1) ? 0x08U : 0U)));
+            CHECK(p_timer->dev->ccmr[1 - channel / 2] == 0);
+            CHECK((p_timer->dev->ccmr[channel / 2] & ~(0xFFU << ((channel % 2) * 8))) == 0);
+
+            ccer = p_timer->dev->ccer;
+            CHECK(ccer == ((1U | ((mode & 1) ? 2U : 0U)) << (channel * 4)));
+            CHECK(p_timer->dev->ccr[channel] == 1000U + channel);
+        }
+
+        CHECK(tim_gp_hal_set_compare(p_timer, channel, 77) == OK && p_timer->dev->ccr[channel] == 77);
+    }
+
+    printf("compare: OCxM, OCxPE, CCxE and CCxP of every channel and mode\n");
+
+    /* Capture: CCxS = 01, ICxPSC and ICxF, CCxP/CCxNP 00 rising, 01 falling, 11 both */
+    for(channel = 0; channel < TIM_GP_CHANNEL_MAX; channel++)
+    {
+        for(edge = 0; edge < TIM_GP_EDGE_MAX; edge++)
+        {
+            p_timer->dev->ccmr[0] = 0xFFFFFFFFU;
+            p_timer->dev->ccmr[1] = 0xFFFFFFFFU;
+            p_timer->dev->ccer = 0xFFFFU & ~(0xFU << (channel * 4));
+
+            CHECK(tim_gp_hal_config_capture(p_timer, channel, edge, TIM_GP_IC_DIV_4, 9) == OK);
+
+            byte = (p_timer->dev->ccmr[channel / 2] >> ((channel % 2) * 8)) & 0xFF;
+            CHECK(byte == ((9U << 4) | (TIM_GP_IC_DIV_4 << 2) | 1U));
+
+            /* Other channels untouched */
+            CHECK((p_timer->dev->ccmr[channel / 2] | (0xFFU << ((channel % 2) * 8))) == 0xFFFFFFFFU);
+            CHECK(((p_timer->dev->ccer >> (channel * 4)) & 0xF) ==
+                    (1U | ((edge != TIM_GP_EDGE_RISING) ? 2U : 0U) | ((edge == TIM_GP_EDGE_BOTH) ? 8U : 0U)));
+            CHECK((p_timer->dev->ccer | (0xFU << (channel * 4))) == 0xFFFFU);
+        }
+    }
+
+    CHECK(tim_gp_hal_config_capture(p_timer, 0, TIM_GP_EDGE_MAX, 0, 0) == FAILED);
+    CHECK(tim_gp_hal_config_capture(p_timer, 0, 0, TIM_GP_IC_DIV_MAX, 0) == FAILED);
+    CHECK(tim_gp_hal_config_capture(p_timer, 0, 0, 0, 16) == FAILED);
+    printf("capture: CCxS, ICxPSC, ICxF, CCxP and CCxNP of every channel and edge\n");
+}
+
+static void check_flags(void)
+{
+    tim_gp_config_t config;
+    tim_gp_hal_context_t* p_timer;
+    uint32_t pending;
+    uint8_t channel;
+
+    memset(&config, 0, sizeof(config));
+    config.reload = 100;
+    config.callback = update_callback;
+    config.channel_callback = channel_callback;
+    p_timer = tim_gp_hal_init(TIM_GP_TIM4, &config);
+    CHECK(p_timer);
+
+    /* Each clear writes 0 to its own flag only, rc_w0 leaves the others set */
+    pending = 0x1E5FU;
+
+    p_timer->dev->sr = pending;
+    TIM_GP_LL_CLEAR_UPDATE_FLAG(p_timer->dev);
+    CHECK(rc_w0(pending, p_timer->dev->sr) == (pending & ~TIM_GP_SR_UIF_S));
+
+    for(channel = 0; channel < TIM_GP_CHANNEL_MAX; channel++)
+    {
+        p_timer->dev->sr = pending;
+        TIM_GP_LL_CLEAR_CC_FLAG(p_timer->dev, channel);
+        CHECK(rc_w0(pending, p_timer->dev->sr) == (pending & ~(TIM_GP_SR_CC1IF_S << channel)));
+
+        p_timer->dev->sr = pending;
+        TIM_GP_LL_CLEAR_OVERCAPTURE_FLAG(p_timer->dev, channel);
+        CHECK(rc_w0(pending, p_timer->dev->sr) == (pending & ~(TIM_GP_SR_CC1OF_S << channel)));
+    }
+
+    /* One flag at a time, RAM keeps the 1s a clear writes to the other flags */
+    p_timer->dev->sr = TIM_GP_SR_UIF_S;
+    tim4_irq_handler();
+    CHECK(update_calls == 1);
+    CHECK(p_timer->dev->sr == (uint32_t) ~TIM_GP_SR_UIF_S);
+
+    CHECK(tim_gp_hal_enable_channel_it(p_timer, 2) == OK);
+    CHECK(p_timer->dev->dier & (TIM_GP_DIER_CC1IE_S << 2));
+
+    p_timer->dev->sr = TIM_GP_SR_CC1IF_S << 2;
+    tim4_irq_handler();
+    CHECK(channel_calls[2] == 1);
+    CHECK(p_timer->dev->sr == (uint32_t) ~(TIM_GP_SR_CC1IF_S << 2));
+
+    /* A flag of a channel without its interrupt is left to polling */
+    p_timer->dev->sr = TIM_GP_SR_CC1IF_S << 1;
+    tim4_irq_handler();
+    CHECK(channel_calls[1] == 0 && p_timer->dev->sr == (TIM_GP_SR_CC1IF_S << 1));
+
+    CHECK(tim_gp_hal_disable_channel_it(p_timer, 2) == OK);
+    CHECK(!(p_timer->dev->dier & (TIM_GP_DIER_CC1IE_S << 2)));
+    printf("flags: rc_w0 clears, update and channel interrupts\n");
+}
+
+static void check_dma(void)
+{
+    static uint32_t captures32[64];
+    static uint16_t captures16[64];
+    static const uint32_t words[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    tim_gp_config_t config;
+    tim_gp_hal_context_t* tim2;
+    tim_gp_hal_context_t* tim4;
+    tim_gp_hal_context_t* tim1;
+    dma_hal_context_t* dma;
+
+    memset(&config, 0, sizeof(config));
+    config.reload = 0xFFFFFFFFU;
+    tim2 = tim_gp_hal_init(TIM_GP_TIM2, &config);
+    config.reload = 0xFFFF;
+    tim4 = tim_gp_hal_init(TIM_GP_TIM4, &config);
+    tim1 = tim_gp_hal_init(TIM_GP_TIM1, &config);
+    CHECK(tim2 && tim4 && tim1);
+
+    /* TIM2 CH1 on DMA1 stream 5 channel 3, 32-bit captures from CCR1 */
+    CHECK(tim_gp_hal_start_capture_dma(tim2, 0, captures32, 64) == OK);
+    dma = tim2->capture_dma[0];
+    CHECK(dma == &fake_streams[DMA1][DMA_STREAM_5] && dma->dma_config.channel == DMA_CHANNEL_3);
+    CHECK(dma->dma_config.dir == DMA_PERIPH_TO_MEM && dma->dma_config.mode == DMA_MODE_DIRECT_CIRC);
+    CHECK(dma->dma_config.periph_data_size == DMA_PERIPH_SIZE_WORD);
+    CHECK(dma->dma_config.mem_data_size == DMA_MEM_SIZE_WORD);
+    CHECK(dma->reconfig.src_addr == (uint32_t) (uintptr_t) &tim2->dev->ccr[0]);
+    CHECK(dma->reconfig.src_addr == PERIPH_BASE + 0x34);
+    CHECK(dma->reconfig.len == 64 && dma->state == DMA_STATE_BUSY);
+    CHECK(tim2->dev->dier & TIM_GP_DIER_CC1DE_S);
+
+    /* Write position from NDTR, len reads as index 0 */
+    CHECK(tim_gp_hal_get_capture_dma_index(tim2, 0) == 0);
+    dma->remaining = 50;
+    CHECK(tim_gp_hal_get_capture_dma_index(tim2, 0) == 14);
+    dma->remaining = 1;
+    CHECK(tim_gp_hal_get_capture_dma_index(tim2, 0) == 63);
+
+    CHECK(tim_gp_hal_stop_capture_dma(tim2, 0) == OK);
+    CHECK(!(tim2->dev->dier & TIM_GP_DIER_CC1DE_S));
+    CHECK(tim_gp_hal_get_capture_dma_index(tim2, 0) == 0);
+
+    /* TIM4 is 16 bits and CH4 has no request */
+    CHECK(tim_gp_hal_start_capture_dma(tim4, 3, captures16, 64) == FAILED);
+    CHECK(tim_gp_hal_start_capture_dma(tim4, 1, captures16, 64) == OK);
+    dma = tim4->capture_dma[1];
+    CHECK(dma == &fake_streams[DMA1][DMA_STREAM_3] && dma->dma_config.channel == DMA_CHANNEL_2);
+    CHECK(dma->dma_config.periph_data_size == DMA_PERIPH_SIZE_HALF_WORD);
+    CHECK(dma->reconfig.src_addr == (uint32_t) (uintptr_t) &tim4->dev->ccr[1]);
+
+    /* A stream claimed by another driver is refused */
+    fake_claimed[DMA2][DMA_STREAM_1] = 1;
+    fake_streams[DMA2][DMA_STREAM_1].parent = (void*) &fake_claimed;
+    CHECK(tim_gp_hal_start_capture_dma(tim1, 0, captures16, 64) == FAILED);
+
+    /* One-shot update DMA to a register, counter started from 0 */
+    CHECK(tim_gp_hal_start_update_dma(tim1, 0x40020018UL, words, 8, 0, NULL) == OK);
+    dma = tim1->update_dma;
+    CHECK(dma == &fake_streams[DMA2][DMA_STREAM_5] && dma->dma_config.channel == DMA_CHANNEL_6);
+    CHECK(dma->dma_config.dir == DMA_MEM_TO_PERIPH && dma->dma_config.mode == DMA_MODE_DIRECT);
+    CHECK(dma->reconfig.dest_addr == 0x40020018UL && dma->reconfig.len == 8);
+    CHECK(fake_started_it[DMA2][DMA_STREAM_5]);
+    CHECK(tim1->dev->dier & TIM_GP_DIER_UDE_S && tim1->dev->cr1 & TIM_GP_CR1_CEN_S);
+    CHECK(tim_gp_hal_is_update_dma_busy(tim1));
+
+    /* Its completion stops the counter */
+    dma->xfer_complete_callback(dma);
+    CHECK(!(tim1->dev->cr1 & TIM_GP_CR1_CEN_S) && !(tim1->dev->dier & TIM_GP_DIER_UDE_S));
+    CHECK(!tim_gp_hal_is_update_dma_busy(tim1));
+
+    printf("dma: capture and update requests, data sizes and write index\n");
+}
+
+int main(void)
+{
+    void* periph;
+
+    periph = mmap((void*) PERIPH_BASE, PERIPH_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    CHECK(periph == (void*) PERIPH_BASE);
+
+    check_layout();
+    check_init();
+    check_channels();
+    check_flags();
+    check_dma();
+
+    return 0;
+}
@@ -0,0 +1,252 @@
+/*
+* Host test of the cycle clock (timer.c): timer_get_cycles, timer_get_us, timer_get_ns
+* and timer_get_milliseconds extend the 32-bit DWT cycle counter to 64 bits with the
+* epoch published by the TIM7 tick. The simulated counter runs through many 2^32
+* wraps. The tick is run from inside the reader at every barrier of timer_get_cycles
+* in turn, a reader runs from inside the tick at each of its barriers, as interrupts
+* would, and a SIGALRM-driven tick interrupts a reading loop anywhere. Each read must
+* fall between the counter values before and after the call and never go backwards.
+*
+* The device header is kept out with its include guard, the DWT and CoreDebug
+* registers and the barriers are provided below, and timer.c is included directly.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_SOFT_TIMER_USE=0 -DCONFIG_TIMER_TICKLESS=0 \
+*       $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_timer.c -o test_timer && ./test_timer
+*/
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+#define READS           50000000UL
+#define SIGNAL_READS    50000000UL
+#define BARRIERS        2U          /* __DMB calls of one timer_get_cycles loop */
+
+struct fake_dwt_t
+{
+    uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+};
+
+struct fake_core_debug_t
+{
+    uint32_t DEMCR;
+};
+
+static struct fake_dwt_t fake_dwt;
+static struct fake_core_debug_t fake_core_debug;
+
+#define DWT                         (&fake_dwt)
+#define CoreDebug                   (&fake_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define DWT_CTRL_NOCYCCNT_Msk       (1UL << 25)
+
+static void fake_barrier(void);
+
+#define __DMB()                     fake_barrier()
+
+static uint64_t sim_cycles;         /* The counter CYCCNT is the low half of */
+static uint32_t cycles_per_barrier; /* Time passing between two reads of the reader */
+static uint32_t tick_at;            /* Barrier the tick interrupts, 0: none */
+static uint32_t barriers;
+static uint8_t in_tick;
+static uint8_t in_nested_read;
+static uint32_t ticks;
+static uint32_t nested_reads;
+static volatile uint32_t signal_ticks;
+
+#include "Components/Drivers/TIMER/timer.c"
+
+static void sim_advance(uint64_t cycles)
+{
+    sim_cycles += cycles;
+    fake_dwt.CYCCNT = (uint32_t) sim_cycles;
+}
+
+static void fake_barrier(void)
+{
+    uint64_t now;
+
+    if(in_nested_read)
+    {
+        return;
+    }
+
+    /* A higher priority reader interrupting the tick, either epoch copy may be in use */
+    if(in_tick)
+    {
+        in_nested_read = 1;
+        now = timer_get_cycles();
+        in_nested_read = 0;
+
+        CHECK(now == sim_cycles);
+        nested_reads++;
+
+        return;
+    }
+
+    sim_advance(cycles_per_barrier);
+
+    if(++barriers == tick_at)
+    {
+        in_tick = 1;
+        timer_one_millisecond_passed(NULL);
+        in_tick = 0;
+        ticks++;
+    }
+}
+
+static void signal_tick(int sig)
+{
+    (void) sig;
+
+    timer_one_millisecond_passed(NULL);
+    signal_ticks++;
+}
+
+tim_basic_hal_context_t* tim_basic_hal_init(uint8_t tim, tim_basic_config_t* config)
+{
+    static struct TIM_BASIC_HAL_CONTEXT context;
+
+    CHECK(tim == TIM_BASIC_TIM7);
+    context.callback = config->callback;
+
+    return &context;
+}
+
+error_t tim_basic_hal_start(tim_basic_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    return OK;
+}
+
+error_t tim_basic_hal_start_once(tim_basic_hal_context_t* p_timer, uint16_t reload)
+{
+    (void) p_timer;
+    (void) reload;
+
+    return OK;
+}
+
+int main(void)
+{
+    struct itimerval interval = {{0, 20}, {0, 20}};
+    ms_timer_t ms_timer;
+    uint64_t before;
+    uint64_t prev;
+    uint64_t now;
+    uint64_t exact;
+    uint32_t wraps;
+    uint32_t indx;
+    unsigned long reads;
+
+    CHECK(timer_time_base_init() == OK);
+    CHECK(fake_dwt.CTRL & DWT_CTRL_CYCCNTENA_Msk);
+    CHECK(fake_core_debug.DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+    CHECK(timer_get_cycles() == 0);
+
+    /* Start just below a wrap */
+    sim_advance(0xFFFFF000UL);
+    timer_one_millisecond_passed(NULL);
+
+    srand(5);
+    prev = 0;
+    wraps = 0;
+
+    for(reads = 0; reads < READS; reads++)
+    {
+        /* Between ticks well under 2^32 cycles pass, as with the 1 ms tick */
+        cycles_per_barrier = 1U + (uint32_t) (rand() % 2000);
+        sim_advance((uint64_t) (rand() % 4000));
+
+        /* The tick runs from the reader every fourth read, at each barrier in turn */
+        barriers = 0;
+        tick_at = (reads % 4U) ? 0U : 1U + (uint32_t) (reads / 4U) % BARRIERS;
+
+        before = sim_cycles;
+        now = timer_get_cycles();
+
+        CHECK(now >= before && now <= sim_cycles);
+        CHECK(now >= prev);
+        prev = now;
+
+        if(!tick_at)
+        {
+            timer_one_millisecond_passed(NULL);
+        }
+    }
+
+    wraps = (uint32_t) (sim_cycles >> 32);
+    CHECK(wraps > 10);
+    printf("timer_get_cycles: %lu reads over %u wraps, %u ticks inside the reader, "
+                        "%u reads inside the tick\n", reads, wraps, ticks, nested_reads);
+
+    /* The tick interrupts the reader at any instruction */
+    cycles_per_barrier = 0;
+    tick_at = 0;
+    wraps = (uint32_t) (sim_cycles >> 32);
+
+    signal(SIGALRM, signal_tick);
+    setitimer(ITIMER_REAL, &interval, NULL);
+
+    for(reads = 0; reads < SIGNAL_READS; reads++)
+    {
+        sim_advance(1013U);
+        now = timer_get_cycles();
+
+        CHECK(now >= prev);
+        prev = now;
+    }
+
+    interval.it_value.tv_usec = 0;
+    interval.it_interval.tv_usec = 0;
+    setitimer(ITIMER_REAL, &interval, NULL);
+
+    CHECK(prev == sim_cycles);
+    wraps = (uint32_t) (sim_cycles >> 32) - wraps;
+    CHECK(wraps > 10 && signal_ticks > 1000);
+    printf("timer_get_cycles: %lu reads over %u wraps, %u ticks from SIGALRM\n",
+                                                                reads, wraps, signal_ticks);
+
+    /* The derived clocks, with the counter standing still */
+    for(indx = 0; indx < 1000; indx++)
+    {
+        /* Up to nearly 2^32 cycles, the tick never misses a wrap */
+        sim_advance((uint64_t) rand() * 2U);
+        timer_one_millisecond_passed(NULL);
+        exact = sim_cycles;
+
+        CHECK(timer_get_cycles() == exact);
+        CHECK(timer_get_us() == exact / TIMER_CYCLES_PER_US);
+        CHECK(timer_get_ns() == exact * 1000U / TIMER_CYCLES_PER_US);
+        CHECK(timer_get_milliseconds() == exact / TIMER_CYCLES_PER_MS);
+        CHECK(timer_cycles_to_us(exact) == exact / TIMER_CYCLES_PER_US);
+    }
+
+    printf("timer_get_us, timer_get_ns, timer_get_milliseconds: exact\n");
+
+    /* Millisecond timers on top */
+    CHECK(timer_clear(&ms_timer) == OK);
+    CHECK(!timer_is_started(&ms_timer));
+    CHECK(timer_elapsed(&ms_timer) == 0);
+    CHECK(timer_start(&ms_timer) == OK);
+
+    sim_advance(1234ULL * TIMER_CYCLES_PER_MS + TIMER_CYCLES_PER_MS / 2U);
+    timer_one_millisecond_passed(NULL);
+
+    CHECK(timer_is_started(&ms_timer));
+    CHECK(timer_elapsed(&ms_timer) == 1234 || timer_elapsed(&ms_timer) == 1235);
+    CHECK(timer_start(NULL) == FAILED && timer_clear(NULL) == FAILED);
+    printf("ms_timer_t: elapsed time follows the cycle clock\n");
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+* Host test of the tickless time base (timer.c and soft_timer.c with
+* CONFIG_TIMER_TICKLESS). TIM7 is simulated as a one-shot microsecond timer on the
+* simulated DWT cycle counter: it interrupts only when it was armed for, and the main
+* loop runs soft_timer_process a fixed latency after each interrupt. Over ten minutes of
+* simulated time, through two counter wraps, thousands of soft timers must never fire
+* early nor more than a few microseconds late, with far fewer interrupts than a 1 kHz
+* tick. With nothing to do the time base must only wake up to keep the counter epoch,
+* and timer_wakeup_at_us must interrupt on the requested microsecond.
+*
+* The device header is kept out with its include guard, the DWT and CoreDebug registers,
+* barriers and PRIMASK are provided below, and both sources are included directly.
+*
+* Build and run from the repository root:
+*   gcc -std=gnu99 -O2 -Wall -D__STM32F446XX_H__ -DCONFIG_SOFT_TIMER_USE=1 -DCONFIG_TIMER_TICKLESS=1 \
+*       -DCONFIG_OS_FREERTOS_USE=0 $(find Components -type d -not -path '*FreeRTOS*' | sed 's/^/-I/') \
+*       test_timer_tickless.c -o test_timer_tickless && ./test_timer_tickless
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(x)    do { if(!(x)) { printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #x); \
+                                                                    exit(1); } } while(0)
+
+struct fake_dwt_t
+{
+    uint32_t CTRL;
+    volatile uint32_t CYCCNT;
+};
+
+struct fake_core_debug_t
+{
+    uint32_t DEMCR;
+};
+
+static struct fake_dwt_t fake_dwt;
+static struct fake_core_debug_t fake_core_debug;
+
+#define DWT                         (&fake_dwt)
+#define CoreDebug                   (&fake_core_debug)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk      (1UL << 0)
+#define DWT_CTRL_NOCYCCNT_Msk       (1UL << 25)
+
+#define __DMB()                     do { } while(0)
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return 0;
+}
+
+static inline void __disable_irq(void)
+{
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    (void) primask;
+}
+
+#include "Components/Drivers/TIMER/timer.c"
+#include "Components/Drivers/TIMER/soft_timer.c"
+
+#define TIMERS              2000
+#define RUN_CYCLES          (600ULL * TIMER_CORE_CLOCK_HZ)      /* Ten minutes */
+#define WAKEUP_LATENCY      40U         /* Cycles from the interrupt to soft_timer_process */
+#define MAX_LATE_CYCLES     (4U * TIMER_CYCLES_PER_US)
+#define NEVER               UINT64_MAX
+
+static struct TIM_BASIC_HAL_CONTEXT tim7;
+static uint64_t sim_cycles;
+static uint64_t fire_at = NEVER;        /* Cycle the armed TIM7 shot ends on */
+static uint32_t interrupts;
+
+static soft_timer_t timers[TIMERS];
+static uint32_t fires;
+static uint32_t early;
+static uint64_t late_max;
+static uint64_t late_sum;
+
+static void sim_advance_to(uint64_t cycles)
+{
+    CHECK(cycles >= sim_cycles);
+
+    sim_cycles = cycles;
+    fake_dwt.CYCCNT = (uint32_t) sim_cycles;
+}
+
+tim_basic_hal_context_t* tim_basic_hal_init(uint8_t tim, tim_basic_config_t* config)
+{
+    CHECK(tim == TIM_BASIC_TIM7);
+    CHECK(config->prescaler == TIMER_CYCLES_PER_US - 1U);
+    tim7.callback = config->callback;
+
+    return &tim7;
+}
+
+error_t tim_basic_hal_start(tim_basic_hal_context_t* p_timer)
+{
+    (void) p_timer;
+
+    /* Free running is the 1 kHz tick, never used when tickless */
+    CHECK(0);
+
+    return FAILED;
+}
+
+error_t tim_basic_hal_start_once(tim_basic_hal_context_t* p_timer, uint16_t reload)
+{
+    CHECK(p_timer == &tim7);
+
+    /* Rearming replaces the running shot */
+    fire_at = sim_cycles + ((uint64_t) reload + 1U) * TIMER_CYCLES_PER_US;
+
+    return OK;
+}
+
+/* The TIM7 interrupt */
+static void sim_interrupt(void)
+{
+    sim_advance_to(fire_at);
+    fire_at = NEVER;
+    interrupts++;
+    tim7.callback(&tim7);
+}
+
+static void timer_callback(soft_timer_t* p_timer, void* arg)
+{
+    uint64_t due;
+    uint64_t now_ms;
+    uint32_t expires;
+
+    (void) arg;
+
+    /* A periodic timer has already moved on to its next expiry */
+    expires = p_timer->period ? p_timer->expires - p_timer->period : p_timer->expires;
+
+    /* Expiry tick k is over once the millisecond clock reaches k + 1 */
+    now_ms = sim_cycles / TIMER_CYCLES_PER_MS;
+    due = (now_ms + (int32_t) (expires + 1U - (uint32_t) now_ms)) * TIMER_CYCLES_PER_MS;
+
+    if(sim_cycles < due)
+    {
+        early++;
+    }
+    else
+    {
+        late_max = (sim_cycles - due > late_max) ? sim_cycles - due : late_max;
+        late_sum += sim_cycles - due;
+    }
+
+    fires++;
+
+    if(!p_timer->period)
+    {
+        soft_timer_start(p_timer, 1U + (uint32_t) (rand() % 20000), 0);
+    }
+}
+
+int main(void)
+{
+    uint64_t idle_start;
+    uint64_t wakeup_us;
+    uint32_t indx;
+
+    srand(3);
+
+    CHECK(timer_wakeup_at_us(1000) == FAILED);
+    CHECK(timer_time_base_init() == OK);
+
+    /* Idle, only the longest shot keeps the counter epoch */
+    idle_start = sim_cycles;
+
+    while(sim_cycles < idle_start + 10ULL * TIMER_CORE_CLOCK_HZ)
+    {
+        sim_interrupt();
+    }
+
+    CHECK(interrupts == (10000000U + TIMER_TICKLESS_MAX_US - 1U) / TIMER_TICKLESS_MAX_US);
+    printf("idle: %u interrupts in 10 s\n", interrupts);
+
+    /* A wake-up on an exact microsecond */
+    wakeup_us = timer_get_us() + 12345U;
+    CHECK(timer_wakeup_at_us(wakeup_us) == OK);
+    sim_interrupt();
+    CHECK(sim_cycles == wakeup_us * TIMER_CYCLES_PER_US);
+    CHECK(timer_get_us() == wakeup_us);
+    printf("timer_wakeup_at_us: on the requested microsecond\n");
+
+    /* Soft timers, a quarter of them periodic */
+    for(indx = 0; indx < TIMERS; indx++)
+    {
+        CHECK(soft_timer_init(&timers[indx], timer_callback, NULL) == OK);
+        CHECK(soft_timer_start(&timers[indx], 1U + (uint32_t) (rand() % 20000),
+                                (indx % 4 == 0) ? 50U + (uint32_t) (rand() % 2000) : 0U) == OK);
+    }
+
+    soft_timer_process();
+    interrupts = 0;
+
+    while(sim_cycles < RUN_CYCLES)
+    {
+        CHECK(fire_at != NEVER);
+        sim_interrupt();
+        sim_advance_to(sim_cycles + WAKEUP_LATENCY);
+        soft_timer_process();
+    }
+
+    CHECK(sim_cycles >> 32 >= 2);
+    CHECK(fires > 100000);
+    CHECK(early == 0);
+    CHECK(late_max <= MAX_LATE_CYCLES);
+    CHECK(interrupts < 600000);
+    printf("10 min: %u interrupts (1 kHz tick: 600000), %u expiries, none early, "
+            "late max %.2f us avg %.2f us\n", interrupts, fires, late_max / (double) TIMER_CYCLES_PER_US,
+            late_sum / (double) TIMER_CYCLES_PER_US / fires);
+
+    return 0;
+}